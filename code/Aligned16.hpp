@@ -0,0 +1,35 @@
+/// \file Aligned16.hpp
+/// \brief Declaration of Aligned16 class template and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef ALIGNED16_HPP
+#define ALIGNED16_HPP
+
+/// \brief A math type placed on a 16-byte boundary, and padded to a multiple
+///   of 16 bytes, so that arrays of it can be loaded with aligned SIMD
+///   instructions and match std140's vec4-sized slots.
+/// It is used wherever the type is: it converts to and from it, and has the
+///   same constructors, members, and operators.  Like the type, it is
+///   trivially copyable and standard-layout.
+/// \tparam T Vector3, Vector4, Matrix3, Matrix4, or Transform.
+template<typename T>
+class alignas (16) Aligned16 : public T
+{
+public:
+  using T::T;
+
+  /// \brief Initializes it as T's default constructor does.
+  Aligned16 () = default;
+
+  /// \brief Initializes it as a copy of an unaligned value.
+  /// \param[in] value The value.
+  Aligned16 (const T& value)
+    : T (value)
+  {
+
+  }
+};
+
+#endif//ALIGNED16_HPP
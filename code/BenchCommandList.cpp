@@ -0,0 +1,160 @@
+/// \file BenchCommandList.cpp
+/// \brief Times recording the draws of tens of thousands of Meshes into
+///   CommandLists, the way Scene does with setRecordingJobs, on 1 thread up
+///   to every hardware thread.
+/// Runs headlessly: the Meshes' buffers live in a SoftwareOpenGLContext, and
+///   the recorded calls are counted rather than replayed.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "CommandList.hpp"
+#include "Geometry.hpp"
+#include "JobSystem.hpp"
+#include "Material.hpp"
+#include "NormalsMesh.hpp"
+#include "ShaderProgram.hpp"
+#include "SoftwareOpenGLContext.hpp"
+
+static const unsigned MESH_COUNT = 20000;
+static const int FRAMES = 20;
+// Scene::DEFAULT_MESHES_PER_LIST.
+static const size_t MESHES_PER_LIST = 256;
+static const unsigned MATERIAL_COUNT = 8;
+
+// A moving cube: where it was and is, so that every frame recomputes its
+//   matrices as drawing between simulation steps does.
+struct MovingCube
+{
+  std::unique_ptr<Mesh> mesh;
+  Transform previous;
+  Transform current;
+};
+
+// A lit cube somewhere in a 40 x 25 x 20 grid.
+static MovingCube
+makeCube (OpenGLContext* context, ShaderProgram* program, Material* material,
+          unsigned i)
+{
+  MovingCube cube;
+  cube.mesh.reset (new NormalsMesh (context, program, material));
+  std::vector<Triangle> faces = buildCube ();
+  std::vector<float> data;
+  std::vector<unsigned> indices;
+  indexData (dataWithFaceNormals (faces, computeFaceNormals (faces)),
+             cube.mesh->getFloatsPerVertex (), data, indices);
+  cube.mesh->addGeometry (data);
+  cube.mesh->addIndices (indices);
+  cube.mesh->prepareVao ();
+  cube.current.setPosition (i % 40 * 3.0f, i / 40 % 25 * 3.0f, i / 1000 * 3.0f);
+  cube.current.yaw (i * 7.0f);
+  cube.previous = cube.current;
+  cube.previous.moveUp (0.1f);
+  return cube;
+}
+
+// The milliseconds per frame to record every cube into lists of
+//   MESH_COUNT / lists.size () cubes, and the calls and bytes recorded.
+static double
+timeRecording (JobSystem& jobs, std::vector<MovingCube>& cubes,
+               std::vector<std::unique_ptr<CommandList>>& lists,
+               size_t& commandCount, size_t& byteCount)
+{
+  std::chrono::steady_clock::duration elapsed =
+    std::chrono::steady_clock::duration::zero ();
+  for (int frame = 0; frame <= FRAMES; ++frame)
+  {
+    // What Scene does on the context's thread before recording.
+    float interpolation = (frame % 4 + 1) / 5.0f;
+    for (MovingCube& cube : cubes)
+    {
+      cube.mesh->setDrawnWorlds (cube.previous, cube.current, interpolation);
+      cube.mesh->prepareDraw ();
+    }
+
+    auto start = std::chrono::steady_clock::now ();
+    jobs.parallelFor (0, lists.size (), 1, [&] (size_t first, size_t last)
+    {
+      for (size_t list = first; list < last; ++list)
+      {
+        lists[list]->reset ();
+        size_t end = std::min (cubes.size (), (list + 1) * MESHES_PER_LIST);
+        for (size_t i = list * MESHES_PER_LIST; i < end; ++i)
+        {
+          cubes[i].mesh->drawThrough (lists[list].get ());
+        }
+      }
+    });
+    // The first frame grows the lists' blocks, so is not timed.
+    if (frame > 0)
+    {
+      elapsed += std::chrono::steady_clock::now () - start;
+    }
+  }
+  commandCount = 0;
+  byteCount = 0;
+  for (const std::unique_ptr<CommandList>& list : lists)
+  {
+    commandCount += list->getCommandCount ();
+    byteCount += list->getByteCount ();
+  }
+  return std::chrono::duration<double, std::milli> (elapsed).count () / FRAMES;
+}
+
+int
+main (int argc, char* argv[])
+{
+  unsigned maxThreads = std::max (1u, std::thread::hardware_concurrency ());
+  if (argc > 1)
+  {
+    maxThreads = std::max (1, std::atoi (argv[1]));
+  }
+
+  SoftwareOpenGLContext context (1, 1, 1);
+  // Recording only needs the program's name, so nothing is compiled.
+  ShaderProgram program (&context);
+  std::vector<std::unique_ptr<Material>> materials;
+  for (unsigned i = 0; i < MATERIAL_COUNT; ++i)
+  {
+    materials.emplace_back (new Material ());
+  }
+  std::vector<MovingCube> cubes;
+  for (unsigned i = 0; i < MESH_COUNT; ++i)
+  {
+    cubes.push_back (makeCube (&context, &program,
+                               materials[i % MATERIAL_COUNT].get (), i));
+  }
+  std::vector<std::unique_ptr<CommandList>> lists;
+  for (size_t i = 0; i * MESHES_PER_LIST < MESH_COUNT; ++i)
+  {
+    lists.emplace_back (new CommandList ());
+  }
+
+  std::printf ("%u meshes in %zu lists, %d frames\n", MESH_COUNT,
+               lists.size (), FRAMES);
+  std::printf ("%8s %12s %10s %10s %10s\n", "threads", "ms/frame", "speedup",
+               "calls", "KiB");
+  double serialMilliseconds = 0.0;
+  for (unsigned threads = 1; threads <= maxThreads; ++threads)
+  {
+    JobSystem jobs (threads);
+    size_t commandCount, byteCount;
+    double milliseconds =
+      timeRecording (jobs, cubes, lists, commandCount, byteCount);
+    if (threads == 1)
+    {
+      serialMilliseconds = milliseconds;
+    }
+    std::printf ("%8u %12.3f %10.2f %10zu %10zu\n", threads, milliseconds,
+                 serialMilliseconds / milliseconds, commandCount,
+                 byteCount / 1024);
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+/// \file BenchDynamicBatch.cpp
+/// \brief Times moving many small meshes into world space every frame, the
+///   way Scene fills its dynamic batches, one vertex at a time through the
+///   Matrix4 and Matrix3 products and through appendTransformedGeometry.
+/// \author Justin Stevens
+/// \version A09
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Geometry.hpp"
+
+static const unsigned MESH_COUNT = 1000;
+static const int FRAMES = 200;
+// Positions and normals, as NormalsMesh lays them out.
+static const unsigned FLOATS_PER_VERTEX = 6;
+static const int NORMAL_OFFSET = 3;
+
+// A mesh as the batcher sees it: its geometry and the matrices it is drawn
+//   with.
+struct SmallMesh
+{
+  std::vector<float> vertices;
+  std::vector<unsigned> indices;
+  Matrix4 world;
+  Matrix3 normalMatrix;
+};
+
+// A cube with a normal on each face, 24 vertices, like the paddles and cubes.
+static SmallMesh
+makeCube (unsigned i)
+{
+  std::vector<Triangle> faces = buildCube ();
+  std::vector<Vector3> normals = computeFaceNormals (faces);
+  SmallMesh mesh;
+  indexData (dataWithFaceNormals (faces, normals), FLOATS_PER_VERTEX,
+             mesh.vertices, mesh.indices);
+  Transform world;
+  world.setPosition (i % 10 * 3.0f, i / 10 % 10 * 3.0f, i / 100 * 3.0f);
+  world.yaw (i * 7.0f);
+  world.scaleLocal (1.0f, 0.5f + i % 3, 1.0f);
+  mesh.world = world.getTransform ();
+  mesh.normalMatrix = world.getOrientation ();
+  mesh.normalMatrix.invert ();
+  mesh.normalMatrix.transpose ();
+  return mesh;
+}
+
+// Appends a mesh to a batch one vertex at a time through the matrix
+//   products, as the batcher would without SIMD.
+static void
+appendScalar (const SmallMesh& mesh, std::vector<float>& batchVertices,
+              std::vector<unsigned>& batchIndices)
+{
+  unsigned firstVertex =
+    static_cast<unsigned> (batchVertices.size () / FLOATS_PER_VERTEX);
+  for (size_t start = 0; start < mesh.vertices.size ();
+       start += FLOATS_PER_VERTEX)
+  {
+    const float* p = &mesh.vertices[start];
+    Vector4 position = mesh.world * Vector4 (p[0], p[1], p[2], 1.0f);
+    Vector3 normal = mesh.normalMatrix * Vector3 (p[3], p[4], p[5]);
+    batchVertices.push_back (position.m_x);
+    batchVertices.push_back (position.m_y);
+    batchVertices.push_back (position.m_z);
+    batchVertices.push_back (normal.m_x);
+    batchVertices.push_back (normal.m_y);
+    batchVertices.push_back (normal.m_z);
+  }
+  for (unsigned index : mesh.indices)
+  {
+    batchIndices.push_back (firstVertex + index);
+  }
+}
+
+// The milliseconds per frame of a function that appends one mesh.
+template <typename Append>
+static double
+timeFrames (const std::vector<SmallMesh>& meshes, Append append)
+{
+  std::vector<float> batchVertices;
+  std::vector<unsigned> batchIndices;
+  auto frame = [&] ()
+  {
+    batchVertices.clear ();
+    batchIndices.clear ();
+    for (const SmallMesh& mesh : meshes)
+    {
+      append (mesh, batchVertices, batchIndices);
+    }
+  };
+  frame ();
+  auto start = std::chrono::steady_clock::now ();
+  for (int i = 0; i < FRAMES; ++i)
+  {
+    frame ();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now () - start;
+  return elapsed.count () / FRAMES;
+}
+
+int
+main ()
+{
+  std::vector<SmallMesh> meshes;
+  for (unsigned i = 0; i < MESH_COUNT; ++i)
+  {
+    meshes.push_back (makeCube (i));
+  }
+  size_t vertexCount = MESH_COUNT * meshes[0].vertices.size ()
+    / FLOATS_PER_VERTEX;
+
+  std::printf ("%u meshes, %zu vertices, %d frames\n", MESH_COUNT,
+               vertexCount, FRAMES);
+  std::printf ("%-28s %10s %14s\n", "transform", "ms/frame", "Mvertices/s");
+  double scalar = timeFrames (meshes, appendScalar);
+  std::printf ("%-28s %10.3f %14.1f\n", "matrix products", scalar,
+               vertexCount / scalar / 1000.0);
+  double batched = timeFrames (meshes,
+    [] (const SmallMesh& mesh, std::vector<float>& batchVertices,
+        std::vector<unsigned>& batchIndices)
+    {
+      Vector3 low, high;
+      appendTransformedGeometry (mesh.vertices, mesh.indices,
+                                 FLOATS_PER_VERTEX, NORMAL_OFFSET, mesh.world,
+                                 mesh.normalMatrix, batchVertices,
+                                 batchIndices, low, high);
+    });
+  std::printf ("%-28s %10.3f %14.1f\n", "appendTransformedGeometry", batched,
+               vertexCount / batched / 1000.0);
+  return 0;
+}
@@ -0,0 +1,146 @@
+/// \file BenchEntitySystems.cpp
+/// \brief Times one physics step for many bouncing spheres stored as
+///   heap-allocated objects in a map, the way Scene keeps Meshes, and as
+///   packed components moved by the moveBodies system.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EntitySystems.hpp"
+#include "Mesh.hpp"
+
+static const unsigned BODY_COUNT = 100000;
+static const float STEP_SECONDS = 1.0f / 60.0f;
+static const int STEPS = 120;
+static const Walls ROOM = { Vector3 (-50.0f), Vector3 (50.0f) };
+
+// Stands in for a Mesh: as large as one, with its world transform inside.
+struct MeshStandIn
+{
+  Transform world;
+  char rest[sizeof (Mesh) - sizeof (Transform)];
+};
+
+// Stands in for a PhysicsObject: updated through a virtual call, and moving
+//   its Mesh through a pointer.
+class BodyObject
+{
+public:
+  BodyObject (MeshStandIn* mesh, const Body& body)
+    : m_mesh (mesh), m_body (body)
+  {
+  }
+
+  virtual
+  ~BodyObject ()
+  {
+  }
+
+  virtual void
+  update (float deltaTime)
+  {
+    m_mesh->world.moveWorld (deltaTime, m_body.velocity);
+    bounceOffWalls (m_mesh->world.getPosition (), m_body.radius, ROOM,
+                    m_body.velocity);
+  }
+
+private:
+  MeshStandIn* m_mesh;
+  Body m_body;
+};
+
+// Where the bodies start and how they move.
+static std::vector<std::pair<Vector3, Body>>
+makeBodies ()
+{
+  std::mt19937 random (375);
+  std::uniform_real_distribution<float> place (-45.0f, 45.0f);
+  std::uniform_real_distribution<float> speed (-20.0f, 20.0f);
+  std::vector<std::pair<Vector3, Body>> bodies (BODY_COUNT);
+  for (auto& body : bodies)
+  {
+    body.first = Vector3 (place (random), place (random), place (random));
+    body.second = { Vector3 (speed (random), speed (random), speed (random)),
+                    0.5f };
+  }
+  return bodies;
+}
+
+// The milliseconds per step of a function that steps every body once.
+template <typename Step>
+static double
+timeSteps (Step step)
+{
+  step ();
+  auto start = std::chrono::steady_clock::now ();
+  for (int i = 0; i < STEPS; ++i)
+  {
+    step ();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now () - start;
+  return elapsed.count () / STEPS;
+}
+
+int
+main ()
+{
+  std::vector<std::pair<Vector3, Body>> start = makeBodies ();
+
+  // Named and allocated one at a time, like Meshes added to a Scene.
+  std::vector<std::unique_ptr<MeshStandIn>> meshes;
+  std::map<std::string, std::unique_ptr<BodyObject>> objects;
+  for (unsigned i = 0; i < BODY_COUNT; ++i)
+  {
+    meshes.emplace_back (new MeshStandIn ());
+    meshes.back ()->world.setPosition (start[i].first);
+    objects["Body" + std::to_string (i)].reset (
+      new BodyObject (meshes.back ().get (), start[i].second));
+  }
+
+  EntityRegistry registry;
+  ComponentStore<Transform> transforms;
+  ComponentStore<Body> bodies;
+  for (unsigned i = 0; i < BODY_COUNT; ++i)
+  {
+    Entity entity = registry.create ();
+    transforms.add (entity, Transform ()).setPosition (start[i].first);
+    bodies.add (entity, start[i].second);
+  }
+
+  unsigned threads = std::max (1u, std::thread::hardware_concurrency ());
+  JobSystem jobs (threads);
+
+  std::printf ("%u bodies, %d steps\n", BODY_COUNT, STEPS);
+  std::printf ("%-32s %10s\n", "layout", "ms/step");
+  std::printf ("%-32s %10.3f\n", "objects in a map",
+               timeSteps ([&] ()
+               {
+                 for (auto& object : objects)
+                 {
+                   object.second->update (STEP_SECONDS);
+                 }
+               }));
+  std::printf ("%-32s %10.3f\n", "components, 1 thread",
+               timeSteps ([&] ()
+               {
+                 moveBodies (bodies, transforms, ROOM, STEP_SECONDS);
+               }));
+  char label[64];
+  std::snprintf (label, sizeof (label), "components, JobSystem of %u", threads);
+  std::printf ("%-32s %10.3f\n", label,
+               timeSteps ([&] ()
+               {
+                 moveBodies (bodies, transforms, ROOM, STEP_SECONDS, &jobs);
+               }));
+  return 0;
+}
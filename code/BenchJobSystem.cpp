@@ -0,0 +1,159 @@
+/// \file BenchJobSystem.cpp
+/// \brief Times the cost of scheduling a job on JobSystem, and how
+///   parallelFor scales from 1 thread to every hardware thread.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "Vector3.hpp"
+
+// The number of empty jobs timed for the overhead table.
+static const unsigned JOB_COUNT = 200000;
+// The number of triangles whose normals are computed for the scaling table.
+static const size_t TRIANGLE_COUNT = 2000000;
+
+// The time per job to run and wait on empty jobs, all run from this thread.
+static double
+timeFlatJobs (JobSystem& jobs)
+{
+  std::atomic<unsigned> ran (0);
+  auto start = std::chrono::steady_clock::now ();
+  JobSystem::Counter counter;
+  for (unsigned job = 0; job < JOB_COUNT; ++job)
+  {
+    jobs.run ([&ran] () { ran.fetch_add (1, std::memory_order_relaxed); },
+             counter);
+  }
+  jobs.wait (counter);
+  std::chrono::duration<double, std::nano> elapsed =
+    std::chrono::steady_clock::now () - start;
+  return ran == JOB_COUNT ? elapsed.count () / JOB_COUNT : -1.0;
+}
+
+// The time per job to run and wait on empty jobs, each parent job running
+//   its children with the same Counter.
+static double
+timeNestedJobs (JobSystem& jobs)
+{
+  const unsigned CHILDREN = 63;
+  std::atomic<unsigned> ran (0);
+  auto start = std::chrono::steady_clock::now ();
+  JobSystem::Counter counter;
+  for (unsigned parent = 0; parent < JOB_COUNT / (CHILDREN + 1); ++parent)
+  {
+    jobs.run ([&jobs, &ran, &counter, CHILDREN] ()
+    {
+      for (unsigned child = 0; child < CHILDREN; ++child)
+      {
+        jobs.run ([&ran] () { ran.fetch_add (1, std::memory_order_relaxed); },
+                  counter);
+      }
+      ran.fetch_add (1, std::memory_order_relaxed);
+    }, counter);
+  }
+  jobs.wait (counter);
+  std::chrono::duration<double, std::nano> elapsed =
+    std::chrono::steady_clock::now () - start;
+  return ran == JOB_COUNT ? elapsed.count () / JOB_COUNT : -1.0;
+}
+
+// Computes the unit normal of every triangle in a soup of vertices.
+static void
+computeNormals (JobSystem& jobs, size_t grainSize,
+                const std::vector<Vector3>& vertices,
+                std::vector<Vector3>& normals)
+{
+  jobs.parallelFor (0, normals.size (), grainSize,
+                    [&] (size_t first, size_t last)
+  {
+    for (size_t face = first; face < last; ++face)
+    {
+      const Vector3& a = vertices[3 * face];
+      Vector3 normal = (vertices[3 * face + 1] - a).cross (
+        vertices[3 * face + 2] - a);
+      normal.normalize ();
+      normals[face] = normal;
+    }
+  });
+}
+
+int
+main (int argc, char* argv[])
+{
+  unsigned maxThreads = std::max (1u, std::thread::hardware_concurrency ());
+  if (argc > 1)
+  {
+    maxThreads = std::max (1, std::atoi (argv[1]));
+  }
+
+  std::printf ("%8s %14s %14s\n", "threads", "ns/flat job", "ns/nested job");
+  for (unsigned threads : { 1u, maxThreads })
+  {
+    JobSystem jobs (threads);
+    // Once to start the workers and grow the queues.
+    timeFlatJobs (jobs);
+    double flat = timeFlatJobs (jobs);
+    double nested = timeNestedJobs (jobs);
+    if (flat < 0.0 || nested < 0.0)
+    {
+      std::printf ("Not every job ran\n");
+      return 1;
+    }
+    std::printf ("%8u %14.1f %14.1f\n", threads, flat, nested);
+    if (maxThreads == 1)
+    {
+      break;
+    }
+  }
+
+  std::mt19937 random (375);
+  std::uniform_real_distribution<float> coordinate (-1.0f, 1.0f);
+  std::vector<Vector3> vertices (3 * TRIANGLE_COUNT);
+  for (Vector3& vertex : vertices)
+  {
+    vertex.set (coordinate (random), coordinate (random), coordinate (random));
+  }
+  std::vector<Vector3> expected (TRIANGLE_COUNT);
+  {
+    JobSystem serial (1);
+    computeNormals (serial, 0, vertices, expected);
+  }
+
+  std::printf ("\n%8s %12s %10s\n", "threads", "ms/pass", "speedup");
+  double serialMilliseconds = 0.0;
+  for (unsigned threads = 1; threads <= maxThreads; ++threads)
+  {
+    JobSystem jobs (threads);
+    std::vector<Vector3> normals (TRIANGLE_COUNT);
+    const int REPEATS = 5;
+    auto start = std::chrono::steady_clock::now ();
+    for (int i = 0; i < REPEATS; ++i)
+    {
+      computeNormals (jobs, 4096, vertices, normals);
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now () - start;
+    if (!std::equal (normals.begin (), normals.end (), expected.begin ()))
+    {
+      std::printf ("Normals with %u threads differ\n", threads);
+      return 1;
+    }
+    double milliseconds = elapsed.count () / REPEATS;
+    if (threads == 1)
+    {
+      serialMilliseconds = milliseconds;
+    }
+    std::printf ("%8u %12.3f %10.2f\n", threads, milliseconds,
+                 serialMilliseconds / milliseconds);
+  }
+  return 0;
+}
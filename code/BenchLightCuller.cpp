@@ -0,0 +1,165 @@
+/// \file BenchLightCuller.cpp
+/// \brief Times ClusteredLightCuller with increasing numbers of lights, and
+///   checks its output against a brute-force assignment.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "ClusteredLightCuller.hpp"
+#include "Matrix4.hpp"
+
+// The frustum that lights are scattered through.
+static const float FOV_Y = 50.0f;
+static const float ASPECT_RATIO = 16.0f / 9.0f;
+static const float NEAR_PLANE = 0.1f;
+static const float FAR_PLANE = 100.0f;
+
+// Lights in structure-of-arrays form, in view space.
+struct Lights
+{
+  std::vector<float> x, y, z, radius;
+};
+
+// Scatters lights uniformly through the frustum's bounding box.
+static Lights
+makeLights (unsigned count, std::mt19937& random)
+{
+  float halfHeight = FAR_PLANE * std::tan (FOV_Y * 3.14159265f / 360.0f);
+  std::uniform_real_distribution<float> depth (NEAR_PLANE, FAR_PLANE);
+  std::uniform_real_distribution<float> side (-1.0f, 1.0f);
+  std::uniform_real_distribution<float> quadratic (5.0f, 40.0f);
+  Lights lights;
+  for (unsigned i = 0; i < count; ++i)
+  {
+    float d = depth (random);
+    float scale = d / FAR_PLANE;
+    lights.x.push_back (side (random) * halfHeight * ASPECT_RATIO * scale);
+    lights.y.push_back (side (random) * halfHeight * scale);
+    lights.z.push_back (-d);
+    lights.radius.push_back (ClusteredLightCuller::attenuationRadius (
+      Vector3 (1.0f, 0.0f, quadratic (random)), 0.2f));
+  }
+  return lights;
+}
+
+// Whether the culler gave the same lights, in the same order, as a simple
+//   per-cluster test of every light.  A cluster with too many lights only
+//   has to keep some of them, and the rest must add up to the dropped count.
+static bool
+matchesBruteForce (const ClusteredLightCuller& culler, const Lights& lights,
+                   const Matrix4& inverseProjection)
+{
+  ClusteredLightCuller reference (culler.getTilesX (), culler.getTilesY (),
+                                  culler.getSlices ());
+  reference.setProjection (inverseProjection);
+  // Cull one light at a time so the reference never needs the bucketing.
+  std::vector<std::vector<unsigned>> expectedLights (culler.getClusterCount ());
+  for (unsigned light = 0; light < lights.x.size (); ++light)
+  {
+    std::vector<float> x (1, lights.x[light]), y (1, lights.y[light]);
+    std::vector<float> z (1, lights.z[light]), r (1, lights.radius[light]);
+    reference.cull (x, y, z, r);
+    for (unsigned cluster = 0; cluster < culler.getClusterCount (); ++cluster)
+    {
+      if (reference.getClusterGrid ()[2 * cluster + 1] == 1)
+      {
+        expectedLights[cluster].push_back (light);
+      }
+    }
+  }
+
+  const std::vector<unsigned>& grid = culler.getClusterGrid ();
+  const std::vector<unsigned>& indices = culler.getLightIndices ();
+  unsigned overflowed = 0, dropped = 0;
+  for (unsigned cluster = 0; cluster < culler.getClusterCount (); ++cluster)
+  {
+    const std::vector<unsigned>& expected = expectedLights[cluster];
+    std::vector<unsigned> actual (indices.begin () + grid[2 * cluster],
+                                  indices.begin () + grid[2 * cluster]
+                                                   + grid[2 * cluster + 1]);
+    bool isSame = actual == expected;
+    if (expected.size () > ClusteredLightCuller::MAX_LIGHTS_PER_CLUSTER)
+    {
+      ++overflowed;
+      dropped += expected.size () - actual.size ();
+      isSame = actual.size () == ClusteredLightCuller::MAX_LIGHTS_PER_CLUSTER
+        && std::includes (expected.begin (), expected.end (), actual.begin (),
+                          actual.end ());
+    }
+    if (!isSame)
+    {
+      std::printf ("Cluster %u differs: %zu lights, expected %zu\n", cluster,
+                   actual.size (), expected.size ());
+      return false;
+    }
+  }
+  if (overflowed != culler.getStats ().overflowedClusters
+      || dropped != culler.getStats ().droppedLights)
+  {
+    std::printf ("%u clusters dropped %u lights, expected %u dropping %u\n",
+                 culler.getStats ().overflowedClusters,
+                 culler.getStats ().droppedLights, overflowed, dropped);
+    return false;
+  }
+  return true;
+}
+
+int
+main ()
+{
+  Matrix4 projection;
+  projection.setToPerspectiveProjection (FOV_Y, ASPECT_RATIO, NEAR_PLANE,
+                                         FAR_PLANE);
+  Matrix4 inverseProjection = projection;
+  inverseProjection.invert ();
+
+  ClusteredLightCuller culler;
+  culler.setProjection (inverseProjection);
+  std::printf ("%u x %u x %u clusters\n", culler.getTilesX (),
+               culler.getTilesY (), culler.getSlices ());
+
+  // The second check crowds some clusters past MAX_LIGHTS_PER_CLUSTER.
+  std::mt19937 random (375);
+  for (unsigned count : { 200u, 5000u })
+  {
+    Lights check = makeLights (count, random);
+    culler.cull (check.x, check.y, check.z, check.radius);
+    if (!matchesBruteForce (culler, check, inverseProjection))
+    {
+      return 1;
+    }
+  }
+
+  std::printf ("%10s %12s %14s %14s %12s %12s\n", "lights", "ms/cull",
+               "indices", "max/cluster", "overflowed", "dropped");
+  for (unsigned count : { 1000u, 10000u, 100000u })
+  {
+    Lights lights = makeLights (count, random);
+    const int REPEATS = 10;
+    auto start = std::chrono::steady_clock::now ();
+    for (int i = 0; i < REPEATS; ++i)
+    {
+      culler.cull (lights.x, lights.y, lights.z, lights.radius);
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now () - start;
+
+    unsigned most = 0;
+    const std::vector<unsigned>& grid = culler.getClusterGrid ();
+    for (unsigned cluster = 0; cluster < culler.getClusterCount (); ++cluster)
+    {
+      most = std::max (most, grid[2 * cluster + 1]);
+    }
+    std::printf ("%10u %12.3f %14zu %14u %12u %12u\n", count,
+                 elapsed.count () / REPEATS, culler.getLightIndices ().size (),
+                 most, culler.getStats ().overflowedClusters,
+                 culler.getStats ().droppedLights);
+  }
+  return 0;
+}
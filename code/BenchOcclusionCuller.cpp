@@ -0,0 +1,158 @@
+/// \file BenchOcclusionCuller.cpp
+/// \brief Times OcclusionCuller on an indoor level, a corridor of rooms
+///   whose walls hide most of the boxes in them, on 1 thread up to every
+///   hardware thread, and reports how many boxes it hides.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "Matrix4.hpp"
+#include "OcclusionCuller.hpp"
+
+static const int FRAMES = 50;
+// Rooms along -z, each ROOM_SIZE across, with a doorway in every wall.
+static const unsigned ROOM_COUNT = 16;
+static const float ROOM_SIZE = 10.0f;
+static const float DOOR_HALF_WIDTH = 1.0f;
+static const unsigned BOXES_PER_ROOM = 400;
+
+// An occluder: a wall's vertices, 3 floats each, and indices.
+struct Wall
+{
+  std::vector<float> vertices;
+  std::vector<unsigned> indices;
+};
+
+// An axis-aligned rectangle in a plane of constant z, split into 2
+//   triangles.
+static Wall
+makeWall (float left, float right, float bottom, float top, float z)
+{
+  Wall wall;
+  wall.vertices = { left, bottom, z,  right, bottom, z,
+                    right, top, z,    left, top, z };
+  wall.indices = { 0, 1, 2,  0, 2, 3 };
+  return wall;
+}
+
+// The walls between the rooms, each with a doorway off to one side, so
+//   that little of one room is seen from the one before it.
+static std::vector<Wall>
+makeWalls ()
+{
+  float half = ROOM_SIZE / 2.0f;
+  std::vector<Wall> walls;
+  for (unsigned room = 1; room <= ROOM_COUNT; ++room)
+  {
+    float z = -(room * ROOM_SIZE);
+    float door = room % 2 == 0 ? half - 2.0f : 2.0f - half;
+    walls.push_back (makeWall (-half, door - DOOR_HALF_WIDTH, -half, half, z));
+    walls.push_back (makeWall (door + DOOR_HALF_WIDTH, half, -half, half, z));
+    walls.push_back (makeWall (door - DOOR_HALF_WIDTH, door + DOOR_HALF_WIDTH,
+                               -half + 2.5f, half, z));
+  }
+  return walls;
+}
+
+// Small boxes scattered through every room.
+static std::vector<OcclusionCuller::Box>
+makeBoxes (const Matrix4& world)
+{
+  std::mt19937 random (7);
+  std::uniform_real_distribution<float> side (-ROOM_SIZE / 2.0f + 0.5f,
+                                              ROOM_SIZE / 2.0f - 0.5f);
+  std::uniform_real_distribution<float> depth (0.5f, ROOM_SIZE - 0.5f);
+  std::vector<OcclusionCuller::Box> boxes;
+  for (unsigned room = 0; room < ROOM_COUNT; ++room)
+  {
+    for (unsigned i = 0; i < BOXES_PER_ROOM; ++i)
+    {
+      Vector3 center (side (random), side (random),
+                      -(room * ROOM_SIZE + depth (random)));
+      boxes.push_back ({ center - Vector3 (0.3f), center + Vector3 (0.3f),
+                         &world });
+    }
+  }
+  return boxes;
+}
+
+// The culler's average times per frame, and what it hid in the last one.
+static OcclusionCuller::Stats
+timeCulling (JobSystem& jobs, OcclusionCuller& culler,
+             const Matrix4& viewProjection, const std::vector<Wall>& walls,
+             const std::vector<OcclusionCuller::Box>& boxes, double& milliseconds)
+{
+  Matrix4 identity;
+  std::vector<unsigned char> isHidden;
+  OcclusionCuller::Stats total = OcclusionCuller::Stats ();
+  auto start = std::chrono::steady_clock::now ();
+  for (int frame = 0; frame < FRAMES; ++frame)
+  {
+    culler.beginFrame (viewProjection);
+    for (const Wall& wall : walls)
+    {
+      culler.addOccluder (wall.vertices, wall.indices, 3, identity);
+    }
+    culler.rasterize (&jobs);
+    culler.testBoxes (boxes, isHidden, &jobs);
+    total.setupMilliseconds += culler.getStats ().setupMilliseconds;
+    total.rasterizeMilliseconds += culler.getStats ().rasterizeMilliseconds;
+    total.testMilliseconds += culler.getStats ().testMilliseconds;
+  }
+  milliseconds = std::chrono::duration<double, std::milli> (
+    std::chrono::steady_clock::now () - start).count () / FRAMES;
+  OcclusionCuller::Stats stats = culler.getStats ();
+  stats.setupMilliseconds = total.setupMilliseconds / FRAMES;
+  stats.rasterizeMilliseconds = total.rasterizeMilliseconds / FRAMES;
+  stats.testMilliseconds = total.testMilliseconds / FRAMES;
+  return stats;
+}
+
+int
+main (int argc, char* argv[])
+{
+  unsigned maxThreads = std::max (1u, std::thread::hardware_concurrency ());
+  if (argc > 1)
+  {
+    maxThreads = std::max (1, std::atoi (argv[1]));
+  }
+
+  // Looking down the corridor from the middle of the first room.
+  Matrix4 viewProjection;
+  viewProjection.setToPerspectiveProjection (60.0, 16.0 / 9.0, 0.1, 500.0);
+  Matrix4 view (Vector4 (1.0f, 0.0f, 0.0f, 0.0f),
+                Vector4 (0.0f, 1.0f, 0.0f, 0.0f),
+                Vector4 (0.0f, 0.0f, 1.0f, 0.0f),
+                Vector4 (0.0f, 0.0f, ROOM_SIZE / 2.0f, 1.0f));
+  viewProjection = viewProjection * view;
+  std::vector<Wall> walls = makeWalls ();
+  Matrix4 identity;
+  std::vector<OcclusionCuller::Box> boxes = makeBoxes (identity);
+  OcclusionCuller culler;
+
+  std::printf ("%zu occluders, %zu boxes, %ux%u depth buffer, %d frames\n",
+               walls.size (), boxes.size (), culler.getWidth (),
+               culler.getHeight (), FRAMES);
+  std::printf ("%8s %10s %10s %10s %10s %10s %10s\n", "threads", "ms/frame",
+               "setup", "rasterize", "test", "hidden", "tested");
+  for (unsigned threads = 1; threads <= maxThreads; ++threads)
+  {
+    JobSystem jobs (threads);
+    double milliseconds;
+    OcclusionCuller::Stats stats =
+      timeCulling (jobs, culler, viewProjection, walls, boxes, milliseconds);
+    std::printf ("%8u %10.3f %10.3f %10.3f %10.3f %10u %10u\n", threads,
+                 milliseconds, stats.setupMilliseconds,
+                 stats.rasterizeMilliseconds, stats.testMilliseconds,
+                 stats.occluded, stats.tested);
+  }
+  return 0;
+}
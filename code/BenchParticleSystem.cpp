@@ -0,0 +1,132 @@
+/// \file BenchParticleSystem.cpp
+/// \brief Times ParticleSystem steps for a million bouncing spheres with each
+///   kernel and with 1 thread up to every hardware thread.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ParticleSystem.hpp"
+
+static const size_t PARTICLE_COUNT = 1000000;
+static const float STEP_SECONDS = 1.0f / 60.0f;
+static const int STEPS = 60;
+
+// Fills a 100-wide room with particles.
+static void
+fillRoom (ParticleSystem& particles, size_t count)
+{
+  std::mt19937 random (375);
+  std::uniform_real_distribution<float> place (-45.0f, 45.0f);
+  std::uniform_real_distribution<float> speed (-20.0f, 20.0f);
+  std::uniform_real_distribution<float> size (0.05f, 0.5f);
+  particles.reserve (count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    particles.add (Vector3 (place (random), place (random), place (random)),
+                   Vector3 (speed (random), speed (random), speed (random)),
+                   size (random));
+  }
+  particles.setBounds (-50.0f, 50.0f, 50.0f, -50.0f, 50.0f, -50.0f);
+}
+
+// The milliseconds per step of one kernel on this thread, working on a copy
+//   of the particles.
+static double
+timeKernel (size_t count, bool isAvx2)
+{
+  ParticleSystem particles;
+  fillRoom (particles, count);
+  std::vector<float> x (count), y (count), z (count);
+  std::vector<float> velocityX (count), velocityY (count), velocityZ (count);
+  std::vector<float> radius (count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    Vector3 position = particles.getPosition (i);
+    Vector3 velocity = particles.getVelocity (i);
+    x[i] = position.m_x;
+    y[i] = position.m_y;
+    z[i] = position.m_z;
+    velocityX[i] = velocity.m_x;
+    velocityY[i] = velocity.m_y;
+    velocityZ[i] = velocity.m_z;
+    radius[i] = 0.25f;
+  }
+  ParticleSpan span { x.data (), y.data (), z.data (), velocityX.data (),
+                      velocityY.data (), velocityZ.data (), radius.data (),
+                      count };
+  const float low[3] = { -50.0f, -50.0f, -50.0f };
+  const float high[3] = { 50.0f, 50.0f, 50.0f };
+  auto start = std::chrono::steady_clock::now ();
+  for (int step = 0; step < STEPS; ++step)
+  {
+    if (isAvx2)
+    {
+      integrateParticlesAvx2 (span, STEP_SECONDS, low, high);
+    }
+    else
+    {
+      integrateParticlesScalar (span, STEP_SECONDS, low, high);
+    }
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now () - start;
+  return elapsed.count () / STEPS;
+}
+
+int
+main (int argc, char* argv[])
+{
+  unsigned maxThreads = std::max (1u, std::thread::hardware_concurrency ());
+  if (argc > 1)
+  {
+    maxThreads = std::max (1, std::atoi (argv[1]));
+  }
+
+  std::printf ("%zu particles\n", PARTICLE_COUNT);
+  std::printf ("%8s %12s\n", "kernel", "ms/step");
+  std::printf ("%8s %12.3f\n", "scalar", timeKernel (PARTICLE_COUNT, false));
+  if (hasAvx2ParticleKernel ())
+  {
+    std::printf ("%8s %12.3f\n", "avx2", timeKernel (PARTICLE_COUNT, true));
+  }
+
+  ParticleSystem particles;
+  fillRoom (particles, PARTICLE_COUNT);
+  std::vector<float> matrices;
+  std::printf ("\n%8s %12s %10s %14s\n", "threads", "ms/step", "speedup",
+               "ms/matrices");
+  double serialMilliseconds = 0.0;
+  for (unsigned threads = 1; threads <= maxThreads; ++threads)
+  {
+    JobSystem jobs (threads);
+    auto start = std::chrono::steady_clock::now ();
+    for (int step = 0; step < STEPS; ++step)
+    {
+      particles.step (STEP_SECONDS, &jobs);
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now () - start;
+    double milliseconds = elapsed.count () / STEPS;
+    if (threads == 1)
+    {
+      serialMilliseconds = milliseconds;
+    }
+
+    // Once to size the array, then timed.
+    particles.writeWorldMatrices (matrices, &jobs);
+    start = std::chrono::steady_clock::now ();
+    particles.writeWorldMatrices (matrices, &jobs);
+    std::chrono::duration<double, std::milli> written =
+      std::chrono::steady_clock::now () - start;
+    std::printf ("%8u %12.3f %10.2f %14.3f\n", threads, milliseconds,
+                 serialMilliseconds / milliseconds, written.count ());
+  }
+  return 0;
+}
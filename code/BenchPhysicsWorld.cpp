@@ -0,0 +1,130 @@
+/// \file BenchPhysicsWorld.cpp
+/// \brief Times PhysicsWorld steps with both broadphases as the number of
+///   bouncing bodies grows, against testing every pair.
+/// \author Justin Stevens
+/// \version A09
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "PhysicsWorld.hpp"
+
+// Bodies per cubic unit, kept the same at every count so that each body has
+//   about as many neighbors.
+static const float DENSITY = 0.05f;
+static const float STEP_SECONDS = 1.0f / 60.0f;
+
+// Fills a room with spheres and a few boxes.
+static void
+fillRoom (PhysicsWorld& world, unsigned count, std::mt19937& random)
+{
+  float halfWidth = 0.5f * std::cbrt (count / DENSITY);
+  std::uniform_real_distribution<float> place (-halfWidth, halfWidth);
+  std::uniform_real_distribution<float> speed (-5.0f, 5.0f);
+  std::uniform_real_distribution<float> size (0.2f, 0.8f);
+  for (unsigned body = 0; body < count; ++body)
+  {
+    Vector3 position (place (random), place (random), place (random));
+    Vector3 velocity (speed (random), speed (random), speed (random));
+    if (body % 8 == 0)
+    {
+      world.addBox (position, velocity,
+                    Vector3 (size (random), size (random), size (random)));
+    }
+    else
+    {
+      world.addSphere (position, velocity, size (random));
+    }
+  }
+  world.setBounds (-halfWidth, halfWidth, halfWidth, -halfWidth, halfWidth,
+                   -halfWidth);
+}
+
+// The milliseconds per step, averaged over a second of simulation.
+static double
+timeSteps (PhysicsWorld& world, size_t& pairs, size_t& contacts)
+{
+  // Settle the sweep and prune order first; the very first sort is a full
+  //   one.
+  world.step (STEP_SECONDS);
+  const int STEPS = 60;
+  pairs = 0;
+  contacts = 0;
+  auto start = std::chrono::steady_clock::now ();
+  for (int step = 0; step < STEPS; ++step)
+  {
+    world.step (STEP_SECONDS);
+    pairs += world.getCandidatePairs ().size ();
+    contacts += world.getContacts ().size ();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now () - start;
+  pairs /= STEPS;
+  contacts /= STEPS;
+  return elapsed.count () / STEPS;
+}
+
+// The milliseconds to test every pair of bounding boxes once.
+static double
+timeAllPairs (const PhysicsWorld& world, size_t& pairs)
+{
+  std::vector<Vector3> positions;
+  for (unsigned body = 0; body < world.getBodyCount (); ++body)
+  {
+    positions.push_back (world.getPosition (body));
+  }
+  auto start = std::chrono::steady_clock::now ();
+  pairs = 0;
+  for (size_t a = 0; a < positions.size (); ++a)
+  {
+    for (size_t b = a + 1; b < positions.size (); ++b)
+    {
+      Vector3 distance = positions[b] - positions[a];
+      // Every body fits in a 1.6-wide box.
+      if (std::abs (distance.m_x) <= 1.6f && std::abs (distance.m_y) <= 1.6f
+          && std::abs (distance.m_z) <= 1.6f)
+      {
+        ++pairs;
+      }
+    }
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+int
+main ()
+{
+  std::printf ("%8s %14s %14s %14s %10s %10s\n", "bodies", "sweep ms/step",
+               "grid ms/step", "all-pairs ms", "pairs", "contacts");
+  for (unsigned count : { 1000u, 4000u, 16000u, 64000u })
+  {
+    std::mt19937 random (375);
+    PhysicsWorld sweep;
+    fillRoom (sweep, count, random);
+    random.seed (375);
+    PhysicsWorld grid;
+    fillRoom (grid, count, random);
+    grid.setBroadphase (PhysicsWorld::Broadphase::UNIFORM_GRID);
+
+    size_t pairs = 0;
+    size_t contacts = 0;
+    double sweepMilliseconds = timeSteps (sweep, pairs, contacts);
+    double gridMilliseconds = timeSteps (grid, pairs, contacts);
+    // Testing every pair is quadratic, so stop before it takes minutes.
+    double allPairsMilliseconds = -1.0;
+    if (count <= 16000)
+    {
+      size_t loosePairs = 0;
+      allPairsMilliseconds = timeAllPairs (grid, loosePairs);
+    }
+    std::printf ("%8u %14.3f %14.3f %14.3f %10zu %10zu\n", count,
+                 sweepMilliseconds, gridMilliseconds, allPairsMilliseconds,
+                 pairs, contacts);
+  }
+  return 0;
+}
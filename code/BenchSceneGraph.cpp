@@ -0,0 +1,97 @@
+/// \file BenchSceneGraph.cpp
+/// \brief Times SceneGraph updates for a large hierarchy when a few nodes
+///   change each frame, and when every node does.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "SceneGraph.hpp"
+
+static const unsigned NODE_COUNT = 100000;
+// Each node has up to this many children, like objects with a few attached
+//   parts that have parts of their own.
+static const unsigned FANOUT = 8;
+static const int FRAMES = 200;
+
+// Builds a hierarchy FANOUT wide at every level, then hands the leaves to
+//   random inner nodes, so that the array has to be re-sorted.
+static void
+buildHierarchy (SceneGraph& graph, std::vector<unsigned>& nodes,
+                std::mt19937& random)
+{
+  nodes.assign (NODE_COUNT, SceneGraph::NO_PARENT);
+  nodes[0] = graph.add (Transform ());
+  for (unsigned i = 1; i < NODE_COUNT; ++i)
+  {
+    Transform local;
+    local.setPosition (1.0f, 0.0f, 0.0f);
+    nodes[i] = graph.add (local, nodes[(i - 1) / FANOUT]);
+  }
+  std::vector<unsigned> leaves;
+  for (unsigned i = NODE_COUNT / FANOUT + 1; i < NODE_COUNT; ++i)
+  {
+    leaves.push_back (nodes[i]);
+  }
+  std::shuffle (leaves.begin (), leaves.end (), random);
+  for (unsigned i = 0; i < leaves.size (); ++i)
+  {
+    graph.setParent (leaves[i], nodes[i % (NODE_COUNT / FANOUT)]);
+  }
+}
+
+// Moves a share of the nodes and updates, FRAMES times.  Prints the average
+//   milliseconds each update took and transforms it recomputed.
+static void
+timeFrames (SceneGraph& graph, const std::vector<unsigned>& nodes,
+            double changingShare, std::mt19937& random)
+{
+  std::uniform_int_distribution<unsigned> pick (0, NODE_COUNT - 1);
+  unsigned changing = static_cast<unsigned> (NODE_COUNT * changingShare);
+  size_t recomputed = 0;
+  double milliseconds = 0.0;
+  for (int frame = 0; frame < FRAMES; ++frame)
+  {
+    for (unsigned i = 0; i < changing; ++i)
+    {
+      unsigned node = changing == NODE_COUNT ? nodes[i] : nodes[pick (random)];
+      Transform local = graph.getLocal (node);
+      local.yaw (1.0f);
+      graph.setLocal (node, local);
+    }
+    auto start = std::chrono::steady_clock::now ();
+    recomputed += graph.update ();
+    std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now () - start;
+    milliseconds += elapsed.count ();
+  }
+  std::printf ("%9.1f%% %12.3f %14zu\n", 100.0 * changingShare,
+               milliseconds / FRAMES, recomputed / FRAMES);
+}
+
+int
+main ()
+{
+  std::mt19937 random (43);
+  SceneGraph graph;
+  std::vector<unsigned> nodes;
+  buildHierarchy (graph, nodes, random);
+
+  auto start = std::chrono::steady_clock::now ();
+  graph.update ();
+  std::chrono::duration<double, std::milli> sorted =
+    std::chrono::steady_clock::now () - start;
+  std::printf ("%u nodes, %u children each; first update and sort: %.3f ms\n",
+               NODE_COUNT, FANOUT, sorted.count ());
+
+  std::printf ("%10s %12s %14s\n", "changing", "ms/update", "recomputed");
+  for (double share : { 0.0, 0.001, 0.01, 0.1, 1.0 })
+  {
+    timeFrames (graph, nodes, share, random);
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/// \file BenchTransformLayout.cpp
+/// \brief Reports how much memory each Transform takes now that Matrix3 has
+///   no virtual destructor, and times copying large arrays of them.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Transform.hpp"
+
+static const size_t TRANSFORM_COUNT = 1000000;
+static const int COPIES = 20;
+
+// Matrix3 and Transform as they were laid out when Matrix3 had a virtual
+//   destructor: a vtable pointer, then the members, padded to its alignment.
+class VirtualMatrix3
+{
+public:
+  virtual ~VirtualMatrix3 () { }
+
+  Vector3 m_right;
+  Vector3 m_up;
+  Vector3 m_back;
+};
+
+struct VirtualTransform
+{
+  VirtualMatrix3 m_rotScale;
+  Vector3 m_position;
+};
+
+// The milliseconds one copy takes, averaged over COPIES.
+template<typename Copy>
+static double
+timeCopies (Copy copy)
+{
+  auto start = std::chrono::steady_clock::now ();
+  for (int i = 0; i < COPIES; ++i)
+  {
+    copy ();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now () - start;
+  return elapsed.count () / COPIES;
+}
+
+// Prints one row of the table.
+static void
+printRow (const char* name, size_t size, size_t alignment, bool isMemcpy,
+          double milliseconds)
+{
+  double megabytes = static_cast<double> (size) * TRANSFORM_COUNT / 1.0e6;
+  std::printf ("%-20s %6zu %6zu %8s %10.1f %10.3f\n", name, size, alignment,
+               isMemcpy ? "yes" : "no", megabytes, milliseconds);
+}
+
+int
+main ()
+{
+  std::vector<VirtualTransform> virtualSource (TRANSFORM_COUNT);
+  std::vector<VirtualTransform> virtualCopy (TRANSFORM_COUNT);
+  std::vector<Transform> source (TRANSFORM_COUNT);
+  std::vector<Transform> copy (TRANSFORM_COUNT);
+  std::vector<AlignedTransform> alignedSource (TRANSFORM_COUNT);
+  std::vector<AlignedTransform> alignedCopy (TRANSFORM_COUNT);
+  for (size_t i = 0; i < TRANSFORM_COUNT; ++i)
+  {
+    source[i].moveWorld (1.0f, Vector3 (i, 0.0f, 0.0f));
+    alignedSource[i] = source[i];
+  }
+
+  // A type with a vtable has to be copied one element at a time.
+  double virtualMilliseconds = timeCopies ([&] ()
+  {
+    std::copy (virtualSource.begin (), virtualSource.end (),
+               virtualCopy.begin ());
+  });
+  double milliseconds = timeCopies ([&] ()
+  {
+    std::memcpy (copy.data (), source.data (),
+                 source.size () * sizeof (Transform));
+  });
+  double alignedMilliseconds = timeCopies ([&] ()
+  {
+    std::memcpy (alignedCopy.data (), alignedSource.data (),
+                 alignedSource.size () * sizeof (AlignedTransform));
+  });
+  if (std::memcmp (copy.data (), source.data (),
+                   source.size () * sizeof (Transform)) != 0)
+  {
+    std::printf ("copy differs from source\n");
+    return 1;
+  }
+
+  std::printf ("%zu transforms, copied %d times\n", TRANSFORM_COUNT, COPIES);
+  std::printf ("%-20s %6s %6s %8s %10s %10s\n", "layout", "bytes", "align",
+               "memcpy", "MB", "ms/copy");
+  printRow ("virtual Matrix3", sizeof (VirtualTransform),
+            alignof (VirtualTransform), false, virtualMilliseconds);
+  printRow ("Transform", sizeof (Transform), alignof (Transform), true,
+            milliseconds);
+  printRow ("AlignedTransform", sizeof (AlignedTransform),
+            alignof (AlignedTransform), true, alignedMilliseconds);
+  std::printf ("\nsaved per Transform: %zu bytes (%zu per Matrix3)\n",
+               sizeof (VirtualTransform) - sizeof (Transform),
+               sizeof (VirtualMatrix3) - sizeof (Matrix3));
+  return 0;
+}
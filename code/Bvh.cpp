@@ -0,0 +1,432 @@
+/// \file Bvh.cpp
+/// \brief Definition of Bvh class and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cfloat>
+#include <limits>
+
+#include "Bvh.hpp"
+
+// The number of candidate split planes along each axis is BIN_COUNT - 1.
+static const int BIN_COUNT = 12;
+// Leaves are never bigger than this unless their triangles cannot be split.
+static const unsigned MAX_LEAF_TRIANGLES = 4;
+// The traversal stack holds at most one node per level, and buildNode stops
+//   splitting at this depth.
+static const int STACK_SIZE = 64;
+
+// An axis-aligned box that can grow to contain points.
+struct Bounds
+{
+  Vector3 min = Vector3 (FLT_MAX);
+  Vector3 max = Vector3 (-FLT_MAX);
+
+  void
+  grow (const Vector3& p)
+  {
+    min = Vector3 (std::min (min.m_x, p.m_x), std::min (min.m_y, p.m_y),
+                   std::min (min.m_z, p.m_z));
+    max = Vector3 (std::max (max.m_x, p.m_x), std::max (max.m_y, p.m_y),
+                   std::max (max.m_z, p.m_z));
+  }
+
+  void
+  grow (const Bounds& b)
+  {
+    grow (b.min);
+    grow (b.max);
+  }
+
+  float
+  getHalfArea () const
+  {
+    Vector3 size = max - min;
+    if (size.m_x < 0.0f)
+    {
+      return 0.0f;
+    }
+    return size.m_x * size.m_y + size.m_y * size.m_z + size.m_z * size.m_x;
+  }
+};
+
+static float
+getAxis (const Vector3& v, int axis)
+{
+  return axis == 0 ? v.m_x : (axis == 1 ? v.m_y : v.m_z);
+}
+
+Bvh::Bvh ()
+{
+}
+
+void
+Bvh::build (const std::vector<Vector3>& vertices)
+{
+  m_nodes.clear ();
+  m_triangles.clear ();
+  m_triangles.reserve (vertices.size () / 3);
+  for (size_t i = 0; i + 2 < vertices.size (); i += 3)
+  {
+    m_triangles.push_back (Triangle { vertices[i],
+                                      vertices[i + 1] - vertices[i],
+                                      vertices[i + 2] - vertices[i],
+                                      static_cast<unsigned> (i / 3) });
+  }
+  if (!m_triangles.empty ())
+  {
+    m_nodes.reserve (2 * m_triangles.size ());
+    buildNode (0, static_cast<unsigned> (m_triangles.size ()), 0);
+  }
+}
+
+unsigned
+Bvh::buildNode (unsigned first, unsigned count, int depth)
+{
+  unsigned index = static_cast<unsigned> (m_nodes.size ());
+  m_nodes.push_back (Node ());
+
+  Bounds bounds, centroidBounds;
+  for (unsigned i = first; i < first + count; ++i)
+  {
+    const Triangle& t = m_triangles[i];
+    bounds.grow (t.vertex0);
+    bounds.grow (t.vertex0 + t.edge1);
+    bounds.grow (t.vertex0 + t.edge2);
+    centroidBounds.grow (t.vertex0 + (t.edge1 + t.edge2) / 3.0f);
+  }
+  Node node;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    node.min[axis] = getAxis (bounds.min, axis);
+    node.max[axis] = getAxis (bounds.max, axis);
+  }
+  node.secondChildOrFirst = first;
+  node.count = count;
+
+  // Find the cheapest split plane among the bin boundaries of every axis.
+  float bestCost = FLT_MAX;
+  int bestAxis = -1;
+  int bestSplit = 0;
+  for (int axis = 0; axis < 3 && count > MAX_LEAF_TRIANGLES / 2; ++axis)
+  {
+    float low = getAxis (centroidBounds.min, axis);
+    float extent = getAxis (centroidBounds.max, axis) - low;
+    if (extent <= 0.0f)
+    {
+      continue;
+    }
+    Bounds binBounds[BIN_COUNT];
+    unsigned binCounts[BIN_COUNT] = {};
+    float scale = BIN_COUNT / extent;
+    for (unsigned i = first; i < first + count; ++i)
+    {
+      const Triangle& t = m_triangles[i];
+      float centroid = getAxis (t.vertex0 + (t.edge1 + t.edge2) / 3.0f, axis);
+      int bin = std::min (static_cast<int> ((centroid - low) * scale),
+                          BIN_COUNT - 1);
+      ++binCounts[bin];
+      binBounds[bin].grow (t.vertex0);
+      binBounds[bin].grow (t.vertex0 + t.edge1);
+      binBounds[bin].grow (t.vertex0 + t.edge2);
+    }
+    // Sweep from both ends to get the cost of each plane in linear time.
+    float leftCosts[BIN_COUNT - 1];
+    Bounds left, right;
+    unsigned leftCount = 0, rightCount = 0;
+    for (int split = 0; split < BIN_COUNT - 1; ++split)
+    {
+      left.grow (binBounds[split]);
+      leftCount += binCounts[split];
+      leftCosts[split] = leftCount * left.getHalfArea ();
+    }
+    for (int split = BIN_COUNT - 1; split > 0; --split)
+    {
+      right.grow (binBounds[split]);
+      rightCount += binCounts[split];
+      float cost = leftCosts[split - 1] + rightCount * right.getHalfArea ();
+      if (cost < bestCost)
+      {
+        bestCost = cost;
+        bestAxis = axis;
+        bestSplit = split;
+      }
+    }
+  }
+
+  // Splitting costs one more box test, and saves the triangle tests of
+  //   whichever child a ray misses.
+  float leafCost = count * bounds.getHalfArea ();
+  bool isLeaf = bestAxis < 0 || depth + 1 >= STACK_SIZE
+    || (count <= MAX_LEAF_TRIANGLES
+        && bounds.getHalfArea () + bestCost >= leafCost);
+  if (isLeaf)
+  {
+    m_nodes[index] = node;
+    return index;
+  }
+
+  float low = getAxis (centroidBounds.min, bestAxis);
+  float scale = BIN_COUNT / (getAxis (centroidBounds.max, bestAxis) - low);
+  auto middle = std::partition (
+    m_triangles.begin () + first, m_triangles.begin () + first + count,
+    [=] (const Triangle& t)
+    {
+      float centroid = getAxis (t.vertex0 + (t.edge1 + t.edge2) / 3.0f,
+                                bestAxis);
+      return std::min (static_cast<int> ((centroid - low) * scale),
+                       BIN_COUNT - 1) < bestSplit;
+    });
+  unsigned leftCount = static_cast<unsigned> (middle - m_triangles.begin ())
+    - first;
+
+  // The first child is always the node right after this one.
+  buildNode (first, leftCount, depth + 1);
+  node.secondChildOrFirst = buildNode (first + leftCount, count - leftCount,
+                                       depth + 1);
+  node.count = 0;
+  m_nodes[index] = node;
+  return index;
+}
+
+float
+Bvh::intersectBox (const Node& node, const Ray& ray, float maxDistance)
+{
+  float near = 0.0f;
+  float far = maxDistance;
+  const float origin[3] = { ray.origin.m_x, ray.origin.m_y, ray.origin.m_z };
+  const float inverse[3] = { ray.inverseDirection.m_x,
+                             ray.inverseDirection.m_y,
+                             ray.inverseDirection.m_z };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    float t0 = (node.min[axis] - origin[axis]) * inverse[axis];
+    float t1 = (node.max[axis] - origin[axis]) * inverse[axis];
+    near = std::max (near, std::min (t0, t1));
+    far = std::min (far, std::max (t0, t1));
+  }
+  return near <= far ? near : FLT_MAX;
+}
+
+bool
+Bvh::intersectTriangle (const Triangle& triangle, const Ray& ray,
+                        float maxDistance, BvhHit& hit,
+                        bool isCullingBackFaces)
+{
+  Vector3 p = ray.direction.cross (triangle.edge2);
+  // This is positive when the ray sees the vertices counterclockwise.
+  float determinant = triangle.edge1.dot (p);
+  if (std::abs (determinant) < 1e-12f
+      || (isCullingBackFaces && determinant < 0.0f))
+  {
+    return false;
+  }
+  float inverseDeterminant = 1.0f / determinant;
+  Vector3 s = ray.origin - triangle.vertex0;
+  float u = s.dot (p) * inverseDeterminant;
+  if (u < 0.0f || u > 1.0f)
+  {
+    return false;
+  }
+  Vector3 q = s.cross (triangle.edge1);
+  float v = ray.direction.dot (q) * inverseDeterminant;
+  if (v < 0.0f || u + v > 1.0f)
+  {
+    return false;
+  }
+  float distance = triangle.edge2.dot (q) * inverseDeterminant;
+  if (distance <= 0.0f || distance >= maxDistance)
+  {
+    return false;
+  }
+  hit = BvhHit { distance, triangle.index, u, v };
+  return true;
+}
+
+bool
+Bvh::traverse (const Ray& ray, float maxDistance, bool isAnyHit,
+               BvhHit& hit) const
+{
+  if (m_nodes.empty ())
+  {
+    return false;
+  }
+  bool isHit = false;
+  unsigned stack[STACK_SIZE];
+  int stackSize = 0;
+  unsigned current = 0;
+  while (true)
+  {
+    const Node& node = m_nodes[current];
+    if (node.count > 0)
+    {
+      for (unsigned i = 0; i < node.count; ++i)
+      {
+        if (intersectTriangle (m_triangles[node.secondChildOrFirst + i], ray,
+                               maxDistance, hit))
+        {
+          isHit = true;
+          maxDistance = hit.distance;
+          if (isAnyHit)
+          {
+            return true;
+          }
+        }
+      }
+    }
+    else
+    {
+      // Visit the nearer child first so the farther one is more likely to be
+      //   culled by the hit found in the nearer one.
+      unsigned first = current + 1;
+      unsigned second = node.secondChildOrFirst;
+      float firstDistance = intersectBox (m_nodes[first], ray, maxDistance);
+      float secondDistance = intersectBox (m_nodes[second], ray, maxDistance);
+      if (secondDistance < firstDistance)
+      {
+        std::swap (first, second);
+        std::swap (firstDistance, secondDistance);
+      }
+      if (firstDistance <= maxDistance)
+      {
+        if (secondDistance <= maxDistance)
+        {
+          stack[stackSize++] = second;
+        }
+        current = first;
+        continue;
+      }
+    }
+    // Pop the next node that the ray still reaches.
+    if (stackSize == 0)
+    {
+      return isHit;
+    }
+    current = stack[--stackSize];
+  }
+}
+
+// Builds a Ray, avoiding infinities in the inverse direction.
+static Vector3
+getInverseDirection (const Vector3& direction)
+{
+  const float tiny = 1e-20f;
+  return Vector3 (1.0f / (std::abs (direction.m_x) > tiny ? direction.m_x
+                                                          : tiny),
+                  1.0f / (std::abs (direction.m_y) > tiny ? direction.m_y
+                                                          : tiny),
+                  1.0f / (std::abs (direction.m_z) > tiny ? direction.m_z
+                                                          : tiny));
+}
+
+bool
+Bvh::intersect (const Vector3& origin, const Vector3& direction,
+                float maxDistance, BvhHit& hit) const
+{
+  Ray ray { origin, direction, getInverseDirection (direction) };
+  return traverse (ray, maxDistance, false, hit);
+}
+
+bool
+Bvh::isOccluded (const Vector3& origin, const Vector3& direction,
+                 float maxDistance) const
+{
+  Ray ray { origin, direction, getInverseDirection (direction) };
+  BvhHit hit;
+  return traverse (ray, maxDistance, true, hit);
+}
+
+void
+Bvh::intersectPacket (const Vector3 origins[PACKET_SIZE],
+                      const Vector3 directions[PACKET_SIZE], float maxDistance,
+                      BvhHit hits[PACKET_SIZE], bool isHit[PACKET_SIZE],
+                      bool isCullingBackFaces) const
+{
+  Ray rays[PACKET_SIZE];
+  float closest[PACKET_SIZE];
+  for (int r = 0; r < PACKET_SIZE; ++r)
+  {
+    rays[r] = Ray { origins[r], directions[r],
+                    getInverseDirection (directions[r]) };
+    closest[r] = maxDistance;
+    isHit[r] = false;
+  }
+  if (m_nodes.empty ())
+  {
+    return;
+  }
+
+  unsigned stack[STACK_SIZE];
+  int stackSize = 0;
+  unsigned current = 0;
+  while (true)
+  {
+    const Node& node = m_nodes[current];
+    if (node.count > 0)
+    {
+      for (unsigned i = 0; i < node.count; ++i)
+      {
+        const Triangle& triangle = m_triangles[node.secondChildOrFirst + i];
+        for (int r = 0; r < PACKET_SIZE; ++r)
+        {
+          if (intersectTriangle (triangle, rays[r], closest[r], hits[r],
+                                 isCullingBackFaces))
+          {
+            isHit[r] = true;
+            closest[r] = hits[r].distance;
+          }
+        }
+      }
+    }
+    else
+    {
+      // A child is visited if any ray in the packet reaches it, nearest (for
+      //   whichever ray reaches it soonest) first.
+      unsigned first = current + 1;
+      unsigned second = node.secondChildOrFirst;
+      float firstDistance = FLT_MAX;
+      float secondDistance = FLT_MAX;
+      for (int r = 0; r < PACKET_SIZE; ++r)
+      {
+        float d = intersectBox (m_nodes[first], rays[r], closest[r]);
+        firstDistance = d <= closest[r] ? std::min (firstDistance, d)
+                                        : firstDistance;
+        d = intersectBox (m_nodes[second], rays[r], closest[r]);
+        secondDistance = d <= closest[r] ? std::min (secondDistance, d)
+                                         : secondDistance;
+      }
+      if (secondDistance < firstDistance)
+      {
+        std::swap (first, second);
+        std::swap (firstDistance, secondDistance);
+      }
+      if (firstDistance < FLT_MAX)
+      {
+        if (secondDistance < FLT_MAX)
+        {
+          stack[stackSize++] = second;
+        }
+        current = first;
+        continue;
+      }
+    }
+    if (stackSize == 0)
+    {
+      return;
+    }
+    current = stack[--stackSize];
+  }
+}
+
+size_t
+Bvh::getTriangleCount () const
+{
+  return m_triangles.size ();
+}
+
+size_t
+Bvh::getNodeCount () const
+{
+  return m_nodes.size ();
+}
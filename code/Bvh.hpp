@@ -0,0 +1,168 @@
+/// \file Bvh.hpp
+/// \brief Declaration of Bvh class and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef BVH_HPP
+#define BVH_HPP
+
+#include <vector>
+
+#include "Vector3.hpp"
+
+/// \brief Where a ray hit a triangle.
+struct BvhHit
+{
+  /// How far along the ray the hit is, in multiples of its direction.
+  float distance;
+  /// The index of the triangle, in the order the triangles were built with.
+  unsigned triangle;
+  /// The barycentric weights of the triangle's second and third vertices.
+  float u, v;
+};
+
+/// \brief A bounding volume hierarchy over triangles, which finds the
+///   triangles a ray hits without testing every one of them.
+/// The tree is built with the surface area heuristic, evaluated over a fixed
+///   number of bins along each axis, and is stored depth first in one array
+///   so that traversal touches as little memory as possible.
+class Bvh
+{
+public:
+
+  /// \brief The number of rays traced together by intersectPacket.
+  static const int PACKET_SIZE = 4;
+
+  /// \brief Constructs an empty hierarchy, which no ray hits.
+  Bvh ();
+
+  /// \brief Builds the hierarchy.
+  /// \param[in] vertices The triangles' vertices, 3 per triangle.
+  /// \post Any previous triangles have been replaced by these ones.
+  void
+  build (const std::vector<Vector3>& vertices);
+
+  /// \brief Finds the closest triangle a ray hits.
+  /// \param[in] origin Where the ray starts.
+  /// \param[in] direction Which way the ray goes.  It need not be unit
+  ///   length.
+  /// \param[in] maxDistance How far along the ray to look.
+  /// \param[out] hit The closest hit, if there is one.
+  /// \return Whether the ray hits anything closer than maxDistance.
+  bool
+  intersect (const Vector3& origin, const Vector3& direction,
+             float maxDistance, BvhHit& hit) const;
+
+  /// \brief Tests whether a ray hits anything, which is cheaper than finding
+  ///   the closest hit, for shadow rays.
+  /// \param[in] origin Where the ray starts.
+  /// \param[in] direction Which way the ray goes.
+  /// \param[in] maxDistance How far along the ray to look.
+  /// \return Whether the ray hits anything closer than maxDistance.
+  bool
+  isOccluded (const Vector3& origin, const Vector3& direction,
+              float maxDistance) const;
+
+  /// \brief Finds the closest hits of PACKET_SIZE rays at once.
+  /// The rays share one traversal, so coherent rays (like camera rays through
+  ///   neighboring pixels) read each node once instead of once per ray.
+  /// \param[in] origins Where each ray starts.
+  /// \param[in] directions Which way each ray goes.
+  /// \param[in] maxDistance How far along the rays to look.
+  /// \param[out] hits The closest hit of each ray.
+  /// \param[out] isHit Whether each ray hit anything.
+  /// \param[in] isCullingBackFaces Whether to ignore triangles whose vertices
+  ///   are clockwise as seen by the ray, the way GL_CULL_FACE does.
+  void
+  intersectPacket (const Vector3 origins[PACKET_SIZE],
+                   const Vector3 directions[PACKET_SIZE], float maxDistance,
+                   BvhHit hits[PACKET_SIZE], bool isHit[PACKET_SIZE],
+                   bool isCullingBackFaces = false) const;
+
+  /// \brief Gets the number of triangles.
+  /// \return The number of triangles the hierarchy was built with.
+  size_t
+  getTriangleCount () const;
+
+  /// \brief Gets the number of nodes, for reporting.
+  /// \return The number of nodes in the tree.
+  size_t
+  getNodeCount () const;
+
+private:
+
+  /// \brief One node of the tree, in 32 bytes.
+  /// An interior node's first child is the next node and its second child is
+  ///   at secondChildOrFirst; a leaf's triangles are count elements of
+  ///   m_triangles starting at secondChildOrFirst.
+  struct Node
+  {
+    float min[3];
+    unsigned secondChildOrFirst;
+    float max[3];
+    unsigned count;
+  };
+
+  /// \brief A triangle, stored for the Moller-Trumbore intersection test.
+  struct Triangle
+  {
+    Vector3 vertex0;
+    Vector3 edge1;
+    Vector3 edge2;
+    unsigned index;
+  };
+
+  /// \brief A ray with what the traversal needs precomputed.
+  struct Ray
+  {
+    Vector3 origin;
+    Vector3 direction;
+    Vector3 inverseDirection;
+  };
+
+  /// \brief Builds the subtree over m_triangles[first, first + count).
+  /// \param[in] first The first triangle in the subtree.
+  /// \param[in] count The number of triangles in the subtree.
+  /// \param[in] depth The depth of the subtree's root.
+  /// \return The index of the subtree's root.
+  unsigned
+  buildNode (unsigned first, unsigned count, int depth);
+
+  /// \brief Finds how far along a ray it enters a node's box.
+  /// \param[in] node The node.
+  /// \param[in] ray The ray.
+  /// \param[in] maxDistance How far along the ray to look.
+  /// \return The entry distance, or a value greater than maxDistance if the
+  ///   ray misses.
+  static float
+  intersectBox (const Node& node, const Ray& ray, float maxDistance);
+
+  /// \brief Finds where a ray hits a triangle.
+  /// \param[in] triangle The triangle.
+  /// \param[in] ray The ray.
+  /// \param[in] maxDistance How far along the ray to look.
+  /// \param[out] hit The hit, if it is closer than maxDistance.
+  /// \param[in] isCullingBackFaces Whether to miss the triangle's back.
+  /// \return Whether the ray hits the triangle closer than maxDistance.
+  static bool
+  intersectTriangle (const Triangle& triangle, const Ray& ray,
+                     float maxDistance, BvhHit& hit,
+                     bool isCullingBackFaces = false);
+
+  /// \brief Finds the closest hit, or any hit, of a ray.
+  /// \param[in] ray The ray.
+  /// \param[in] maxDistance How far along the ray to look.
+  /// \param[in] isAnyHit Whether to stop at the first hit found.
+  /// \param[out] hit The hit.
+  /// \return Whether anything was hit.
+  bool
+  traverse (const Ray& ray, float maxDistance, bool isAnyHit,
+            BvhHit& hit) const;
+
+  /// The nodes, depth first, with the root at index 0.
+  std::vector<Node> m_nodes;
+  /// The triangles, ordered so that every leaf's are contiguous.
+  std::vector<Triangle> m_triangles;
+};
+
+#endif//BVH_HPP
@@ -8,6 +8,8 @@
 Camera::Camera (const Vector3& eyePosition, const Vector3& localBackDirection,
   float nearClipPlaneDistance, float farClipPlaneDistance,
   float aspectRatio, float verticalFieldOfViewDegrees)
+  : m_viewUpdateCount(0), m_projectionUpdateCount(0),
+    m_viewProjectionUpdateCount(0)
 {
   m_world.setPosition(eyePosition);
   m_startingEyePosition = eyePosition;
@@ -82,8 +84,22 @@ Camera::roll (float degrees)
   hasCameraMoved = true;
 }
 
-Transform
+const Matrix4&
 Camera::getViewMatrix ()
+{
+  updateView();
+  return m_viewMatrix;
+}
+
+const Matrix4&
+Camera::getInverseViewMatrix ()
+{
+  updateView();
+  return m_inverseViewMatrix;
+}
+
+void
+Camera::updateView ()
 {
   if (hasCameraMoved) 
   {
@@ -93,12 +109,17 @@ Camera::getViewMatrix ()
     Vector3 e (m_world.getPosition() - p);
     Vector3 r = m_world.getUp().cross(m_world.getBack());
     Vector3 b = e / e.length();
-    m_viewMatrix.setOrientation(r, u, b);
-    m_viewMatrix.setPosition(t);
+    Transform eye;
+    eye.setOrientation(r, u, b);
+    eye.setPosition(t);
+    m_inverseViewMatrix = eye.getTransform();
+    eye.invertRt();
+    m_viewMatrix = eye.getTransform();
+
     hasCameraMoved = false;
-    m_viewMatrix.invertRt();
+    m_isViewProjectionDirty = true;
+    ++m_viewUpdateCount;
   }
-  return m_viewMatrix;
 }
 
 void
@@ -107,6 +128,7 @@ Camera::setProjectionSymmetricPerspective (double verticalFovDegrees, double asp
 {
   m_fov = verticalFovDegrees;
   m_projectionMatrix.setToPerspectiveProjection(verticalFovDegrees, aspectRatio, nearZ, farZ);
+  projectionChanged();
 }
 
 void
@@ -115,6 +137,7 @@ Camera::setProjectionAsymmetricPerspective (double left, double right,
         double nearPlaneZ, double farPlaneZ)
 {
   m_projectionMatrix.setToPerspectiveProjection(left, right, bottom, top, nearPlaneZ, farPlaneZ);
+  projectionChanged();
 }
 
 void
@@ -123,14 +146,66 @@ Camera::setProjectionOrthographic (double left, double right,
             double nearPlaneZ, double farPlaneZ)
 {
   m_projectionMatrix.setToOrthographicProjection(left, right, bottom, top, nearPlaneZ, farPlaneZ);
+  projectionChanged();
 }
 
-Matrix4
-Camera::getProjectionMatrix ()
+const Matrix4&
+Camera::getProjectionMatrix () const
 {
   return m_projectionMatrix;
 }
 
+const Matrix4&
+Camera::getInverseProjectionMatrix ()
+{
+  if (m_isInverseProjectionDirty)
+  {
+    m_inverseProjectionMatrix = m_projectionMatrix;
+    m_inverseProjectionMatrix.invert();
+    m_isInverseProjectionDirty = false;
+  }
+  return m_inverseProjectionMatrix;
+}
+
+const Matrix4&
+Camera::getViewProjectionMatrix ()
+{
+  updateView();
+  if (m_isViewProjectionDirty)
+  {
+    m_viewProjectionMatrix = m_projectionMatrix * m_viewMatrix;
+    m_isViewProjectionDirty = false;
+    ++m_viewProjectionUpdateCount;
+  }
+  return m_viewProjectionMatrix;
+}
+
+unsigned
+Camera::getViewUpdateCount () const
+{
+  return m_viewUpdateCount;
+}
+
+unsigned
+Camera::getProjectionUpdateCount () const
+{
+  return m_projectionUpdateCount;
+}
+
+unsigned
+Camera::getViewProjectionUpdateCount () const
+{
+  return m_viewProjectionUpdateCount;
+}
+
+void
+Camera::projectionChanged ()
+{
+  m_isInverseProjectionDirty = true;
+  m_isViewProjectionDirty = true;
+  ++m_projectionUpdateCount;
+}
+
 void
 Camera::resetPose ()
 {
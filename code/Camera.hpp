@@ -90,9 +90,15 @@ public:
 
   /// \brief Gets the view matrix, recalculating it only if necessary.
   /// \return A view matrix based on the camera's location and axis vectors.
-  Transform
+  const Matrix4&
   getViewMatrix ();
 
+  /// \brief Gets the inverse of the view matrix (the camera's own world
+  ///   transform), recalculating it only if necessary.
+  /// \return The matrix that takes eye coordinates to world coordinates.
+  const Matrix4&
+  getInverseViewMatrix ();
+
   /// \brief Recreates the projection matrix to a symmetric perspective.
   /// \param[in] verticalFovDegrees The viewing angle.
   /// \param[in] aspectRatio The width / height.
@@ -128,8 +134,38 @@ public:
 
   /// \brief Gets the projection matrix.
   /// \return The projection matrix.
-  Matrix4
-  getProjectionMatrix ();
+  const Matrix4&
+  getProjectionMatrix () const;
+
+  /// \brief Gets the inverse of the projection matrix, recalculating it only
+  ///   if necessary.
+  /// \return The matrix that takes clip coordinates to eye coordinates.
+  const Matrix4&
+  getInverseProjectionMatrix ();
+
+  /// \brief Gets the product of the projection and view matrices,
+  ///   recalculating it only if either has changed.
+  /// \return The matrix that takes world coordinates to clip coordinates.
+  const Matrix4&
+  getViewProjectionMatrix ();
+
+  /// \brief Gets how many times the view matrix has been recalculated.
+  /// Callers can remember this number to tell whether the view has changed
+  ///   since they last used it.
+  /// \return The number of view matrix recalculations.
+  unsigned
+  getViewUpdateCount () const;
+
+  /// \brief Gets how many times the projection matrix has been set.
+  /// \return The number of projection matrix changes.
+  unsigned
+  getProjectionUpdateCount () const;
+
+  /// \brief Gets how many times the view-projection matrix has been
+  ///   recalculated.
+  /// \return The number of view-projection matrix recalculations.
+  unsigned
+  getViewProjectionUpdateCount () const;
 
   /// \brief Resets the camera to its original pose.
   /// \post The position (eye point) is the same as what had been specified in
@@ -155,13 +191,28 @@ public:
 
 private:
 
+  /// \brief Recalculates the view and inverse view matrices if the camera
+  ///   has moved.
+  void
+  updateView ();
+
+  /// \brief Marks everything that depends on the projection as out of date.
+  void
+  projectionChanged ();
+
   /// A 4 by 4 matrix storing the up, back, right and position of the camera.
   Transform m_world;
 
   /// The projection matrix.
   Matrix4 m_projectionMatrix;
   /// The view matrix.
-  Transform m_viewMatrix;
+  Matrix4 m_viewMatrix;
+  /// The inverse of the view matrix.
+  Matrix4 m_inverseViewMatrix;
+  /// The inverse of the projection matrix.
+  Matrix4 m_inverseProjectionMatrix;
+  /// The projection matrix times the view matrix.
+  Matrix4 m_viewProjectionMatrix;
 
   /// Orginal location of camera
   Vector3 m_startingEyePosition;
@@ -173,6 +224,17 @@ private:
 
   /// Boolean value to change when camera is moved
   bool hasCameraMoved;
+  /// Whether m_inverseProjectionMatrix is out of date.
+  bool m_isInverseProjectionDirty;
+  /// Whether m_viewProjectionMatrix is out of date.
+  bool m_isViewProjectionDirty;
+
+  /// Number of times the view matrix has been recalculated.
+  unsigned m_viewUpdateCount;
+  /// Number of times the projection matrix has been set.
+  unsigned m_projectionUpdateCount;
+  /// Number of times the view-projection matrix has been recalculated.
+  unsigned m_viewProjectionUpdateCount;
 };
 
 #endif//CAMERA_HPP
\ No newline at end of file
@@ -0,0 +1,356 @@
+/// \file ClusteredLightCuller.cpp
+/// \brief Implementation of ClusteredLightCuller class and any associated
+///   global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ClusteredLightCuller.hpp"
+#include "Vector4.hpp"
+
+const unsigned ClusteredLightCuller::MAX_LIGHTS_PER_CLUSTER;
+
+// Where padding lights are placed so that they never touch a cluster.
+static const float FAR_AWAY = 1.0e30f;
+
+// Transforms a normalized device coordinate into view space.
+static Vector4
+unproject (const Matrix4& inverseProjection, float x, float y, float z)
+{
+  Vector4 v = inverseProjection * Vector4 (x, y, z, 1.0f);
+  return v * (1.0f / v.m_w);
+}
+
+ClusteredLightCuller::ClusteredLightCuller (unsigned tilesX, unsigned tilesY,
+                                            unsigned slices)
+  : m_tilesX(tilesX), m_tilesY(tilesY), m_slices(slices),
+    m_near(0.0f), m_far(0.0f), m_depthScale(0.0f), m_depthBias(0.0f),
+    m_sliceX(slices), m_sliceY(slices), m_sliceZ(slices),
+    m_sliceRadius(slices), m_sliceIndex(slices),
+    m_grid(2 * tilesX * tilesY * slices, 0), m_stats()
+{
+}
+
+void
+ClusteredLightCuller::setProjection (const Matrix4& inverseProjection)
+{
+  m_near = -unproject (inverseProjection, 0.0f, 0.0f, -1.0f).m_z;
+  m_far = -unproject (inverseProjection, 0.0f, 0.0f, 1.0f).m_z;
+  float logRatio = std::log (m_far / m_near);
+  m_depthScale = m_slices / logRatio;
+  m_depthBias = -(m_slices * std::log (m_near)) / logRatio;
+
+  unsigned count = getClusterCount ();
+  m_minX.assign (count, 0.0f);
+  m_minY.assign (count, 0.0f);
+  m_minZ.assign (count, 0.0f);
+  m_maxX.assign (count, 0.0f);
+  m_maxY.assign (count, 0.0f);
+  m_maxZ.assign (count, 0.0f);
+
+  // The rays through each corner of the tiles, from the near plane to the far
+  //   plane.  Working from both planes keeps this correct for orthographic
+  //   projections, where the rays do not meet at the eye.
+  unsigned cornersX = m_tilesX + 1;
+  unsigned cornersY = m_tilesY + 1;
+  std::vector<Vector4> nearCorners (cornersX * cornersY);
+  std::vector<Vector4> farCorners (cornersX * cornersY);
+  for (unsigned j = 0; j < cornersY; ++j)
+  {
+    float y = -1.0f + 2.0f * j / m_tilesY;
+    for (unsigned i = 0; i < cornersX; ++i)
+    {
+      float x = -1.0f + 2.0f * i / m_tilesX;
+      nearCorners[j * cornersX + i] = unproject (inverseProjection, x, y, -1.0f);
+      farCorners[j * cornersX + i] = unproject (inverseProjection, x, y, 1.0f);
+    }
+  }
+
+  for (unsigned k = 0; k < m_slices; ++k)
+  {
+    float depths[2] = {
+      m_near * std::pow (m_far / m_near, static_cast<float> (k) / m_slices),
+      m_near * std::pow (m_far / m_near, static_cast<float> (k + 1) / m_slices)
+    };
+    for (unsigned j = 0; j < m_tilesY; ++j)
+    {
+      for (unsigned i = 0; i < m_tilesX; ++i)
+      {
+        unsigned cluster = (k * m_tilesY + j) * m_tilesX + i;
+        float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+        for (unsigned corner = 0; corner < 4; ++corner)
+        {
+          unsigned index = (j + corner / 2) * cornersX + i + corner % 2;
+          const Vector4& n = nearCorners[index];
+          const Vector4& f = farCorners[index];
+          for (float depth : depths)
+          {
+            float t = (-depth - n.m_z) / (f.m_z - n.m_z);
+            float x = n.m_x + t * (f.m_x - n.m_x);
+            float y = n.m_y + t * (f.m_y - n.m_y);
+            minX = std::min (minX, x);
+            maxX = std::max (maxX, x);
+            minY = std::min (minY, y);
+            maxY = std::max (maxY, y);
+          }
+        }
+        m_minX[cluster] = minX;
+        m_minY[cluster] = minY;
+        m_minZ[cluster] = -depths[1];
+        m_maxX[cluster] = maxX;
+        m_maxY[cluster] = maxY;
+        m_maxZ[cluster] = -depths[0];
+      }
+    }
+  }
+}
+
+void
+ClusteredLightCuller::cull (const std::vector<float>& x,
+                            const std::vector<float>& y,
+                            const std::vector<float>& z,
+                            const std::vector<float>& radius)
+{
+  // Bucket the lights by the slices their spheres reach, so that each cluster
+  //   only tests the lights that share its depth range.
+  for (unsigned k = 0; k < m_slices; ++k)
+  {
+    m_sliceX[k].clear ();
+    m_sliceY[k].clear ();
+    m_sliceZ[k].clear ();
+    m_sliceRadius[k].clear ();
+    m_sliceIndex[k].clear ();
+  }
+  for (size_t light = 0; light < x.size (); ++light)
+  {
+    float depth = -z[light];
+    float r = radius[light];
+    if (depth + r < m_near || depth - r > m_far)
+    {
+      continue;
+    }
+    unsigned first = sliceOf (std::max (depth - r, m_near));
+    unsigned last = sliceOf (std::min (depth + r, m_far));
+    for (unsigned k = first; k <= last; ++k)
+    {
+      m_sliceX[k].push_back (x[light]);
+      m_sliceY[k].push_back (y[light]);
+      m_sliceZ[k].push_back (z[light]);
+      m_sliceRadius[k].push_back (r);
+      m_sliceIndex[k].push_back (static_cast<unsigned> (light));
+    }
+  }
+  for (unsigned k = 0; k < m_slices; ++k)
+  {
+    while (m_sliceX[k].size () % 4 != 0)
+    {
+      m_sliceX[k].push_back (FAR_AWAY);
+      m_sliceY[k].push_back (FAR_AWAY);
+      m_sliceZ[k].push_back (FAR_AWAY);
+      m_sliceRadius[k].push_back (0.0f);
+      m_sliceIndex[k].push_back (0);
+    }
+  }
+
+  // Test every cluster's box against its slice's spheres, 4 spheres at a
+  //   time, using the squared distance from each center to the box.
+  m_indices.clear ();
+  m_stats = Stats ();
+  for (unsigned k = 0; k < m_slices; ++k)
+  {
+    const float* sx = m_sliceX[k].data ();
+    const float* sy = m_sliceY[k].data ();
+    const float* sz = m_sliceZ[k].data ();
+    const float* sr = m_sliceRadius[k].data ();
+    const unsigned* si = m_sliceIndex[k].data ();
+    size_t candidates = m_sliceX[k].size ();
+    for (unsigned cluster = k * m_tilesX * m_tilesY;
+         cluster < (k + 1) * m_tilesX * m_tilesY; ++cluster)
+    {
+      unsigned offset = static_cast<unsigned> (m_indices.size ());
+      unsigned count = 0;
+#ifdef __SSE2__
+      __m128 zero = _mm_setzero_ps ();
+      __m128 minX = _mm_set1_ps (m_minX[cluster]);
+      __m128 minY = _mm_set1_ps (m_minY[cluster]);
+      __m128 minZ = _mm_set1_ps (m_minZ[cluster]);
+      __m128 maxX = _mm_set1_ps (m_maxX[cluster]);
+      __m128 maxY = _mm_set1_ps (m_maxY[cluster]);
+      __m128 maxZ = _mm_set1_ps (m_maxZ[cluster]);
+      for (size_t c = 0; c < candidates; c += 4)
+      {
+        __m128 px = _mm_loadu_ps (sx + c);
+        __m128 py = _mm_loadu_ps (sy + c);
+        __m128 pz = _mm_loadu_ps (sz + c);
+        __m128 r = _mm_loadu_ps (sr + c);
+        __m128 dx = _mm_max_ps (_mm_max_ps (_mm_sub_ps (minX, px),
+                                            _mm_sub_ps (px, maxX)), zero);
+        __m128 dy = _mm_max_ps (_mm_max_ps (_mm_sub_ps (minY, py),
+                                            _mm_sub_ps (py, maxY)), zero);
+        __m128 dz = _mm_max_ps (_mm_max_ps (_mm_sub_ps (minZ, pz),
+                                            _mm_sub_ps (pz, maxZ)), zero);
+        __m128 distanceSquared = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, dx),
+                                                         _mm_mul_ps (dy, dy)),
+                                             _mm_mul_ps (dz, dz));
+        int mask = _mm_movemask_ps (_mm_cmple_ps (distanceSquared,
+                                                  _mm_mul_ps (r, r)));
+        while (mask != 0)
+        {
+          int lane = __builtin_ctz (mask);
+          mask &= mask - 1;
+          m_indices.push_back (si[c + lane]);
+          ++count;
+        }
+      }
+#else
+      for (size_t c = 0; c < candidates; ++c)
+      {
+        float dx = std::max (std::max (m_minX[cluster] - sx[c],
+                                       sx[c] - m_maxX[cluster]), 0.0f);
+        float dy = std::max (std::max (m_minY[cluster] - sy[c],
+                                       sy[c] - m_maxY[cluster]), 0.0f);
+        float dz = std::max (std::max (m_minZ[cluster] - sz[c],
+                                       sz[c] - m_maxZ[cluster]), 0.0f);
+        if (dx * dx + dy * dy + dz * dz <= sr[c] * sr[c])
+        {
+          m_indices.push_back (si[c]);
+          ++count;
+        }
+      }
+#endif
+      if (count > MAX_LIGHTS_PER_CLUSTER)
+      {
+        ++m_stats.overflowedClusters;
+        m_stats.droppedLights += count - MAX_LIGHTS_PER_CLUSTER;
+        keepNearest (cluster, offset, x, y, z);
+        count = MAX_LIGHTS_PER_CLUSTER;
+      }
+      m_grid[2 * cluster] = offset;
+      m_grid[2 * cluster + 1] = count;
+    }
+  }
+}
+
+const std::vector<unsigned>&
+ClusteredLightCuller::getClusterGrid () const
+{
+  return m_grid;
+}
+
+const std::vector<unsigned>&
+ClusteredLightCuller::getLightIndices () const
+{
+  return m_indices;
+}
+
+const ClusteredLightCuller::Stats&
+ClusteredLightCuller::getStats () const
+{
+  return m_stats;
+}
+
+unsigned
+ClusteredLightCuller::getClusterCount () const
+{
+  return m_tilesX * m_tilesY * m_slices;
+}
+
+unsigned
+ClusteredLightCuller::getTilesX () const
+{
+  return m_tilesX;
+}
+
+unsigned
+ClusteredLightCuller::getTilesY () const
+{
+  return m_tilesY;
+}
+
+unsigned
+ClusteredLightCuller::getSlices () const
+{
+  return m_slices;
+}
+
+float
+ClusteredLightCuller::getDepthScale () const
+{
+  return m_depthScale;
+}
+
+float
+ClusteredLightCuller::getDepthBias () const
+{
+  return m_depthBias;
+}
+
+float
+ClusteredLightCuller::attenuationRadius (const Vector3& attenuationCoefficients,
+                                         float intensity, float threshold)
+{
+  // Solve intensity / (c + l * d + q * d^2) = threshold for d.
+  float c = attenuationCoefficients.m_x;
+  float l = attenuationCoefficients.m_y;
+  float q = attenuationCoefficients.m_z;
+  float k = intensity / threshold - c;
+  if (k <= 0.0f)
+  {
+    return 0.0f;
+  }
+  if (q > 0.0f)
+  {
+    return (-l + std::sqrt (l * l + 4.0f * q * k)) / (2.0f * q);
+  }
+  if (l > 0.0f)
+  {
+    return k / l;
+  }
+  return FLT_MAX;
+}
+
+unsigned
+ClusteredLightCuller::sliceOf (float depth) const
+{
+  float slice = std::floor (std::log (depth) * m_depthScale + m_depthBias);
+  return static_cast<unsigned> (std::min (std::max (slice, 0.0f),
+                                          static_cast<float> (m_slices - 1)));
+}
+
+void
+ClusteredLightCuller::keepNearest (unsigned cluster, unsigned offset,
+                                   const std::vector<float>& x,
+                                   const std::vector<float>& y,
+                                   const std::vector<float>& z)
+{
+  float centerX = 0.5f * (m_minX[cluster] + m_maxX[cluster]);
+  float centerY = 0.5f * (m_minY[cluster] + m_maxY[cluster]);
+  float centerZ = 0.5f * (m_minZ[cluster] + m_maxZ[cluster]);
+  auto distanceSquared = [&] (unsigned light)
+  {
+    float dx = x[light] - centerX;
+    float dy = y[light] - centerY;
+    float dz = z[light] - centerZ;
+    return dx * dx + dy * dy + dz * dz;
+  };
+  // Ties go to the lower index, so the cut does not depend on the order the
+  //   lights were found in.
+  auto isNearer = [&] (unsigned a, unsigned b)
+  {
+    float da = distanceSquared (a);
+    float db = distanceSquared (b);
+    return da < db || (da == db && a < b);
+  };
+  auto first = m_indices.begin () + offset;
+  std::nth_element (first, first + MAX_LIGHTS_PER_CLUSTER, m_indices.end (),
+                    isNearer);
+  m_indices.resize (offset + MAX_LIGHTS_PER_CLUSTER);
+  std::sort (m_indices.begin () + offset, m_indices.end ());
+}
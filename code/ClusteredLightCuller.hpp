@@ -0,0 +1,174 @@
+/// \file ClusteredLightCuller.hpp
+/// \brief Declaration of ClusteredLightCuller class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef CLUSTERED_LIGHT_CULLER_HPP
+#define CLUSTERED_LIGHT_CULLER_HPP
+
+#include <vector>
+
+#include "Matrix4.hpp"
+#include "Vector3.hpp"
+
+/// \brief Assigns local (point and spot) lights to the cells of a 3-D grid
+///   that covers the view frustum, so each fragment only has to light itself
+///   with the lights near it.
+/// The grid is tilesX by tilesY in screen space and is cut into slices along
+///   the view direction whose thickness grows exponentially with distance,
+///   which keeps clusters close to cube-shaped.  Each light is bounded by a
+///   sphere, and a sphere is assigned to every cluster whose view-space
+///   bounding box it touches.
+/// Nothing here calls OpenGL, so culling can be run and timed headlessly.
+class ClusteredLightCuller
+{
+public:
+
+  /// \brief The most lights that will be recorded for a single cluster.
+  /// When more lights than this touch a cluster, it keeps those whose
+  ///   centers are nearest its own center, and the rest are left out and
+  ///   counted in the statistics.
+  static const unsigned MAX_LIGHTS_PER_CLUSTER = 128;
+
+  /// \brief What the last cull had to leave out.
+  struct Stats
+  {
+    /// How many clusters were touched by more than MAX_LIGHTS_PER_CLUSTER
+    ///   lights.
+    unsigned overflowedClusters;
+    /// How many lights were left out of those clusters, summed over them.
+    unsigned droppedLights;
+  };
+
+  /// \brief Constructs a culler with a given grid resolution.
+  /// \param[in] tilesX The number of columns of clusters across the screen.
+  /// \param[in] tilesY The number of rows of clusters up the screen.
+  /// \param[in] slices The number of clusters along the view direction.
+  /// \post The grid has the given size, but has no frustum until
+  ///   setProjection is called.
+  ClusteredLightCuller (unsigned tilesX = 16, unsigned tilesY = 9,
+                        unsigned slices = 24);
+
+  /// \brief Recomputes the view-space bounding box of every cluster.
+  /// This only needs to be called when the projection changes.
+  /// \param[in] inverseProjection The inverse of the camera's projection.
+  /// \post The near and far distances have been recovered from the projection
+  ///   and every cluster's bounds have been computed.
+  void
+  setProjection (const Matrix4& inverseProjection);
+
+  /// \brief Assigns lights to clusters.
+  /// The four arrays hold the lights in structure-of-arrays form and must all
+  ///   have the same size.
+  /// \param[in] x The view-space x-coordinates of the lights.
+  /// \param[in] y The view-space y-coordinates of the lights.
+  /// \param[in] z The view-space z-coordinates of the lights.
+  /// \param[in] radius The distance beyond which each light has no effect.
+  /// \pre setProjection has been called.
+  /// \post getClusterGrid and getLightIndices describe which lights touch
+  ///   which clusters, and getStats how many were left out.
+  void
+  cull (const std::vector<float>& x, const std::vector<float>& y,
+        const std::vector<float>& z, const std::vector<float>& radius);
+
+  /// \brief Gets where each cluster's lights are in getLightIndices.
+  /// \return Two numbers per cluster: the offset of its first light index,
+  ///   and how many light indices it has.  Clusters are ordered by x, then y,
+  ///   then slice, so cluster (i, j, k) is at
+  ///   (k * tilesY + j) * tilesX + i.
+  const std::vector<unsigned>&
+  getClusterGrid () const;
+
+  /// \brief Gets every cluster's light indices, one cluster after another.
+  /// \return Indices into the arrays passed to cull.
+  const std::vector<unsigned>&
+  getLightIndices () const;
+
+  /// \brief Gets what the last cull had to leave out.
+  /// \return The counts of full clusters and of the lights they dropped.
+  const Stats&
+  getStats () const;
+
+  /// \brief Gets the total number of clusters.
+  /// \return tilesX * tilesY * slices.
+  unsigned
+  getClusterCount () const;
+
+  /// \brief Gets the number of columns of clusters.
+  unsigned
+  getTilesX () const;
+
+  /// \brief Gets the number of rows of clusters.
+  unsigned
+  getTilesY () const;
+
+  /// \brief Gets the number of slices of clusters.
+  unsigned
+  getSlices () const;
+
+  /// \brief Gets the scale for finding a slice from a view-space depth.
+  /// The slice of a point at distance d in front of the camera is
+  ///   floor (log (d) * getDepthScale () + getDepthBias ()).
+  float
+  getDepthScale () const;
+
+  /// \brief Gets the bias for finding a slice from a view-space depth.
+  float
+  getDepthBias () const;
+
+  /// \brief Computes how far away a light stops mattering.
+  /// \param[in] attenuationCoefficients The constant, linear, and quadratic
+  ///   attenuation coefficients of the light.
+  /// \param[in] intensity The brightest channel of the light's intensity.
+  /// \param[in] threshold The contribution below which the light is ignored.
+  /// \return The distance at which intensity * attenuation equals threshold,
+  ///   or a very large number if the light never gets that dim.
+  static float
+  attenuationRadius (const Vector3& attenuationCoefficients, float intensity,
+                     float threshold = 1.0f / 256.0f);
+
+private:
+  /// \brief Finds the slice containing a view-space distance.
+  /// \param[in] depth A positive distance in front of the camera.
+  /// \return The slice index, clamped to the grid.
+  unsigned
+  sliceOf (float depth) const;
+
+  /// \brief Cuts an overflowing cluster down to the lights nearest its
+  ///   center.
+  /// \param[in] cluster The cluster, whose light indices are at the end of
+  ///   m_indices, starting at offset.
+  /// \param[in] offset Where the cluster's light indices start.
+  /// \param[in] x, y, z The view-space positions of the lights, as passed to
+  ///   cull.
+  /// \post The cluster's MAX_LIGHTS_PER_CLUSTER nearest lights are left, in
+  ///   increasing order, at the end of m_indices.
+  void
+  keepNearest (unsigned cluster, unsigned offset, const std::vector<float>& x,
+               const std::vector<float>& y, const std::vector<float>& z);
+
+  /// \brief The grid resolution.
+  unsigned m_tilesX, m_tilesY, m_slices;
+  /// \brief The near and far distances of the frustum.
+  float m_near, m_far;
+  /// \brief Constants that turn log (depth) into a slice index.
+  float m_depthScale, m_depthBias;
+
+  /// \brief The view-space bounding box of every cluster, one array per
+  ///   bound.
+  std::vector<float> m_minX, m_minY, m_minZ, m_maxX, m_maxY, m_maxZ;
+
+  /// \brief The lights that overlap each slice, in structure-of-arrays form,
+  ///   padded to a multiple of 4 so they can be tested 4 at a time.
+  std::vector<std::vector<float>> m_sliceX, m_sliceY, m_sliceZ, m_sliceRadius;
+  /// \brief The index of each light in m_sliceX and friends.
+  std::vector<std::vector<unsigned>> m_sliceIndex;
+
+  /// \brief The output of cull.
+  std::vector<unsigned> m_grid;
+  std::vector<unsigned> m_indices;
+  Stats m_stats;
+};
+
+#endif//CLUSTERED_LIGHT_CULLER_HPP
@@ -29,24 +29,27 @@ ColorsMesh::enableAttributes()
 }
 
 void
-ColorsMesh::draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPosition)
+ColorsMesh::drawThrough (OpenGLContext* context)
 {
   // Iterate over each object in scene and draw it
   // The shader program is already enabled, but we do not want to
   //   make that assumption in general.
-  m_shaderProgram->enable ();
-
-  Transform modelView = viewMatrix * m_world;
-  m_shaderProgram->setUniformMatrix ("uModelView", modelView.getTransform());
-  m_shaderProgram->setUniformMatrix ("uProjection", projectionMatrix);
-  m_shaderProgram->setUniformInt("uHasTexture", 0);
+  m_shaderProgram->enable (context);
 
+  // The camera is in the Scene's FrameBlock.
+  bindUniformBlocks (context, false);
 
   // Draw geometry
-  m_context->bindVertexArray (m_vao);
-  glDrawElements (GL_TRIANGLES, m_indices.size (), GL_UNSIGNED_INT,
+  context->bindVertexArray (m_vao);
+  context->drawElements (GL_TRIANGLES, m_indices.size (), m_indexType,
     reinterpret_cast<void*> (0));
-  m_context->bindVertexArray (0);
+  context->bindVertexArray (0);
+
+  m_shaderProgram->disable (context);
+}
 
-  m_shaderProgram->disable ();
-}
\ No newline at end of file
+Mesh*
+ColorsMesh::createEmpty () const
+{
+  return new ColorsMesh(m_context, m_shaderProgram);
+}
@@ -38,9 +38,16 @@ public:
   void
   enableAttributes();
 
+  /// \brief Draws this Mesh with per-vertex colors.
+  /// \param context The context to make the calls through.
   void
-  draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPosition);
+  drawThrough (OpenGLContext* context);
 
+  /// \brief Constructs an empty Mesh of the same kind as this one, drawn with
+  ///   the same ShaderProgram, Material, and texture.
+  /// \return The new Mesh, which the caller owns.
+  Mesh*
+  createEmpty () const;
 };
 
 #endif//COLORSMESH_HPP
\ No newline at end of file
@@ -0,0 +1,665 @@
+/// \file CommandList.cpp
+/// \brief Definitions of CommandList member and associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "CommandList.hpp"
+
+struct CommandList::Command
+{
+  /// Makes the call through a context.
+  void (*replay) (const Command* command, OpenGLContext* context);
+  /// The call recorded after this one, or nullptr.
+  Command* next;
+};
+
+template <typename Call>
+struct CommandList::RecordedCall : Command
+{
+  explicit RecordedCall (const Call& recorded)
+    : call (recorded)
+  {
+    replay = &replayCall;
+    next = nullptr;
+  }
+
+  static void
+  replayCall (const Command* command, OpenGLContext* context)
+  {
+    static_cast<const RecordedCall*> (command)->call (context);
+  }
+
+  Call call;
+};
+
+namespace
+{
+  /// \brief Rounds a size up to the alignment every allocation keeps.
+  size_t
+  align (size_t size)
+  {
+    const size_t ALIGNMENT = alignof (std::max_align_t);
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+
+  /// \brief Gets the number of bytes texImage2D reads for an image, with
+  ///   rows padded to the default unpack alignment of 4.
+  /// \throw std::logic_error If the format or type is not one this engine
+  ///   uploads.
+  size_t
+  getImageSize (GLsizei width, GLsizei height, GLenum format, GLenum type)
+  {
+    size_t components;
+    switch (format)
+    {
+      case GL_RED: case GL_DEPTH_COMPONENT: components = 1; break;
+      case GL_RG: components = 2; break;
+      case GL_RGB: case GL_BGR: components = 3; break;
+      case GL_RGBA: case GL_BGRA: components = 4; break;
+      default:
+        throw std::logic_error ("CommandList cannot size texImage2D format "
+                                + std::to_string (format));
+    }
+    size_t componentSize;
+    switch (type)
+    {
+      case GL_UNSIGNED_BYTE: componentSize = 1; break;
+      case GL_FLOAT: componentSize = 4; break;
+      default:
+        throw std::logic_error ("CommandList cannot size texImage2D type "
+                                + std::to_string (type));
+    }
+    size_t rowSize = (width * components * componentSize + 3) / 4 * 4;
+    return rowSize * height;
+  }
+}
+
+CommandList::CommandList ()
+  : m_block (0), m_blockUsed (0), m_first (nullptr), m_last (nullptr),
+    m_commandCount (0), m_byteCount (0)
+{
+}
+
+CommandList::~CommandList ()
+{
+}
+
+void
+CommandList::replay (OpenGLContext* context) const
+{
+  for (const Command* command = m_first; command != nullptr;
+       command = command->next)
+  {
+    command->replay (command, context);
+  }
+}
+
+void
+CommandList::reset ()
+{
+  m_block = 0;
+  m_blockUsed = 0;
+  m_first = nullptr;
+  m_last = nullptr;
+  m_commandCount = 0;
+  m_byteCount = 0;
+}
+
+size_t
+CommandList::getCommandCount () const
+{
+  return m_commandCount;
+}
+
+size_t
+CommandList::getByteCount () const
+{
+  return m_byteCount;
+}
+
+template <typename Call>
+void
+CommandList::record (const Call& call)
+{
+  // Blocks are reused without running destructors.
+  static_assert (std::is_trivially_destructible<Call>::value,
+                 "A recorded call must only hold plain values");
+  static_assert (alignof (RecordedCall<Call>) <= alignof (std::max_align_t),
+                 "A recorded call must fit the blocks' alignment");
+  Command* command =
+    new (allocate (sizeof (RecordedCall<Call>))) RecordedCall<Call> (call);
+  if (m_last == nullptr)
+  {
+    m_first = command;
+  }
+  else
+  {
+    m_last->next = command;
+  }
+  m_last = command;
+  ++m_commandCount;
+}
+
+void*
+CommandList::allocate (size_t size)
+{
+  size = align (size);
+  // Blocks too small for this allocation are skipped until the next reset.
+  while (m_block < m_blocks.size ()
+         && m_blockUsed + size > m_blocks[m_block].size)
+  {
+    ++m_block;
+    m_blockUsed = 0;
+  }
+  if (m_block == m_blocks.size ())
+  {
+    size_t blockSize = std::max (BLOCK_SIZE, size);
+    m_blocks.push_back (Block { std::unique_ptr<unsigned char[]> (
+                                  new unsigned char[blockSize]), blockSize });
+    m_blockUsed = 0;
+  }
+  void* memory = m_blocks[m_block].memory.get () + m_blockUsed;
+  m_blockUsed += size;
+  m_byteCount += size;
+  return memory;
+}
+
+const void*
+CommandList::copy (const void* data, size_t size)
+{
+  if (data == nullptr)
+  {
+    return nullptr;
+  }
+  void* copied = allocate (size);
+  std::memcpy (copied, data, size);
+  return copied;
+}
+
+void
+CommandList::refuse (const char* name) const
+{
+  throw std::logic_error (std::string ("CommandList cannot record ") + name
+                          + ", which must be called on the context's thread");
+}
+
+
+void
+CommandList::activeTexture (GLenum texture)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->activeTexture (texture);
+  });
+}
+
+void
+CommandList::attachShader (GLuint program, GLuint shader)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->attachShader (program, shader);
+  });
+}
+
+void
+CommandList::bindBuffer (GLenum target, GLuint buffer)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->bindBuffer (target, buffer);
+  });
+}
+
+void
+CommandList::bindBufferBase (GLenum target, GLuint index, GLuint buffer)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->bindBufferBase (target, index, buffer);
+  });
+}
+
+void
+CommandList::bindTexture (GLenum target, GLuint texture)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->bindTexture (target, texture);
+  });
+}
+
+void
+CommandList::bindVertexArray (GLuint array)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->bindVertexArray (array);
+  });
+}
+
+void
+CommandList::bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+  const void* copied = copy (data, size);
+  record ([=] (OpenGLContext* context)
+  {
+    context->bufferData (target, size, copied, usage);
+  });
+}
+
+void
+CommandList::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  const void* copied = copy (data, size);
+  record ([=] (OpenGLContext* context)
+  {
+    context->bufferSubData (target, offset, size, copied);
+  });
+}
+
+void
+CommandList::clear (GLbitfield mask)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->clear (mask);
+  });
+}
+
+void
+CommandList::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->clearColor (red, green, blue, alpha);
+  });
+}
+
+void
+CommandList::compileShader (GLuint shader)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->compileShader (shader);
+  });
+}
+
+GLuint
+CommandList::createProgram ()
+{
+  refuse ("createProgram");
+}
+
+GLuint
+CommandList::createShader (GLenum shaderType)
+{
+  refuse ("createShader");
+}
+
+void
+CommandList::cullFace (GLenum mode)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->cullFace (mode);
+  });
+}
+
+void
+CommandList::deleteBuffers (GLsizei n, const GLuint* buffers)
+{
+  const GLuint* copied =
+    static_cast<const GLuint*> (copy (buffers, n * sizeof (GLuint)));
+  record ([=] (OpenGLContext* context)
+  {
+    context->deleteBuffers (n, copied);
+  });
+}
+
+void
+CommandList::deleteProgram (GLuint program)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->deleteProgram (program);
+  });
+}
+
+void
+CommandList::deleteShader (GLuint shader)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->deleteShader (shader);
+  });
+}
+
+void
+CommandList::deleteTextures (GLsizei n, const GLuint* textures)
+{
+  const GLuint* copied =
+    static_cast<const GLuint*> (copy (textures, n * sizeof (GLuint)));
+  record ([=] (OpenGLContext* context)
+  {
+    context->deleteTextures (n, copied);
+  });
+}
+
+void
+CommandList::deleteVertexArrays (GLsizei n, const GLuint* arrays)
+{
+  const GLuint* copied =
+    static_cast<const GLuint*> (copy (arrays, n * sizeof (GLuint)));
+  record ([=] (OpenGLContext* context)
+  {
+    context->deleteVertexArrays (n, copied);
+  });
+}
+
+void
+CommandList::detachShader (GLuint program, GLuint shader)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->detachShader (program, shader);
+  });
+}
+
+void
+CommandList::drawArrays (GLenum mode, GLint first, GLsizei count)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->drawArrays (mode, first, count);
+  });
+}
+
+void
+CommandList::drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+  // indices is an offset into the bound element buffer, not client memory.
+  record ([=] (OpenGLContext* context)
+  {
+    context->drawElements (mode, count, type, indices);
+  });
+}
+
+void
+CommandList::enable (GLenum cap)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->enable (cap);
+  });
+}
+
+void
+CommandList::enableVertexAttribArray (GLuint index)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->enableVertexAttribArray (index);
+  });
+}
+
+void
+CommandList::frontFace (GLenum mode)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->frontFace (mode);
+  });
+}
+
+void
+CommandList::genBuffers (GLsizei n, GLuint* buffers)
+{
+  refuse ("genBuffers");
+}
+
+void
+CommandList::generateMipmap (GLenum target)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->generateMipmap (target);
+  });
+}
+
+void
+CommandList::genTextures (GLsizei n, GLuint* textures)
+{
+  refuse ("genTextures");
+}
+
+void
+CommandList::genVertexArrays (GLsizei n, GLuint* arrays)
+{
+  refuse ("genVertexArrays");
+}
+
+GLint
+CommandList::getAttribLocation (GLuint program, const GLchar* name)
+{
+  refuse ("getAttribLocation");
+}
+
+void
+CommandList::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  refuse ("getProgramInfoLog");
+}
+
+void
+CommandList::getProgramiv (GLuint program, GLenum pname, GLint* params)
+{
+  refuse ("getProgramiv");
+}
+
+void
+CommandList::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  refuse ("getShaderInfoLog");
+}
+
+void
+CommandList::getShaderiv (GLuint shader, GLenum pname, GLint* params)
+{
+  refuse ("getShaderiv");
+}
+
+const GLubyte*
+CommandList::getString (GLenum name)
+{
+  refuse ("getString");
+}
+
+GLuint
+CommandList::getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName)
+{
+  refuse ("getUniformBlockIndex");
+}
+
+GLint
+CommandList::getUniformLocation (GLuint program, const GLchar* name)
+{
+  refuse ("getUniformLocation");
+}
+
+void
+CommandList::linkProgram (GLuint program)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->linkProgram (program);
+  });
+}
+
+void
+CommandList::multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+{
+  // indirect is an offset into the bound GL_DRAW_INDIRECT_BUFFER.
+  record ([=] (OpenGLContext* context)
+  {
+    context->multiDrawElementsIndirect (mode, type, indirect, drawcount,
+                                        stride);
+  });
+}
+
+void
+CommandList::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+{
+  // Each string is copied with a terminator, so no lengths are replayed.
+  const GLchar** strings =
+    static_cast<const GLchar**> (allocate (count * sizeof (const GLchar*)));
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    size_t size = length != nullptr && length[i] >= 0
+      ? static_cast<size_t> (length[i]) : std::strlen (string[i]);
+    GLchar* copied = static_cast<GLchar*> (allocate (size + 1));
+    std::memcpy (copied, string[i], size);
+    copied[size] = '\0';
+    strings[i] = copied;
+  }
+  record ([=] (OpenGLContext* context)
+  {
+    context->shaderSource (shader, count, strings, nullptr);
+  });
+}
+
+void
+CommandList::texBuffer (GLenum target, GLenum internalFormat, GLuint buffer)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->texBuffer (target, internalFormat, buffer);
+  });
+}
+
+void
+CommandList::texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data)
+{
+  const void* copied = data == nullptr
+    ? nullptr : copy (data, getImageSize (width, height, format, type));
+  record ([=] (OpenGLContext* context)
+  {
+    context->texImage2D (target, level, internalFormat, width, height, border,
+                         format, type, copied);
+  });
+}
+
+void
+CommandList::texParameteri (GLenum target, GLenum pname, GLint param)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->texParameteri (target, pname, param);
+  });
+}
+
+void
+CommandList::uniform1f (GLint location, GLfloat v0)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->uniform1f (location, v0);
+  });
+}
+
+void
+CommandList::uniform1i (GLint location, GLint v0)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->uniform1i (location, v0);
+  });
+}
+
+void
+CommandList::uniform3fv (GLint location, GLsizei count, const GLfloat* value)
+{
+  const GLfloat* copied =
+    static_cast<const GLfloat*> (copy (value, count * 3 * sizeof (GLfloat)));
+  record ([=] (OpenGLContext* context)
+  {
+    context->uniform3fv (location, count, copied);
+  });
+}
+
+void
+CommandList::uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->uniformBlockBinding (program, uniformBlockIndex,
+                                  uniformBlockBinding);
+  });
+}
+
+void
+CommandList::uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  const GLfloat* copied =
+    static_cast<const GLfloat*> (copy (value, count * 9 * sizeof (GLfloat)));
+  record ([=] (OpenGLContext* context)
+  {
+    context->uniformMatrix3fv (location, count, transpose, copied);
+  });
+}
+
+void
+CommandList::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  const GLfloat* copied =
+    static_cast<const GLfloat*> (copy (value, count * 16 * sizeof (GLfloat)));
+  record ([=] (OpenGLContext* context)
+  {
+    context->uniformMatrix4fv (location, count, transpose, copied);
+  });
+}
+
+void
+CommandList::useProgram (GLuint program)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->useProgram (program);
+  });
+}
+
+void
+CommandList::vertexAttribDivisor (GLuint index, GLuint divisor)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->vertexAttribDivisor (index, divisor);
+  });
+}
+
+void
+CommandList::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+  // pointer is an offset into the bound array buffer, not client memory.
+  record ([=] (OpenGLContext* context)
+  {
+    context->vertexAttribPointer (index, size, type, normalized, stride,
+                                  pointer);
+  });
+}
+
+void
+CommandList::viewport (GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  record ([=] (OpenGLContext* context)
+  {
+    context->viewport (x, y, width, height);
+  });
+}
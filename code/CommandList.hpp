@@ -0,0 +1,290 @@
+/// \file CommandList.hpp
+/// \brief Declaration of CommandList class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef COMMAND_LIST_HPP
+#define COMMAND_LIST_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "OpenGLContext.hpp"
+
+/// \brief A subclass of OpenGLContext that records calls instead of making
+///   them, so that draws can be prepared on any thread and made later, in
+///   order, on the thread that owns the real context.
+///
+/// Calls are appended to blocks of memory that are kept when the list is
+///   reset, so a list refilled every frame stops allocating once it has
+///   grown to the size of a frame.  Whatever a call points to is copied into
+///   the list as the call is recorded, except the offsets drawElements,
+///   vertexAttribPointer, and multiDrawElementsIndirect take into bound
+///   buffers.  Calls that return a value or write through a pointer, such as
+///   those that create objects, cannot wait to be replayed and throw
+///   std::logic_error, so objects must be created on the context's thread
+///   before anything that uses them is recorded.
+///
+/// A list is not synchronized: each thread records into a list of its own.
+class CommandList : public OpenGLContext
+{
+public:
+
+  /// Constructs an empty CommandList.
+  CommandList ();
+
+  /// Destructs a CommandList.
+  virtual
+  ~CommandList ();
+
+  /// Copy constructor deleted because you should not be copying
+  ///   CommandLists.
+  CommandList (const CommandList&) = delete;
+
+  /// Assignment operator deleted because you should not be assigning
+  ///   CommandLists.
+  CommandList&
+  operator= (const CommandList&) = delete;
+
+  /// \brief Makes every recorded call, in the order recorded.
+  /// \param context The context to make the calls through.
+  /// \post The calls are still recorded, so the list may be replayed again.
+  void
+  replay (OpenGLContext* context) const;
+
+  /// \brief Forgets every recorded call, keeping the memory they used.
+  /// \post The list is empty.
+  void
+  reset ();
+
+  /// \brief Gets the number of calls recorded since the list was reset.
+  /// \return The number of calls.
+  size_t
+  getCommandCount () const;
+
+  /// \brief Gets the memory used by the calls recorded since the list was
+  ///   reset, including the data they point to.
+  /// \return The size, in bytes.
+  size_t
+  getByteCount () const;
+
+
+  virtual void
+  activeTexture (GLenum texture);
+
+  virtual void
+  attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  bindBuffer (GLenum target, GLuint buffer);
+
+  virtual void
+  bindBufferBase (GLenum target, GLuint index, GLuint buffer);
+
+  virtual void
+  bindTexture (GLenum target, GLuint texture);
+
+  virtual void
+  bindVertexArray (GLuint array);
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+  virtual void
+  clear (GLbitfield mask);
+
+  virtual void
+  clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+  virtual void
+  compileShader (GLuint shader);
+
+  virtual GLuint
+  createProgram ();
+
+  virtual GLuint
+  createShader (GLenum shaderType);
+
+  virtual void
+  cullFace (GLenum mode);
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers);
+
+  virtual void
+  deleteProgram (GLuint program);
+
+  virtual void
+  deleteShader (GLuint shader);
+
+  virtual void
+  deleteTextures (GLsizei n, const GLuint* textures);
+
+  virtual void
+  deleteVertexArrays (GLsizei n, const GLuint* arrays);
+
+  virtual void
+  detachShader (GLuint program, GLuint shader);
+
+  virtual void
+  drawArrays (GLenum mode, GLint first, GLsizei count);
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+  virtual void
+  enable (GLenum cap);
+
+  virtual void
+  enableVertexAttribArray (GLuint index);
+
+  virtual void
+  frontFace (GLenum mode);
+
+  virtual void
+  genBuffers (GLsizei n, GLuint* buffers);
+
+  virtual void
+  generateMipmap (GLenum target);
+
+  virtual void
+  genTextures (GLsizei n, GLuint* textures);
+
+  virtual void
+  genVertexArrays (GLsizei n, GLuint* arrays);
+
+  virtual GLint
+  getAttribLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getProgramiv (GLuint program, GLenum pname, GLint* params);
+
+  virtual void
+  getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getShaderiv (GLuint shader, GLenum pname, GLint* params);
+
+  virtual const GLubyte*
+  getString (GLenum name);
+
+  virtual GLuint
+  getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName);
+
+  virtual GLint
+  getUniformLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  linkProgram (GLuint program);
+
+  virtual void
+  multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+
+  virtual void
+  texBuffer (GLenum target, GLenum internalFormat, GLuint buffer);
+
+  virtual void
+  texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data);
+
+  virtual void
+  texParameteri (GLenum target, GLenum pname, GLint param);
+
+  virtual void
+  uniform1f (GLint location, GLfloat v0);
+
+  virtual void
+  uniform1i (GLint location, GLint v0);
+
+  virtual void
+  uniform3fv (GLint location, GLsizei count, const GLfloat* value);
+
+  virtual void
+  uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
+  virtual void
+  uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  useProgram (GLuint program);
+
+  virtual void
+  vertexAttribDivisor (GLuint index, GLuint divisor);
+
+  virtual void
+  vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+  virtual void
+  viewport (GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+
+  /// \brief A recorded call, followed in memory by its arguments.
+  struct Command;
+
+  /// \brief A Command holding the function that makes its call.
+  template <typename Call>
+  struct RecordedCall;
+
+  /// \brief Memory that calls are recorded into.
+  struct Block
+  {
+    std::unique_ptr<unsigned char[]> memory;
+    size_t size;
+  };
+
+  /// \brief Appends a call.
+  /// \param[in] call A function that makes the call through the context it
+  ///   is given, holding copies of the arguments.
+  template <typename Call>
+  void
+  record (const Call& call);
+
+  /// \brief Takes memory from the end of the list.
+  /// \param[in] size The number of bytes needed.
+  /// \return Memory suitably aligned for any type, valid until the list is
+  ///   destructed.
+  void*
+  allocate (size_t size);
+
+  /// \brief Copies data a call points to into the list.
+  /// \param[in] data The data, or nullptr.
+  /// \param[in] size The number of bytes to copy.
+  /// \return The copy, or nullptr if data was nullptr.
+  const void*
+  copy (const void* data, size_t size);
+
+  /// \brief Reports a call that cannot be recorded.
+  /// \param[in] name The name of the call.
+  /// \throw std::logic_error Always.
+  [[noreturn]] void
+  refuse (const char* name) const;
+
+  /// The size of each block, unless a call needs more.
+  static const size_t BLOCK_SIZE = 64 * 1024;
+
+  std::vector<Block> m_blocks;
+  /// The block being recorded into, and how much of it is used.
+  size_t m_block;
+  size_t m_blockUsed;
+  /// The calls, as a list linked through the blocks.
+  Command* m_first;
+  Command* m_last;
+  size_t m_commandCount;
+  size_t m_byteCount;
+};
+
+#endif//COMMAND_LIST_HPP
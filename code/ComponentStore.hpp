@@ -0,0 +1,165 @@
+/// \file ComponentStore.hpp
+/// \brief Declaration and definition of ComponentStore class template.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef COMPONENT_STORE_HPP
+#define COMPONENT_STORE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "EntityRegistry.hpp"
+
+/// \brief Holds one type of component for any number of entities, packed
+///   into a dense array with no gaps, so that a system can walk every
+///   component of the type in order.
+/// This is a sparse set: a sparse array, indexed by entity index, holds each
+///   component's place in the dense array, and the dense array of entities
+///   says whose each component is.  Removing a component moves the last one
+///   into its place, so the dense arrays stay packed but are not in any
+///   particular order.
+/// \tparam T The type of component, which is copied in and out.
+template <typename T>
+class ComponentStore
+{
+public:
+
+  /// \brief Constructs a store with no components.
+  ComponentStore ()
+  {
+  }
+
+  /// \brief Gives an entity a component, or replaces the one it has.
+  /// \param[in] entity The entity.
+  /// \param[in] component Its component.
+  /// \return The stored component, until the next add or remove.
+  T&
+  add (Entity entity, const T& component)
+  {
+    if (has (entity))
+    {
+      return m_components[m_slots[entity.index]] = component;
+    }
+    if (entity.index >= m_slots.size ())
+    {
+      m_slots.resize (entity.index + 1, NONE);
+    }
+    // Whatever is still here belonged to an older generation of the index.
+    if (m_slots[entity.index] != NONE)
+    {
+      removeSlot (m_slots[entity.index]);
+    }
+    m_slots[entity.index] = static_cast<unsigned> (m_entities.size ());
+    m_entities.push_back (entity);
+    m_components.push_back (component);
+    return m_components.back ();
+  }
+
+  /// \brief Takes an entity's component away, if it has one.
+  /// \param[in] entity The entity.
+  /// \post The last component has been moved into the removed one's place.
+  void
+  remove (Entity entity)
+  {
+    if (has (entity))
+    {
+      removeSlot (m_slots[entity.index]);
+    }
+  }
+
+  /// \brief Tests whether an entity has a component here.
+  /// \param[in] entity The entity, which may be stale.
+  /// \return Whether it has one; a stale handle never does.
+  bool
+  has (Entity entity) const
+  {
+    return entity.index < m_slots.size () && m_slots[entity.index] != NONE
+      && m_entities[m_slots[entity.index]] == entity;
+  }
+
+  /// \brief Gets an entity's component.
+  /// \param[in] entity The entity.
+  /// \pre The entity has a component here.
+  /// \return Its component, until the next add or remove.
+  T&
+  get (Entity entity)
+  {
+    assert (has (entity));
+    return m_components[m_slots[entity.index]];
+  }
+
+  /// \brief Gets an entity's component.
+  /// \param[in] entity The entity.
+  /// \pre The entity has a component here.
+  /// \return Its component, until the next add or remove.
+  const T&
+  get (Entity entity) const
+  {
+    assert (has (entity));
+    return m_components[m_slots[entity.index]];
+  }
+
+  /// \brief Gets the number of components.
+  /// \return The number of entities that have one.
+  size_t
+  size () const
+  {
+    return m_components.size ();
+  }
+
+  /// \brief Gets every component, packed, for systems to walk.
+  /// \return The components, in the same order as getEntities.
+  std::vector<T>&
+  getComponents ()
+  {
+    return m_components;
+  }
+
+  /// \brief Gets every component, packed, for systems to walk.
+  /// \return The components, in the same order as getEntities.
+  const std::vector<T>&
+  getComponents () const
+  {
+    return m_components;
+  }
+
+  /// \brief Gets whose each component is.
+  /// \return The entities, in the same order as getComponents.
+  const std::vector<Entity>&
+  getEntities () const
+  {
+    return m_entities;
+  }
+
+private:
+  /// \brief Removes the component in a slot by moving the last one there.
+  void
+  removeSlot (unsigned slot)
+  {
+    m_slots[m_entities[slot].index] = NONE;
+    if (slot + 1 != m_components.size ())
+    {
+      m_components[slot] = m_components.back ();
+      m_entities[slot] = m_entities.back ();
+      m_slots[m_entities[slot].index] = slot;
+    }
+    m_components.pop_back ();
+    m_entities.pop_back ();
+  }
+
+  /// Marks an entity index with no component here.
+  static const unsigned NONE = ~0u;
+
+  /// By entity index: where its component is in the dense arrays.
+  std::vector<unsigned> m_slots;
+  /// Dense: whose each component is, and the components themselves.
+  std::vector<Entity> m_entities;
+  std::vector<T> m_components;
+};
+
+template <typename T>
+const unsigned ComponentStore<T>::NONE;
+
+#endif//COMPONENT_STORE_HPP
@@ -0,0 +1,61 @@
+/// \file EntityRegistry.cpp
+/// \brief Definition of EntityRegistry class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <cassert>
+
+#include "EntityRegistry.hpp"
+
+bool
+operator== (const Entity& e1, const Entity& e2)
+{
+  return e1.index == e2.index && e1.generation == e2.generation;
+}
+
+bool
+operator!= (const Entity& e1, const Entity& e2)
+{
+  return !(e1 == e2);
+}
+
+EntityRegistry::EntityRegistry ()
+{
+
+}
+
+Entity
+EntityRegistry::create ()
+{
+  if (m_freeIndexes.empty ())
+  {
+    m_generations.push_back (0);
+    return { static_cast<unsigned> (m_generations.size () - 1), 0 };
+  }
+  unsigned index = m_freeIndexes.back ();
+  m_freeIndexes.pop_back ();
+  return { index, m_generations[index] };
+}
+
+void
+EntityRegistry::destroy (Entity entity)
+{
+  assert (isAlive (entity));
+  // Moving on to the next generation is what makes old handles stale.
+  ++m_generations[entity.index];
+  m_freeIndexes.push_back (entity.index);
+}
+
+bool
+EntityRegistry::isAlive (Entity entity) const
+{
+  return entity.index < m_generations.size ()
+    && m_generations[entity.index] == entity.generation;
+}
+
+size_t
+EntityRegistry::getCount () const
+{
+  return m_generations.size () - m_freeIndexes.size ();
+}
@@ -0,0 +1,82 @@
+/// \file EntityRegistry.hpp
+/// \brief Declaration of Entity, EntityRegistry class, and any associated
+///   global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef ENTITY_REGISTRY_HPP
+#define ENTITY_REGISTRY_HPP
+
+#include <cstddef>
+#include <vector>
+
+/// \brief Names a thing in the world, which is whatever components are
+///   stored for it.
+/// Indexes are reused once an entity is destroyed, so each one comes with the
+///   generation it was created in.  A handle kept past its entity's
+///   destruction has an old generation, and is recognized as stale instead of
+///   naming whatever took its place.
+struct Entity
+{
+  /// Where the entity's components are looked up.
+  unsigned index;
+  /// How many entities had this index before it.
+  unsigned generation;
+};
+
+/// \brief Tests whether two handles name the same entity.
+/// \param[in] e1 A handle.
+/// \param[in] e2 Another handle.
+/// \return Whether both the indexes and the generations match.
+bool
+operator== (const Entity& e1, const Entity& e2);
+
+/// \brief Tests whether two handles name different entities.
+/// \param[in] e1 A handle.
+/// \param[in] e2 Another handle.
+/// \return Whether the indexes or the generations differ.
+bool
+operator!= (const Entity& e1, const Entity& e2);
+
+/// \brief Hands out entities and keeps track of which are alive.
+/// It knows nothing of components: those are kept in ComponentStores, one
+///   per type, which anyone holding the handles can iterate on their own.
+class EntityRegistry
+{
+public:
+
+  /// \brief Constructs a registry with no entities.
+  EntityRegistry ();
+
+  /// \brief Creates an entity.
+  /// \return A handle to it, reusing the index of a destroyed entity if there
+  ///   is one.
+  Entity
+  create ();
+
+  /// \brief Destroys an entity, so that handles to it are stale.
+  /// Its components are not touched; remove them from their stores first.
+  /// \param[in] entity A handle to it.
+  /// \pre The entity is alive.
+  void
+  destroy (Entity entity);
+
+  /// \brief Tests whether a handle names a living entity.
+  /// \param[in] entity The handle.
+  /// \return Whether the entity has been created and not destroyed since.
+  bool
+  isAlive (Entity entity) const;
+
+  /// \brief Gets the number of living entities.
+  /// \return The number of entities created and not destroyed.
+  size_t
+  getCount () const;
+
+private:
+  /// The current generation of every index ever handed out.
+  std::vector<unsigned> m_generations;
+  /// Indexes of destroyed entities, to be handed out again.
+  std::vector<unsigned> m_freeIndexes;
+};
+
+#endif//ENTITY_REGISTRY_HPP
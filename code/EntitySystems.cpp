@@ -0,0 +1,97 @@
+/// \file EntitySystems.cpp
+/// \brief Definition of the systems that update scene objects and any
+///   associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include "EntitySystems.hpp"
+
+// Bodies per job; each one is a handful of flops, so jobs must be large to be
+//   worth handing out.
+static const size_t BODIES_PER_JOB = 4096;
+
+void
+bounceOffWalls (const Vector3& position, float radius, const Walls& walls,
+                Vector3& velocity)
+{
+  if (position.m_x - radius < walls.low.m_x
+      || position.m_x + radius > walls.high.m_x)
+  {
+    velocity.m_x = -velocity.m_x;
+  }
+  if (position.m_y - radius < walls.low.m_y
+      || position.m_y + radius > walls.high.m_y)
+  {
+    velocity.m_y = -velocity.m_y;
+  }
+  if (position.m_z - radius < walls.low.m_z
+      || position.m_z + radius > walls.high.m_z)
+  {
+    velocity.m_z = -velocity.m_z;
+  }
+}
+
+void
+moveBodies (ComponentStore<Body>& bodies,
+            ComponentStore<Transform>& transforms, const Walls& walls,
+            float deltaTime, JobSystem* jobs)
+{
+  std::vector<Body>& components = bodies.getComponents ();
+  const std::vector<Entity>& entities = bodies.getEntities ();
+  // Each body has its own transform, so jobs never write to the same one.
+  auto move = [&] (size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      Body& body = components[i];
+      Transform& transform = transforms.get (entities[i]);
+      transform.moveWorld (deltaTime, body.velocity);
+      bounceOffWalls (transform.getPosition (), body.radius, walls,
+                      body.velocity);
+    }
+  };
+  if (jobs == nullptr)
+  {
+    move (0, components.size ());
+  }
+  else
+  {
+    jobs->parallelFor (0, components.size (), BODIES_PER_JOB, move);
+  }
+}
+
+void
+steerPaddles (const ComponentStore<PaddleAi>& paddles,
+              ComponentStore<Transform>& transforms, const Vector3& ball,
+              const Walls& walls, float deltaTime)
+{
+  const std::vector<PaddleAi>& components = paddles.getComponents ();
+  const std::vector<Entity>& entities = paddles.getEntities ();
+  for (size_t i = 0; i < components.size (); ++i)
+  {
+    const PaddleAi& paddle = components[i];
+    Transform& transform = transforms.get (entities[i]);
+    Vector3 position = transform.getPosition ();
+    Vector3 half = paddle.size * 0.5f;
+    // A paddle only moves while its edge is short of the wall, but then at
+    //   the whole chase speed, even if that takes it a little past.
+    float velocityY = trackBall3D (ball.m_y, position.m_y, paddle.parameters);
+    if (velocityY > 0.0f && position.m_y + half.m_y < walls.high.m_y)
+    {
+      transform.moveWorld (deltaTime, Vector3 (0.0f, velocityY, 0.0f));
+    }
+    else if (velocityY < 0.0f && position.m_y - half.m_y > walls.low.m_y)
+    {
+      transform.moveWorld (deltaTime, Vector3 (0.0f, velocityY, 0.0f));
+    }
+    float velocityX = trackBall3D (ball.m_x, position.m_x, paddle.parameters);
+    if (velocityX > 0.0f && position.m_x + half.m_x < walls.high.m_x)
+    {
+      transform.moveWorld (deltaTime, Vector3 (velocityX, 0.0f, 0.0f));
+    }
+    else if (velocityX < 0.0f && position.m_x - half.m_x > walls.low.m_x)
+    {
+      transform.moveWorld (deltaTime, Vector3 (velocityX, 0.0f, 0.0f));
+    }
+  }
+}
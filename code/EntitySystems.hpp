@@ -0,0 +1,81 @@
+/// \file EntitySystems.hpp
+/// \brief Declaration of the components scene objects are made of and the
+///   systems that update them, and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef ENTITY_SYSTEMS_HPP
+#define ENTITY_SYSTEMS_HPP
+
+#include "ComponentStore.hpp"
+#include "JobSystem.hpp"
+#include "Transform.hpp"
+#include "Vector3.hpp"
+#include "Scenes/Pong/PongAi.hpp"
+
+/// \brief A sphere that moves at a constant velocity and bounces off the
+///   walls, like a PhysicsObject.
+struct Body
+{
+  /// Its velocity, in units per second.
+  Vector3 velocity;
+  /// How far from its position it reaches the walls.
+  float radius;
+};
+
+/// \brief A paddle moved by the 3D Pong AI.
+struct PaddleAi
+{
+  /// How closely and how fast it follows the ball.
+  PongAiParameters parameters;
+  /// Its width, height, and depth, which must stay within the walls.
+  Vector3 size;
+};
+
+/// \brief The walls of a box-shaped room, which bodies bounce off and
+///   paddles stay within.
+struct Walls
+{
+  /// The left, bottom, and far walls: the lowest coordinate along each axis.
+  Vector3 low;
+  /// The right, top, and near walls: the highest coordinate along each axis.
+  Vector3 high;
+};
+
+/// \brief Turns a sphere around along every axis on which it has gone past a
+///   wall.
+/// \param[in] position Where its center is.
+/// \param[in] radius Its radius.
+/// \param[in] walls The walls.
+/// \param[in,out] velocity Its velocity, whose components are negated along
+///   those axes.
+void
+bounceOffWalls (const Vector3& position, float radius, const Walls& walls,
+                Vector3& velocity);
+
+/// \brief Moves every body for one step, then bounces it off the walls.
+/// Bodies are walked in the order they are stored, and each one's transform
+///   is looked up by entity.
+/// \param[in,out] bodies The bodies, whose velocities may be turned around.
+/// \param[in,out] transforms The transforms, which every body must have.
+/// \param[in] walls The walls.
+/// \param[in] deltaTime The length of the step, in seconds.
+/// \param[in] jobs If not null, splits the bodies across its threads.
+void
+moveBodies (ComponentStore<Body>& bodies,
+            ComponentStore<Transform>& transforms, const Walls& walls,
+            float deltaTime, JobSystem* jobs = nullptr);
+
+/// \brief Moves every AI paddle toward the ball for one step, up, down,
+///   left, or right, as far as the walls allow.
+/// \param[in] paddles The paddles.
+/// \param[in,out] transforms The transforms, which every paddle must have.
+/// \param[in] ball Where the ball is.
+/// \param[in] walls The walls; only left, right, top, and bottom matter.
+/// \param[in] deltaTime The length of the step, in seconds.
+void
+steerPaddles (const ComponentStore<PaddleAi>& paddles,
+              ComponentStore<Transform>& transforms, const Vector3& ball,
+              const Walls& walls, float deltaTime);
+
+#endif//ENTITY_SYSTEMS_HPP
@@ -0,0 +1,68 @@
+/// \file FixedTimestep.cpp
+/// \brief Definition of FixedTimestep class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <cmath>
+
+#include "FixedTimestep.hpp"
+
+FixedTimestep::FixedTimestep (double stepsPerSecond,
+                              unsigned maxStepsPerFrame)
+  : m_stepSeconds (1.0 / stepsPerSecond),
+    m_maxStepsPerFrame (maxStepsPerFrame),
+    m_accumulator (0.0)
+{
+
+}
+
+void
+FixedTimestep::setStepsPerSecond (double stepsPerSecond)
+{
+  m_stepSeconds = 1.0 / stepsPerSecond;
+  reset ();
+}
+
+void
+FixedTimestep::setMaxStepsPerFrame (unsigned maxStepsPerFrame)
+{
+  m_maxStepsPerFrame = maxStepsPerFrame;
+}
+
+void
+FixedTimestep::reset ()
+{
+  m_accumulator = 0.0;
+}
+
+unsigned
+FixedTimestep::advance (double frameSeconds)
+{
+  if (frameSeconds > 0.0)
+    m_accumulator += frameSeconds;
+
+  unsigned steps = 0;
+  while (m_accumulator >= m_stepSeconds && steps < m_maxStepsPerFrame)
+  {
+    m_accumulator -= m_stepSeconds;
+    ++steps;
+  }
+  // Anything the steps could not catch up on is dropped, but the fraction of
+  //   a step is kept so that the interpolation stays smooth.
+  if (m_accumulator >= m_stepSeconds)
+    m_accumulator = std::fmod (m_accumulator, m_stepSeconds);
+  return steps;
+}
+
+double
+FixedTimestep::getStepSeconds () const
+{
+  return m_stepSeconds;
+}
+
+float
+FixedTimestep::getInterpolation () const
+{
+  return static_cast<float> (m_accumulator / m_stepSeconds);
+}
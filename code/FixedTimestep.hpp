@@ -0,0 +1,68 @@
+/// \file FixedTimestep.hpp
+/// \brief Declaration of FixedTimestep class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef FIXED_TIMESTEP_HPP
+#define FIXED_TIMESTEP_HPP
+
+/// \brief Turns variable frame times into a whole number of equal simulation
+///   steps.
+/// Frame time is added to an accumulator, and a step is taken for every full
+///   step length it holds.  What is left over is how far the next step has
+///   progressed, which is used to interpolate between the last two simulated
+///   states when drawing.  Because every step has the same length, the
+///   simulation does the same thing no matter how fast frames are drawn.
+class FixedTimestep
+{
+public:
+
+  /// \brief Constructs a FixedTimestep with nothing accumulated.
+  /// \param[in] stepsPerSecond How many steps to take per second of frame time.
+  /// \param[in] maxStepsPerFrame The most steps one frame may take.  Time
+  ///   beyond that is dropped, so that a slow frame slows the simulation
+  ///   down instead of making the next frame slower still.
+  FixedTimestep (double stepsPerSecond, unsigned maxStepsPerFrame);
+
+  /// \brief Changes the simulation rate.
+  /// \param[in] stepsPerSecond How many steps to take per second.
+  /// \post The accumulated time has been discarded.
+  void
+  setStepsPerSecond (double stepsPerSecond);
+
+  /// \brief Changes how many steps one frame may take to catch up.
+  /// \param[in] maxStepsPerFrame The most steps per frame.
+  void
+  setMaxStepsPerFrame (unsigned maxStepsPerFrame);
+
+  /// \brief Discards the accumulated time.
+  /// \post getInterpolation is 0.
+  void
+  reset ();
+
+  /// \brief Adds a frame's worth of time and takes the steps it completes.
+  /// \param[in] frameSeconds The time since the previous frame.
+  /// \return The number of steps to simulate, at most the maximum per frame.
+  unsigned
+  advance (double frameSeconds);
+
+  /// \brief Gets the length of one step.
+  /// \return The step length, in seconds.
+  double
+  getStepSeconds () const;
+
+  /// \brief Gets how far the simulation is between its previous and current
+  ///   states.
+  /// \return The fraction of a step left in the accumulator, in [0, 1).
+  float
+  getInterpolation () const;
+
+private:
+  double m_stepSeconds;
+  unsigned m_maxStepsPerFrame;
+  /// Frame time not yet simulated.
+  double m_accumulator;
+};
+
+#endif//FIXED_TIMESTEP_HPP
@@ -0,0 +1,46 @@
+/// \file FrameState.hpp
+/// \brief Declaration of FrameState struct and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef FRAME_STATE_HPP
+#define FRAME_STATE_HPP
+
+#include <vector>
+
+#include "Camera.hpp"
+#include "Transform.hpp"
+
+class Scene;
+
+/// \brief Everything the render thread needs to draw one simulated frame,
+///   copied out of the Scene so that the simulation can carry on moving it.
+/// Lights are not copied: a Scene's lights are fixed once they are added, so
+///   the render thread reads the Scene's own copies.
+struct FrameState
+{
+  /// \brief Constructs a FrameState that views nothing yet.
+  /// \param[in] camera The camera to start from, since Cameras have no
+  ///   default.
+  explicit FrameState (const Camera& camera)
+    : camera (camera), scene (nullptr), time (0.0), stepSeconds (1.0)
+  {
+  }
+
+  /// The camera, with its view matrix already brought up to date so that its
+  ///   update counts can be compared from frame to frame.
+  Camera camera;
+  /// The Scene that was simulated.
+  Scene* scene;
+  /// Each Mesh's world transform before and after the last step, in the
+  ///   order of the Scene's getMeshes.
+  std::vector<Transform> previousWorlds;
+  std::vector<Transform> worlds;
+  /// The clock time, in seconds, at which worlds became current.
+  double time;
+  /// The length of a simulation step, in seconds.
+  double stepSeconds;
+};
+
+#endif//FRAME_STATE_HPP
@@ -3,12 +3,23 @@
 /// \author Chad Hogg
 /// \version A08
 
+#include <algorithm>
 #include <random>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
 
 #include "Geometry.hpp"
 
+// SSE is part of every x86-64 CPU, so unlike the AVX2 kernels this needs no
+//   check at run time; 32-bit builds only get it if they are compiled for it.
+#if defined(__GNUC__) && defined(__SSE__)
+#define GEOMETRY_SSE
+#include <xmmintrin.h>
+#endif
+
 void
 indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
 	   std::vector<float>& data, std::vector<unsigned int>& indices)
@@ -51,6 +62,23 @@ indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
   }
 }
 
+bool
+narrowIndices (const std::vector<unsigned>& indices,
+               std::vector<std::uint16_t>& shortIndices)
+{
+  shortIndices.resize (indices.size ());
+  for (size_t i = 0; i < indices.size (); ++i)
+  {
+    if (indices[i] > 0xFFFF)
+    {
+      shortIndices.clear ();
+      return false;
+    }
+    shortIndices[i] = static_cast<std::uint16_t> (indices[i]);
+  }
+  return true;
+}
+
 std::vector<Vector3>
 computeFaceNormals (const std::vector<Triangle>& faces)
 {
@@ -118,35 +146,69 @@ generateRandomFaceColors (const std::vector<Triangle>& faces)
   return faceColors;
 }
 
+// SplitMix64's finalizer: scrambles every bit of its input into every bit of
+//   its output.
+static std::uint64_t
+mixBits (std::uint64_t bits)
+{
+  bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ull;
+  bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBull;
+  return bits ^ (bits >> 31);
+}
+
+// Hashes the exact bits of a position, with -0 counted as 0.
+static std::uint64_t
+hashPosition (const Vector3& position)
+{
+  std::uint32_t bits[3];
+  float coordinates[3] = { position.m_x + 0.0f, position.m_y + 0.0f,
+                           position.m_z + 0.0f };
+  std::memcpy (bits, coordinates, sizeof (bits));
+  return mixBits ((static_cast<std::uint64_t> (bits[0]) << 32 | bits[1])
+                  ^ mixBits (bits[2]));
+}
+
+// Gets a color from a counter-based generator keyed by a hash: channel i is
+//   the hash stepped i + 1 times along the SplitMix64 sequence, so no state
+//   is carried from one vertex to the next.
+static Vector3
+colorFromHash (std::uint64_t hash)
+{
+  const std::uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+  // The top 24 bits fill a float's mantissa exactly, in [0, 1).
+  const float TO_UNIT = 1.0f / 16777216.0f;
+  float channels[3];
+  for (unsigned int channel = 0; channel < 3; channel++)
+  {
+    std::uint64_t bits = mixBits (hash + (channel + 1) * GOLDEN_GAMMA);
+    channels[channel] = static_cast<float> (bits >> 40) * TO_UNIT;
+  }
+  return Vector3 (channels[0], channels[1], channels[2]);
+}
+
 std::vector<Vector3>
-generateRandomVertexColors (const std::vector<Triangle>& faces)
+generateRandomVertexColors (const std::vector<Triangle>& faces,
+                            JobSystem* jobs)
 {
-  std::default_random_engine generator;
-  std::uniform_real_distribution<float> distribution(0.0f,1.0f);
-  std::vector<Vector3> vertexColors;
-  for (unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  std::vector<Vector3> vertexColors (faces.size () * 3);
+  auto colorFaces = [&faces, &vertexColors] (size_t first, size_t last)
   {
-    for (unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
+    for (size_t faceIndex = first; faceIndex < last; faceIndex++)
     {
-      // If we already assigned a color to that position, we need to copy it.
-      bool foundMatch = false;
-      for (unsigned int otherFaceIndex = 0; otherFaceIndex < faceIndex && !foundMatch; otherFaceIndex++)
-      {
-        for (unsigned int otherVertexIndex = 0; otherVertexIndex < 3; otherVertexIndex++)
-        {
-          if(faces[faceIndex][vertexIndex] == faces[otherFaceIndex][otherVertexIndex])
-          {
-            vertexColors.push_back (vertexColors[otherFaceIndex * 3 + otherVertexIndex]);
-            foundMatch = true;
-          }
-	      }
-      }
-      // If we never saw this position before, generate a new random color.
-      if(!foundMatch)
+      for (unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
       {
-	      vertexColors.push_back (Vector3 (distribution (generator), distribution (generator), distribution (generator)));
+        vertexColors[faceIndex * 3 + vertexIndex] =
+          colorFromHash (hashPosition (faces[faceIndex][vertexIndex]));
       }
     }
+  };
+  if (jobs == nullptr)
+  {
+    colorFaces (0, faces.size ());
+  }
+  else
+  {
+    jobs->parallelFor (0, faces.size (), 0, colorFaces);
   }
   return vertexColors;
 }
@@ -345,4 +407,141 @@ buildRect(Vector3 topLeft, Vector3 size, Vector3 normal)
                       normal
   );
   return temp;
-}
\ No newline at end of file
+}
+
+#ifdef GEOMETRY_SSE
+
+// Moves count vertices into world space in place, 4 floats of a column at a
+//   time.  Sums are taken in the same order as the Matrix4 and Matrix3
+//   products, so the results match them exactly.
+static void
+transformVertices (float* vertices, size_t count, unsigned floatsPerVertex,
+                   int normalOffset, const Matrix4& world,
+                   const Matrix3& normalMatrix, Vector3& low, Vector3& high)
+{
+  const float* w = world.data ();
+  __m128 right = _mm_loadu_ps (w);
+  __m128 up = _mm_loadu_ps (w + 4);
+  __m128 back = _mm_loadu_ps (w + 8);
+  __m128 translation = _mm_loadu_ps (w + 12);
+  // Matrix3 columns are 3 floats apart, so they are loaded one at a time.
+  const float* n = normalMatrix.data ();
+  __m128 normalRight = _mm_setr_ps (n[0], n[1], n[2], 0.0f);
+  __m128 normalUp = _mm_setr_ps (n[3], n[4], n[5], 0.0f);
+  __m128 normalBack = _mm_setr_ps (n[6], n[7], n[8], 0.0f);
+  __m128 lowest = _mm_set1_ps (std::numeric_limits<float>::max ());
+  __m128 highest = _mm_set1_ps (-std::numeric_limits<float>::max ());
+  for (size_t i = 0; i < count; ++i)
+  {
+    float* p = vertices + i * floatsPerVertex;
+    __m128 position = _mm_add_ps (
+      _mm_add_ps (_mm_add_ps (_mm_mul_ps (right, _mm_set1_ps (p[0])),
+                              _mm_mul_ps (up, _mm_set1_ps (p[1]))),
+                  _mm_mul_ps (back, _mm_set1_ps (p[2]))),
+      translation);
+    // Only x, y, and z are stored, so the attribute after them is kept.
+    _mm_storel_pi (reinterpret_cast<__m64*> (p), position);
+    _mm_store_ss (p + 2, _mm_movehl_ps (position, position));
+    lowest = _mm_min_ps (lowest, position);
+    highest = _mm_max_ps (highest, position);
+    if (normalOffset >= 0)
+    {
+      float* q = p + normalOffset;
+      __m128 normal = _mm_add_ps (
+        _mm_add_ps (_mm_mul_ps (normalRight, _mm_set1_ps (q[0])),
+                    _mm_mul_ps (normalUp, _mm_set1_ps (q[1]))),
+        _mm_mul_ps (normalBack, _mm_set1_ps (q[2])));
+      _mm_storel_pi (reinterpret_cast<__m64*> (q), normal);
+      _mm_store_ss (q + 2, _mm_movehl_ps (normal, normal));
+    }
+  }
+  alignas (16) float bounds[8];
+  _mm_store_ps (bounds, lowest);
+  _mm_store_ps (bounds + 4, highest);
+  low = Vector3 (bounds[0], bounds[1], bounds[2]);
+  high = Vector3 (bounds[4], bounds[5], bounds[6]);
+}
+
+#else
+
+// Moves count vertices into world space in place.
+static void
+transformVertices (float* vertices, size_t count, unsigned floatsPerVertex,
+                   int normalOffset, const Matrix4& world,
+                   const Matrix3& normalMatrix, Vector3& low, Vector3& high)
+{
+  low = Vector3 (std::numeric_limits<float>::max ());
+  high = Vector3 (-std::numeric_limits<float>::max ());
+  for (size_t i = 0; i < count; ++i)
+  {
+    float* p = vertices + i * floatsPerVertex;
+    Vector4 position = world * Vector4 (p[0], p[1], p[2], 1.0f);
+    p[0] = position.m_x;
+    p[1] = position.m_y;
+    p[2] = position.m_z;
+    low = Vector3 (std::min (low.m_x, position.m_x),
+                   std::min (low.m_y, position.m_y),
+                   std::min (low.m_z, position.m_z));
+    high = Vector3 (std::max (high.m_x, position.m_x),
+                    std::max (high.m_y, position.m_y),
+                    std::max (high.m_z, position.m_z));
+    if (normalOffset >= 0)
+    {
+      float* q = p + normalOffset;
+      Vector3 normal = normalMatrix * Vector3 (q[0], q[1], q[2]);
+      q[0] = normal.m_x;
+      q[1] = normal.m_y;
+      q[2] = normal.m_z;
+    }
+  }
+}
+
+#endif
+
+void
+appendTransformedGeometry (const std::vector<float>& vertices,
+                           const std::vector<unsigned>& indices,
+                           unsigned floatsPerVertex, int normalOffset,
+                           const Transform& world,
+                           std::vector<float>& batchVertices,
+                           std::vector<unsigned>& batchIndices,
+                           Vector3& low, Vector3& high)
+{
+  Matrix3 normalMatrix = world.getOrientation ();
+  normalMatrix.invert ();
+  normalMatrix.transpose ();
+  appendTransformedGeometry (vertices, indices, floatsPerVertex, normalOffset,
+                             world.getTransform (), normalMatrix,
+                             batchVertices, batchIndices, low, high);
+}
+
+void
+appendTransformedGeometry (const std::vector<float>& vertices,
+                           const std::vector<unsigned>& indices,
+                           unsigned floatsPerVertex, int normalOffset,
+                           const Matrix4& world, const Matrix3& normalMatrix,
+                           std::vector<float>& batchVertices,
+                           std::vector<unsigned>& batchIndices,
+                           Vector3& low, Vector3& high)
+{
+  size_t count = vertices.size () / floatsPerVertex;
+  size_t out = batchVertices.size ();
+  unsigned firstVertex = static_cast<unsigned> (out / floatsPerVertex);
+  // Copied whole, so that attributes other than positions and normals come
+  //   along, then moved in place.
+  batchVertices.resize (out + count * floatsPerVertex);
+  if (count > 0)
+  {
+    std::memcpy (&batchVertices[out], vertices.data (),
+                 count * floatsPerVertex * sizeof (float));
+  }
+  transformVertices (batchVertices.data () + out, count, floatsPerVertex,
+                     normalOffset, world, normalMatrix, low, high);
+
+  size_t firstIndex = batchIndices.size ();
+  batchIndices.resize (firstIndex + indices.size ());
+  for (size_t i = 0; i < indices.size (); ++i)
+  {
+    batchIndices[firstIndex + i] = firstVertex + indices[i];
+  }
+}
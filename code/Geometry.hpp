@@ -3,9 +3,15 @@
 /// \author Chad Hogg
 /// \version A08
 
+#ifndef GEOMETRY_HPP
+#define GEOMETRY_HPP
+
 #include <vector>
 #include <array>
+#include <cstdint>
 
+#include "JobSystem.hpp"
+#include "Transform.hpp"
 #include "Vector3.hpp"
 
 // A triangle consists of exactly 3 Vector3s (the coordinates of the vertices).
@@ -25,6 +31,18 @@ void
 indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
 	   std::vector<float>& data, std::vector<unsigned int>& indices);
 
+/// \brief Copies indices into 16 bits each, if every one of them fits, so
+///   that an index buffer built from them takes half the memory and
+///   bandwidth.
+/// \param[in] indices The indices.
+/// \param[out] shortIndices Set to the same indices, in 16 bits; its
+///   capacity is kept, so it may be reused from call to call.
+/// \return Whether every index is below 65536.  If not, shortIndices is left
+///   empty and the indices need 32 bits.
+bool
+narrowIndices (const std::vector<unsigned>& indices,
+               std::vector<std::uint16_t>& shortIndices);
+
 /// \brief Computes a normal vector for each face of a mesh.
 /// \param[in] faces A collection of faces that are part of the mesh.
 /// \return A collection containing one normal vector per face.
@@ -54,12 +72,20 @@ std::vector<Vector3>
 generateRandomFaceColors (const std::vector<Triangle>& faces);
 
 /// \brief Assigns a random color to each vertex of a mesh.
-/// \param[in] A collection of faces that are part of the mesh.
+/// Each color is derived from a hash of the vertex's position, so vertices
+///   are matched without searching, every vertex can be colored
+///   independently, and the same position always gets the same color, from
+///   run to run and however the work is split.
+/// \param[in] faces A collection of faces that are part of the mesh.
+/// \param jobs The JobSystem to split the faces across, or nullptr to color
+///   them all on this thread.
 /// \return A collection containing three colors per face.  When the same
 ///   vertex is shared by multiple faces, each copy of the vertex will be
-///   assigned the same random color.
+///   assigned the same random color.  Positions must match exactly to be
+///   shared, apart from 0 and -0, which are treated as the same.
 std::vector<Vector3>
-generateRandomVertexColors (const std::vector<Triangle>& faces);
+generateRandomVertexColors (const std::vector<Triangle>& faces,
+                            JobSystem* jobs = nullptr);
 
 /// \brief Produces a collection of interleaved position / color data from
 ///   faces and face colors.
@@ -117,4 +143,49 @@ std::vector<float>
 buildTexturedRect(Vector3 topLeft, Vector3 size, Vector3 normal, float quality);
 
 std::vector<float>
-buildRect(Vector3 topLeft, Vector3 size, Vector3 normal);
\ No newline at end of file
+buildRect(Vector3 topLeft, Vector3 size, Vector3 normal);
+
+/// \brief Appends indexed geometry to a batch, moved into world space, so
+///   that it can be drawn with an identity world matrix alongside geometry
+///   from other places.
+/// \param[in] vertices The vertex data, floatsPerVertex floats per vertex,
+///   each starting with its position.
+/// \param[in] indices The indices into vertices, 3 per triangle.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] normalOffset Where each vertex's normal starts, or -1 if the
+///   vertices have none.  Normals are multiplied by the inverse transpose of
+///   the world orientation, as the shaders would, and are not renormalized.
+/// \param[in] world Where the geometry is.
+/// \param[in,out] batchVertices The batch's vertex data, which the moved
+///   vertices are appended to; any other attributes are copied unchanged.
+/// \param[in,out] batchIndices The batch's indices, which the indices are
+///   appended to, offset past the vertices already in the batch.
+/// \param[out] low The lowest world coordinate of the appended vertices along
+///   each axis.
+/// \param[out] high The highest world coordinate along each axis.
+void
+appendTransformedGeometry (const std::vector<float>& vertices,
+                           const std::vector<unsigned>& indices,
+                           unsigned floatsPerVertex, int normalOffset,
+                           const Transform& world,
+                           std::vector<float>& batchVertices,
+                           std::vector<unsigned>& batchIndices,
+                           Vector3& low, Vector3& high);
+
+/// \brief Appends indexed geometry to a batch, moved into world space by
+///   matrices that have already been worked out, as a Mesh keeps them.
+/// Positions and normals are moved with SSE where it is available, giving the
+///   same results as the Matrix4 and Matrix3 products.
+/// \param[in] world The world matrix.
+/// \param[in] normalMatrix The matrix that takes normals to world space.
+/// The other parameters are as for the version that takes a Transform.
+void
+appendTransformedGeometry (const std::vector<float>& vertices,
+                           const std::vector<unsigned>& indices,
+                           unsigned floatsPerVertex, int normalOffset,
+                           const Matrix4& world, const Matrix3& normalMatrix,
+                           std::vector<float>& batchVertices,
+                           std::vector<unsigned>& batchIndices,
+                           Vector3& low, Vector3& high);
+
+#endif//GEOMETRY_HPP
@@ -0,0 +1,216 @@
+/// \file IndirectDrawList.cpp
+/// \brief Implementation of IndirectDrawList class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+
+#include "IndirectDrawList.hpp"
+#include "Geometry.hpp"
+
+IndirectDrawList::IndirectDrawList (OpenGLContext* context,
+                                    ShaderProgram* program)
+  : m_context (context), m_program (program), m_indexType (GL_UNSIGNED_INT),
+    m_objectBuffer (context, GL_RGBA32F),
+    m_materialBuffer (context, GL_RGBA32F)
+{
+  m_context->genVertexArrays (1, &m_vao);
+  m_context->genBuffers (1, &m_vbo);
+  m_context->genBuffers (1, &m_ibo);
+  m_context->genBuffers (1, &m_objectIndexBuffer);
+  m_context->genBuffers (1, &m_commandBuffer);
+}
+
+IndirectDrawList::~IndirectDrawList ()
+{
+  m_context->deleteVertexArrays (1, &m_vao);
+  m_context->deleteBuffers (1, &m_vbo);
+  m_context->deleteBuffers (1, &m_ibo);
+  m_context->deleteBuffers (1, &m_objectIndexBuffer);
+  m_context->deleteBuffers (1, &m_commandBuffer);
+}
+
+void
+IndirectDrawList::setMeshes (const std::vector<const Mesh*>& meshes)
+{
+  m_meshes = meshes;
+  m_commands.clear ();
+  m_materials.clear ();
+  m_materialIndices.clear ();
+
+  // Each Mesh keeps its own indices; baseVertex moves them to its vertices.
+  std::vector<float> vertices;
+  std::vector<unsigned> indices;
+  std::vector<float> objectIndices;
+  for (const Mesh* mesh : m_meshes)
+  {
+    DrawElementsIndirectCommand command;
+    command.count = mesh->getIndices ().size ();
+    command.instanceCount = 1;
+    command.firstIndex = indices.size ();
+    command.baseVertex = vertices.size () / mesh->getFloatsPerVertex ();
+    command.baseInstance = m_commands.size ();
+    m_commands.push_back (command);
+    objectIndices.push_back (static_cast<float> (command.baseInstance));
+    vertices.insert (vertices.end (), mesh->getVertices ().begin (),
+                     mesh->getVertices ().end ());
+    indices.insert (indices.end (), mesh->getIndices ().begin (),
+                    mesh->getIndices ().end ());
+
+    auto material = std::find (m_materials.begin (), m_materials.end (),
+                               mesh->getMaterial ());
+    m_materialIndices.push_back (material - m_materials.begin ());
+    if (material == m_materials.end ())
+    {
+      m_materials.push_back (mesh->getMaterial ());
+    }
+  }
+  m_objects.resize (m_meshes.size ());
+  m_materialUniforms.resize (m_materials.size ());
+
+  // The element buffer binding belongs to the VAO, so it is bound first.
+  m_context->bindVertexArray (m_vao);
+  m_context->bindBuffer (GL_ARRAY_BUFFER, m_vbo);
+  m_context->bufferData (GL_ARRAY_BUFFER, vertices.size () * sizeof (float),
+                         vertices.data (), GL_STATIC_DRAW);
+  m_context->bindBuffer (GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+  std::vector<std::uint16_t> shortIndices;
+  if (narrowIndices (indices, shortIndices))
+  {
+    m_indexType = GL_UNSIGNED_SHORT;
+    m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER,
+                           shortIndices.size () * sizeof (std::uint16_t),
+                           shortIndices.data (), GL_STATIC_DRAW);
+  }
+  else
+  {
+    m_indexType = GL_UNSIGNED_INT;
+    m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER,
+                           indices.size () * sizeof (std::uint32_t),
+                           indices.data (), GL_STATIC_DRAW);
+  }
+  if (!m_meshes.empty ())
+  {
+    enableAttributes (m_meshes.front ()->getVertexLayout (),
+                      m_meshes.front ()->getFloatsPerVertex ());
+  }
+  m_context->bindBuffer (GL_ARRAY_BUFFER, m_objectIndexBuffer);
+  m_context->bufferData (GL_ARRAY_BUFFER,
+                         objectIndices.size () * sizeof (float),
+                         objectIndices.data (), GL_STATIC_DRAW);
+  const GLuint OBJECT_INDEX_ATTRIB_INDEX = 4;
+  m_context->enableVertexAttribArray (OBJECT_INDEX_ATTRIB_INDEX);
+  m_context->vertexAttribPointer (OBJECT_INDEX_ATTRIB_INDEX, 1, GL_FLOAT,
+                                  GL_FALSE, sizeof (float),
+                                  reinterpret_cast<void*> (0));
+  // Advances once per instance, so each command's baseInstance picks it.
+  m_context->vertexAttribDivisor (OBJECT_INDEX_ATTRIB_INDEX, 1);
+  m_context->bindVertexArray (0);
+
+  m_context->bindBuffer (GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+  m_context->bufferData (GL_DRAW_INDIRECT_BUFFER,
+                         m_commands.size () * sizeof (DrawElementsIndirectCommand),
+                         m_commands.data (), GL_STATIC_DRAW);
+  m_context->bindBuffer (GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+const std::vector<const Mesh*>&
+IndirectDrawList::getMeshes () const
+{
+  return m_meshes;
+}
+
+const std::vector<DrawElementsIndirectCommand>&
+IndirectDrawList::getCommands () const
+{
+  return m_commands;
+}
+
+GLenum
+IndirectDrawList::getIndexType () const
+{
+  return m_indexType;
+}
+
+void
+IndirectDrawList::draw ()
+{
+  if (m_commands.empty ())
+  {
+    return;
+  }
+  writeObjects ();
+
+  m_program->enable ();
+  m_objectBuffer.bind (INDIRECT_OBJECTS_UNIT);
+  m_materialBuffer.bind (INDIRECT_MATERIALS_UNIT);
+  m_context->activeTexture (GL_TEXTURE0);
+  m_context->bindVertexArray (m_vao);
+  m_context->bindBuffer (GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+  m_context->multiDrawElementsIndirect (GL_TRIANGLES, m_indexType,
+                                        reinterpret_cast<void*> (0),
+                                        m_commands.size (), 0);
+  m_context->bindBuffer (GL_DRAW_INDIRECT_BUFFER, 0);
+  m_context->bindVertexArray (0);
+  m_program->disable ();
+}
+
+void
+IndirectDrawList::enableAttributes (const VertexLayout& layout,
+                                    unsigned floatsPerVertex)
+{
+  // The same locations every Mesh's enableAttributes uses.
+  const GLuint POSITION_ATTRIB_INDEX = 0;
+  const GLuint COLOR_ATTRIB_INDEX = 1;
+  const GLuint NORMALS_ATTRIB_INDEX = 2;
+  const GLuint TEXTURE_ATTRIB_INDEX = 3;
+  GLsizei stride = floatsPerVertex * sizeof (float);
+
+  m_context->enableVertexAttribArray (POSITION_ATTRIB_INDEX);
+  m_context->vertexAttribPointer (POSITION_ATTRIB_INDEX, 3, GL_FLOAT, GL_FALSE,
+                                  stride, reinterpret_cast<void*> (0));
+  if (layout.colorOffset >= 0)
+  {
+    m_context->enableVertexAttribArray (COLOR_ATTRIB_INDEX);
+    m_context->vertexAttribPointer (COLOR_ATTRIB_INDEX, 3, GL_FLOAT, GL_FALSE,
+      stride, reinterpret_cast<void*> (layout.colorOffset * sizeof (float)));
+  }
+  if (layout.normalOffset >= 0)
+  {
+    m_context->enableVertexAttribArray (NORMALS_ATTRIB_INDEX);
+    m_context->vertexAttribPointer (NORMALS_ATTRIB_INDEX, 3, GL_FLOAT,
+      GL_FALSE, stride,
+      reinterpret_cast<void*> (layout.normalOffset * sizeof (float)));
+  }
+  if (layout.uvOffset >= 0)
+  {
+    m_context->enableVertexAttribArray (TEXTURE_ATTRIB_INDEX);
+    m_context->vertexAttribPointer (TEXTURE_ATTRIB_INDEX, 2, GL_FLOAT,
+      GL_FALSE, stride,
+      reinterpret_cast<void*> (layout.uvOffset * sizeof (float)));
+  }
+}
+
+void
+IndirectDrawList::writeObjects ()
+{
+  for (size_t i = 0; i < m_meshes.size (); ++i)
+  {
+    IndirectObjectUniforms& object = m_objects[i];
+    copyToBlock (object.world, m_meshes[i]->getWorldMatrix ());
+    copyToBlock (object.worldNormal, m_meshes[i]->getNormalMatrix ());
+    object.materialIndex = static_cast<float> (m_materialIndices[i]);
+    object.padding[0] = object.padding[1] = object.padding[2] = 0.0f;
+  }
+  for (size_t i = 0; i < m_materials.size (); ++i)
+  {
+    m_materialUniforms[i] = m_materials[i] == nullptr
+      ? MaterialUniforms () : m_materials[i]->getUniforms ();
+  }
+  m_objectBuffer.setData (m_objects.data (),
+                          m_objects.size () * sizeof (IndirectObjectUniforms));
+  m_materialBuffer.setData (m_materialUniforms.data (),
+                            m_materialUniforms.size ()
+                            * sizeof (MaterialUniforms));
+}
@@ -0,0 +1,123 @@
+/// \file IndirectDrawList.hpp
+/// \brief Declaration of IndirectDrawList class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef INDIRECT_DRAW_LIST_HPP
+#define INDIRECT_DRAW_LIST_HPP
+
+#include <vector>
+
+#include "Material.hpp"
+#include "Mesh.hpp"
+#include "OpenGLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "TextureBuffer.hpp"
+#include "UniformBlocks.hpp"
+
+/// \brief Meshes of one kind whose geometry has been copied into one shared
+///   vertex and index buffer, so that all of them are drawn with a single
+///   glMultiDrawElementsIndirect call.
+/// Each Mesh becomes one command, whose baseInstance selects its world
+///   matrices and Material from texture buffers rewritten every frame, so
+///   the Meshes still move and are lit independently.  They must be drawn
+///   with a ShaderProgram compiled with INDIRECT_DRAW defined.
+class IndirectDrawList
+{
+public:
+
+  /// \brief Constructs an empty list.
+  /// \param context A pointer to an object through which the list will make
+  ///   OpenGL calls.
+  /// \param[in] program The ShaderProgram, compiled with INDIRECT_DRAW, to
+  ///   draw the Meshes with.  Its uObjects and uMaterials samplers must read
+  ///   INDIRECT_OBJECTS_UNIT and INDIRECT_MATERIALS_UNIT.
+  /// \post A VAO and the buffers it reads have been generated.
+  IndirectDrawList (OpenGLContext* context, ShaderProgram* program);
+
+  /// \brief Destructs this list.
+  /// \post The VAO and buffers have been deleted.  The Meshes are not.
+  ~IndirectDrawList ();
+
+  /// \brief Copy constructor removed because you shouldn't be copying lists.
+  IndirectDrawList (const IndirectDrawList&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   lists.
+  IndirectDrawList&
+  operator= (const IndirectDrawList&) = delete;
+
+  /// \brief Replaces the Meshes drawn, copying their geometry into the shared
+  ///   buffers and making one command for each.
+  /// \param[in] meshes The Meshes, which must all be of the same kind, and
+  ///   must outlive the list or be replaced first.
+  /// \post The vertex attributes are laid out as the first Mesh says.
+  /// \post The indices are 16 bits each if every Mesh's indices fit, since
+  ///   baseVertex moves them to the Mesh's vertices after they are read.
+  void
+  setMeshes (const std::vector<const Mesh*>& meshes);
+
+  /// \brief Gets the Meshes drawn.
+  /// \return The Meshes, in command order.
+  const std::vector<const Mesh*>&
+  getMeshes () const;
+
+  /// \brief Gets the commands the Meshes are drawn with.
+  /// \return One command per Mesh.
+  const std::vector<DrawElementsIndirectCommand>&
+  getCommands () const;
+
+  /// \brief Gets the type of the shared index buffer.
+  /// \return GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+  GLenum
+  getIndexType () const;
+
+  /// \brief Draws every Mesh where it is now, with one call.
+  /// \pre The Scene's FrameBlock and clustered lights are bound.
+  /// \post The per-object and material buffers hold the Meshes' current
+  ///   world matrices and Materials.
+  void
+  draw ();
+
+private:
+  /// \brief Sets up the VAO for vertices laid out like a Mesh's, plus the
+  ///   per-instance object index.
+  /// \param[in] layout Where each attribute is within a vertex.
+  /// \param[in] floatsPerVertex The number of floats used for each vertex.
+  /// \pre The VAO is bound.
+  void
+  enableAttributes (const VertexLayout& layout, unsigned floatsPerVertex);
+
+  /// \brief Writes the world matrices and Materials of every Mesh into the
+  ///   texture buffers the shaders read them from.
+  void
+  writeObjects ();
+
+  /// A pointer to the object through which the list makes OpenGL calls.
+  OpenGLContext* m_context;
+  /// The ShaderProgram the Meshes are drawn with.
+  ShaderProgram* m_program;
+  GLuint m_vao, m_vbo, m_ibo;
+  /// The type of the indices in m_ibo.
+  GLenum m_indexType;
+  /// Holds 0, 1, 2, ..., read as aObjectIndex once per instance.
+  GLuint m_objectIndexBuffer;
+  /// Holds m_commands, bound as GL_DRAW_INDIRECT_BUFFER.
+  GLuint m_commandBuffer;
+  std::vector<const Mesh*> m_meshes;
+  std::vector<DrawElementsIndirectCommand> m_commands;
+  /// Each distinct Material the Meshes use, in the order first used; a Mesh
+  ///   without one uses a Material of all zeros.
+  std::vector<const Material*> m_materials;
+  /// The index into m_materials of each Mesh's Material.
+  std::vector<unsigned> m_materialIndices;
+  /// CPU copies of what the texture buffers hold, reused from frame to frame.
+  std::vector<IndirectObjectUniforms> m_objects;
+  std::vector<MaterialUniforms> m_materialUniforms;
+  /// Read by the shaders as uObjects and uMaterials.
+  TextureBuffer m_objectBuffer;
+  TextureBuffer m_materialBuffer;
+};
+
+#endif//INDIRECT_DRAW_LIST_HPP
@@ -0,0 +1,228 @@
+/// \file JobSystem.cpp
+/// \brief Definition of JobSystem class and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+
+#include "JobSystem.hpp"
+
+namespace
+{
+  /// The JobSystem this thread is a worker of, if any, and its queue.
+  thread_local const JobSystem* t_system = nullptr;
+  thread_local unsigned t_queue = 0;
+}
+
+JobSystem::Counter::Counter ()
+  : m_pending (0)
+{
+
+}
+
+bool
+JobSystem::Counter::isDone () const
+{
+  return m_pending.load (std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem (unsigned threadCount)
+  : m_queueCount (threadCount), m_queuedCount (0), m_sleeperCount (0),
+    m_nextQueue (0), m_isStopping (false)
+{
+  if (m_queueCount == 0)
+  {
+    m_queueCount = std::max (1u, std::thread::hardware_concurrency ());
+  }
+  m_queues.reset (new TaskQueue[m_queueCount]);
+  for (unsigned queue = 1; queue < m_queueCount; ++queue)
+  {
+    m_workers.emplace_back (&JobSystem::workerLoop, this, queue);
+  }
+}
+
+JobSystem::~JobSystem ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_wakeMutex);
+    m_isStopping = true;
+  }
+  m_wake.notify_all ();
+  for (std::thread& worker : m_workers)
+  {
+    worker.join ();
+  }
+}
+
+unsigned
+JobSystem::getThreadCount () const
+{
+  return m_queueCount;
+}
+
+void
+JobSystem::run (Job job, Counter& counter)
+{
+  counter.m_pending.fetch_add (1, std::memory_order_relaxed);
+  if (t_system == this)
+  {
+    push (Task { std::move (job), &counter }, t_queue, true);
+  }
+  else
+  {
+    unsigned queue = m_nextQueue.fetch_add (1, std::memory_order_relaxed)
+      % m_queueCount;
+    push (Task { std::move (job), &counter }, queue, false);
+  }
+}
+
+void
+JobSystem::wait (Counter& counter)
+{
+  unsigned self = getOwnQueue ();
+  while (!counter.isDone ())
+  {
+    Task task;
+    if (pop (self, task))
+    {
+      execute (task);
+    }
+    else
+    {
+      // The rest of the group is running on other threads.
+      std::this_thread::yield ();
+    }
+  }
+}
+
+void
+JobSystem::parallelFor (size_t begin, size_t end, size_t grainSize,
+                        const RangeJob& body)
+{
+  if (end <= begin)
+  {
+    return;
+  }
+  size_t count = end - begin;
+  if (grainSize == 0)
+  {
+    size_t jobCount = 4 * static_cast<size_t> (m_queueCount);
+    grainSize = std::max<size_t> (1, (count + jobCount - 1) / jobCount);
+  }
+  size_t chunkCount = (count + grainSize - 1) / grainSize;
+  if (chunkCount == 1)
+  {
+    body (begin, end);
+    return;
+  }
+
+  // A worker keeps the whole range and lets the others steal it from the far
+  //   end; any other thread deals out contiguous runs of it, one per queue.
+  Counter counter;
+  counter.m_pending.store (static_cast<unsigned> (chunkCount),
+                           std::memory_order_relaxed);
+  bool isWorker = t_system == this;
+  const RangeJob* bodyPointer = &body;
+  for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+  {
+    size_t first = begin + chunk * grainSize;
+    size_t last = std::min (first + grainSize, end);
+    unsigned queue = isWorker ? t_queue
+      : static_cast<unsigned> (chunk * m_queueCount / chunkCount);
+    push (Task { [bodyPointer, first, last] () { (*bodyPointer) (first, last); },
+                 &counter },
+          queue, isWorker);
+  }
+  wait (counter);
+}
+
+void
+JobSystem::push (Task task, unsigned queue, bool isFront)
+{
+  // Counted before it can be taken, so the count never goes below 0.
+  m_queuedCount.fetch_add (1);
+  {
+    std::lock_guard<std::mutex> lock (m_queues[queue].mutex);
+    if (isFront)
+    {
+      m_queues[queue].tasks.push_front (std::move (task));
+    }
+    else
+    {
+      m_queues[queue].tasks.push_back (std::move (task));
+    }
+  }
+  // A worker counts itself as sleeping before it checks m_queuedCount, so
+  //   either it sees this job or this sees it and wakes it.
+  if (m_sleeperCount.load () > 0)
+  {
+    std::lock_guard<std::mutex> lock (m_wakeMutex);
+    m_wake.notify_one ();
+  }
+}
+
+bool
+JobSystem::pop (unsigned self, Task& task)
+{
+  for (unsigned i = 0; i < m_queueCount; ++i)
+  {
+    TaskQueue& queue = m_queues[(self + i) % m_queueCount];
+    std::lock_guard<std::mutex> lock (queue.mutex);
+    if (!queue.tasks.empty ())
+    {
+      if (i == 0)
+      {
+        task = std::move (queue.tasks.front ());
+        queue.tasks.pop_front ();
+      }
+      else
+      {
+        task = std::move (queue.tasks.back ());
+        queue.tasks.pop_back ();
+      }
+      m_queuedCount.fetch_sub (1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+JobSystem::execute (Task& task)
+{
+  task.job ();
+  task.counter->m_pending.fetch_sub (1, std::memory_order_acq_rel);
+}
+
+unsigned
+JobSystem::getOwnQueue () const
+{
+  return t_system == this ? t_queue : 0;
+}
+
+void
+JobSystem::workerLoop (unsigned self)
+{
+  t_system = this;
+  t_queue = self;
+  while (true)
+  {
+    Task task;
+    if (pop (self, task))
+    {
+      execute (task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock (m_wakeMutex);
+    m_sleeperCount.fetch_add (1);
+    m_wake.wait (lock, [this] ()
+    {
+      return m_isStopping || m_queuedCount.load () > 0;
+    });
+    m_sleeperCount.fetch_sub (1);
+    if (m_isStopping)
+    {
+      return;
+    }
+  }
+}
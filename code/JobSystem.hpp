@@ -0,0 +1,183 @@
+/// \file JobSystem.hpp
+/// \brief Declaration of JobSystem class and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \brief Runs small jobs on a fixed set of worker threads.
+/// Every worker has its own queue of jobs.  A worker takes from the front of
+///   its own queue and, when that is empty, steals from the back of the
+///   others', so that a thread that finishes early takes work from one that
+///   is still busy.  Jobs are grouped by Counters, which count the jobs that
+///   have not finished yet; waiting on a Counter runs queued jobs on the
+///   waiting thread until the Counter reaches 0, so waiting inside a job
+///   never blocks a worker.
+/// Any thread may run jobs and wait on Counters, including threads that are
+///   not workers, such as the main loop.  A thread that is not a worker
+///   only ever runs jobs while it waits.
+class JobSystem
+{
+public:
+
+  /// \brief A unit of work.
+  using Job = std::function<void ()>;
+
+  /// \brief Work on the indexes [first, last) of a range.
+  using RangeJob = std::function<void (size_t, size_t)>;
+
+  /// \brief Counts the jobs of a group that have not finished.
+  /// A job may run more jobs with the Counter it was run with.  Because the
+  ///   children are counted before their parent finishes, the Counter does not
+  ///   reach 0 until the parent and all of its descendants have finished.
+  class Counter
+  {
+  public:
+
+    /// \brief Constructs a Counter with no jobs.
+    Counter ();
+
+    /// \brief Copy constructor removed because jobs refer to their Counter.
+    Counter (const Counter&) = delete;
+
+    /// \brief Assignment operator removed because jobs refer to their Counter.
+    Counter&
+    operator= (const Counter&) = delete;
+
+    /// \brief Checks whether every job of the group has finished.
+    /// \return True if no job run with this Counter is waiting or running.
+    bool
+    isDone () const;
+
+  private:
+    friend class JobSystem;
+
+    std::atomic<unsigned> m_pending;
+  };
+
+  /// \brief Constructs a JobSystem and starts its workers.
+  /// \param[in] threadCount The number of threads to run jobs on, counting
+  ///   the thread that waits; 0 means one per hardware thread.  A JobSystem
+  ///   with 1 thread starts no workers and runs everything while waiting.
+  explicit JobSystem (unsigned threadCount = 0);
+
+  /// \brief Copy constructor removed because workers refer to their JobSystem.
+  JobSystem (const JobSystem&) = delete;
+
+  /// \brief Assignment operator removed because workers refer to their
+  ///   JobSystem.
+  JobSystem&
+  operator= (const JobSystem&) = delete;
+
+  /// \brief Stops and joins the workers.
+  /// \pre Every Counter has been waited on.
+  ~JobSystem ();
+
+  /// \brief Gets the number of threads jobs run on.
+  /// \return The number of workers plus the one waiting thread.
+  unsigned
+  getThreadCount () const;
+
+  /// \brief Queues a job.
+  /// A worker queues the job on its own queue, where it will be the next job
+  ///   it takes; any other thread spreads its jobs over all of the queues.
+  /// \param[in] job The job.
+  /// \param counter The Counter of the job's group, which must outlive the
+  ///   job.
+  /// \post counter is not done until job has finished.
+  void
+  run (Job job, Counter& counter);
+
+  /// \brief Runs jobs on this thread until a group has finished.
+  /// \param counter The Counter of the group.
+  /// \post counter is done, and everything its jobs wrote is visible.
+  void
+  wait (Counter& counter);
+
+  /// \brief Runs a function over a range of indexes, split into jobs, and
+  ///   waits for all of them.
+  /// Each job covers a contiguous run of the range, and the jobs are queued
+  ///   so that neighboring runs tend to be taken by the same thread.
+  /// \param[in] begin The first index.
+  /// \param[in] end One past the last index.
+  /// \param[in] grainSize The most indexes per job; 0 splits the range into a
+  ///   few jobs per thread.
+  /// \param[in] body Called with the first and one past the last index of
+  ///   each job.
+  void
+  parallelFor (size_t begin, size_t end, size_t grainSize,
+               const RangeJob& body);
+
+private:
+  /// \brief A queued job and the group it belongs to.
+  struct Task
+  {
+    Job job;
+    Counter* counter;
+  };
+
+  /// \brief One thread's jobs.
+  struct TaskQueue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /// \brief Adds a job to a queue and wakes a sleeping worker.
+  /// \param[in] task The job.
+  /// \param[in] queue The index of the queue.
+  /// \param[in] isFront Whether to add it where the owner takes from.
+  void
+  push (Task task, unsigned queue, bool isFront);
+
+  /// \brief Takes a job from the front of one queue or the back of any other.
+  /// \param[in] self The index of the queue to take from the front of.
+  /// \param[out] task The job taken.
+  /// \return True if a job was taken.
+  bool
+  pop (unsigned self, Task& task);
+
+  /// \brief Runs a job and counts it as finished.
+  /// \param task The job.
+  void
+  execute (Task& task);
+
+  /// \brief Gets the queue this thread owns.
+  /// \return The calling worker's queue, or 0 for any other thread.
+  unsigned
+  getOwnQueue () const;
+
+  /// \brief Takes and runs jobs until the JobSystem is destroyed.
+  /// \param[in] self The worker's queue.
+  void
+  workerLoop (unsigned self);
+
+  /// Queue 0 is shared by the threads that are not workers; worker i owns
+  ///   queue i.
+  std::unique_ptr<TaskQueue[]> m_queues;
+  unsigned m_queueCount;
+  std::vector<std::thread> m_workers;
+
+  /// The number of queued jobs, so that workers know when to sleep.
+  std::atomic<size_t> m_queuedCount;
+  /// The number of workers sleeping on m_wake.
+  std::atomic<unsigned> m_sleeperCount;
+  /// Where the next job from a thread that is not a worker is queued.
+  std::atomic<unsigned> m_nextQueue;
+  bool m_isStopping;
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wake;
+};
+
+#endif//JOB_SYSTEM_HPP
@@ -6,12 +6,15 @@
 #ifndef KEY_BUFFER_HPP
 #define KEY_BUFFER_HPP
 
+#include <atomic>
+
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 /// \brief A way to remember the status of each key -- either up or down.
 /// Nothing in this class actually controls the keys, it just keeps track of
-///   which ones it has been told are down.
+///   which ones it has been told are down.  Keys may be set on the thread
+///   that receives window events while another thread reads them.
 class KeyBuffer
 {
  public:
@@ -45,7 +48,7 @@ class KeyBuffer
  private:
   /// \brief An array containing the status of each key constant.
   /// True indicates that the key is down, false that it is up.
-  bool keyIsPressed[GLFW_KEY_LAST + 1];
+  std::atomic<bool> keyIsPressed[GLFW_KEY_LAST + 1];
 };
 
 
@@ -18,12 +18,10 @@ LightSource::~LightSource ()
 }
 
 void 
-LightSource::setUniforms (ShaderProgram* program, int lightNum)
+LightSource::writeUniforms (LightUniforms& light) const
 {
-  std::string light = "uLights[" + std::to_string(lightNum);
-  light += "]";
-  program->setUniformVector(light + ".diffuseIntensity", m_diffuseIntensity);
-  program->setUniformVector(light + ".specularIntensity", m_specularIntensity);
+  copyToBlock(light.diffuseIntensity, m_diffuseIntensity);
+  copyToBlock(light.specularIntensity, m_specularIntensity);
 }
 
 
@@ -40,13 +38,11 @@ DirectionalLightSource::~DirectionalLightSource ()
 }
 
 void 
-DirectionalLightSource::setUniforms (ShaderProgram* program, int lightNum)
+DirectionalLightSource::writeUniforms (LightUniforms& light) const
 {
-  LightSource::setUniforms(program, lightNum);
-  std::string light = "uLights[" + std::to_string(lightNum);
-  light += "]";
-  program->setUniformVector(light + ".direction", m_direction);
-  program->setUniformInt(light + ".type", LightType(DIRECTIONAL));
+  LightSource::writeUniforms(light);
+  copyToBlock(light.direction, m_direction);
+  light.type = DIRECTIONAL;
 }
 
 
@@ -64,13 +60,11 @@ LocationLightSource::~LocationLightSource ()
 }
 
 void 
-LocationLightSource::setUniforms (ShaderProgram* program, int lightNum)
+LocationLightSource::writeUniforms (LightUniforms& light) const
 {
-  LightSource::setUniforms(program, lightNum);
-  std::string light = "uLights[" + std::to_string(lightNum);
-  light += "]";
-  program->setUniformVector(light + ".position", m_position);
-  program->setUniformVector(light + ".attenuationCoefficients", m_attenuationCoefficients);
+  LightSource::writeUniforms(light);
+  copyToBlock(light.position, m_position);
+  copyToBlock(light.attenuationCoefficients, m_attenuationCoefficients);
 }
 
 
@@ -87,12 +81,10 @@ PointLightSource::~PointLightSource ()
 }
 
 void 
-PointLightSource::setUniforms (ShaderProgram* program, int lightNum)
+PointLightSource::writeUniforms (LightUniforms& light) const
 {
-  LocationLightSource::setUniforms(program, lightNum);
-  std::string light = "uLights[" + std::to_string(lightNum);
-  light += "]";
-  program->setUniformInt(light + ".type", LightType(POINT));
+  LocationLightSource::writeUniforms(light);
+  light.type = POINT;
 }
 
 SpotLightSource::SpotLightSource (const Vector3& diffuseIntensity, const Vector3& specularIntensity, const Vector3& position, const Vector3& attenuationCoefficients, const Vector3& direction, float cutoffCosAngle, float falloff)
@@ -110,13 +102,11 @@ SpotLightSource::~SpotLightSource ()
 }
 
 void 
-SpotLightSource::setUniforms (ShaderProgram* program, int lightNum)
+SpotLightSource::writeUniforms (LightUniforms& light) const
 {
-  LocationLightSource::setUniforms(program, lightNum);
-  std::string light = "uLights[" + std::to_string(lightNum);
-  light += "]";
-  program->setUniformVector(light + ".direction", m_direction);
-  program->setUniformFloat(light + ".cutoffCosAngle", m_cutoffCosAngle);
-  program->setUniformFloat(light + ".falloff", m_falloff);
-  program->setUniformInt(light + ".type", LightType(SPOT));
-}
\ No newline at end of file
+  LocationLightSource::writeUniforms(light);
+  copyToBlock(light.direction, m_direction);
+  light.cutoffCosAngle = m_cutoffCosAngle;
+  light.falloff = m_falloff;
+  light.type = SPOT;
+}
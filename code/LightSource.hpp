@@ -7,7 +7,7 @@
 #define LIGHT_SOURCE_HPP
 
 #include "Vector3.hpp"
-#include "ShaderProgram.hpp"
+#include "UniformBlocks.hpp"
 
 enum LightType {
   DIRECTIONAL = 0,
@@ -19,7 +19,8 @@ class LightSource {
 public:
   LightSource (const Vector3& diffuseIntensity, const Vector3& specularIntensity);
   virtual ~LightSource ();
-  virtual void setUniforms (ShaderProgram* program, int lightNum);
+  /// Fills in this light's element of the FrameBlock "uLights" array.
+  virtual void writeUniforms (LightUniforms& light) const;
 private:
   Vector3 m_diffuseIntensity;
   Vector3 m_specularIntensity;
@@ -29,7 +30,8 @@ class DirectionalLightSource : public LightSource {
 public:
   DirectionalLightSource (const Vector3& diffuseIntensity, const Vector3& specularIntensity, const Vector3& direction);
   virtual ~DirectionalLightSource ();
-  virtual void setUniforms (ShaderProgram* program, int lightNum);
+  /// Fills in this light's element of the FrameBlock "uLights" array.
+  virtual void writeUniforms (LightUniforms& light) const;
 private:
   Vector3 m_direction;
 };
@@ -38,7 +40,8 @@ class LocationLightSource : public LightSource {
 public:
   LocationLightSource (const Vector3& diffuseIntensity, const Vector3& specularIntensity, const Vector3& position, const Vector3& attenuationCoefficients);
   virtual ~LocationLightSource ();
-  virtual void setUniforms (ShaderProgram* program, int lightNum);
+  /// Fills in this light's element of the FrameBlock "uLights" array.
+  virtual void writeUniforms (LightUniforms& light) const;
 private:
   Vector3 m_position;
   Vector3 m_attenuationCoefficients;
@@ -48,14 +51,16 @@ class PointLightSource : public LocationLightSource {
 public:
   PointLightSource (const Vector3& diffuseIntensity, const Vector3& specularIntensity, const Vector3& position, const Vector3& attenuationCoefficients);
   virtual ~PointLightSource ();
-  virtual void setUniforms (ShaderProgram* program, int lightNum);
+  /// Fills in this light's element of the FrameBlock "uLights" array.
+  virtual void writeUniforms (LightUniforms& light) const;
 };
 
 class SpotLightSource : public LocationLightSource {
 public:
   SpotLightSource (const Vector3& diffuseIntensity, const Vector3& specularIntensity, const Vector3& position, const Vector3& attenuationCoefficients, const Vector3& direction, float cutoffCosAngle, float falloff);
   virtual ~SpotLightSource ();
-  virtual void setUniforms (ShaderProgram* program, int lightNum);
+  /// Fills in this light's element of the FrameBlock "uLights" array.
+  virtual void writeUniforms (LightUniforms& light) const;
 private:
   Vector3 m_direction;
   float m_cutoffCosAngle;
@@ -4,13 +4,20 @@
 /// \version A09
 ///
 /// This is a fairly simple program that uses OpenGL 3.3 to draw a scene.  It
-///   allows limited movement of a very simple virtual camera.
+///   allows limited movement of a very simple virtual camera.  The scene is
+///   simulated on a thread of its own, which hands each finished frame to the
+///   main thread to draw.
 
 
 /******************************************************************/
 // System includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <string>
+#include <thread>
 #include <vector>
 
 // Use GLEW so we can access the latest OpenGL functionality
@@ -32,7 +39,13 @@
 /******************************************************************/
 // Local includes
 #include "RealOpenGLContext.hpp"
+#include "RecordingOpenGLContext.hpp"
+#include "JobSystem.hpp"
+#include "FixedTimestep.hpp"
+#include "FrameState.hpp"
+#include "TripleBuffer.hpp"
 #include "ShaderProgram.hpp"
+#include "UniformBlocks.hpp"
 #include "Mesh.hpp"
 #include "Scenes/Scene.hpp"
 #include "Scenes/MyScene.hpp"
@@ -55,11 +68,30 @@
 /******************************************************************/
 // Global variables
 
+/// \brief How many times per second the Scene is simulated, regardless of
+///   how often it is drawn.
+const double SIMULATION_STEPS_PER_SECOND = 60.0;
+
+/// \brief The most simulation steps one frame may take to catch up.  After a
+///   longer stall the simulation falls behind real time instead.
+const unsigned MAX_STEPS_PER_FRAME = 5;
+
 /// \brief The OpenGLContext through which all OpenGL calls will be made.
 ///
 /// This should be allocated in ::init and deallocated in ::releaseGlResources.
 OpenGLContext* g_context;
 
+/// \brief g_context, if it is recording statistics for --profile, or else
+///   nullptr.
+RecordingOpenGLContext* g_recordingContext;
+
+/// \brief The workers the Scenes record their draws on for --record and
+///   cull occluded Meshes on for --occlude, or nullptr to draw on the main
+///   thread alone.
+///
+/// This should be allocated in ::init and deallocated in ::releaseGlResources.
+JobSystem* g_drawJobs;
+
 /// \brief A collection of Meshes stored in one scene.
 ///
 /// This will be filled in initScene, and its contents need to be deleted in
@@ -79,12 +111,52 @@ ShaderProgram* g_colorShaderProgram;
 ///   ::releaseGlResources.
 ShaderProgram* g_normalShaderProgram;
 
-/// \brief The Camera that views the Scene.
+/// \brief Variants of g_colorShaderProgram and g_normalShaderProgram,
+///   compiled with INDIRECT_DRAW, that the Scenes draw untextured Meshes
+///   with, or nullptr if --indirect was not given or is not supported.
+///
+/// These should be allocated in ::initShaders and deallocated in
+///   ::releaseGlResources.
+ShaderProgram* g_indirectColorShaderProgram;
+ShaderProgram* g_indirectNormalShaderProgram;
+
+/// \brief The Camera that views the Scene, which the simulation moves.
 ///
 /// This should be allocated in ::initCamera and deallocated in
 ///   ::releaseGlResources.
 Camera* g_camera;
 
+/// \brief The Camera the Scene is drawn through, copied from each FrameState
+///   so that the simulation can keep moving g_camera meanwhile.
+///
+/// This should be allocated in ::initCamera and deallocated in
+///   ::releaseGlResources.
+Camera* g_drawCamera;
+
+/// \brief The frames handed from the simulation thread to the render thread.
+///
+/// This should be allocated in ::initCamera and deallocated in
+///   ::releaseGlResources.
+TripleBuffer<FrameState>* g_frames;
+
+/// \brief Whether the simulation thread should keep running.
+std::atomic<bool> g_isSimulating (false);
+
+/// \brief The window's width divided by its height, set when the window is
+///   resized and applied to g_camera by the simulation.
+std::atomic<double> g_aspectRatio (16.0 / 9.0);
+
+/// \brief The aspect ratio g_camera's projection was last made with.
+double g_cameraAspectRatio = 16.0 / 9.0;
+
+/// \brief The cursor position that mouse look last turned g_camera to.
+double g_lookX = 0.0;
+double g_lookY = 0.0;
+
+/// \brief The time the simulation has spent stepping, in nanoseconds, for
+///   --profile.
+std::atomic<long long> g_simulationNanoseconds (0);
+
 /// \brief The KeyBufffer that tracks what keys are up and down.
 ///
 /// This should be allocated in ::initScene and deallocated in
@@ -103,10 +175,19 @@ MouseBuffer* g_mouseBuffer;
 
 /// \brief Initializes all libraries and global variables.
 /// \param[out] window A pointer that will be filled with a GLFWwindow.
+/// \param[in] isProfiling Whether to record OpenGL statistics and draw as
+///   fast as possible instead of once per vertical sync.
+/// \param[in] isIndirect Whether to draw untextured Meshes with
+///   glMultiDrawElementsIndirect, where it is supported.
+/// \param[in] isRecording Whether to record draws into CommandLists on
+///   worker threads and replay them on this one.
+/// \param[in] isOccluding Whether to skip drawing Meshes hidden behind
+///   occluders, found on worker threads.
 ///
 /// This should be called once at the beginning of the application.
 void
-init (GLFWwindow*& window);
+init (GLFWwindow*& window, bool isProfiling, bool isIndirect,
+      bool isRecording, bool isOccluding);
 
 /// \brief Initializes the GLFW library.  Should only be called by ::init.
 void
@@ -119,8 +200,9 @@ initGlew ();
 /// \brief Creates and initializes the window.  Should only be called by
 ///   ::init.
 /// \param[out] window A pointer that will be filled with a GLFWwindow.
+/// \param[in] isVsynced Whether to swap buffers once per vertical sync.
 void
-initWindow (GLFWwindow*& window);
+initWindow (GLFWwindow*& window, bool isVsynced);
 
 /// \brief Re-renders the window.  This should be called whenever the window
 ///   size changes.
@@ -131,28 +213,85 @@ void
 resetViewport (GLFWwindow* window, int width, int height);
 
 /// \brief Creates the Scene.  Should only be called by ::init.
+/// \param[in] isRecording Whether the Scenes record their draws on
+///   g_drawJobs.
+/// \param[in] isOccluding Whether the Scenes cull occluded Meshes on
+///   g_drawJobs.
 void
-initScene ();
+initScene (bool isRecording, bool isOccluding);
 
-/// \brief Creates the ShaderProgram.  Should only be called by ::init.
+/// \brief Creates the ShaderPrograms.  Should only be called by ::init.
+/// \param[in] isIndirect Whether to also create the indirect variants, if
+///   the OpenGL implementation can draw with them.
 void
-initShaders ();
+initShaders (bool isIndirect);
 
 /// \brief Initializes the Camera.  Should only be called by ::init.
 void
 initCamera ();
 
+/// \brief Updates and draws the Scene one after the other on this thread.
+/// \param[in] window The GLFWwindow to draw in.
+void
+runSerial (GLFWwindow* window);
+
+/// \brief Updates the Scene on a second thread while this one draws the
+///   frames it publishes.
+/// \param[in] window The GLFWwindow to draw in.
+void
+runPipelined (GLFWwindow* window);
+
+/// \brief Steps the Scene at a fixed rate and publishes each result to
+///   g_frames, until g_isSimulating is cleared.  This is the body of the
+///   simulation thread.
+void
+simulate ();
+
+/// \brief Takes input, then moves geometric objects around using game logic.
+///   This should be called for every simulation step.
+/// \param[in] time The length of a simulation step, in seconds.
+void
+stepScene (float time);
+
 /// \brief Moves geometric objects around using game logic.  This should be
-///   called for every frame.
-/// \param[in] time The number of seconds since the previous update.
+///   called for every simulation step.
+/// \param[in] time The length of a simulation step, in seconds.
 void
 updateScene (double time);
 
+/// \brief Copies the simulated camera and Scene into g_frames and makes them
+///   the latest frame.
+/// \param[in] time The clock time at which the Scene reached its state.
+/// \param[in] stepSeconds The length of a simulation step.
+void
+publishFrame (double time, double stepSeconds);
+
 /// \brief Draws the Scene onto the window.  This should be called for every
 ///   frame.
 /// \param[in] window The GLFWwindow to draw in.
+/// \param[in] interpolation How far the simulation is between its last two
+///   steps, for drawing moving Meshes between them.
+void
+drawScene (GLFWwindow* window, float interpolation);
+
+/// \brief Draws a published frame onto the window.
+/// \param[in] window The GLFWwindow to draw in.
+/// \param[in] frame The frame.
+/// \param[in] interpolation Where between the frame's two steps to draw it.
+void
+drawFrame (GLFWwindow* window, const FrameState& frame, float interpolation);
+
+/// \brief Prints the average frame, update, and render times once a second,
+///   for --profile, and what occlusion culling did in the last frame.
+/// \param[in] renderSeconds The time this frame spent drawing.
+/// \param[in] scene The Scene this frame drew.
+void
+reportStatistics (double renderSeconds, const Scene* scene);
+
+/// \brief Prints the size of every Mesh's index buffer, and how much
+///   uploading it in 16 bits saved, for --profile.
 void
-drawScene (GLFWwindow* window);
+reportIndexSizes ();
 
 /// \brief Records user input with a keybuffer.  This should be set as a callback.
 /// \param[in] window The GLFWwindow the input came from.
@@ -187,9 +326,17 @@ void
 processScrollWheel (GLFWwindow* window, double xoffset, double yoffset);
 
 /// \brief Responds to implemented keys that are pressed down in keybuffer.
+///   This should be called for every simulation step.
+/// \param[in] deltaTime The length of a simulation step, in seconds.
 void 
 processKeys (float deltaTime);
 
+/// \brief Turns and zooms the camera by however much the mouse has moved,
+///   and fits it to the window's shape.  This should be called for every
+///   simulation step.
+void
+processMouse ();
+
 /// \brief Cleans up all resources as program exits.
 void
 releaseGlResources ();
@@ -204,52 +351,190 @@ outputGlfwError (int error, const char* description);
 /******************************************************************/
 
 /// \brief Runs our program.
-/// \param[in] argc The number of command-line arguments, which we ignore.
-/// \param[in] argv The array of command-line-arguments, which we ignore.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The command-line arguments: --serial updates and draws on
+///   one thread, --profile prints how long frames take, --indirect draws
+///   each kind of untextured Mesh with one multi-draw indirect call,
+///   --record prepares draws on worker threads, and --occlude skips Meshes
+///   hidden behind walls.
 int
 main (int argc, char* argv[])
 {
+  bool isSerial = false;
+  bool isProfiling = false;
+  bool isIndirect = false;
+  bool isRecording = false;
+  bool isOccluding = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string argument (argv[i]);
+    if (argument == "--serial")
+      isSerial = true;
+    else if (argument == "--profile")
+      isProfiling = true;
+    else if (argument == "--indirect")
+      isIndirect = true;
+    else if (argument == "--record")
+      isRecording = true;
+    else if (argument == "--occlude")
+      isOccluding = true;
+    else
+      fprintf (stderr, "Ignoring unknown argument %s\n", argv[i]);
+  }
+
   GLFWwindow* window;
-  init (window);
+  init (window, isProfiling, isIndirect, isRecording, isOccluding);
+
+  if (isSerial)
+    runSerial (window);
+  else
+    runPipelined (window);
+
+  releaseGlResources ();
+  // Destroying the window destroys the OpenGL context
+  glfwDestroyWindow (window);
+  glfwTerminate ();
+
+  return EXIT_SUCCESS;
+}
+
+/******************************************************************/
 
+void
+runSerial (GLFWwindow* window)
+{
   // Game/render loop
+  // The Scene is simulated in fixed steps, so that it behaves the same at any
+  //   frame rate, and drawn between the last two steps.
+  FixedTimestep timestep (SIMULATION_STEPS_PER_SECOND, MAX_STEPS_PER_FRAME);
+  float stepTime = static_cast<float> (timestep.getStepSeconds ());
   double previousTime = glfwGetTime ();
   while (!glfwWindowShouldClose (window))
   {
     double currentTime = glfwGetTime ();
-    // Compute frame times, which we can use later for frame rate computation,
-    //   animation, and physics.
     double deltaTime = currentTime - previousTime;
     previousTime = currentTime;
-    updateScene (deltaTime);
-    drawScene (window);
     // Process events in the event queue, which results in callbacks
     //   being invoked.
     glfwPollEvents ();
-    processKeys(deltaTime);
+    unsigned steps = timestep.advance (deltaTime);
+    for (unsigned step = 0; step < steps; ++step)
+      stepScene (stepTime);
+    drawScene (window, timestep.getInterpolation ());
   }
+}
 
-  releaseGlResources ();
-  // Destroying the window destroys the OpenGL context
-  glfwDestroyWindow (window);
-  glfwTerminate ();
+/******************************************************************/
 
-  return EXIT_SUCCESS;
+void
+runPipelined (GLFWwindow* window)
+{
+  // The render thread always has a frame to draw, even before the simulation
+  //   thread publishes its first.
+  publishFrame (glfwGetTime (), 1.0 / SIMULATION_STEPS_PER_SECOND);
+  g_isSimulating = true;
+  std::thread simulation (simulate);
+
+  // Render loop
+  // While this thread draws one frame, the simulation thread computes the
+  //   next, so a frame takes as long as the slower of the two instead of
+  //   both.
+  while (!glfwWindowShouldClose (window))
+  {
+    glfwPollEvents ();
+    const FrameState& frame = g_frames->getFront ();
+    double sinceFrame = glfwGetTime () - frame.time;
+    float interpolation = static_cast<float> (
+      std::min (std::max (sinceFrame / frame.stepSeconds, 0.0), 1.0));
+    drawFrame (window, frame, interpolation);
+  }
+
+  g_isSimulating = false;
+  simulation.join ();
+}
+
+/******************************************************************/
+
+void
+simulate ()
+{
+  FixedTimestep timestep (SIMULATION_STEPS_PER_SECOND, MAX_STEPS_PER_FRAME);
+  float stepTime = static_cast<float> (timestep.getStepSeconds ());
+  // glfwGetTime may be called from any thread.
+  double previousTime = glfwGetTime ();
+  while (g_isSimulating)
+  {
+    double currentTime = glfwGetTime ();
+    unsigned steps = timestep.advance (currentTime - previousTime);
+    previousTime = currentTime;
+    for (unsigned step = 0; step < steps; ++step)
+      stepScene (stepTime);
+    if (steps > 0)
+    {
+      // The Scene reached this state when the accumulator last held nothing.
+      double stateTime = currentTime
+        - timestep.getInterpolation () * timestep.getStepSeconds ();
+      publishFrame (stateTime, timestep.getStepSeconds ());
+    }
+    // Sleep until the next step is due.
+    std::this_thread::sleep_for (std::chrono::duration<double> (
+      (1.0 - timestep.getInterpolation ()) * timestep.getStepSeconds ()));
+  }
 }
 
 /******************************************************************/
 
 void
-init (GLFWwindow*& window)
+stepScene (float time)
+{
+  auto start = std::chrono::steady_clock::now ();
+  (*g_currentScene)->storePreviousWorlds ();
+  processMouse ();
+  processKeys (time);
+  updateScene (time);
+  g_simulationNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds> (
+    std::chrono::steady_clock::now () - start).count ();
+}
+
+/******************************************************************/
+
+void
+publishFrame (double time, double stepSeconds)
+{
+  FrameState& frame = g_frames->getBack ();
+  // Bring the view matrix and its update count up to date, so that the render
+  //   thread's copy can tell whether the camera moved.
+  g_camera->getViewMatrix ();
+  frame.camera = *g_camera;
+  (*g_currentScene)->capture (frame);
+  frame.time = time;
+  frame.stepSeconds = stepSeconds;
+  g_frames->publish ();
+}
+
+/******************************************************************/
+
+void
+init (GLFWwindow*& window, bool isProfiling, bool isIndirect,
+      bool isRecording, bool isOccluding)
 {
   g_context = new RealOpenGLContext ();
+  g_recordingContext = nullptr;
+  g_drawJobs = isRecording || isOccluding ? new JobSystem () : nullptr;
+  if (isProfiling)
+  {
+    g_recordingContext = new RecordingOpenGLContext (g_context);
+    g_context = g_recordingContext;
+  }
   // Always initialize GLFW before GLEW
   initGlfw ();
-  initWindow (window);
+  initWindow (window, !isProfiling);
   initGlew ();
-  initShaders ();
+  initShaders (isIndirect);
   initCamera ();
-  initScene ();
+  initScene (isRecording, isOccluding);
+  if (isProfiling)
+    reportIndexSizes ();
 }
 
 /******************************************************************/
@@ -268,7 +553,7 @@ initGlfw ()
 /******************************************************************/
 
 void
-initWindow (GLFWwindow*& window)
+initWindow (GLFWwindow*& window, bool isVsynced)
 {
   glfwWindowHint (GLFW_CONTEXT_VERSION_MAJOR, 3);
   glfwWindowHint (GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -287,8 +572,8 @@ initWindow (GLFWwindow*& window)
   glfwSetWindowPos (window, 100, 100);
 
   glfwMakeContextCurrent (window);
-  // Swap buffers after 1 frame
-  glfwSwapInterval (1);
+  // Swap buffers after 1 frame, unless frames are being timed
+  glfwSwapInterval (isVsynced ? 1 : 0);
   glfwSetKeyCallback (window, recordKeys);
   glfwSetMouseButtonCallback(window, recordMouseKeys);
   glfwSetScrollCallback(window, processScrollWheel);
@@ -339,13 +624,15 @@ resetViewport (GLFWwindow* window, int width, int height)
   // Render into entire window
   // Origin for window coordinates is lower-left of window
   g_context->viewport (0, 0, width, height);
-  g_camera->setProjectionSymmetricPerspective(60, ((double) width) / height, 0.01, 90.0);
+  // The simulation owns the camera, so it applies the new shape.
+  if (height > 0)
+    g_aspectRatio = static_cast<double> (width) / height;
 }
 
 /******************************************************************/
 
 void
-initScene ()
+initScene (bool isRecording, bool isOccluding)
 {
   // Create new MyScene and assign it to global scene.
   g_scene.push_back (new Pong2DScene(g_context, g_colorShaderProgram, g_normalShaderProgram));
@@ -353,6 +640,24 @@ initScene ()
   g_scene.push_back (new PhysicsScene(g_context, g_colorShaderProgram, g_normalShaderProgram));
   g_scene.push_back (new MyScene(g_context, g_colorShaderProgram, g_normalShaderProgram));
   g_currentScene = g_scene.begin();
+  (*g_currentScene)->storePreviousWorlds ();
+  if (g_indirectNormalShaderProgram != nullptr)
+  {
+    for (Scene* scene : g_scene)
+    {
+      scene->setIndirectProgram (g_colorShaderProgram,
+                                 g_indirectColorShaderProgram);
+      scene->setIndirectProgram (g_normalShaderProgram,
+                                 g_indirectNormalShaderProgram);
+    }
+  }
+  for (Scene* scene : g_scene)
+  {
+    if (isRecording)
+      scene->setRecordingJobs (g_drawJobs);
+    if (isOccluding)
+      scene->setOcclusionCulling (true, g_drawJobs);
+  }
 
   // Create new KeyBuffer and assign it to global keyBuffer.
   g_keyBuffer = new KeyBuffer();
@@ -364,7 +669,7 @@ initScene ()
 /******************************************************************/
 
 void
-initShaders ()
+initShaders (bool isIndirect)
 {
   // Create shader programs, which consist of linked shaders.
   // No need to use the program until we draw or set uniform variables.
@@ -377,6 +682,69 @@ initShaders ()
   g_normalShaderProgram->createVertexShader ("Shaders/PhongShader.vert");
   g_normalShaderProgram->createFragmentShader ("Shaders/PhongShader.frag");
   g_normalShaderProgram->link ();
+
+  // Block bindings and sampler units never change, so they are set once here
+  //   rather than every time something is drawn.
+  for (ShaderProgram* program : { g_colorShaderProgram, g_normalShaderProgram })
+  {
+    program->bindUniformBlock ("FrameBlock", FRAME_BLOCK_BINDING);
+    program->bindUniformBlock ("MaterialBlock", MATERIAL_BLOCK_BINDING);
+    program->bindUniformBlock ("ObjectBlock", OBJECT_BLOCK_BINDING);
+  }
+  g_normalShaderProgram->enable ();
+  g_normalShaderProgram->setUniformInt ("uDiffuseSampler", 0);
+  g_normalShaderProgram->setUniformInt ("uClusterLights", CLUSTER_LIGHTS_UNIT);
+  g_normalShaderProgram->setUniformInt ("uClusterGrid", CLUSTER_GRID_UNIT);
+  g_normalShaderProgram->setUniformInt ("uClusterIndices",
+                                        CLUSTER_INDICES_UNIT);
+  g_normalShaderProgram->disable ();
+
+  g_indirectColorShaderProgram = nullptr;
+  g_indirectNormalShaderProgram = nullptr;
+  if (!isIndirect)
+    return;
+  // Indirect commands only honor baseInstance, which picks each Mesh's
+  //   object, from OpenGL 4.2 on.
+  if (!GLEW_VERSION_4_3
+      && !(GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance))
+  {
+    fprintf (stderr, "Multi-draw indirect is not supported; ignoring"
+             " --indirect.\n");
+    return;
+  }
+  const std::string DEFINES = "#define INDIRECT_DRAW\n";
+  g_indirectColorShaderProgram = new ShaderProgram (g_context);
+  g_indirectColorShaderProgram->createVertexShader ("Shaders/Vec3.vert",
+                                                    DEFINES);
+  g_indirectColorShaderProgram->createFragmentShader ("Shaders/Vec3.frag",
+                                                      DEFINES);
+  g_indirectColorShaderProgram->link ();
+
+  g_indirectNormalShaderProgram = new ShaderProgram (g_context);
+  g_indirectNormalShaderProgram->createVertexShader (
+    "Shaders/PhongShader.vert", DEFINES);
+  g_indirectNormalShaderProgram->createFragmentShader (
+    "Shaders/PhongShader.frag", DEFINES);
+  g_indirectNormalShaderProgram->link ();
+
+  for (ShaderProgram* program : { g_indirectColorShaderProgram,
+                                  g_indirectNormalShaderProgram })
+  {
+    program->bindUniformBlock ("FrameBlock", FRAME_BLOCK_BINDING);
+    program->enable ();
+    program->setUniformInt ("uObjects", INDIRECT_OBJECTS_UNIT);
+    program->disable ();
+  }
+  g_indirectNormalShaderProgram->enable ();
+  g_indirectNormalShaderProgram->setUniformInt ("uMaterials",
+                                                INDIRECT_MATERIALS_UNIT);
+  g_indirectNormalShaderProgram->setUniformInt ("uClusterLights",
+                                                CLUSTER_LIGHTS_UNIT);
+  g_indirectNormalShaderProgram->setUniformInt ("uClusterGrid",
+                                                CLUSTER_GRID_UNIT);
+  g_indirectNormalShaderProgram->setUniformInt ("uClusterIndices",
+                                                CLUSTER_INDICES_UNIT);
+  g_indirectNormalShaderProgram->disable ();
 }
 
 /******************************************************************/
@@ -398,6 +766,8 @@ initCamera ()
 
   // Create camera object given the above variables.
   g_camera = new Camera (position, back, nearZ, farZ, aspectRatio, verticalFov);
+  g_drawCamera = new Camera (*g_camera);
+  g_frames = new TripleBuffer<FrameState> (FrameState (*g_camera));
 }
 
 /******************************************************************/
@@ -411,30 +781,111 @@ updateScene (double time)
 /******************************************************************/
 
 void
-drawScene (GLFWwindow* window)
+drawScene (GLFWwindow* window, float interpolation)
 {
+  auto start = std::chrono::steady_clock::now ();
   g_context->clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   //Draw everything in the scene.
-  (*g_currentScene)->draw(g_camera->getViewMatrix(), g_camera->getProjectionMatrix(), g_camera->getPosition());
+  (*g_currentScene)->draw(g_camera, interpolation);
+  std::chrono::duration<double> renderTime = std::chrono::steady_clock::now () - start;
 
   // Swap the front and back buffers.
   // We draw to the back buffer, which is then swapped with the front
   //   for display.
   glfwSwapBuffers (window);
+  reportStatistics (renderTime.count (), *g_currentScene);
 }
 
+/******************************************************************/
+
+void
+drawFrame (GLFWwindow* window, const FrameState& frame, float interpolation)
+{
+  auto start = std::chrono::steady_clock::now ();
+  g_context->clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  // Draw the frame through a camera of our own, which keeps the same address
+  //   from frame to frame so the Scene can tell when it moves.
+  *g_drawCamera = frame.camera;
+  frame.scene->draw(g_drawCamera, frame, interpolation);
+  std::chrono::duration<double> renderTime = std::chrono::steady_clock::now () - start;
+
+  glfwSwapBuffers (window);
+  reportStatistics (renderTime.count (), frame.scene);
+}
 
 /******************************************************************/
 
 void
-processScrollWheel (GLFWwindow* window, double xoffset, double yoffset) 
+reportStatistics (double renderSeconds, const Scene* scene)
+{
+  if (g_recordingContext == nullptr)
+    return;
+
+  static double reportTime = glfwGetTime ();
+  static unsigned frames = 0;
+  static double totalRenderSeconds = 0.0;
+  ++frames;
+  totalRenderSeconds += renderSeconds;
+
+  double now = glfwGetTime ();
+  if (now - reportTime >= 1.0)
+  {
+    double perFrame = 1000.0 / frames;
+    double updateSeconds = g_simulationNanoseconds.exchange (0) * 1e-9;
+    fprintf (stderr, "%u frames: %.3f ms/frame, update %.3f ms/frame, render %.3f ms/frame (%.3f ms in %lu OpenGL calls, %lu draws, %lu indirect commands)\n",
+             frames, (now - reportTime) * perFrame, updateSeconds * perFrame,
+             totalRenderSeconds * perFrame,
+             g_recordingContext->getSeconds () * perFrame,
+             g_recordingContext->getCallCount () / frames,
+             g_recordingContext->getDrawCallCount () / frames,
+             g_recordingContext->getIndirectCommandCount () / frames);
+    const OcclusionCuller::Stats& occlusion = scene->getOcclusionStats ();
+    if (occlusion.occluders > 0)
+      fprintf (stderr, "  occlusion: %u of %u meshes hidden by %u occluders (%u triangles), %.3f ms setup, %.3f ms rasterize, %.3f ms test\n",
+               occlusion.occluded, occlusion.tested, occlusion.occluders,
+               occlusion.triangles, occlusion.setupMilliseconds,
+               occlusion.rasterizeMilliseconds, occlusion.testMilliseconds);
+    g_recordingContext->resetStatistics ();
+    reportTime = now;
+    frames = 0;
+    totalRenderSeconds = 0.0;
+  }
+}
+
+
+void
+reportIndexSizes ()
 {
-  if (1 < (g_camera->getFOV()) + yoffset && (g_camera->getFOV() + yoffset) < 120)
+  size_t totalBytes = 0;
+  size_t totalSaved = 0;
+  for (const Scene* scene : g_scene)
   {
-    g_camera->setFOV(g_camera->getFOV() + yoffset);
-    g_camera->setProjectionSymmetricPerspective(g_camera->getFOV(), 16.0 / 9.0, 0.01, 90.0);
+    for (auto const& it : scene->getMeshes ())
+    {
+      const Mesh* mesh = it.second;
+      size_t bytes = mesh->getIndexBufferSize ();
+      size_t saved = mesh->getIndices ().size () * sizeof (GLuint) - bytes;
+      fprintf (stderr, "%-24s %8zu indices, %2d-bit, %9zu bytes, %9zu saved\n",
+               it.first.c_str (), mesh->getIndices ().size (),
+               mesh->getIndexType () == GL_UNSIGNED_SHORT ? 16 : 32, bytes,
+               saved);
+      totalBytes += bytes;
+      totalSaved += saved;
+    }
   }
+  fprintf (stderr, "Index buffers: %zu bytes, %zu saved by 16-bit indices\n",
+           totalBytes, totalSaved);
+}
+
+/******************************************************************/
+
+void
+processScrollWheel (GLFWwindow* window, double xoffset, double yoffset) 
+{
+  // The simulation owns the camera, so it applies the zoom.
+  g_mouseBuffer->addScroll(yoffset);
 }
 
 void
@@ -467,20 +918,8 @@ recordMouseKeys (GLFWwindow* window, int button, int action, int mods)
 void
 recordMousePosition (GLFWwindow* window, double xpos, double ypos)
 {
-  double deltaX = xpos - g_mouseBuffer->getX();
-  double deltaY = ypos - g_mouseBuffer->getY();
-  float sensitivity = 0.2;
-
+  // The simulation owns the camera, so it turns it in processMouse.
   g_mouseBuffer->setPosition(xpos, ypos);
-
-  if (g_mouseBuffer->getLeftButton()) 
-  {
-    g_camera->yaw(-deltaX * sensitivity);
-    g_camera->pitch(-deltaY * sensitivity);
-  }
-  else if (g_mouseBuffer->getRightButton()) {
-    g_camera->roll(deltaX * sensitivity);
-  }
 }
 
 void
@@ -503,6 +942,38 @@ recordKeys (GLFWwindow* window, int key, int scanCode, int action,
     g_keyBuffer->setKeyUp(key);
 }
 
+void
+processMouse ()
+{
+  double x = g_mouseBuffer->getX();
+  double y = g_mouseBuffer->getY();
+  double deltaX = x - g_lookX;
+  double deltaY = y - g_lookY;
+  float sensitivity = 0.2;
+  g_lookX = x;
+  g_lookY = y;
+
+  if (g_mouseBuffer->getLeftButton()) 
+  {
+    g_camera->yaw(-deltaX * sensitivity);
+    g_camera->pitch(-deltaY * sensitivity);
+  }
+  else if (g_mouseBuffer->getRightButton()) {
+    g_camera->roll(deltaX * sensitivity);
+  }
+
+  double scroll = g_mouseBuffer->takeScroll();
+  double fov = g_camera->getFOV();
+  if (1 < fov + scroll && fov + scroll < 120)
+    fov += scroll;
+  double aspectRatio = g_aspectRatio;
+  if (fov != g_camera->getFOV() || aspectRatio != g_cameraAspectRatio)
+  {
+    g_cameraAspectRatio = aspectRatio;
+    g_camera->setProjectionSymmetricPerspective(fov, aspectRatio, 0.01, 90.0);
+  }
+}
+
 void 
 processKeys (float deltaTime)
 {
@@ -584,6 +1055,7 @@ processKeys (float deltaTime)
     }
     g_keyBuffer->setKeyUp(GLFW_KEY_MINUS);
     (*g_currentScene)->resetCamera(g_camera);
+    (*g_currentScene)->storePreviousWorlds();
   }
   if (g_keyBuffer->isKeyDown(GLFW_KEY_EQUAL)) {
     ++g_currentScene;
@@ -593,6 +1065,7 @@ processKeys (float deltaTime)
     }
     g_keyBuffer->setKeyUp(GLFW_KEY_EQUAL);
     (*g_currentScene)->resetCamera(g_camera);
+    (*g_currentScene)->storePreviousWorlds();
   }
 
   (*g_currentScene)->processKeys(g_keyBuffer, deltaTime);
@@ -659,8 +1132,13 @@ releaseGlResources ()
   delete g_keyBuffer;
   delete g_mouseBuffer;
   delete g_camera;
+  delete g_drawCamera;
+  delete g_frames;
   delete g_colorShaderProgram;
   delete g_normalShaderProgram;
+  delete g_indirectColorShaderProgram;
+  delete g_indirectNormalShaderProgram;
+  delete g_drawJobs;
   delete g_context;
 }
 
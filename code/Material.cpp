@@ -19,13 +19,47 @@ Material::~Material(){
 
 }
 
+MaterialUniforms
+Material::getUniforms() const
+{
+  MaterialUniforms block = {};
+  copyToBlock(block.ambientReflection, m_ambient);
+  copyToBlock(block.diffuseReflection, m_diffuse);
+  copyToBlock(block.specularReflection, m_specular);
+  copyToBlock(block.emissiveIntensity, m_emmissiveIntensity);
+  block.specularPower = m_specularPower;
+  return block;
+}
+
+void
+Material::bind(OpenGLContext* context)
+{
+  upload(context);
+  bindUploaded(context);
+}
+
 void
-Material::setUniforms(ShaderProgram* shader){
-    shader->setUniformVector("uAmbientReflection", m_ambient);
-    shader->setUniformVector("uDiffuseReflection", m_diffuse);
-    shader->setUniformVector("uSpecularReflection", m_specular);
-    shader->setUniformFloat("uSpecularPower", m_specularPower);
-    shader->setUniformVector("uEmissiveIntensity", m_emmissiveIntensity);
+Material::upload(OpenGLContext* context)
+{
+  MaterialUniforms block = getUniforms();
+
+  if (!m_buffer)
+  {
+    m_buffer.reset(new UniformBuffer(context, sizeof(MaterialUniforms)));
+    m_buffer->update(&block, sizeof(block));
+    m_uploaded = block;
+  }
+  else if (std::memcmp(&block, &m_uploaded, sizeof(block)) != 0)
+  {
+    m_buffer->update(&block, sizeof(block));
+    m_uploaded = block;
+  }
+}
+
+void
+Material::bindUploaded(OpenGLContext* context) const
+{
+  m_buffer->bind(context, MATERIAL_BLOCK_BINDING);
 }
 
 void
@@ -6,8 +6,11 @@
 #ifndef MATERIAL_HPP
 #define MATERIAL_HPP
 
+#include <memory>
+
 #include "Vector3.hpp"
-#include "ShaderProgram.hpp"
+#include "UniformBlocks.hpp"
+#include "UniformBuffer.hpp"
 
 class Material
 {
@@ -20,10 +23,37 @@ public:
   ~Material ();
 
   void
-  setUniforms(ShaderProgram* shader);
+  setToGold();
 
+  /// \brief Lays this material out as the MaterialBlock uniform block
+  ///   expects, which is also how the "uMaterials" texture buffer holds it.
+  /// \return The block's contents.
+  MaterialUniforms
+  getUniforms() const;
+
+  /// \brief Attaches this material's uniform buffer to the MaterialBlock
+  ///   binding point, creating or refreshing the buffer first if needed.
+  /// The buffer is only rewritten when a member has changed since the last
+  ///   call, so materials shared by many meshes cost one upload in total.
+  /// \param context The context to make OpenGL calls through.
   void
-  setToGold();
+  bind(OpenGLContext* context);
+
+  /// \brief Creates this material's uniform buffer, or refreshes it if a
+  ///   member has changed since the last upload.
+  /// \param context The context to make OpenGL calls through, which must be
+  ///   one that can create buffers.
+  void
+  upload(OpenGLContext* context);
+
+  /// \brief Attaches the uniform buffer to the MaterialBlock binding point
+  ///   without touching its contents, so that meshes sharing this material
+  ///   may record the call on several threads at once.
+  /// \param context The context, such as a CommandList, to make the call
+  ///   through.
+  /// \pre upload has been called since the material last changed.
+  void
+  bindUploaded(OpenGLContext* context) const;
 
   Vector3 m_ambient;
 
@@ -35,6 +65,11 @@ public:
 
   float m_specularPower;
 
+private:
+  /// Lazily created buffer that backs the MaterialBlock uniform block.
+  std::unique_ptr<UniformBuffer> m_buffer;
+  /// The values most recently copied into m_buffer.
+  MaterialUniforms m_uploaded;
 };
 
 #endif//MATERIAL_HPP
\ No newline at end of file
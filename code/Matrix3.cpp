@@ -42,11 +42,6 @@ Matrix3::Matrix3 (const Vector3& up, const Vector3& back,
   }
 }
 
-Matrix3::~Matrix3 ()
-{
-
-}
-
 void
 Matrix3::setToIdentity ()
 {
@@ -10,7 +10,9 @@
 #include <iostream>
 //For sin cos and radians
 #include <math.h> 
+#include <type_traits>
 
+#include "Aligned16.hpp"
 #include "Vector3.hpp"
 
 /// \brief A 3x3 matrix of floats.
@@ -62,9 +64,6 @@ public:
   Matrix3 (const Vector3& up, const Vector3& back,
            bool makeOrthonormal = false);
 
-  /// \brief Destructs a matrix.
-  virtual ~Matrix3 ();
-  
   /// \brief Sets this to the identity matrix.
   /// \post rx, uy, and bz are 1.0f while all other elements are 0.0f.
   void
@@ -345,4 +344,19 @@ bool
 operator== (const Matrix3& m1, const Matrix3& m2);
 
 
+// With no virtual destructor there is no vtable pointer, so a Matrix3 is 36
+//   bytes instead of 48.
+static_assert (std::is_trivially_copyable<Matrix3>::value
+               && std::is_standard_layout<Matrix3>::value,
+               "Matrix3 must be copyable as bytes");
+static_assert (sizeof (Matrix3) == 3 * sizeof (Vector3),
+               "Matrix3 must hold nothing but its three columns");
+
+/// \brief A Matrix3 on a 16-byte boundary.
+using AlignedMatrix3 = Aligned16<Matrix3>;
+
+static_assert (sizeof (AlignedMatrix3) == 48
+               && std::is_trivially_copyable<AlignedMatrix3>::value,
+               "AlignedMatrix3 must be Matrix3 padded to 16 bytes");
+
 #endif//MATRIX3_HPP
\ No newline at end of file
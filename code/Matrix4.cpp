@@ -68,6 +68,74 @@ Matrix4::data () const
   return &(m_right.m_x);
 }
 
+void
+Matrix4::invert ()
+{
+  const float* m = data();
+  float inv[16];
+
+  // Cofactors of the transposed matrix (the adjugate), in column-major order.
+  inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15]
+         + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+  inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15]
+         - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+  inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15]
+         + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+  inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14]
+          - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+  inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15]
+         - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+  inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15]
+         + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+  inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15]
+         - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+  inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14]
+          + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+  inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15]
+         + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+  inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15]
+         - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+  inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15]
+          + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+  inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14]
+          - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+  inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11]
+         - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+  inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11]
+         + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+  inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11]
+          - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+  inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10]
+          + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+  float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+
+  // No inverse case, do not find inverse
+  if (det == 0) return;
+
+  float s = 1.0f / det;
+  m_right.set       (inv[0] * s, inv[1] * s, inv[2] * s, inv[3] * s);
+  m_up.set          (inv[4] * s, inv[5] * s, inv[6] * s, inv[7] * s);
+  m_back.set        (inv[8] * s, inv[9] * s, inv[10] * s, inv[11] * s);
+  m_translation.set (inv[12] * s, inv[13] * s, inv[14] * s, inv[15] * s);
+}
+
+Matrix4&
+Matrix4::operator*= (const Matrix4& m)
+{
+  // Each column of the product is this matrix times a column of m.
+  Vector4 r = (*this) * m.m_right;
+  Vector4 u = (*this) * m.m_up;
+  Vector4 b = (*this) * m.m_back;
+  Vector4 t = (*this) * m.m_translation;
+
+  m_right = r;
+  m_up = u;
+  m_back = b;
+  m_translation = t;
+  return *this;
+}
+
 void
 Matrix4::setToPerspectiveProjection (double fovYDegrees, double aspectRatio,
           double nearPlaneZ, double farPlaneZ)
@@ -116,6 +184,21 @@ Matrix4::setToOrthographicProjection (double left, double right,
   m_translation.m_w = 1.0f;
 }
 
+Matrix4
+operator* (const Matrix4& m1, const Matrix4& m2)
+{
+  Matrix4 copy = m1;
+  copy *= m2;
+  return copy;
+}
+
+Vector4
+operator* (const Matrix4& m, const Vector4& v)
+{
+  return m.getRight() * v.m_x + m.getUp() * v.m_y
+       + m.getBack() * v.m_z + m.getTranslation() * v.m_w;
+}
+
 std::ostream&
 operator<< (std::ostream& out, const Matrix4& m)
 {
@@ -9,8 +9,10 @@
 // For overload of shift operator.
 #include <iostream>
 #include <math.h> 
+#include <type_traits>
 
 // Local includes.
+#include "Aligned16.hpp"
 #include "Vector4.hpp"
 
 /// \brief A 4x4 matrix of floats.
@@ -75,6 +77,20 @@ public:
   const float*
   data () const;
 
+  /// \brief Inverts this matrix.
+  /// Uses the full cofactor expansion, so it also works for projections.
+  /// \post If this matrix was invertible it contains its inverse; otherwise
+  ///   it is unchanged.
+  void
+  invert ();
+
+  /// \brief Multiplies this matrix by another one.
+  /// \param[in] m The matrix to multiply by.
+  /// \return This matrix.
+  /// \post This matrix contains the product of itself with m.
+  Matrix4&
+  operator*= (const Matrix4& m);
+
   // For the projection methods, do all computations using
   //   double-s and only cast to float when NECESSARY. 
 
@@ -125,6 +141,20 @@ private:
   Vector4 m_translation;
 };
 
+/// \brief Multiplies two matrices.
+/// \param[in] m1 The left matrix.
+/// \param[in] m2 The right matrix.
+/// \return A new matrix that is m1 * m2.
+Matrix4
+operator* (const Matrix4& m1, const Matrix4& m2);
+
+/// \brief Transforms a vector by a matrix.
+/// \param[in] m A matrix.
+/// \param[in] v A (column) vector.
+/// \return A new vector that is m * v.
+Vector4
+operator* (const Matrix4& m, const Vector4& v);
+
 /// \brief Inserts a matrix into an output stream.
 /// Each element of the matrix should have 2 digits of precision and a field
 ///   width of 10.  Elements should be in this order:
@@ -148,4 +178,17 @@ operator<< (std::ostream& out, const Matrix4& m);
 bool
 operator== (const Matrix4& m1, const Matrix4& m2);
 
+static_assert (std::is_trivially_copyable<Matrix4>::value
+               && std::is_standard_layout<Matrix4>::value,
+               "Matrix4 must be copyable as bytes");
+static_assert (sizeof (Matrix4) == 4 * sizeof (Vector4),
+               "Matrix4 must hold nothing but its four columns");
+
+/// \brief A Matrix4 on a 16-byte boundary.
+using AlignedMatrix4 = Aligned16<Matrix4>;
+
+static_assert (sizeof (AlignedMatrix4) == 64
+               && std::is_trivially_copyable<AlignedMatrix4>::value,
+               "AlignedMatrix4 must be Matrix4 padded to 16 bytes");
+
 #endif//MATRIX4_HPP
\ No newline at end of file
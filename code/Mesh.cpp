@@ -3,11 +3,20 @@
 /// \author Justin Stevens
 /// \version A09
 
+#include <algorithm>
+
 #include "Mesh.hpp"
 #include "Geometry.hpp"
+#include "QuaternionTransform.hpp"
 #include "ShaderProgram.hpp"
 
 Mesh::Mesh (OpenGLContext* context, ShaderProgram* shaderProgram) 
+  : m_indexType(GL_UNSIGNED_INT), m_material(nullptr), m_isStatic(false),
+    m_isOccluder(false), m_interpolation(1.0f),
+    m_isWorldDirty(true),
+    m_worldUpdateCount(0),
+    m_objectBuffer(context, sizeof(ObjectUniforms)), m_objectWorldCount(0),
+    m_objectHasTexture(false)
 {
   m_context = context;
 
@@ -20,7 +29,12 @@ Mesh::Mesh (OpenGLContext* context, ShaderProgram* shaderProgram)
 }
 
 Mesh::Mesh (OpenGLContext* context, ShaderProgram* shaderProgram, Material* material)
-  : m_material(material)
+  : m_indexType(GL_UNSIGNED_INT), m_material(material), m_isStatic(false),
+    m_isOccluder(false), m_interpolation(1.0f),
+    m_isWorldDirty(true),
+    m_worldUpdateCount(0),
+    m_objectBuffer(context, sizeof(ObjectUniforms)), m_objectWorldCount(0),
+    m_objectHasTexture(false)
 {
   m_context = context;
 
@@ -56,38 +70,67 @@ Mesh::prepareVao ()
       m_vertices.data (), GL_STATIC_DRAW);
 
   m_context->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-  m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER, m_indices.size () * sizeof (float),
-      m_indices.data (), GL_STATIC_DRAW);
+  std::vector<std::uint16_t> shortIndices;
+  uploadIndices (shortIndices, GL_STATIC_DRAW);
 
   enableAttributes();
 
   m_context->bindVertexArray (0);
+  updateBounds ();
+}
+
+void
+Mesh::stream (const std::vector<float>& vertices,
+              const std::vector<unsigned>& indices)
+{
+  // Assigned rather than swapped, so both sides keep their capacity from
+  //   frame to frame.
+  m_vertices = vertices;
+  m_indices = indices;
+
+  // The element buffer binding belongs to the VAO, so it is bound first.
+  m_context->bindVertexArray (m_vao);
+  m_context->bindBuffer (GL_ARRAY_BUFFER, m_vbo);
+  m_context->bufferData (GL_ARRAY_BUFFER, m_vertices.size () * sizeof (float),
+      m_vertices.data (), GL_STREAM_DRAW);
+  m_context->bindBuffer (GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+  uploadIndices (m_streamIndices, GL_STREAM_DRAW);
+  m_context->bindVertexArray (0);
+  updateBounds ();
+}
+
+void
+Mesh::draw (Camera* camera) 
+{
+  prepareDraw ();
+  drawThrough (m_context);
+}
+
+void
+Mesh::prepareDraw ()
+{
+  if (m_material != NULL)
+    m_material->upload (m_context);
 }
 
 void
-Mesh::draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPosition) 
+Mesh::drawThrough (OpenGLContext* context)
 {
   // Iterate over each object in scene and draw it
   // The shader program is already enabled, but we do not want to
   //   make that assumption in general.
-  m_shaderProgram->enable ();
+  m_shaderProgram->enable (context);
 
-  Transform modelView = viewMatrix * m_world;
-  m_shaderProgram->setUniformMatrix ("uModelView", modelView.getTransform());
-  m_shaderProgram->setUniformMatrix ("uProjection", projectionMatrix);
-  
-  if (m_material != NULL) {
-    m_material->setUniforms(m_shaderProgram);
-  }
-  m_shaderProgram->setUniformInt("uHasTexture", 0);
+  // The view and projection are in the Scene's FrameBlock.
+  bindUniformBlocks (context, false);
 
   // Draw geometry
-  m_context->bindVertexArray (m_vao);
-  glDrawElements (GL_TRIANGLES, m_indices.size (), GL_UNSIGNED_INT,
+  context->bindVertexArray (m_vao);
+  context->drawElements (GL_TRIANGLES, m_indices.size (), m_indexType,
     reinterpret_cast<void*> (0));
-  m_context->bindVertexArray (0);
+  context->bindVertexArray (0);
 
-  m_shaderProgram->disable ();
+  m_shaderProgram->disable (context);
 }
 
 Transform
@@ -96,6 +139,67 @@ Mesh::getWorld () const
   return m_world;
 }
 
+void
+Mesh::setWorld (const Transform& world)
+{
+  m_world = world;
+}
+
+const Matrix4&
+Mesh::getWorldMatrix () const
+{
+  updateWorld();
+  return m_worldMatrix;
+}
+
+const Matrix3&
+Mesh::getNormalMatrix () const
+{
+  updateWorld();
+  return m_normalMatrix;
+}
+
+unsigned
+Mesh::getWorldUpdateCount () const
+{
+  return m_worldUpdateCount;
+}
+
+void
+Mesh::storePreviousWorld ()
+{
+  m_previousWorld = m_world;
+}
+
+Transform
+Mesh::getPreviousWorld () const
+{
+  return m_previousWorld;
+}
+
+void
+Mesh::setDrawnWorlds (const Transform& previous, const Transform& current,
+                      float interpolation)
+{
+  bool isMoving = !(previous == current);
+  // Meshes that are standing still keep their cached matrices, whatever the
+  //   interpolation.
+  if (!(previous == m_drawnPrevious) || !(current == m_drawnWorld)
+      || (isMoving && interpolation != m_interpolation))
+  {
+    m_drawnPrevious = previous;
+    m_drawnWorld = current;
+    m_interpolation = interpolation;
+    markWorldDirty();
+  }
+}
+
+ShaderProgram*
+Mesh::getShaderProgram () const
+{
+  return m_shaderProgram;
+}
+
 void
 Mesh::moveRight (float distance)
 {
@@ -204,6 +308,106 @@ Mesh::getPosition()
   return m_world.getPosition();
 }
 
+void
+Mesh::bindUniformBlocks (OpenGLContext* context, bool hasTexture)
+{
+  // getWorldMatrix brings the world update count up to date.
+  const Matrix4& world = getWorldMatrix();
+  if (m_objectWorldCount != getWorldUpdateCount()
+      || m_objectHasTexture != hasTexture)
+  {
+    ObjectUniforms block = {};
+    copyToBlock(block.world, world);
+    copyToBlock(block.worldNormal, getNormalMatrix());
+    block.hasTexture = hasTexture;
+    m_objectBuffer.update(context, &block, sizeof(block));
+
+    m_objectWorldCount = getWorldUpdateCount();
+    m_objectHasTexture = hasTexture;
+  }
+  m_objectBuffer.bind(context, OBJECT_BLOCK_BINDING);
+
+  if (m_material != NULL)
+    m_material->bindUploaded(context);
+}
+
+void
+Mesh::markWorldDirty ()
+{
+  m_isWorldDirty = true;
+}
+
+void
+Mesh::updateWorld () const
+{
+  if (m_isWorldDirty)
+  {
+    Transform drawn = m_drawnWorld;
+    if (m_interpolation < 1.0f && !(m_drawnPrevious == m_drawnWorld))
+    {
+      // Blending the orientation matrices directly would shrink and skew a
+      //   spinning Mesh, so the rotation is blended as a quaternion, and the
+      //   scale and position separately.
+      drawn = interpolate(QuaternionTransform(m_drawnPrevious),
+                          QuaternionTransform(m_drawnWorld),
+                          m_interpolation).toTransform();
+    }
+    m_worldMatrix = drawn.getTransform();
+    // Normals need the inverse transpose so that non-uniform scales and
+    //   shears keep them perpendicular to the surface.
+    m_normalMatrix = drawn.getOrientation();
+    m_normalMatrix.invert();
+    m_normalMatrix.transpose();
+
+    m_isWorldDirty = false;
+    ++m_worldUpdateCount;
+  }
+}
+
+void
+Mesh::uploadIndices (std::vector<std::uint16_t>& shortIndices, GLenum usage)
+{
+  // The buffer is sized from the type chosen, so that the draws, which read
+  //   by that type, stay within it.
+  if (narrowIndices (m_indices, shortIndices))
+  {
+    m_indexType = GL_UNSIGNED_SHORT;
+    m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER,
+        shortIndices.size () * sizeof (std::uint16_t), shortIndices.data (),
+        usage);
+  }
+  else
+  {
+    m_indexType = GL_UNSIGNED_INT;
+    m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER,
+        m_indices.size () * sizeof (std::uint32_t), m_indices.data (), usage);
+  }
+}
+
+void
+Mesh::updateBounds ()
+{
+  m_boundsLow = Vector3 (0.0f);
+  m_boundsHigh = Vector3 (0.0f);
+  unsigned floatsPerVertex = getFloatsPerVertex ();
+  for (size_t i = 0; i + 2 < m_vertices.size (); i += floatsPerVertex)
+  {
+    Vector3 position (m_vertices[i], m_vertices[i + 1], m_vertices[i + 2]);
+    if (i == 0)
+    {
+      m_boundsLow = position;
+      m_boundsHigh = position;
+      continue;
+    }
+    m_boundsLow.m_x = std::min (m_boundsLow.m_x, position.m_x);
+    m_boundsLow.m_y = std::min (m_boundsLow.m_y, position.m_y);
+    m_boundsLow.m_z = std::min (m_boundsLow.m_z, position.m_z);
+    m_boundsHigh.m_x = std::max (m_boundsHigh.m_x, position.m_x);
+    m_boundsHigh.m_y = std::max (m_boundsHigh.m_y, position.m_y);
+    m_boundsHigh.m_z = std::max (m_boundsHigh.m_z, position.m_z);
+  }
+}
+
 /// \brief Adds additional triangles to this Mesh.
 /// \param[in] indices A collection of indices into the vertex buffer for 1
 ///   or more triangles.  There must be 3 indices per triangle.
@@ -224,6 +428,88 @@ Mesh::getFloatsPerVertex () const
   return 6;
 }
 
+VertexLayout
+Mesh::getVertexLayout () const
+{
+  // Positions, then colors.
+  return VertexLayout { 3, -1, -1 };
+}
+
+const Texture*
+Mesh::getTexture () const
+{
+  return nullptr;
+}
+
+const std::vector<float>&
+Mesh::getVertices () const
+{
+  return m_vertices;
+}
+
+const std::vector<unsigned>&
+Mesh::getIndices () const
+{
+  return m_indices;
+}
+
+GLenum
+Mesh::getIndexType () const
+{
+  return m_indexType;
+}
+
+size_t
+Mesh::getIndexBufferSize () const
+{
+  return m_indices.size ()
+    * (m_indexType == GL_UNSIGNED_SHORT ? sizeof (std::uint16_t)
+                                        : sizeof (std::uint32_t));
+}
+
+const Material*
+Mesh::getMaterial () const
+{
+  return m_material;
+}
+
+void
+Mesh::setStatic (bool isStatic)
+{
+  m_isStatic = isStatic;
+}
+
+bool
+Mesh::isStatic () const
+{
+  return m_isStatic;
+}
+
+void
+Mesh::setOccluder (bool isOccluder)
+{
+  m_isOccluder = isOccluder;
+}
+
+bool
+Mesh::isOccluder () const
+{
+  return m_isOccluder;
+}
+
+void
+Mesh::getLocalBounds (Vector3& low, Vector3& high) const
+{
+  low = m_boundsLow;
+  high = m_boundsHigh;
+}
+
+Mesh*
+Mesh::createEmpty () const
+{
+  return new Mesh(m_context, m_shaderProgram, m_material);
+}
+
 /// \brief Enables VAO attributes.
 /// \pre This Mesh's VAO has been bound.
 /// \post Any attributes (positions, colors, normals, texture coordinates)
@@ -6,6 +6,7 @@
 #ifndef MESH_HPP
 #define MESH_HPP
 
+#include <cstdint>
 #include <vector>
 
 #include "OpenGLContext.hpp"
@@ -14,6 +15,21 @@
 #include "Vector3.hpp"
 #include "Matrix4.hpp"
 #include "Material.hpp"
+#include "Camera.hpp"
+#include "UniformBlocks.hpp"
+#include "UniformBuffer.hpp"
+
+class Texture;
+
+/// \brief Where each attribute starts within one vertex of a Mesh's
+///   geometry, in floats.  Positions always start at 0, and an attribute the
+///   vertices do not have is at -1.
+struct VertexLayout
+{
+  int colorOffset;
+  int normalOffset;
+  int uvOffset;
+};
 
 /// \brief An object that exists in the world, which consists of one or more
 ///   3-D triangles.
@@ -72,22 +88,106 @@ public:
   void
   prepareVao ();
 
+  /// \brief Replaces this Mesh's geometry and indices, as a Mesh rebuilt every
+  ///   frame does.
+  /// The buffers are re-specified with GL_STREAM_DRAW rather than written in
+  ///   place, so that the driver can hand out fresh storage while the GPU may
+  ///   still be reading the last frame's.
+  /// \param[in] vertices The new vertex data, laid out as getVertexLayout says.
+  /// \param[in] indices The new indices, 3 per triangle.
+  /// \pre This Mesh has been prepared.
+  void
+  stream (const std::vector<float>& vertices,
+          const std::vector<unsigned>& indices);
+
   /// \brief Draws this Mesh in OpenGL.
-  /// \param[in] viewMatrix The view matrix that should be used by itself as
-  ///   the model-view matrix (there is not yet any model part).
-  /// \param[in] projectionMatrix The projection matrix that should be used when drawing
-  ///   the Scene.
+  /// \param[in] camera The camera the Scene is being viewed through.
   /// \pre This Mesh has been prepared.
-  /// \post While the ShaderProgram was enabled, the viewMatrix has been set as
-  ///   the "uModelView" uniform matrix and the geometry has been drawn.
+  /// \pre The Scene has already set the camera's uniforms on this Mesh's
+  ///   ShaderProgram.
+  /// \post While the ShaderProgram was enabled, this Mesh's uniform blocks
+  ///   have been bound and the geometry has been drawn.
+  virtual void
+  draw (Camera* camera);
+
+  /// \brief Makes the calls drawing this Mesh needs that cannot be made
+  ///   through a CommandList, uploading its Material if that changed.
+  /// Must be called on the context's thread before drawThrough, once per
+  ///   frame; draw calls it itself.
+  void
+  prepareDraw ();
+
+  /// \brief Draws this Mesh by making its calls through another context,
+  ///   such as a CommandList recording them to be made later.
+  /// Nothing shared with other Meshes is changed, so different Meshes may
+  ///   be drawn through different CommandLists on several threads at once.
+  /// \param context The context to make the calls through.
+  /// \pre prepareDraw has been called since the Material last changed.
   virtual void
-  draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPosition);
+  drawThrough (OpenGLContext* context);
 
   /// \brief Gets the mesh's world matrix.
   /// \return The world matrix.
   Transform
   getWorld () const;
 
+  /// \brief Replaces the mesh's world transform, as systems do when they copy
+  ///   a Transform component back to the Mesh that draws it.
+  /// \param[in] world The new world transform.
+  void
+  setWorld (const Transform& world);
+
+  /// \brief Gets the matrix the mesh was last drawn with, recalculating it
+  ///   only if the drawn transforms have changed since the last call.
+  /// This is interpolated between the transforms given to setDrawnWorlds, and
+  ///   does not follow moves made since.
+  /// \return The world matrix.
+  const Matrix4&
+  getWorldMatrix () const;
+
+  /// \brief Gets the inverse transpose of the upper 3x3 part of the world
+  ///   matrix, recalculating it only if necessary.
+  /// \return The matrix that takes local normals to world normals.
+  const Matrix3&
+  getNormalMatrix () const;
+
+  /// \brief Gets how many times the cached world matrices have been
+  ///   recalculated.
+  /// \return The number of world matrix recalculations.
+  unsigned
+  getWorldUpdateCount () const;
+
+  /// \brief Remembers the current world transform as the one the next
+  ///   simulation step starts from.
+  /// Call this before each step, and after teleporting the mesh so that it is
+  ///   not drawn sliding to its new place.
+  /// \post The previous world transform is the current one.
+  void
+  storePreviousWorld ();
+
+  /// \brief Gets the world transform from before the current step.
+  /// \return The transform saved by storePreviousWorld.
+  Transform
+  getPreviousWorld () const;
+
+  /// \brief Sets the transforms the mesh is drawn between.
+  /// These are kept apart from the world transform the simulation moves, so
+  ///   that a simulation thread can keep moving the mesh while it is drawn
+  ///   from a snapshot.  The orientations are blended linearly, which is
+  ///   accurate for the small rotations of one step.
+  /// \param[in] previous The world transform before the last step.
+  /// \param[in] current The world transform after the last step.
+  /// \param[in] interpolation Where to draw the mesh between them, from 0
+  ///   (previous) to 1 (current).
+  void
+  setDrawnWorlds (const Transform& previous, const Transform& current,
+                  float interpolation);
+
+  /// \brief Gets the ShaderProgram this Mesh is drawn with.
+  /// \return A pointer to the ShaderProgram.
+  ShaderProgram*
+  getShaderProgram () const;
+
   /// \brief Moves the mesh right (locally).
   /// \param[in] distance The distance to move the mesh.
   /// \post The mesh has been moved.
@@ -218,6 +318,82 @@ public:
   virtual unsigned int
   getFloatsPerVertex () const;
 
+  /// \brief Gets which attributes each vertex has and where they are.
+  /// \return The layout of the vertices in getVertices.
+  virtual VertexLayout
+  getVertexLayout () const;
+
+  /// \brief Gets the texture the diffuse reflection is read from, if any.
+  /// \return The texture, or nullptr if the Mesh is not textured.
+  virtual const Texture*
+  getTexture () const;
+
+  /// \brief Gets the local-space vertex data, getFloatsPerVertex floats per
+  ///   vertex.
+  /// \return The vertices, which are also kept after prepareVao.
+  const std::vector<float>&
+  getVertices () const;
+
+  /// \brief Gets the vertex indices, 3 per triangle.
+  /// \return The indices.
+  const std::vector<unsigned>&
+  getIndices () const;
+
+  /// \brief Gets the type the indices were last uploaded as, which prepareVao
+  ///   and stream choose from the largest index.
+  /// \return GL_UNSIGNED_SHORT if every index fits in 16 bits, or else
+  ///   GL_UNSIGNED_INT.
+  GLenum
+  getIndexType () const;
+
+  /// \brief Gets the size of the index buffer.
+  /// \return The bytes last uploaded: 2 or 4 per index, as getIndexType
+  ///   says.
+  size_t
+  getIndexBufferSize () const;
+
+  /// \brief Gets the Material the Mesh is lit with.
+  /// \return The Material, or nullptr for Meshes that are not lit.
+  const Material*
+  getMaterial () const;
+
+  /// \brief Marks the mesh as one that never moves, so that a Scene may draw
+  ///   it as part of a static batch.
+  /// \param[in] isStatic Whether it never moves.
+  void
+  setStatic (bool isStatic);
+
+  /// \brief Tests whether the mesh has been marked as never moving.
+  /// \return Whether it is static.
+  bool
+  isStatic () const;
+
+  /// \brief Marks the mesh as one large enough to hide others behind it, such
+  ///   as a wall, so that a Scene culling occluded Meshes draws it into the
+  ///   culler's depth buffer.
+  /// \param[in] isOccluder Whether it hides others.
+  void
+  setOccluder (bool isOccluder);
+
+  /// \brief Tests whether the mesh has been marked as hiding others.
+  /// \return Whether it is an occluder.
+  bool
+  isOccluder () const;
+
+  /// \brief Gets the box around the mesh's vertices, in local space.
+  /// \param[out] low The lowest coordinate of any vertex along each axis.
+  /// \param[out] high The highest coordinate along each axis.
+  /// \pre prepareVao or stream has been called since the vertices last
+  ///   changed.
+  void
+  getLocalBounds (Vector3& low, Vector3& high) const;
+
+  /// \brief Constructs an empty Mesh of the same kind as this one, drawn with
+  ///   the same ShaderProgram, Material, and texture.
+  /// \return The new Mesh, which the caller owns.
+  virtual Mesh*
+  createEmpty () const;
+
   Vector3
   getPosition();
 
@@ -231,6 +407,21 @@ protected:
   virtual void
   enableAttributes();
 
+  /// \brief Attaches this Mesh's ObjectBlock and its Material's
+  ///   MaterialBlock, rewriting the object buffer only if the world matrix or
+  ///   hasTexture changed since it was last written.
+  /// \param context The context to make the calls through.
+  /// \param[in] hasTexture Whether the shader should sample uDiffuseSampler.
+  /// \pre The Mesh's ShaderProgram is enabled, and prepareDraw has been
+  ///   called.
+  void
+  bindUniformBlocks (OpenGLContext* context, bool hasTexture);
+
+  /// \brief Marks the cached world matrices as out of date.
+  /// Must be called after any change to the drawn transforms.
+  void
+  markWorldDirty ();
+
   /// A pointer to the object through which this Mesh will make OpenGL calls.
   OpenGLContext* m_context;
 
@@ -241,6 +432,8 @@ protected:
   std::vector<float> m_vertices;
   /// Stores the vertex it is using from the m_ibo
   std::vector<unsigned> m_indices;
+  /// The type m_indices were uploaded to m_ibo as, which draws must pass.
+  GLenum m_indexType;
 
   float m_texels;
 
@@ -252,6 +445,64 @@ protected:
 
   /// Transforms mesh from local to world cordinates.
   Transform m_world;
+
+  /// m_world as it was before the current simulation step.
+  Transform m_previousWorld;
+
+  /// Whether the mesh never moves.
+  bool m_isStatic;
+
+  /// Whether the mesh hides others behind it.
+  bool m_isOccluder;
+
+private:
+  /// \brief Recalculates the cached world matrices if the drawn transforms
+  ///   have changed.
+  void
+  updateWorld () const;
+
+  /// \brief Recalculates the box around the vertices.
+  void
+  updateBounds ();
+
+  /// \brief Uploads m_indices to m_ibo in 16 bits each if they all fit, or
+  ///   else in 32, and sets m_indexType to match.
+  /// \param[in,out] shortIndices Somewhere to narrow the indices into.
+  /// \param[in] usage The buffer's usage hint.
+  /// \pre m_vao and m_ibo are bound.
+  void
+  uploadIndices (std::vector<std::uint16_t>& shortIndices, GLenum usage);
+
+  /// The transforms the mesh is drawn between, owned by whichever thread
+  ///   draws.
+  Transform m_drawnPrevious;
+  Transform m_drawnWorld;
+  /// Where between m_drawnPrevious and m_drawnWorld the mesh is drawn.
+  float m_interpolation;
+
+  /// The box around m_vertices as they were last uploaded.
+  Vector3 m_boundsLow;
+  Vector3 m_boundsHigh;
+
+  /// Where stream narrows the indices, kept from frame to frame so that its
+  ///   memory is reused.
+  std::vector<std::uint16_t> m_streamIndices;
+
+  /// The most recently calculated 4x4 world matrix.
+  mutable Matrix4 m_worldMatrix;
+  /// The most recently calculated normal matrix.
+  mutable Matrix3 m_normalMatrix;
+  /// Whether the cached matrices are out of date.
+  mutable bool m_isWorldDirty;
+  /// Number of times the cached matrices have been recalculated.
+  mutable unsigned m_worldUpdateCount;
+
+  /// Buffer that backs the ObjectBlock uniform block.
+  UniformBuffer m_objectBuffer;
+  /// The world update count when m_objectBuffer was last written.
+  unsigned m_objectWorldCount;
+  /// The hasTexture value m_objectBuffer was last written with.
+  bool m_objectHasTexture;
 };
 
 #endif//MESH_HPP
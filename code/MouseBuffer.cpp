@@ -6,7 +6,8 @@
 #include "MouseBuffer.hpp"
 
 MouseBuffer::MouseBuffer () 
-: m_leftButton(false), m_rightButton(false), m_xPos(0), m_yPos(0)
+: m_leftButton(false), m_rightButton(false), m_xPos(0), m_yPos(0),
+  m_scroll(0)
 {
 
 }
@@ -52,4 +53,19 @@ double
 MouseBuffer::getY () const
 {
   return m_yPos;
-}
\ No newline at end of file
+}
+
+void
+MouseBuffer::addScroll (double offset)
+{
+  double scroll = m_scroll.load();
+  while (!m_scroll.compare_exchange_weak(scroll, scroll + offset))
+  {
+  }
+}
+
+double
+MouseBuffer::takeScroll ()
+{
+  return m_scroll.exchange(0.0);
+}
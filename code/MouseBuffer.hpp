@@ -6,7 +6,11 @@
 #ifndef MOUSE_BUFFER_HPP
 #define MOUSE_BUFFER_HPP
 
+#include <atomic>
+
 /// \brief A class that remembers the status of the mouse.
+/// The status may be set on the thread that receives window events while
+///   another thread reads it.
 class MouseBuffer
 {
  public:
@@ -55,15 +59,30 @@ class MouseBuffer
   double
   getY () const;
 
+  /// \brief Adds to the distance the scroll wheel has moved.
+  /// \param[in] offset How far the wheel moved.
+  /// \post The offset has been added to the distance not yet taken.
+  void
+  addScroll (double offset);
+
+  /// \brief Takes the distance the scroll wheel has moved since the last
+  ///   call.
+  /// \return The total offset.
+  /// \post No distance is left to take.
+  double
+  takeScroll ();
+
  private:
   /// \brief The status of the left mouse button (true=down, false=up).
-  bool m_leftButton;
+  std::atomic<bool> m_leftButton;
   /// \brief The status of the right mouse button (true=down, false=up).
-  bool m_rightButton;
+  std::atomic<bool> m_rightButton;
   /// \brief The X-coodinate of the cursor.
-  double m_xPos;
+  std::atomic<double> m_xPos;
   /// \brief The Y-coordinate of the cursor.
-  double m_yPos;
+  std::atomic<double> m_yPos;
+  /// \brief The scroll wheel offset not yet taken.
+  std::atomic<double> m_scroll;
 };
 
 
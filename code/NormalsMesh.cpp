@@ -95,30 +95,24 @@ NormalsMesh::~NormalsMesh ()
 }
 
 void
-NormalsMesh::draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPosition) 
+NormalsMesh::drawThrough (OpenGLContext* context) 
 {
   // Iterate over each object in scene and draw it
   // The shader program is already enabled, but we do not want to
   //   make that assumption in general.
-  m_shaderProgram->enable ();
+  m_shaderProgram->enable (context);
 
-  m_shaderProgram->setUniformMatrix ("uWorld", m_world.getTransform());
-  m_shaderProgram->setUniformMatrix ("uView", viewMatrix.getTransform());
-  m_shaderProgram->setUniformMatrix ("uProjection", projectionMatrix);
-
-  //m_shaderProgram->setUniformVector ("uEyePosition", cameraPosition);
-  m_shaderProgram->setUniformVector ("uEyePosition", Vector3(0.0f, 0.0f, 0.0f));
-  m_shaderProgram->setUniformInt("uHasTexture", 0);
-
-  m_material->setUniforms(m_shaderProgram);
+  // The camera and lights are in the Scene's FrameBlock, so only the
+  //   object and material blocks are bound here.
+  bindUniformBlocks (context, false);
 
   // Draw geometry
-  m_context->bindVertexArray (m_vao);
-  glDrawElements (GL_TRIANGLES, m_indices.size (), GL_UNSIGNED_INT,
+  context->bindVertexArray (m_vao);
+  context->drawElements (GL_TRIANGLES, m_indices.size (), m_indexType,
     reinterpret_cast<void*> (0));
-  m_context->bindVertexArray (0);
+  context->bindVertexArray (0);
 
-  m_shaderProgram->disable ();
+  m_shaderProgram->disable (context);
 }
 
 unsigned int
@@ -127,6 +121,12 @@ NormalsMesh::getFloatsPerVertex () const
   return 6;
 }
 
+VertexLayout
+NormalsMesh::getVertexLayout () const
+{
+  return VertexLayout { -1, 3, -1 };
+}
+
 void
 NormalsMesh::enableAttributes()
 {
@@ -143,4 +143,10 @@ NormalsMesh::enableAttributes()
   // Normals have 3 parts, each are floats, start at 3rd position in array, stride is 6
   m_context->vertexAttribPointer (NORMALS_ATTRIB_INDEX, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
           reinterpret_cast<void*> (3 * sizeof(float)));
-}
\ No newline at end of file
+}
+
+Mesh*
+NormalsMesh::createEmpty () const
+{
+  return new NormalsMesh(m_context, m_shaderProgram, m_material);
+}
@@ -0,0 +1,446 @@
+/// \file OcclusionCuller.cpp
+/// \brief Implementation of OcclusionCuller class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "OcclusionCuller.hpp"
+
+namespace
+{
+  /// \brief Transforms a point by a column-major matrix.
+  Vector4
+  transformPoint (const float* m, float x, float y, float z)
+  {
+    return Vector4 (m[0] * x + m[4] * y + m[8] * z + m[12],
+                    m[1] * x + m[5] * y + m[9] * z + m[13],
+                    m[2] * x + m[6] * y + m[10] * z + m[14],
+                    m[3] * x + m[7] * y + m[11] * z + m[15]);
+  }
+
+  /// \brief How far a clip-space point is in front of the near plane,
+  ///   z = -w; negative behind it.
+  float
+  nearDistance (const Vector4& v)
+  {
+    return v.m_z + v.m_w;
+  }
+
+  /// \brief The point where the segment from a to b crosses the near plane.
+  Vector4
+  clipToNear (const Vector4& a, const Vector4& b)
+  {
+    float t = nearDistance (a) / (nearDistance (a) - nearDistance (b));
+    return Vector4 (a.m_x + t * (b.m_x - a.m_x), a.m_y + t * (b.m_y - a.m_y),
+                    a.m_z + t * (b.m_z - a.m_z), a.m_w + t * (b.m_w - a.m_w));
+  }
+
+  /// \brief The milliseconds since a time.
+  double
+  millisecondsSince (std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli> (
+      std::chrono::steady_clock::now () - start).count ();
+  }
+}
+
+OcclusionCuller::OcclusionCuller (unsigned width, unsigned height)
+  : m_width ((width + TILE_WIDTH - 1) / TILE_WIDTH * TILE_WIDTH),
+    m_height ((height + TILE_HEIGHT - 1) / TILE_HEIGHT * TILE_HEIGHT),
+    m_tilesX (m_width / TILE_WIDTH), m_tilesY (m_height / TILE_HEIGHT),
+    m_depth (m_width * m_height, 1.0f),
+    m_tileDepth (m_tilesX * m_tilesY, 1.0f),
+    m_rowTriangles (m_tilesY),
+    m_stats ()
+{
+}
+
+void
+OcclusionCuller::beginFrame (const Matrix4& viewProjection)
+{
+  m_viewProjection = viewProjection;
+  std::fill (m_depth.begin (), m_depth.end (), 1.0f);
+  std::fill (m_tileDepth.begin (), m_tileDepth.end (), 1.0f);
+  m_triangles.clear ();
+  for (std::vector<unsigned>& row : m_rowTriangles)
+  {
+    row.clear ();
+  }
+  m_stats = Stats ();
+}
+
+void
+OcclusionCuller::addOccluder (const std::vector<float>& vertices,
+                              const std::vector<unsigned>& indices,
+                              unsigned floatsPerVertex, const Matrix4& world)
+{
+  auto start = std::chrono::steady_clock::now ();
+  Matrix4 toClip = m_viewProjection * world;
+  const float* m = toClip.data ();
+  for (size_t i = 0; i + 2 < indices.size (); i += 3)
+  {
+    Vector4 corners[3];
+    for (unsigned c = 0; c < 3; ++c)
+    {
+      const float* p = &vertices[indices[i + c] * floatsPerVertex];
+      corners[c] = transformPoint (m, p[0], p[1], p[2]);
+    }
+
+    // Clipping a triangle to the near plane leaves 0, 3, or 4 corners.
+    Vector4 polygon[4];
+    unsigned count = 0;
+    for (unsigned c = 0; c < 3; ++c)
+    {
+      const Vector4& from = corners[c];
+      const Vector4& to = corners[(c + 1) % 3];
+      bool isFromInside = nearDistance (from) > 0.0f;
+      bool isToInside = nearDistance (to) > 0.0f;
+      if (isFromInside)
+      {
+        polygon[count++] = from;
+      }
+      if (isFromInside != isToInside)
+      {
+        polygon[count++] = clipToNear (from, to);
+      }
+    }
+    for (unsigned c = 2; c < count; ++c)
+    {
+      addTriangle (polygon[0], polygon[c - 1], polygon[c]);
+    }
+  }
+  ++m_stats.occluders;
+  m_stats.setupMilliseconds += millisecondsSince (start);
+}
+
+void
+OcclusionCuller::rasterize (JobSystem* jobs)
+{
+  auto start = std::chrono::steady_clock::now ();
+  // Each job owns whole rows of tiles, so no two write the same pixel.
+  auto rasterizeRows = [this] (size_t first, size_t last)
+  {
+    for (size_t row = first; row < last; ++row)
+    {
+      for (unsigned triangle : m_rowTriangles[row])
+      {
+        rasterizeTriangle (m_triangles[triangle], row);
+      }
+      updateTileDepths (row);
+    }
+  };
+  if (jobs == nullptr)
+  {
+    rasterizeRows (0, m_tilesY);
+  }
+  else
+  {
+    jobs->parallelFor (0, m_tilesY, 1, rasterizeRows);
+  }
+  m_stats.triangles = m_triangles.size ();
+  m_stats.rasterizeMilliseconds += millisecondsSince (start);
+}
+
+bool
+OcclusionCuller::isOccluded (const Box& box) const
+{
+  Matrix4 toClip = m_viewProjection * *box.world;
+  const float* m = toClip.data ();
+  float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+  float nearest = INFINITY;
+  for (unsigned corner = 0; corner < 8; ++corner)
+  {
+    Vector4 clip = transformPoint (m,
+      corner & 1 ? box.high.m_x : box.low.m_x,
+      corner & 2 ? box.high.m_y : box.low.m_y,
+      corner & 4 ? box.high.m_z : box.low.m_z);
+    if (nearDistance (clip) <= 0.0f || clip.m_w <= 0.0f)
+    {
+      return false;
+    }
+    float x = (clip.m_x / clip.m_w * 0.5f + 0.5f) * m_width;
+    float y = (clip.m_y / clip.m_w * 0.5f + 0.5f) * m_height;
+    minX = std::min (minX, x);
+    maxX = std::max (maxX, x);
+    minY = std::min (minY, y);
+    maxY = std::max (maxY, y);
+    nearest = std::min (nearest, clip.m_z / clip.m_w * 0.5f + 0.5f);
+  }
+  // Boxes partly off the screen may be seen where no occluder was drawn.
+  if (minX < 0.0f || minY < 0.0f || maxX >= m_width || maxY >= m_height)
+  {
+    return false;
+  }
+
+  // Every pixel the box's rectangle overlaps, however little.
+  int left = static_cast<int> (minX);
+  int right = static_cast<int> (maxX);
+  int bottom = static_cast<int> (minY);
+  int top = static_cast<int> (maxY);
+  for (int tileY = bottom / TILE_HEIGHT; tileY <= top / int (TILE_HEIGHT);
+       ++tileY)
+  {
+    for (int tileX = left / TILE_WIDTH; tileX <= right / int (TILE_WIDTH);
+         ++tileX)
+    {
+      // Behind the farthest depth in the tile is behind every pixel of it.
+      if (nearest > m_tileDepth[tileY * m_tilesX + tileX])
+      {
+        continue;
+      }
+      int rowEnd = std::min<int> (top + 1, (tileY + 1) * TILE_HEIGHT);
+      int columnEnd = std::min<int> (right + 1, (tileX + 1) * TILE_WIDTH);
+      for (int y = std::max<int> (bottom, tileY * TILE_HEIGHT); y < rowEnd; ++y)
+      {
+        const float* row = &m_depth[y * m_width];
+        for (int x = std::max<int> (left, tileX * TILE_WIDTH); x < columnEnd;
+             ++x)
+        {
+          if (nearest <= row[x])
+          {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void
+OcclusionCuller::testBoxes (const std::vector<Box>& boxes,
+                            std::vector<unsigned char>& isHidden,
+                            JobSystem* jobs)
+{
+  auto start = std::chrono::steady_clock::now ();
+  isHidden.resize (boxes.size ());
+  auto testRange = [&] (size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      isHidden[i] = isOccluded (boxes[i]);
+    }
+  };
+  if (jobs == nullptr)
+  {
+    testRange (0, boxes.size ());
+  }
+  else
+  {
+    jobs->parallelFor (0, boxes.size (), 0, testRange);
+  }
+  m_stats.tested += boxes.size ();
+  m_stats.occluded += std::count (isHidden.begin (), isHidden.end (), 1);
+  m_stats.testMilliseconds += millisecondsSince (start);
+}
+
+unsigned
+OcclusionCuller::getWidth () const
+{
+  return m_width;
+}
+
+unsigned
+OcclusionCuller::getHeight () const
+{
+  return m_height;
+}
+
+float
+OcclusionCuller::getDepth (unsigned x, unsigned y) const
+{
+  return m_depth[y * m_width + x];
+}
+
+float
+OcclusionCuller::getTileDepth (unsigned tileX, unsigned tileY) const
+{
+  return m_tileDepth[tileY * m_tilesX + tileX];
+}
+
+const OcclusionCuller::Stats&
+OcclusionCuller::getStats () const
+{
+  return m_stats;
+}
+
+void
+OcclusionCuller::addTriangle (const Vector4& a, const Vector4& b,
+                              const Vector4& c)
+{
+  ScreenTriangle triangle;
+  const Vector4* corners[3] = { &a, &b, &c };
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    const Vector4& v = *corners[i];
+    triangle.x[i] = (v.m_x / v.m_w * 0.5f + 0.5f) * m_width;
+    triangle.y[i] = (v.m_y / v.m_w * 0.5f + 0.5f) * m_height;
+    triangle.z[i] = v.m_z / v.m_w * 0.5f + 0.5f;
+  }
+  float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0])
+    - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+  if (area == 0.0f)
+  {
+    return;
+  }
+  // Occluders hide whichever side faces the camera.
+  if (area < 0.0f)
+  {
+    std::swap (triangle.x[1], triangle.x[2]);
+    std::swap (triangle.y[1], triangle.y[2]);
+    std::swap (triangle.z[1], triangle.z[2]);
+  }
+
+  float minX = std::min ({ triangle.x[0], triangle.x[1], triangle.x[2] });
+  float maxX = std::max ({ triangle.x[0], triangle.x[1], triangle.x[2] });
+  float minY = std::min ({ triangle.y[0], triangle.y[1], triangle.y[2] });
+  float maxY = std::max ({ triangle.y[0], triangle.y[1], triangle.y[2] });
+  if (maxX < 0.0f || minX >= m_width || maxY < 0.0f || minY >= m_height)
+  {
+    return;
+  }
+  unsigned index = m_triangles.size ();
+  m_triangles.push_back (triangle);
+  unsigned firstRow = static_cast<unsigned> (std::max (minY, 0.0f)) / TILE_HEIGHT;
+  unsigned lastRow = std::min (static_cast<unsigned> (maxY) / TILE_HEIGHT,
+                               m_tilesY - 1);
+  for (unsigned row = firstRow; row <= lastRow; ++row)
+  {
+    m_rowTriangles[row].push_back (index);
+  }
+}
+
+void
+OcclusionCuller::rasterizeTriangle (const ScreenTriangle& triangle,
+                                    unsigned tileRow)
+{
+  const float* x = triangle.x;
+  const float* y = triangle.y;
+  const float* z = triangle.z;
+  // Edge i runs from corner i to corner i + 1, and is positive inside:
+  //   e = a * px + b * py + c.  Each edge is pulled in by the most it falls
+  //   across half a pixel, so that testing a pixel's center tests the whole
+  //   pixel, and only pixels the triangle covers fully are written.
+  float a[3], b[3], c[3];
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    unsigned j = (i + 1) % 3;
+    a[i] = y[i] - y[j];
+    b[i] = x[j] - x[i];
+    c[i] = x[i] * y[j] - x[j] * y[i]
+      - 0.5f * (std::abs (a[i]) + std::abs (b[i]));
+  }
+  // Depth is linear across the screen: z = zx * px + zy * py + z0.  Each
+  //   pixel is given the farthest depth within it rather than that at its
+  //   center.
+  float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+  float zx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0]))
+    / area;
+  float zy = ((x[1] - x[0]) * (z[2] - z[0]) - (x[2] - x[0]) * (z[1] - z[0]))
+    / area;
+  float z0 = z[0] - zx * x[0] - zy * y[0]
+    + 0.5f * (std::abs (zx) + std::abs (zy));
+
+  // Only whole groups of 4 columns are visited, which the width allows.
+  float minX = std::max (std::min ({ x[0], x[1], x[2] }), 0.0f);
+  float maxX = std::min (std::max ({ x[0], x[1], x[2] }), m_width - 1.0f);
+  float minY = std::min ({ y[0], y[1], y[2] });
+  float maxY = std::max ({ y[0], y[1], y[2] });
+  unsigned left = static_cast<unsigned> (minX) & ~3u;
+  unsigned right = static_cast<unsigned> (maxX);
+  unsigned bottom = std::max (tileRow * TILE_HEIGHT,
+    static_cast<unsigned> (std::max (minY, 0.0f)));
+  unsigned top = std::min ((tileRow + 1) * TILE_HEIGHT - 1,
+    static_cast<unsigned> (std::min (maxY, m_height - 1.0f)));
+
+  for (unsigned row = bottom; row <= top; ++row)
+  {
+    float py = row + 0.5f;
+    float* depth = &m_depth[row * m_width];
+#ifdef __SSE2__
+    __m128 zero = _mm_setzero_ps ();
+    __m128 e0Row = _mm_set1_ps (b[0] * py + c[0]);
+    __m128 e1Row = _mm_set1_ps (b[1] * py + c[1]);
+    __m128 e2Row = _mm_set1_ps (b[2] * py + c[2]);
+    __m128 zRow = _mm_set1_ps (zy * py + z0);
+    __m128 a0 = _mm_set1_ps (a[0]);
+    __m128 a1 = _mm_set1_ps (a[1]);
+    __m128 a2 = _mm_set1_ps (a[2]);
+    __m128 zStep = _mm_set1_ps (zx);
+    for (unsigned column = left; column <= right; column += 4)
+    {
+      __m128 px = _mm_add_ps (_mm_set1_ps (column + 0.5f),
+                              _mm_setr_ps (0.0f, 1.0f, 2.0f, 3.0f));
+      __m128 inside = _mm_and_ps (
+        _mm_and_ps (_mm_cmpge_ps (_mm_add_ps (_mm_mul_ps (a0, px), e0Row), zero),
+                    _mm_cmpge_ps (_mm_add_ps (_mm_mul_ps (a1, px), e1Row), zero)),
+        _mm_cmpge_ps (_mm_add_ps (_mm_mul_ps (a2, px), e2Row), zero));
+      if (_mm_movemask_ps (inside) == 0)
+      {
+        continue;
+      }
+      __m128 old = _mm_loadu_ps (depth + column);
+      __m128 nearer = _mm_min_ps (old, _mm_add_ps (_mm_mul_ps (zStep, px),
+                                                   zRow));
+      _mm_storeu_ps (depth + column,
+                     _mm_or_ps (_mm_and_ps (inside, nearer),
+                                _mm_andnot_ps (inside, old)));
+    }
+#else
+    for (unsigned column = left; column <= right; ++column)
+    {
+      float px = column + 0.5f;
+      if (a[0] * px + b[0] * py + c[0] >= 0.0f
+          && a[1] * px + b[1] * py + c[1] >= 0.0f
+          && a[2] * px + b[2] * py + c[2] >= 0.0f)
+      {
+        depth[column] = std::min (depth[column], zx * px + zy * py + z0);
+      }
+    }
+#endif
+  }
+}
+
+void
+OcclusionCuller::updateTileDepths (unsigned tileRow)
+{
+  for (unsigned tileX = 0; tileX < m_tilesX; ++tileX)
+  {
+    const float* tile = &m_depth[tileRow * TILE_HEIGHT * m_width
+                                 + tileX * TILE_WIDTH];
+#ifdef __SSE2__
+    __m128 farthest = _mm_loadu_ps (tile);
+    for (unsigned row = 0; row < TILE_HEIGHT; ++row)
+    {
+      for (unsigned column = 0; column < TILE_WIDTH; column += 4)
+      {
+        farthest = _mm_max_ps (farthest,
+                               _mm_loadu_ps (tile + row * m_width + column));
+      }
+    }
+    farthest = _mm_max_ps (farthest, _mm_shuffle_ps (farthest, farthest,
+                                                     _MM_SHUFFLE (1, 0, 3, 2)));
+    farthest = _mm_max_ps (farthest, _mm_shuffle_ps (farthest, farthest,
+                                                     _MM_SHUFFLE (2, 3, 0, 1)));
+    m_tileDepth[tileRow * m_tilesX + tileX] = _mm_cvtss_f32 (farthest);
+#else
+    float farthest = tile[0];
+    for (unsigned row = 0; row < TILE_HEIGHT; ++row)
+    {
+      for (unsigned column = 0; column < TILE_WIDTH; ++column)
+      {
+        farthest = std::max (farthest, tile[row * m_width + column]);
+      }
+    }
+    m_tileDepth[tileRow * m_tilesX + tileX] = farthest;
+#endif
+  }
+}
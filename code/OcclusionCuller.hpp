@@ -0,0 +1,191 @@
+/// \file OcclusionCuller.hpp
+/// \brief Declaration of OcclusionCuller class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef OCCLUSION_CULLER_HPP
+#define OCCLUSION_CULLER_HPP
+
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "Matrix4.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+
+/// \brief Hides Meshes behind large occluders, such as walls, by drawing the
+///   occluders into a small depth buffer on the CPU and testing the bounding
+///   box of every other Mesh against it before the Mesh is drawn.
+/// The depth buffer is cut into tiles of TILE_WIDTH by TILE_HEIGHT pixels,
+///   and each tile keeps the farthest depth within it, so that most boxes
+///   are settled a tile at a time and only those at the edge of an occluder
+///   compare pixels.  Occluders are rasterized 4 pixels at a time, and both
+///   rasterizing and testing are split across a JobSystem's threads, by rows
+///   of tiles and by boxes.
+/// Depths are normalized device depths, remapped from [-1, 1] to [0, 1].
+///   Culling is conservative: occluders only write the pixels they cover
+///   fully, with their farthest depth in each, and boxes are tested against
+///   every pixel they overlap.  Boxes that reach in front of the near plane
+///   or off the screen are never hidden.
+/// Nothing here calls OpenGL, so culling can be run and timed headlessly.
+class OcclusionCuller
+{
+public:
+
+  /// \brief The width of a tile, in pixels.
+  static const unsigned TILE_WIDTH = 8;
+  /// \brief The height of a tile, in pixels.
+  static const unsigned TILE_HEIGHT = 4;
+
+  /// \brief A box to test, in the local space of the Mesh it bounds.
+  struct Box
+  {
+    Vector3 low;
+    Vector3 high;
+    /// The Mesh's world matrix, which must outlive the test.
+    const Matrix4* world;
+  };
+
+  /// \brief What the culler did since the last beginFrame.
+  struct Stats
+  {
+    /// How many occluders were added.
+    unsigned occluders;
+    /// How many occluder triangles were rasterized, after clipping.
+    unsigned triangles;
+    /// How many boxes were tested, and how many of them were hidden.
+    unsigned tested;
+    unsigned occluded;
+    /// Time spent transforming and clipping occluders, on the adding thread.
+    double setupMilliseconds;
+    /// Time spent rasterizing them and finding the tiles' farthest depths.
+    double rasterizeMilliseconds;
+    /// Time spent testing boxes.
+    double testMilliseconds;
+  };
+
+  /// \brief Constructs a culler with an empty depth buffer.
+  /// \param[in] width The width of the depth buffer, in pixels, which is
+  ///   rounded up to a multiple of TILE_WIDTH.
+  /// \param[in] height The height of the depth buffer, in pixels, which is
+  ///   rounded up to a multiple of TILE_HEIGHT.
+  OcclusionCuller (unsigned width = 256, unsigned height = 128);
+
+  /// \brief Clears the depth buffer and forgets the occluders, ready for a
+  ///   frame seen through a camera.
+  /// \param[in] viewProjection The camera's projection times its view.
+  /// \post Every depth is 1, the far plane, and the statistics are 0.
+  void
+  beginFrame (const Matrix4& viewProjection);
+
+  /// \brief Transforms an occluder's triangles onto the screen, clipping
+  ///   them to the near plane, to be rasterized by rasterize.
+  /// \param[in] vertices The occluder's vertices, each starting with its
+  ///   position, as a Mesh holds them.
+  /// \param[in] indices The occluder's indices, 3 per triangle.
+  /// \param[in] floatsPerVertex The number of floats in each vertex.
+  /// \param[in] world The occluder's world matrix.
+  /// \pre beginFrame has been called.
+  void
+  addOccluder (const std::vector<float>& vertices,
+               const std::vector<unsigned>& indices,
+               unsigned floatsPerVertex, const Matrix4& world);
+
+  /// \brief Rasterizes every occluder added since beginFrame.
+  /// \param jobs The JobSystem to split the rows of tiles across, or nullptr
+  ///   to rasterize on this thread.
+  /// \post Each pixel holds the nearest depth of the occluders covering it
+  ///   fully, each taken at its farthest within the pixel, and each tile
+  ///   the farthest of its pixels.
+  void
+  rasterize (JobSystem* jobs = nullptr);
+
+  /// \brief Tests whether a box is hidden behind the occluders.
+  /// Does not change the culler, so any number of threads may test at once.
+  /// \param[in] box The box.
+  /// \return Whether every pixel the box could cover has an occluder in
+  ///   front of the box's nearest point.
+  /// \pre rasterize has been called since the last occluder was added.
+  bool
+  isOccluded (const Box& box) const;
+
+  /// \brief Tests many boxes.
+  /// \param[in] boxes The boxes.
+  /// \param[out] isHidden Set to one flag per box, nonzero if it is hidden.
+  /// \param jobs The JobSystem to split the boxes across, or nullptr to test
+  ///   them on this thread.
+  /// \post The statistics count the boxes tested and hidden.
+  void
+  testBoxes (const std::vector<Box>& boxes,
+             std::vector<unsigned char>& isHidden, JobSystem* jobs = nullptr);
+
+  /// \brief Gets the width of the depth buffer.
+  unsigned
+  getWidth () const;
+
+  /// \brief Gets the height of the depth buffer.
+  unsigned
+  getHeight () const;
+
+  /// \brief Gets the depth of a pixel.
+  /// \param[in] x The column, from the left.
+  /// \param[in] y The row, from the bottom.
+  /// \return The nearest depth of the occluders covering the pixel fully,
+  ///   or 1.
+  float
+  getDepth (unsigned x, unsigned y) const;
+
+  /// \brief Gets the farthest depth within a tile.
+  /// \param[in] tileX The column of tiles, from the left.
+  /// \param[in] tileY The row of tiles, from the bottom.
+  /// \return The farthest of the tile's pixels' depths.
+  float
+  getTileDepth (unsigned tileX, unsigned tileY) const;
+
+  /// \brief Gets what the culler did since the last beginFrame.
+  /// \return The counts and times.
+  const Stats&
+  getStats () const;
+
+private:
+  /// \brief An occluder triangle on the screen, wound counterclockwise.
+  struct ScreenTriangle
+  {
+    /// Pixel coordinates and depth of each corner.
+    float x[3], y[3], z[3];
+  };
+
+  /// \brief Projects a clipped triangle onto the screen and files it under
+  ///   each row of tiles it touches.
+  /// \param[in] a, b, c The corners, in clip space, in front of the near
+  ///   plane.
+  void
+  addTriangle (const Vector4& a, const Vector4& b, const Vector4& c);
+
+  /// \brief Rasterizes the part of a triangle within a row of tiles.
+  /// \param[in] triangle The triangle.
+  /// \param[in] tileRow The row of tiles.
+  void
+  rasterizeTriangle (const ScreenTriangle& triangle, unsigned tileRow);
+
+  /// \brief Finds the farthest depth of every tile in a row.
+  /// \param[in] tileRow The row of tiles.
+  void
+  updateTileDepths (unsigned tileRow);
+
+  unsigned m_width, m_height;
+  unsigned m_tilesX, m_tilesY;
+  Matrix4 m_viewProjection;
+  /// One depth per pixel, row by row from the bottom.
+  std::vector<float> m_depth;
+  /// The farthest depth of each tile, row by row from the bottom.
+  std::vector<float> m_tileDepth;
+  /// The occluder triangles added since beginFrame.
+  std::vector<ScreenTriangle> m_triangles;
+  /// The indices into m_triangles of those touching each row of tiles.
+  std::vector<std::vector<unsigned>> m_rowTriangles;
+  Stats m_stats;
+};
+
+#endif//OCCLUSION_CULLER_HPP
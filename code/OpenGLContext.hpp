@@ -11,6 +11,23 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+/// \brief One draw in the buffer bound to GL_DRAW_INDIRECT_BUFFER, laid out
+///   as glMultiDrawElementsIndirect reads it.
+struct DrawElementsIndirectCommand
+{
+  /// How many indices to draw.
+  GLuint count;
+  /// How many instances to draw.
+  GLuint instanceCount;
+  /// The first index, counted in indices from the start of the element
+  ///   buffer.
+  GLuint firstIndex;
+  /// Added to every index before it selects a vertex.
+  GLint baseVertex;
+  /// The first instance, which selects where attributes with a divisor start.
+  GLuint baseInstance;
+};
+
 /// \brief A class that works as a proxy between clients and the OpenGL
 ///   library.
 ///
@@ -28,6 +45,10 @@ public:
   virtual
   ~OpenGLContext () = 0;
 
+  /// See documentation of glActiveTexture.
+  virtual void
+  activeTexture (GLenum texture) = 0;
+
   /// See documentation of glAttachShader.
   virtual void
   attachShader (GLuint program, GLuint shader) = 0;
@@ -36,6 +57,14 @@ public:
   virtual void
   bindBuffer (GLenum target, GLuint buffer) = 0;
 
+  /// See documentation of glBindBufferBase.
+  virtual void
+  bindBufferBase (GLenum target, GLuint index, GLuint buffer) = 0;
+
+  /// See documentation of glBindTexture.
+  virtual void
+  bindTexture (GLenum target, GLuint texture) = 0;
+
   /// See documentation of glBindVertexArray.
   virtual void
   bindVertexArray (GLuint array) = 0;
@@ -44,6 +73,10 @@ public:
   virtual void
   bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage) = 0;
 
+  /// See documentation of glBufferSubData.
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data) = 0;
+
   /// See documentation of glClear.
   virtual void
   clear (GLbitfield mask) = 0;
@@ -80,6 +113,10 @@ public:
   virtual void
   deleteShader (GLuint shader) = 0;
 
+  /// See documentation of glDeleteTextures.
+  virtual void
+  deleteTextures (GLsizei n, const GLuint* textures) = 0;
+
   /// See documentation of glDeleteVertexArrays.
   virtual void
   deleteVertexArrays (GLsizei n, const GLuint* arrays) = 0;
@@ -112,6 +149,14 @@ public:
   virtual void
   genBuffers (GLsizei n, GLuint* buffers) = 0;
 
+  /// See documentation of glGenerateMipmap.
+  virtual void
+  generateMipmap (GLenum target) = 0;
+
+  /// See documentation of glGenTextures.
+  virtual void
+  genTextures (GLsizei n, GLuint* textures) = 0;
+
   /// See documentation of glGenVertexArrays.
   virtual void
   genVertexArrays (GLsizei n, GLuint* arrays) = 0;
@@ -140,6 +185,10 @@ public:
   virtual const GLubyte*
   getString (GLenum name) = 0;
 
+  /// See documentation of glGetUniformBlockIndex.
+  virtual GLuint
+  getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName) = 0;
+
   /// See documentation of glGetUniformLocation.
   virtual GLint
   getUniformLocation (GLuint program, const GLchar* name) = 0;
@@ -148,10 +197,46 @@ public:
   virtual void
   linkProgram (GLuint program) = 0;
 
+  /// See documentation of glMultiDrawElementsIndirect.
+  virtual void
+  multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride) = 0;
+
   /// See documentation of glShaderSource.
   virtual void
   shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length) = 0;
 
+  /// See documentation of glTexBuffer.
+  virtual void
+  texBuffer (GLenum target, GLenum internalFormat, GLuint buffer) = 0;
+
+  /// See documentation of glTexImage2D.
+  virtual void
+  texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data) = 0;
+
+  /// See documentation of glTexParameteri.
+  virtual void
+  texParameteri (GLenum target, GLenum pname, GLint param) = 0;
+
+  /// See documentation of glUniform1f.
+  virtual void
+  uniform1f (GLint location, GLfloat v0) = 0;
+
+  /// See documentation of glUniform1i.
+  virtual void
+  uniform1i (GLint location, GLint v0) = 0;
+
+  /// See documentation of glUniform3fv.
+  virtual void
+  uniform3fv (GLint location, GLsizei count, const GLfloat* value) = 0;
+
+  /// See documentation of glUniformBlockBinding.
+  virtual void
+  uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) = 0;
+
+  /// See documentation of glUniformMatrix3fv.
+  virtual void
+  uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) = 0;
+
   /// See documentation of glUniformMatrix4fv.
   virtual void
   uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) = 0;
@@ -160,6 +245,10 @@ public:
   virtual void
   useProgram (GLuint program) = 0;
 
+  /// See documentation of glVertexAttribDivisor.
+  virtual void
+  vertexAttribDivisor (GLuint index, GLuint divisor) = 0;
+
   /// See documentation of glVertexAttribPointer.
   virtual void
   vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer) = 0;
@@ -0,0 +1,244 @@
+/// \file ParticleSystem.cpp
+/// \brief Definition of ParticleSystem class, the kernels that move its
+///   particles, and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <limits>
+
+#include "ParticleSystem.hpp"
+#include "Simd.hpp"
+
+// Moves particles [first, count) along one axis.
+static void
+integrateAxisScalar (float* position, float* velocity, const float* radius,
+                     size_t first, size_t count, float deltaTime, float low,
+                     float high)
+{
+  for (size_t i = first; i < count; ++i)
+  {
+    position[i] += velocity[i] * deltaTime;
+    if (position[i] - radius[i] < low)
+    {
+      velocity[i] = -velocity[i];
+    }
+    else if (position[i] + radius[i] > high)
+    {
+      velocity[i] = -velocity[i];
+    }
+  }
+}
+
+void
+integrateParticlesScalar (const ParticleSpan& particles, float deltaTime,
+                          const float low[3], const float high[3])
+{
+  // One axis at a time, so each loop streams through three arrays.
+  integrateAxisScalar (particles.x, particles.velocityX, particles.radius, 0,
+                       particles.count, deltaTime, low[0], high[0]);
+  integrateAxisScalar (particles.y, particles.velocityY, particles.radius, 0,
+                       particles.count, deltaTime, low[1], high[1]);
+  integrateAxisScalar (particles.z, particles.velocityZ, particles.radius, 0,
+                       particles.count, deltaTime, low[2], high[2]);
+}
+
+#ifdef HAS_AVX2_TARGET
+
+// Moves particles along one axis 8 at a time, and the remainder one at a
+//   time.
+AVX2_TARGET static void
+integrateAxisAvx2 (float* position, float* velocity, const float* radius,
+                   size_t count, float deltaTime, float low, float high)
+{
+  const __m256 step = _mm256_set1_ps (deltaTime);
+  const __m256 lowWall = _mm256_set1_ps (low);
+  const __m256 highWall = _mm256_set1_ps (high);
+  const __m256 signBit = _mm256_set1_ps (-0.0f);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 p = _mm256_loadu_ps (position + i);
+    __m256 v = _mm256_loadu_ps (velocity + i);
+    __m256 r = _mm256_loadu_ps (radius + i);
+    p = _mm256_add_ps (p, _mm256_mul_ps (v, step));
+    // The scalar kernel's else-if negates at most once, as does or-ing the
+    //   two tests.
+    __m256 isOut = _mm256_or_ps (
+      _mm256_cmp_ps (_mm256_sub_ps (p, r), lowWall, _CMP_LT_OQ),
+      _mm256_cmp_ps (_mm256_add_ps (p, r), highWall, _CMP_GT_OQ));
+    v = _mm256_xor_ps (v, _mm256_and_ps (isOut, signBit));
+    _mm256_storeu_ps (position + i, p);
+    _mm256_storeu_ps (velocity + i, v);
+  }
+  integrateAxisScalar (position, velocity, radius, i, count, deltaTime, low,
+                       high);
+}
+
+void
+integrateParticlesAvx2 (const ParticleSpan& particles, float deltaTime,
+                        const float low[3], const float high[3])
+{
+  integrateAxisAvx2 (particles.x, particles.velocityX, particles.radius,
+                     particles.count, deltaTime, low[0], high[0]);
+  integrateAxisAvx2 (particles.y, particles.velocityY, particles.radius,
+                     particles.count, deltaTime, low[1], high[1]);
+  integrateAxisAvx2 (particles.z, particles.velocityZ, particles.radius,
+                     particles.count, deltaTime, low[2], high[2]);
+}
+
+bool
+hasAvx2ParticleKernel ()
+{
+  return isAvx2Supported ();
+}
+
+#else
+
+void
+integrateParticlesAvx2 (const ParticleSpan& particles, float deltaTime,
+                        const float low[3], const float high[3])
+{
+  integrateParticlesScalar (particles, deltaTime, low, high);
+}
+
+bool
+hasAvx2ParticleKernel ()
+{
+  return false;
+}
+
+#endif
+
+void
+integrateParticles (const ParticleSpan& particles, float deltaTime,
+                    const float low[3], const float high[3])
+{
+  if (hasAvx2ParticleKernel ())
+  {
+    integrateParticlesAvx2 (particles, deltaTime, low, high);
+  }
+  else
+  {
+    integrateParticlesScalar (particles, deltaTime, low, high);
+  }
+}
+
+ParticleSystem::ParticleSystem ()
+  : m_low { -std::numeric_limits<float>::max (),
+            -std::numeric_limits<float>::max (),
+            -std::numeric_limits<float>::max () },
+    m_high { std::numeric_limits<float>::max (),
+             std::numeric_limits<float>::max (),
+             std::numeric_limits<float>::max () }
+{
+
+}
+
+void
+ParticleSystem::reserve (size_t count)
+{
+  for (std::vector<float>* array : { &m_x, &m_y, &m_z, &m_velocityX,
+                                     &m_velocityY, &m_velocityZ, &m_radius })
+  {
+    array->reserve (count);
+  }
+}
+
+size_t
+ParticleSystem::add (const Vector3& position, const Vector3& velocity,
+                     float radius)
+{
+  m_x.push_back (position.m_x);
+  m_y.push_back (position.m_y);
+  m_z.push_back (position.m_z);
+  m_velocityX.push_back (velocity.m_x);
+  m_velocityY.push_back (velocity.m_y);
+  m_velocityZ.push_back (velocity.m_z);
+  m_radius.push_back (radius);
+  return m_x.size () - 1;
+}
+
+size_t
+ParticleSystem::getCount () const
+{
+  return m_x.size ();
+}
+
+void
+ParticleSystem::setBounds (float left, float right, float up, float down,
+                           float near, float far)
+{
+  m_low[0] = left;
+  m_high[0] = right;
+  m_low[1] = down;
+  m_high[1] = up;
+  m_low[2] = far;
+  m_high[2] = near;
+}
+
+void
+ParticleSystem::step (float deltaTime, JobSystem* jobs)
+{
+  if (jobs == nullptr)
+  {
+    integrateParticles (getSpan (0, getCount ()), deltaTime, m_low, m_high);
+    return;
+  }
+  jobs->parallelFor (0, getCount (), PARTICLES_PER_JOB,
+                     [this, deltaTime] (size_t first, size_t last)
+  {
+    integrateParticles (getSpan (first, last), deltaTime, m_low, m_high);
+  });
+}
+
+void
+ParticleSystem::writeWorldMatrices (std::vector<float>& matrices,
+                                    JobSystem* jobs) const
+{
+  matrices.resize (16 * getCount ());
+  auto write = [this, &matrices] (size_t first, size_t last)
+  {
+    float* matrix = matrices.data () + 16 * first;
+    for (size_t i = first; i < last; ++i, matrix += 16)
+    {
+      float r = m_radius[i];
+      float columns[16] = { r, 0.0f, 0.0f, 0.0f,
+                            0.0f, r, 0.0f, 0.0f,
+                            0.0f, 0.0f, r, 0.0f,
+                            m_x[i], m_y[i], m_z[i], 1.0f };
+      std::copy (columns, columns + 16, matrix);
+    }
+  };
+  if (jobs == nullptr)
+  {
+    write (0, getCount ());
+  }
+  else
+  {
+    jobs->parallelFor (0, getCount (), PARTICLES_PER_JOB, write);
+  }
+}
+
+Vector3
+ParticleSystem::getPosition (size_t particle) const
+{
+  return Vector3 (m_x[particle], m_y[particle], m_z[particle]);
+}
+
+Vector3
+ParticleSystem::getVelocity (size_t particle) const
+{
+  return Vector3 (m_velocityX[particle], m_velocityY[particle],
+                  m_velocityZ[particle]);
+}
+
+ParticleSpan
+ParticleSystem::getSpan (size_t first, size_t last)
+{
+  return ParticleSpan { m_x.data () + first, m_y.data () + first,
+                        m_z.data () + first, m_velocityX.data () + first,
+                        m_velocityY.data () + first,
+                        m_velocityZ.data () + first, m_radius.data () + first,
+                        last - first };
+}
@@ -0,0 +1,158 @@
+/// \file ParticleSystem.hpp
+/// \brief Declaration of ParticleSystem class, the kernels that move its
+///   particles, and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef PARTICLE_SYSTEM_HPP
+#define PARTICLE_SYSTEM_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "Vector3.hpp"
+
+/// \brief A run of particles in structure-of-arrays form, which is what the
+///   integration kernels work on.
+struct ParticleSpan
+{
+  float* x;
+  float* y;
+  float* z;
+  float* velocityX;
+  float* velocityY;
+  float* velocityZ;
+  const float* radius;
+  size_t count;
+};
+
+/// \brief Moves each particle by its velocity and turns it around at the
+///   walls, the way PhysicsObject::update does, one particle at a time.
+/// Along each axis, a particle whose sphere is past the low wall has that
+///   component of its velocity negated; otherwise, if it is past the high
+///   wall, it is negated too.
+/// This is the reference the AVX2 kernel is validated against.
+/// \param particles The particles.
+/// \param[in] deltaTime How long to move them for.
+/// \param[in] low The lowest x, y, and z a sphere may reach.
+/// \param[in] high The highest x, y, and z a sphere may reach.
+void
+integrateParticlesScalar (const ParticleSpan& particles, float deltaTime,
+                          const float low[3], const float high[3]);
+
+/// \brief Does the same as integrateParticlesScalar, 8 particles at a time
+///   with AVX2 instructions.
+/// Positions are advanced with a separate multiply and add rather than a
+///   fused one, so the result is bit for bit the same as the scalar kernel's.
+/// \pre hasAvx2ParticleKernel () is true.
+void
+integrateParticlesAvx2 (const ParticleSpan& particles, float deltaTime,
+                        const float low[3], const float high[3]);
+
+/// \brief Whether this CPU, and the compiler this was built with, can run
+///   integrateParticlesAvx2.
+bool
+hasAvx2ParticleKernel ();
+
+/// \brief Calls integrateParticlesAvx2 if this CPU supports it and
+///   integrateParticlesScalar otherwise.
+void
+integrateParticles (const ParticleSpan& particles, float deltaTime,
+                    const float low[3], const float high[3]);
+
+/// \brief Very many spheres that bounce off the walls of a box and pass
+///   through each other.
+/// Unlike PhysicsObject, which moves one Mesh through its Transform,
+///   particles are kept in contiguous arrays of positions, velocities, and
+///   radii, which the kernels stream through, and their world matrices are
+///   written out all at once for instanced drawing.  Both passes can be split
+///   across the threads of a JobSystem.
+class ParticleSystem
+{
+public:
+
+  /// \brief The most particles one job moves or writes out.
+  /// A multiple of 8, so that only the last job has a partial AVX2 batch.
+  static const size_t PARTICLES_PER_JOB = 16384;
+
+  /// \brief Constructs a system with no particles and walls far enough away
+  ///   to never be touched.
+  ParticleSystem ();
+
+  /// \brief Makes room for particles, so adding them does not reallocate.
+  /// \param[in] count The total number of particles to make room for.
+  void
+  reserve (size_t count);
+
+  /// \brief Adds a particle.
+  /// \param[in] position Where its center starts.
+  /// \param[in] velocity Its velocity, in units per second.
+  /// \param[in] radius Its radius.
+  /// \return Its index.
+  size_t
+  add (const Vector3& position, const Vector3& velocity, float radius);
+
+  /// \brief Gets the number of particles.
+  /// \return The number of particles.
+  size_t
+  getCount () const;
+
+  /// \brief Sets the walls, in the same order as PhysicsObject::setBounds.
+  /// \param[in] left The lowest x.
+  /// \param[in] right The highest x.
+  /// \param[in] up The highest y.
+  /// \param[in] down The lowest y.
+  /// \param[in] near The highest z.
+  /// \param[in] far The lowest z.
+  void
+  setBounds (float left, float right, float up, float down, float near,
+             float far);
+
+  /// \brief Moves every particle and turns it around at the walls.
+  /// \param[in] deltaTime How long the step is, in seconds.
+  /// \param jobs The JobSystem to split the work across, or nullptr to do it
+  ///   all on this thread.
+  void
+  step (float deltaTime, JobSystem* jobs = nullptr);
+
+  /// \brief Writes every particle's world matrix: a scale by its radius
+  ///   followed by a move to its position.
+  /// \param[out] matrices 16 floats per particle, each matrix in
+  ///   column-major order as glUniformMatrix4fv and instanced attributes
+  ///   expect.  It is resized to fit.
+  /// \param jobs The JobSystem to split the work across, or nullptr to do it
+  ///   all on this thread.
+  void
+  writeWorldMatrices (std::vector<float>& matrices,
+                      JobSystem* jobs = nullptr) const;
+
+  /// \brief Gets where a particle is.
+  /// \param[in] particle The particle's index.
+  /// \return The position of its center.
+  Vector3
+  getPosition (size_t particle) const;
+
+  /// \brief Gets how fast a particle is going.
+  /// \param[in] particle The particle's index.
+  /// \return Its velocity.
+  Vector3
+  getVelocity (size_t particle) const;
+
+private:
+  /// \brief Gets some of the particles in the form the kernels take.
+  /// \param[in] first The first particle.
+  /// \param[in] last One past the last particle.
+  /// \return The particles [first, last).
+  ParticleSpan
+  getSpan (size_t first, size_t last);
+
+  std::vector<float> m_x, m_y, m_z;
+  std::vector<float> m_velocityX, m_velocityY, m_velocityZ;
+  std::vector<float> m_radius;
+  /// The walls: the lowest and highest coordinate along each axis.
+  float m_low[3];
+  float m_high[3];
+};
+
+#endif//PARTICLE_SYSTEM_HPP
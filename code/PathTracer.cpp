@@ -0,0 +1,589 @@
+/// \file PathTracer.cpp
+/// \brief Definition of PathTracer class and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <FreeImagePlus.h>
+
+#include "PathTracer.hpp"
+#include "LightSource.hpp"
+#include "Matrix3.hpp"
+#include "Matrix4.hpp"
+#include "Vector4.hpp"
+
+static const float PI = 3.14159265f;
+// How far new rays start from the surface they leave, so they do not hit it.
+static const float RAY_OFFSET = 1e-3f;
+// How far rays that never hit anything are traced.
+static const float MAX_RAY_DISTANCE = 1e30f;
+// The number of bounces after which paths may be ended early.
+static const unsigned ROULETTE_DEPTH = 2;
+
+// Mixes the bits of a 32-bit integer.
+static uint32_t
+hash (uint32_t x)
+{
+  x ^= x >> 16;
+  x *= 0x7FEB352Du;
+  x ^= x >> 15;
+  x *= 0x846CA68Bu;
+  x ^= x >> 16;
+  return x;
+}
+
+static Vector3
+multiply (const Vector3& a, const Vector3& b)
+{
+  return Vector3 (a.m_x * b.m_x, a.m_y * b.m_y, a.m_z * b.m_z);
+}
+
+static Vector3
+toVector (const float* v)
+{
+  return Vector3 (v[0], v[1], v[2]);
+}
+
+// Converts a float to a byte, clamping it to [0, 1] first.
+static BYTE
+toByte (float value)
+{
+  return static_cast<BYTE> (std::min (std::max (value, 0.0f), 1.0f) * 255.0f
+                            + 0.5f);
+}
+
+// Saves an RGB float image, bottom row first, as a PNG.
+static bool
+writeRgbPng (const std::string& filename, unsigned width, unsigned height,
+             const float* rgb, float scale)
+{
+  FIBITMAP* image = FreeImage_Allocate (width, height, 24);
+  if (image == nullptr)
+  {
+    return false;
+  }
+  // FreeImage also stores the bottom row first.
+  for (unsigned y = 0; y < height; ++y)
+  {
+    BYTE* line = FreeImage_GetScanLine (image, y);
+    for (unsigned x = 0; x < width; ++x)
+    {
+      const float* texel = &rgb[3 * (y * width + x)];
+      line[3 * x + FI_RGBA_RED] = toByte (texel[0] * scale);
+      line[3 * x + FI_RGBA_GREEN] = toByte (texel[1] * scale);
+      line[3 * x + FI_RGBA_BLUE] = toByte (texel[2] * scale);
+    }
+  }
+  bool isSaved = FreeImage_Save (FIF_PNG, image, filename.c_str ()) != 0;
+  FreeImage_Unload (image);
+  return isSaved;
+}
+
+bool
+Lightmap::writePng (const std::string& filename) const
+{
+  return writeRgbPng (filename, width, height, texels.data (), 1.0f);
+}
+
+float
+PathTracer::Random::next ()
+{
+  // xorshift32
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+PathTracer::PathTracer (const Scene& scene, unsigned threadCount)
+  : m_jobs (threadCount), m_seed (0), m_maxBounces (4), m_width (0),
+    m_height (0), m_sampleCount (0)
+{
+  for (const auto& entry : scene.getMeshes ())
+  {
+    const Mesh* mesh = entry.second;
+    // The simulated transform, which is where the Mesh is even if it has not
+    //   been drawn there yet.
+    Transform meshWorld = scene.getWorld (entry.first);
+    Matrix4 world = meshWorld.getTransform ();
+    Matrix3 normalMatrix = meshWorld.getOrientation ();
+    normalMatrix.invert ();
+    normalMatrix.transpose ();
+    VertexLayout layout = mesh->getVertexLayout ();
+    unsigned floatsPerVertex = mesh->getFloatsPerVertex ();
+    const std::vector<float>& vertices = mesh->getVertices ();
+    const std::vector<unsigned>& indices = mesh->getIndices ();
+
+    Surface surface;
+    surface.texture = layout.uvOffset >= 0 ? mesh->getTexture () : nullptr;
+    surface.hasColors = layout.colorOffset >= 0;
+    const Material* material = mesh->getMaterial ();
+    surface.diffuseReflection = material != nullptr ? material->m_diffuse
+                                                    : Vector3 (0.5f);
+    surface.emission = material != nullptr ? material->m_emmissiveIntensity
+                                           : Vector3 (0.0f);
+    unsigned surfaceIndex = static_cast<unsigned> (m_surfaces.size ());
+    m_surfaces.push_back (surface);
+
+    MeshRange range;
+    range.firstTriangle = static_cast<unsigned> (m_surfaceIndices.size ());
+    for (size_t i = 0; i + 2 < indices.size (); i += 3)
+    {
+      for (size_t corner = 0; corner < 3; ++corner)
+      {
+        const float* vertex = &vertices[indices[i + corner] * floatsPerVertex];
+        Vector4 position = world * Vector4 (vertex[0], vertex[1], vertex[2],
+                                            1.0f);
+        m_positions.push_back (Vector3 (position.m_x, position.m_y,
+                                        position.m_z));
+        Vector3 normal (0.0f);
+        if (layout.normalOffset >= 0)
+        {
+          normal = normalMatrix * toVector (vertex + layout.normalOffset);
+          normal.normalize ();
+        }
+        m_normals.push_back (normal);
+        Vector3 attribute (0.0f);
+        if (layout.uvOffset >= 0)
+        {
+          attribute = Vector3 (vertex[layout.uvOffset],
+                               vertex[layout.uvOffset + 1], 0.0f);
+        }
+        else if (layout.colorOffset >= 0)
+        {
+          attribute = toVector (vertex + layout.colorOffset);
+        }
+        m_attributes.push_back (attribute);
+      }
+      m_surfaceIndices.push_back (surfaceIndex);
+    }
+    range.triangleCount = static_cast<unsigned> (m_surfaceIndices.size ())
+      - range.firstTriangle;
+    m_meshRanges[entry.first] = range;
+  }
+  m_bvh.build (m_positions);
+
+  for (const LightSource* light : scene.getLightSources ())
+  {
+    LightUniforms uniforms = {};
+    light->writeUniforms (uniforms);
+    m_lights.push_back (uniforms);
+  }
+}
+
+void
+PathTracer::setSeed (uint32_t seed)
+{
+  m_seed = seed;
+  reset ();
+}
+
+void
+PathTracer::setMaxBounces (unsigned maxBounces)
+{
+  m_maxBounces = maxBounces;
+  reset ();
+}
+
+void
+PathTracer::reset ()
+{
+  m_sampleCount = 0;
+  std::fill (m_accumulation.begin (), m_accumulation.end (), 0.0f);
+}
+
+PathTracer::Random
+PathTracer::makeRandom (uint32_t index, uint32_t sample) const
+{
+  uint32_t state = hash (m_seed ^ hash (index ^ hash (sample + 0x9E3779B9u)));
+  // xorshift never leaves 0.
+  return Random { state != 0 ? state : 1u };
+}
+
+PathTracer::SurfacePoint
+PathTracer::getSurfacePoint (unsigned triangle, float u, float v) const
+{
+  size_t first = 3 * static_cast<size_t> (triangle);
+  float w = 1.0f - u - v;
+  SurfacePoint point;
+  point.position = w * m_positions[first] + u * m_positions[first + 1]
+    + v * m_positions[first + 2];
+  point.normal = w * m_normals[first] + u * m_normals[first + 1]
+    + v * m_normals[first + 2];
+  if (point.normal.dot (point.normal) < 1e-12f)
+  {
+    point.normal = (m_positions[first + 1] - m_positions[first])
+      .cross (m_positions[first + 2] - m_positions[first]);
+  }
+  point.normal.normalize ();
+
+  const Surface& surface = m_surfaces[m_surfaceIndices[triangle]];
+  Vector3 attribute = w * m_attributes[first] + u * m_attributes[first + 1]
+    + v * m_attributes[first + 2];
+  if (surface.texture != nullptr)
+  {
+    point.diffuseReflection = surface.texture->getColor (attribute.m_x,
+                                                         attribute.m_y);
+  }
+  else if (surface.hasColors)
+  {
+    point.diffuseReflection = attribute;
+  }
+  else
+  {
+    point.diffuseReflection = surface.diffuseReflection;
+  }
+  point.emission = surface.emission;
+  return point;
+}
+
+Vector3
+PathTracer::sampleLights (const SurfacePoint& point) const
+{
+  Vector3 result (0.0f);
+  Vector3 origin = point.position + RAY_OFFSET * point.normal;
+  for (const LightUniforms& light : m_lights)
+  {
+    Vector3 lightVector;
+    float distance = MAX_RAY_DISTANCE;
+    if (light.type == DIRECTIONAL)
+    {
+      lightVector = -toVector (light.direction);
+      lightVector.normalize ();
+    }
+    else
+    {
+      lightVector = toVector (light.position) - point.position;
+      distance = lightVector.length ();
+      lightVector /= distance;
+    }
+    float cosine = lightVector.dot (point.normal);
+    if (cosine <= 0.0f)
+    {
+      continue;
+    }
+
+    // The same falloff PhongShader.frag uses.
+    float factor = cosine;
+    if (light.type != DIRECTIONAL)
+    {
+      const float* coefficients = light.attenuationCoefficients;
+      factor /= coefficients[0] + coefficients[1] * distance
+        + coefficients[2] * distance * distance;
+    }
+    if (light.type == SPOT)
+    {
+      Vector3 direction = toVector (light.direction);
+      direction.normalize ();
+      float cosTheta = std::max ((-lightVector).dot (direction), 0.0f);
+      factor *= cosTheta >= light.cutoffCosAngle && cosTheta > 0.0f
+        ? std::pow (cosTheta, light.falloff) : 0.0f;
+    }
+    if (factor <= 0.0f
+        || m_bvh.isOccluded (origin, lightVector, distance - RAY_OFFSET))
+    {
+      continue;
+    }
+    result += factor * toVector (light.diffuseIntensity);
+  }
+  return result;
+}
+
+Vector3
+PathTracer::gatherIndirect (const Vector3& position, const Vector3& normal,
+                            Random& random, unsigned bounces) const
+{
+  if (bounces == 0)
+  {
+    return Vector3 (0.0f);
+  }
+  // Cosine-weighted directions make the estimate of irradiance / pi just the
+  //   light arriving along the direction.
+  Vector3 tangent = std::abs (normal.m_x) > 0.5f ? Vector3 (0.0f, 1.0f, 0.0f)
+                                                 : Vector3 (1.0f, 0.0f, 0.0f);
+  tangent = tangent.cross (normal);
+  tangent.normalize ();
+  Vector3 bitangent = normal.cross (tangent);
+  float radius = std::sqrt (random.next ());
+  float angle = 2.0f * PI * random.next ();
+  Vector3 direction = radius * std::cos (angle) * tangent
+    + radius * std::sin (angle) * bitangent
+    + std::sqrt (std::max (0.0f, 1.0f - radius * radius)) * normal;
+
+  BvhHit hit;
+  if (!m_bvh.intersect (position + RAY_OFFSET * normal, direction,
+                        MAX_RAY_DISTANCE, hit))
+  {
+    return Vector3 (0.0f);
+  }
+  SurfacePoint point = getSurfacePoint (hit.triangle, hit.u, hit.v);
+  if (point.normal.dot (direction) > 0.0f)
+  {
+    point.normal.negate ();
+  }
+
+  // Past a few bounces, end dark paths early, and weight the ones that
+  //   survive up to make up for it.
+  Vector3 reflection = point.diffuseReflection;
+  if (m_maxBounces - bounces >= ROULETTE_DEPTH)
+  {
+    float survival = std::min (std::max (std::max (reflection.m_x,
+                                                   reflection.m_y),
+                                         std::max (reflection.m_z, 0.05f)),
+                               0.95f);
+    if (random.next () >= survival)
+    {
+      return point.emission;
+    }
+    reflection /= survival;
+  }
+  return point.emission
+    + multiply (reflection, sampleLights (point)
+                + gatherIndirect (point.position, point.normal, random,
+                                  bounces - 1));
+}
+
+Vector3
+PathTracer::shade (const SurfacePoint& point, Random& random) const
+{
+  return point.emission
+    + multiply (point.diffuseReflection,
+                sampleLights (point)
+                + gatherIndirect (point.position, point.normal, random,
+                                  m_maxBounces));
+}
+
+void
+PathTracer::forEachTile (unsigned width, unsigned height,
+                         const std::function<void (unsigned, unsigned,
+                                                   unsigned, unsigned)>&
+                           shadeTile) const
+{
+  unsigned tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+  unsigned tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+  unsigned tileCount = tilesX * tilesY;
+
+  // One tile per job; neighboring tiles (which touch the same part of the
+  //   Bvh) start out on the same thread.
+  m_jobs.parallelFor (0, tileCount, 1, [&] (size_t first, size_t)
+  {
+    unsigned tile = static_cast<unsigned> (first);
+    unsigned x0 = (tile % tilesX) * TILE_SIZE;
+    unsigned y0 = (tile / tilesX) * TILE_SIZE;
+    shadeTile (x0, y0, std::min (x0 + TILE_SIZE, width),
+               std::min (y0 + TILE_SIZE, height));
+  });
+}
+
+void
+PathTracer::render (Camera* camera, unsigned width, unsigned height,
+                    unsigned sampleCount)
+{
+  if (width != m_width || height != m_height)
+  {
+    m_width = width;
+    m_height = height;
+    m_accumulation.assign (3 * static_cast<size_t> (width) * height, 0.0f);
+    m_sampleCount = 0;
+  }
+  // Camera rays go from the near plane to the far plane, which works for
+  //   orthographic projections too, and clips them the way rasterizing does.
+  Matrix4 inverseViewProjection = camera->getInverseViewMatrix ()
+    * camera->getInverseProjectionMatrix ();
+  auto unproject = [&] (float x, float y, float z)
+  {
+    Vector4 p = inverseViewProjection * Vector4 (x, y, z, 1.0f);
+    return Vector3 (p.m_x, p.m_y, p.m_z) / p.m_w;
+  };
+
+  unsigned firstSample = m_sampleCount;
+  forEachTile (width, height,
+               [&] (unsigned x0, unsigned y0, unsigned x1, unsigned y1)
+  {
+    // Camera rays through each 2x2 block of pixels are traced as a packet.
+    for (unsigned y = y0; y < y1; y += 2)
+    {
+      for (unsigned x = x0; x < x1; x += 2)
+      {
+        unsigned pixels[Bvh::PACKET_SIZE];
+        for (int r = 0; r < Bvh::PACKET_SIZE; ++r)
+        {
+          unsigned px = std::min (x + r % 2, x1 - 1);
+          unsigned py = std::min (y + r / 2, y1 - 1);
+          pixels[r] = py * width + px;
+        }
+        for (unsigned s = firstSample; s < firstSample + sampleCount; ++s)
+        {
+          Random randoms[Bvh::PACKET_SIZE];
+          Vector3 origins[Bvh::PACKET_SIZE];
+          Vector3 directions[Bvh::PACKET_SIZE];
+          for (int r = 0; r < Bvh::PACKET_SIZE; ++r)
+          {
+            randoms[r] = makeRandom (pixels[r], s);
+            float ndcX = 2.0f * (pixels[r] % width + randoms[r].next ())
+              / width - 1.0f;
+            float ndcY = 2.0f * (pixels[r] / width + randoms[r].next ())
+              / height - 1.0f;
+            origins[r] = unproject (ndcX, ndcY, -1.0f);
+            directions[r] = unproject (ndcX, ndcY, 1.0f) - origins[r];
+          }
+          BvhHit hits[Bvh::PACKET_SIZE];
+          bool isHit[Bvh::PACKET_SIZE];
+          // The engine draws with back faces culled, so the camera sees
+          //   through the back of a wall the same way here.
+          m_bvh.intersectPacket (origins, directions, 1.0f, hits, isHit, true);
+          for (int r = 0; r < Bvh::PACKET_SIZE; ++r)
+          {
+            // Packets clamped at the tile's edge repeat a pixel.
+            if (!isHit[r] || (r > 0 && pixels[r] == pixels[r - 1])
+                || (r > 1 && pixels[r] == pixels[r - 2]))
+            {
+              continue;
+            }
+            SurfacePoint point = getSurfacePoint (hits[r].triangle, hits[r].u,
+                                                  hits[r].v);
+            if (point.normal.dot (directions[r]) > 0.0f)
+            {
+              point.normal.negate ();
+            }
+            Vector3 color = shade (point, randoms[r]);
+            float* sum = &m_accumulation[3 * static_cast<size_t> (pixels[r])];
+            sum[0] += color.m_x;
+            sum[1] += color.m_y;
+            sum[2] += color.m_z;
+          }
+        }
+      }
+    }
+  });
+  m_sampleCount += sampleCount;
+}
+
+unsigned
+PathTracer::getSampleCount () const
+{
+  return m_sampleCount;
+}
+
+Vector3
+PathTracer::getPixel (unsigned x, unsigned y) const
+{
+  if (m_sampleCount == 0)
+  {
+    return Vector3 (0.0f);
+  }
+  const float* sum = &m_accumulation[3 * (static_cast<size_t> (y) * m_width
+                                          + x)];
+  return toVector (sum) / static_cast<float> (m_sampleCount);
+}
+
+bool
+PathTracer::writePng (const std::string& filename) const
+{
+  return writeRgbPng (filename, m_width, m_height, m_accumulation.data (),
+                      m_sampleCount > 0 ? 1.0f / m_sampleCount : 0.0f);
+}
+
+Lightmap
+PathTracer::bakeLightmap (const std::string& meshName, unsigned width,
+                          unsigned height, unsigned sampleCount) const
+{
+  auto found = m_meshRanges.find (meshName);
+  if (found == m_meshRanges.end ())
+  {
+    throw std::invalid_argument ("No mesh named " + meshName);
+  }
+  const MeshRange& range = found->second;
+
+  // Each square cell of the atlas holds two triangles: one below its
+  //   diagonal and one above it.  Cells have a 1 texel border, which is
+  //   filled with the nearest edge so filtering does not bleed in black.
+  unsigned cellCount = (range.triangleCount + 1) / 2;
+  unsigned cellsPerRow = static_cast<unsigned> (
+    std::ceil (std::sqrt (static_cast<float> (cellCount))));
+  cellsPerRow = std::max (cellsPerRow, 1u);
+  float cellWidth = static_cast<float> (width) / cellsPerRow;
+  float cellHeight = static_cast<float> (height) / cellsPerRow;
+  float insideWidth = std::max (cellWidth - 2.0f, 1.0f);
+  float insideHeight = std::max (cellHeight - 2.0f, 1.0f);
+
+  Lightmap lightmap;
+  lightmap.width = width;
+  lightmap.height = height;
+  lightmap.texels.assign (3 * static_cast<size_t> (width) * height, 0.0f);
+  lightmap.uvs.reserve (6 * range.triangleCount);
+  for (unsigned i = 0; i < range.triangleCount; ++i)
+  {
+    unsigned cell = i / 2;
+    float left = ((cell % cellsPerRow) * cellWidth + 1.0f) / width;
+    float bottom = ((cell / cellsPerRow) * cellHeight + 1.0f) / height;
+    float right = left + insideWidth / width;
+    float top = bottom + insideHeight / height;
+    // Matches the barycentric weights chosen for each texel below.
+    const float lower[6] = { left, bottom, right, bottom, left, top };
+    const float upper[6] = { right, top, left, top, right, bottom };
+    const float* corners = i % 2 == 0 ? lower : upper;
+    lightmap.uvs.insert (lightmap.uvs.end (), corners, corners + 6);
+  }
+
+  forEachTile (width, height,
+               [&] (unsigned x0, unsigned y0, unsigned x1, unsigned y1)
+  {
+    for (unsigned y = y0; y < y1; ++y)
+    {
+      for (unsigned x = x0; x < x1; ++x)
+      {
+        unsigned column = std::min (static_cast<unsigned> (x / cellWidth),
+                                    cellsPerRow - 1);
+        unsigned row = std::min (static_cast<unsigned> (y / cellHeight),
+                                 cellsPerRow - 1);
+        float s = (x + 0.5f - column * cellWidth - 1.0f) / insideWidth;
+        float t = (y + 0.5f - row * cellHeight - 1.0f) / insideHeight;
+        s = std::min (std::max (s, 0.0f), 1.0f);
+        t = std::min (std::max (t, 0.0f), 1.0f);
+        unsigned i = 2 * (row * cellsPerRow + column);
+        float u = s;
+        float v = t;
+        if (s + t > 1.0f)
+        {
+          ++i;
+          u = 1.0f - s;
+          v = 1.0f - t;
+        }
+        if (i >= range.triangleCount)
+        {
+          continue;
+        }
+
+        SurfacePoint point = getSurfacePoint (range.firstTriangle + i, u, v);
+        uint32_t index = y * width + x;
+        Vector3 sum (0.0f);
+        for (unsigned sample = 0; sample < sampleCount; ++sample)
+        {
+          Random random = makeRandom (index, sample);
+          sum += gatherIndirect (point.position, point.normal, random,
+                                 m_maxBounces);
+        }
+        Vector3 light = sampleLights (point);
+        if (sampleCount > 0)
+        {
+          light += sum / static_cast<float> (sampleCount);
+        }
+        float* texel = &lightmap.texels[3 * static_cast<size_t> (index)];
+        texel[0] = light.m_x;
+        texel[1] = light.m_y;
+        texel[2] = light.m_z;
+      }
+    }
+  });
+  return lightmap;
+}
+
+size_t
+PathTracer::getTriangleCount () const
+{
+  return m_bvh.getTriangleCount ();
+}
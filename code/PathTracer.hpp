@@ -0,0 +1,260 @@
+/// \file PathTracer.hpp
+/// \brief Declaration of PathTracer class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef PATH_TRACER_HPP
+#define PATH_TRACER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Bvh.hpp"
+#include "Camera.hpp"
+#include "JobSystem.hpp"
+#include "Texture.hpp"
+#include "UniformBlocks.hpp"
+#include "Vector3.hpp"
+#include "Scenes/Scene.hpp"
+
+/// \brief The light baked onto a Mesh, one RGB value per texel.
+/// A texel holds the light arriving at that point of the surface, scaled so
+///   that multiplying it by a diffuse reflection gives the light the surface
+///   reflects.  The Mesh's own texture coordinates usually repeat, so the
+///   texels are laid out in an atlas of their own, with one half of a cell
+///   per triangle, and uvs gives each triangle corner's place in it.
+struct Lightmap
+{
+  unsigned width;
+  unsigned height;
+  /// Red, green, and blue of each texel, from the bottom row up.
+  std::vector<float> texels;
+  /// The lightmap coordinates of each element of the Mesh's getIndices, two
+  ///   floats apiece.
+  std::vector<float> uvs;
+
+  /// \brief Saves the lightmap as a PNG, clamping the texels to [0, 1].
+  /// \param[in] filename The name of the file to write.
+  /// \return Whether the file was written.
+  bool
+  writePng (const std::string& filename) const;
+};
+
+/// \brief A CPU path tracer, for ground-truth renders of a Scene and for
+///   baking lightmaps.
+/// The Scene's Meshes are copied into world space and put in one Bvh when the
+///   PathTracer is constructed.  Surfaces are Lambertian, with the diffuse
+///   reflection read from the Mesh's texture, vertex colors, or Material, and
+///   emit their Material's emissive intensity.  The Scene's lights are
+///   sampled directly with shadow rays; their intensities are scaled by pi so
+///   that the directly lit diffuse term matches PhongShader's.  Camera rays
+///   pass through back faces, as they do when the Scene is drawn.
+/// Work is split into tiles, which are run as jobs on the PathTracer's
+///   JobSystem, so that threads steal tiles from each other when theirs run
+///   out.  Every pixel sample draws its random numbers from a generator
+///   seeded by the seed, the pixel, and the sample number, so the result does
+///   not depend on the number of threads or on which thread shaded which
+///   tile.
+class PathTracer
+{
+public:
+
+  /// \brief The width and height of a tile, in pixels or texels.
+  static const unsigned TILE_SIZE = 16;
+
+  /// \brief Copies a Scene's geometry and lights and builds a Bvh over them.
+  /// \param[in] scene The scene.  Its Textures must outlive the PathTracer.
+  /// \param[in] threadCount The number of threads to trace with.
+  PathTracer (const Scene& scene, unsigned threadCount = 0);
+
+  /// \brief Sets the seed that all random numbers are derived from.
+  /// \param[in] seed The seed.
+  /// \post The accumulated image has been discarded.
+  void
+  setSeed (uint32_t seed);
+
+  /// \brief Sets how many times a path may bounce.
+  /// \param[in] maxBounces The number of bounces after the first hit.
+  /// \post The accumulated image has been discarded.
+  void
+  setMaxBounces (unsigned maxBounces);
+
+  /// \brief Discards the accumulated image, which must be done whenever the
+  ///   camera moves.
+  /// \post getSampleCount is 0.
+  void
+  reset ();
+
+  /// \brief Traces more samples of every pixel and adds them to the image.
+  /// \param camera The camera to trace from.
+  /// \param[in] width The image width, in pixels.
+  /// \param[in] height The image height, in pixels.
+  /// \param[in] sampleCount The number of samples per pixel to add.
+  /// \post If the size changed, the image was reset first.
+  /// \post getSampleCount has increased by sampleCount.
+  void
+  render (Camera* camera, unsigned width, unsigned height,
+          unsigned sampleCount);
+
+  /// \brief Gets the number of samples accumulated per pixel.
+  /// \return The number of samples.
+  unsigned
+  getSampleCount () const;
+
+  /// \brief Gets the average of the samples of one pixel.
+  /// \param[in] x The pixel's column, from the left.
+  /// \param[in] y The pixel's row, from the bottom.
+  /// \return The pixel's color, which may be greater than 1.
+  Vector3
+  getPixel (unsigned x, unsigned y) const;
+
+  /// \brief Saves the accumulated image as a PNG, clamping it to [0, 1].
+  /// \param[in] filename The name of the file to write.
+  /// \return Whether the file was written.
+  bool
+  writePng (const std::string& filename) const;
+
+  /// \brief Bakes the light arriving at every point of one of the Scene's
+  ///   Meshes.
+  /// \param[in] meshName The Mesh's name in the Scene.
+  /// \param[in] width The lightmap's width, in texels.
+  /// \param[in] height The lightmap's height, in texels.
+  /// \param[in] sampleCount The number of paths traced from each texel.
+  /// \return The lightmap.
+  /// \throws std::invalid_argument If the Scene had no Mesh called meshName.
+  Lightmap
+  bakeLightmap (const std::string& meshName, unsigned width, unsigned height,
+                unsigned sampleCount) const;
+
+  /// \brief Gets the number of triangles in the Bvh.
+  /// \return The number of triangles.
+  size_t
+  getTriangleCount () const;
+
+private:
+
+  /// \brief How one Mesh's triangles look.
+  struct Surface
+  {
+    /// The texture, or nullptr if the reflection is not read from one.
+    const Texture* texture;
+    /// Whether the reflection is read from the vertex colors.
+    bool hasColors;
+    /// The reflection when there is neither a texture nor vertex colors.
+    Vector3 diffuseReflection;
+    /// The light the surface gives off.
+    Vector3 emission;
+  };
+
+  /// \brief The range of triangles that came from one Mesh.
+  struct MeshRange
+  {
+    unsigned firstTriangle;
+    unsigned triangleCount;
+  };
+
+  /// \brief A random number generator with a tiny state, so that one can be
+  ///   made for every sample.
+  struct Random
+  {
+    uint32_t state;
+
+    /// \brief Gets a number in [0, 1).
+    float
+    next ();
+  };
+
+  /// \brief The point a ray hit, with everything shading needs.
+  struct SurfacePoint
+  {
+    Vector3 position;
+    /// The shading normal, facing the side the ray came from.
+    Vector3 normal;
+    Vector3 diffuseReflection;
+    Vector3 emission;
+  };
+
+  /// \brief Fills in a SurfacePoint from a point on a triangle.
+  /// \param[in] triangle The triangle.
+  /// \param[in] u The barycentric weight of its second vertex.
+  /// \param[in] v The barycentric weight of its third vertex.
+  /// \return The point, with the normal on the side the triangle's vertex
+  ///   normals (or, without them, its winding) face.
+  SurfacePoint
+  getSurfacePoint (unsigned triangle, float u, float v) const;
+
+  /// \brief Estimates the light arriving at a point from the Scene's lights.
+  /// \param[in] point The point.
+  /// \return The irradiance, divided by pi.
+  Vector3
+  sampleLights (const SurfacePoint& point) const;
+
+  /// \brief Estimates the light reflected off a point towards where the ray
+  ///   that hit it came from, tracing the rest of the path.
+  /// \param[in] point The point.
+  /// \param random The path's random numbers.
+  /// \return The reflected light.
+  Vector3
+  shade (const SurfacePoint& point, Random& random) const;
+
+  /// \brief Estimates the light arriving at a point from every direction,
+  ///   tracing paths from the point.
+  /// \param[in] position The point.
+  /// \param[in] normal The surface normal at the point.
+  /// \param random The paths' random numbers.
+  /// \param[in] bounces The number of bounces left.
+  /// \return The irradiance, divided by pi.
+  Vector3
+  gatherIndirect (const Vector3& position, const Vector3& normal,
+                  Random& random, unsigned bounces) const;
+
+  /// \brief Runs a function on every tile of an image on all threads.
+  /// \param[in] width The image width.
+  /// \param[in] height The image height.
+  /// \param[in] shadeTile Called with the bottom-left and top-right corners
+  ///   (exclusive) of each tile.
+  void
+  forEachTile (unsigned width, unsigned height,
+               const std::function<void (unsigned, unsigned, unsigned,
+                                         unsigned)>& shadeTile) const;
+
+  /// \brief Makes the random number generator for one sample.
+  /// \param[in] index The pixel or texel.
+  /// \param[in] sample The sample number.
+  /// \return The generator.
+  Random
+  makeRandom (uint32_t index, uint32_t sample) const;
+
+  /// The world-space vertices, 3 per triangle, in the Bvh's triangle order.
+  std::vector<Vector3> m_positions;
+  /// The world-space vertex normals, 3 per triangle; empty (zero) for Meshes
+  ///   without normals, which use the face normal.
+  std::vector<Vector3> m_normals;
+  /// The texture coordinates (in m_x and m_y) or colors of each vertex.
+  std::vector<Vector3> m_attributes;
+  /// Which of m_surfaces each triangle uses.
+  std::vector<unsigned> m_surfaceIndices;
+  std::vector<Surface> m_surfaces;
+  /// The triangles of each Mesh, by name.
+  std::map<std::string, MeshRange> m_meshRanges;
+  /// The Scene's lights, in world space.
+  std::vector<LightUniforms> m_lights;
+  Bvh m_bvh;
+
+  /// Runs the tiles; mutable because running jobs does not change the image.
+  mutable JobSystem m_jobs;
+  uint32_t m_seed;
+  unsigned m_maxBounces;
+
+  unsigned m_width;
+  unsigned m_height;
+  unsigned m_sampleCount;
+  /// The sum of every sample of every pixel, 3 floats per pixel.
+  std::vector<float> m_accumulation;
+};
+
+#endif//PATH_TRACER_HPP
@@ -0,0 +1,363 @@
+/// \file PhongKernel.cpp
+/// \brief Implementation of the CPU versions of PhongShader.frag's lighting.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+
+#include "PhongKernel.hpp"
+#include "LightSource.hpp"
+#include "Simd.hpp"
+#include "Vector3.hpp"
+
+// GLSL's pow, which is undefined for x <= 0; both kernels call that 0 so
+//   they agree with each other.
+static float
+powPositive (float x, float y)
+{
+  return x > 0.0f ? std::pow (x, y) : 0.0f;
+}
+
+void
+shadePhongScalar (const MaterialUniforms& material, const float eyePosition[3],
+                  const LightUniforms* lights, size_t lightCount,
+                  const PhongFragments& fragments, PhongColors& colors)
+{
+  Vector3 eye (eyePosition[0], eyePosition[1], eyePosition[2]);
+  Vector3 specularReflection (material.specularReflection[0],
+                              material.specularReflection[1],
+                              material.specularReflection[2]);
+  for (int lane = 0; lane < PHONG_BATCH_SIZE; ++lane)
+  {
+    Vector3 position (fragments.positionX[lane], fragments.positionY[lane],
+                      fragments.positionZ[lane]);
+    Vector3 normal (fragments.normalX[lane], fragments.normalY[lane],
+                    fragments.normalZ[lane]);
+    Vector3 diffuseReflection (fragments.diffuseR[lane],
+                               fragments.diffuseG[lane],
+                               fragments.diffuseB[lane]);
+    Vector3 eyeVector = eye - position;
+    eyeVector.normalize ();
+
+    Vector3 result (0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < lightCount; ++i)
+    {
+      const LightUniforms& light = lights[i];
+      Vector3 lightPosition (light.position[0], light.position[1],
+                             light.position[2]);
+      Vector3 direction (light.direction[0], light.direction[1],
+                         light.direction[2]);
+      Vector3 lightVector = light.type == DIRECTIONAL
+        ? -direction : lightPosition - position;
+      lightVector.normalize ();
+
+      float lambertianCoef = std::max (lightVector.dot (normal), 0.0f);
+      if (lambertianCoef <= 0.0f)
+      {
+        continue;
+      }
+      Vector3 diffuseIntensity (light.diffuseIntensity[0],
+                                light.diffuseIntensity[1],
+                                light.diffuseIntensity[2]);
+      Vector3 specularIntensity (light.specularIntensity[0],
+                                 light.specularIntensity[1],
+                                 light.specularIntensity[2]);
+      Vector3 diffuseColor (diffuseReflection.m_x * diffuseIntensity.m_x,
+                            diffuseReflection.m_y * diffuseIntensity.m_y,
+                            diffuseReflection.m_z * diffuseIntensity.m_z);
+      diffuseColor *= lambertianCoef;
+
+      Vector3 specularColor (specularReflection.m_x * specularIntensity.m_x,
+                             specularReflection.m_y * specularIntensity.m_y,
+                             specularReflection.m_z * specularIntensity.m_z);
+      // reflect (-L, N) is -L + 2 * dot (N, L) * N.
+      Vector3 reflectionVector = 2.0f * normal.dot (lightVector) * normal
+        - lightVector;
+      float specularCoef = std::max (eyeVector.dot (reflectionVector), 0.0f);
+      specularColor *= powPositive (specularCoef, material.specularPower);
+
+      float attenuation = 1.0f;
+      if (light.type != DIRECTIONAL)
+      {
+        float distance = (position - lightPosition).length ();
+        const float* coefficients = light.attenuationCoefficients;
+        attenuation = 1.0f / (coefficients[0] + coefficients[1] * distance
+                              + coefficients[2] * distance * distance);
+      }
+      float spotFactor = 1.0f;
+      if (light.type == SPOT)
+      {
+        float cosTheta = std::max ((-lightVector).dot (direction), 0.0f);
+        spotFactor = (cosTheta >= light.cutoffCosAngle) ? cosTheta : 0.0f;
+        spotFactor = powPositive (spotFactor, light.falloff);
+      }
+      result += (spotFactor * attenuation) * (diffuseColor + specularColor);
+    }
+    colors.red[lane] += result.m_x;
+    colors.green[lane] += result.m_y;
+    colors.blue[lane] += result.m_z;
+  }
+}
+
+#ifdef HAS_AVX2_TARGET
+
+// log2 (x) for normal, positive x.  x is split into 2^e * m with m in
+//   [sqrt (1/2), sqrt (2)), and ln (m) is the series
+//   2 * (t + t^3 / 3 + t^5 / 5 + ...) in t = (m - 1) / (m + 1), |t| < 0.172.
+AVX2_FMA_TARGET static __m256
+log2Avx2 (__m256 x)
+{
+  const __m256i mantissaMask = _mm256_set1_epi32 (0x007FFFFF);
+  const __m256i one = _mm256_castps_si256 (_mm256_set1_ps (1.0f));
+  __m256i bits = _mm256_castps_si256 (x);
+  __m256i exponent = _mm256_sub_epi32 (_mm256_srli_epi32 (bits, 23),
+                                       _mm256_set1_epi32 (127));
+  __m256 mantissa = _mm256_castsi256_ps (
+    _mm256_or_si256 (_mm256_and_si256 (bits, mantissaMask), one));
+  __m256 isLarge = _mm256_cmp_ps (mantissa, _mm256_set1_ps (1.41421356f),
+                                  _CMP_GT_OQ);
+  mantissa = _mm256_blendv_ps (mantissa,
+                               _mm256_mul_ps (mantissa, _mm256_set1_ps (0.5f)),
+                               isLarge);
+  // isLarge is -1 in the lanes that were halved.
+  exponent = _mm256_sub_epi32 (exponent, _mm256_castps_si256 (isLarge));
+
+  __m256 t = _mm256_div_ps (_mm256_sub_ps (mantissa, _mm256_set1_ps (1.0f)),
+                            _mm256_add_ps (mantissa, _mm256_set1_ps (1.0f)));
+  __m256 t2 = _mm256_mul_ps (t, t);
+  __m256 series = _mm256_set1_ps (1.0f / 9.0f);
+  series = _mm256_fmadd_ps (series, t2, _mm256_set1_ps (1.0f / 7.0f));
+  series = _mm256_fmadd_ps (series, t2, _mm256_set1_ps (1.0f / 5.0f));
+  series = _mm256_fmadd_ps (series, t2, _mm256_set1_ps (1.0f / 3.0f));
+  series = _mm256_fmadd_ps (series, t2, _mm256_set1_ps (1.0f));
+  // 2 / ln (2) turns 2 * t * series from ln (m) into log2 (m).
+  __m256 log2Mantissa = _mm256_mul_ps (_mm256_mul_ps (t, series),
+                                       _mm256_set1_ps (2.88539008f));
+  return _mm256_add_ps (_mm256_cvtepi32_ps (exponent), log2Mantissa);
+}
+
+// 2^y.  y is split into an integer i and f in [-1/2, 1/2]; 2^f is the Taylor
+//   series of e^(f ln 2) and 2^i is built directly in the exponent bits.
+AVX2_FMA_TARGET static __m256
+exp2Avx2 (__m256 y)
+{
+  y = _mm256_min_ps (_mm256_max_ps (y, _mm256_set1_ps (-126.0f)),
+                     _mm256_set1_ps (127.0f));
+  __m256 whole = _mm256_round_ps (y, _MM_FROUND_TO_NEAREST_INT
+                                     | _MM_FROUND_NO_EXC);
+  __m256 g = _mm256_mul_ps (_mm256_sub_ps (y, whole),
+                            _mm256_set1_ps (0.693147181f));
+  __m256 series = _mm256_set1_ps (1.0f / 720.0f);
+  series = _mm256_fmadd_ps (series, g, _mm256_set1_ps (1.0f / 120.0f));
+  series = _mm256_fmadd_ps (series, g, _mm256_set1_ps (1.0f / 24.0f));
+  series = _mm256_fmadd_ps (series, g, _mm256_set1_ps (1.0f / 6.0f));
+  series = _mm256_fmadd_ps (series, g, _mm256_set1_ps (0.5f));
+  series = _mm256_fmadd_ps (series, g, _mm256_set1_ps (1.0f));
+  series = _mm256_fmadd_ps (series, g, _mm256_set1_ps (1.0f));
+  __m256i scaleBits = _mm256_slli_epi32 (
+    _mm256_add_epi32 (_mm256_cvtps_epi32 (whole), _mm256_set1_epi32 (127)),
+    23);
+  return _mm256_mul_ps (series, _mm256_castsi256_ps (scaleBits));
+}
+
+// powPositive in every lane.
+AVX2_FMA_TARGET static __m256
+powAvx2 (__m256 x, float y)
+{
+  __m256 isPositive = _mm256_cmp_ps (x, _mm256_setzero_ps (), _CMP_GT_OQ);
+  __m256 safeX = _mm256_max_ps (x, _mm256_set1_ps (1.17549435e-38f));
+  __m256 result = exp2Avx2 (_mm256_mul_ps (_mm256_set1_ps (y),
+                                           log2Avx2 (safeX)));
+  return _mm256_and_ps (result, isPositive);
+}
+
+AVX2_FMA_TARGET static __m256
+dotAvx2 (__m256 ax, __m256 ay, __m256 az, __m256 bx, __m256 by, __m256 bz)
+{
+  return _mm256_fmadd_ps (ax, bx, _mm256_fmadd_ps (ay, by,
+                                                   _mm256_mul_ps (az, bz)));
+}
+
+// shadePhongAvx2, which is only a wrapper so that its declaration does not
+//   need the target attribute.
+AVX2_FMA_TARGET static void
+shadePhongAvx2Target (const MaterialUniforms& material,
+                      const float eyePosition[3], const LightUniforms* lights,
+                      size_t lightCount, const PhongFragments& fragments,
+                      PhongColors& colors)
+{
+  const __m256 zero = _mm256_setzero_ps ();
+  const __m256 one = _mm256_set1_ps (1.0f);
+  __m256 positionX = _mm256_loadu_ps (fragments.positionX);
+  __m256 positionY = _mm256_loadu_ps (fragments.positionY);
+  __m256 positionZ = _mm256_loadu_ps (fragments.positionZ);
+  __m256 normalX = _mm256_loadu_ps (fragments.normalX);
+  __m256 normalY = _mm256_loadu_ps (fragments.normalY);
+  __m256 normalZ = _mm256_loadu_ps (fragments.normalZ);
+  __m256 diffuseR = _mm256_loadu_ps (fragments.diffuseR);
+  __m256 diffuseG = _mm256_loadu_ps (fragments.diffuseG);
+  __m256 diffuseB = _mm256_loadu_ps (fragments.diffuseB);
+
+  // The eye vector does not depend on the light.
+  __m256 eyeX = _mm256_sub_ps (_mm256_set1_ps (eyePosition[0]), positionX);
+  __m256 eyeY = _mm256_sub_ps (_mm256_set1_ps (eyePosition[1]), positionY);
+  __m256 eyeZ = _mm256_sub_ps (_mm256_set1_ps (eyePosition[2]), positionZ);
+  __m256 eyeLength = _mm256_sqrt_ps (dotAvx2 (eyeX, eyeY, eyeZ,
+                                              eyeX, eyeY, eyeZ));
+  eyeX = _mm256_div_ps (eyeX, eyeLength);
+  eyeY = _mm256_div_ps (eyeY, eyeLength);
+  eyeZ = _mm256_div_ps (eyeZ, eyeLength);
+
+  __m256 red = _mm256_loadu_ps (colors.red);
+  __m256 green = _mm256_loadu_ps (colors.green);
+  __m256 blue = _mm256_loadu_ps (colors.blue);
+  for (size_t i = 0; i < lightCount; ++i)
+  {
+    const LightUniforms& light = lights[i];
+    // Every lane sees the same light, so its type is a scalar branch; only
+    //   the per-fragment conditions below need masks.
+    __m256 lightX, lightY, lightZ, distance;
+    if (light.type == DIRECTIONAL)
+    {
+      Vector3 direction (-light.direction[0], -light.direction[1],
+                         -light.direction[2]);
+      direction.normalize ();
+      lightX = _mm256_set1_ps (direction.m_x);
+      lightY = _mm256_set1_ps (direction.m_y);
+      lightZ = _mm256_set1_ps (direction.m_z);
+      distance = zero;
+    }
+    else
+    {
+      lightX = _mm256_sub_ps (_mm256_set1_ps (light.position[0]), positionX);
+      lightY = _mm256_sub_ps (_mm256_set1_ps (light.position[1]), positionY);
+      lightZ = _mm256_sub_ps (_mm256_set1_ps (light.position[2]), positionZ);
+      distance = _mm256_sqrt_ps (dotAvx2 (lightX, lightY, lightZ,
+                                          lightX, lightY, lightZ));
+      lightX = _mm256_div_ps (lightX, distance);
+      lightY = _mm256_div_ps (lightY, distance);
+      lightZ = _mm256_div_ps (lightZ, distance);
+    }
+
+    __m256 lambertianCoef = dotAvx2 (lightX, lightY, lightZ,
+                                     normalX, normalY, normalZ);
+    __m256 isLit = _mm256_cmp_ps (lambertianCoef, zero, _CMP_GT_OQ);
+    if (_mm256_movemask_ps (isLit) == 0)
+    {
+      continue;
+    }
+
+    // reflect (-L, N) is -L + 2 * dot (N, L) * N.
+    __m256 twoNDotL = _mm256_add_ps (lambertianCoef, lambertianCoef);
+    __m256 reflectionX = _mm256_fmsub_ps (twoNDotL, normalX, lightX);
+    __m256 reflectionY = _mm256_fmsub_ps (twoNDotL, normalY, lightY);
+    __m256 reflectionZ = _mm256_fmsub_ps (twoNDotL, normalZ, lightZ);
+    __m256 specularCoef = _mm256_max_ps (dotAvx2 (eyeX, eyeY, eyeZ,
+                                                  reflectionX, reflectionY,
+                                                  reflectionZ), zero);
+    __m256 specular = powAvx2 (specularCoef, material.specularPower);
+
+    __m256 factor = one;
+    if (light.type != DIRECTIONAL)
+    {
+      const float* coefficients = light.attenuationCoefficients;
+      __m256 denominator = _mm256_fmadd_ps (
+        _mm256_fmadd_ps (_mm256_set1_ps (coefficients[2]), distance,
+                         _mm256_set1_ps (coefficients[1])),
+        distance, _mm256_set1_ps (coefficients[0]));
+      factor = _mm256_div_ps (one, denominator);
+    }
+    if (light.type == SPOT)
+    {
+      __m256 cosTheta = _mm256_max_ps (
+        _mm256_sub_ps (zero, dotAvx2 (lightX, lightY, lightZ,
+                                      _mm256_set1_ps (light.direction[0]),
+                                      _mm256_set1_ps (light.direction[1]),
+                                      _mm256_set1_ps (light.direction[2]))),
+        zero);
+      __m256 isInCone = _mm256_cmp_ps (cosTheta,
+                                       _mm256_set1_ps (light.cutoffCosAngle),
+                                       _CMP_GE_OQ);
+      __m256 spotFactor = powAvx2 (_mm256_and_ps (cosTheta, isInCone),
+                                   light.falloff);
+      factor = _mm256_mul_ps (factor, spotFactor);
+    }
+
+    // (diffuse + specular) * factor, with the unlit lanes masked to 0.
+    __m256 lambertianFactor = _mm256_mul_ps (lambertianCoef, factor);
+    __m256 specularFactor = _mm256_mul_ps (specular, factor);
+    __m256 contributions[3] = { red, green, blue };
+    __m256 diffuseReflections[3] = { diffuseR, diffuseG, diffuseB };
+    for (int c = 0; c < 3; ++c)
+    {
+      __m256 diffuse = _mm256_mul_ps (
+        _mm256_mul_ps (diffuseReflections[c],
+                       _mm256_set1_ps (light.diffuseIntensity[c])),
+        lambertianFactor);
+      __m256 lit = _mm256_fmadd_ps (
+        _mm256_set1_ps (material.specularReflection[c]
+                        * light.specularIntensity[c]),
+        specularFactor, diffuse);
+      contributions[c] = _mm256_add_ps (contributions[c],
+                                        _mm256_and_ps (lit, isLit));
+    }
+    red = contributions[0];
+    green = contributions[1];
+    blue = contributions[2];
+  }
+  _mm256_storeu_ps (colors.red, red);
+  _mm256_storeu_ps (colors.green, green);
+  _mm256_storeu_ps (colors.blue, blue);
+}
+
+void
+shadePhongAvx2 (const MaterialUniforms& material, const float eyePosition[3],
+                const LightUniforms* lights, size_t lightCount,
+                const PhongFragments& fragments, PhongColors& colors)
+{
+  shadePhongAvx2Target (material, eyePosition, lights, lightCount, fragments,
+                        colors);
+}
+
+bool
+hasAvx2PhongKernel ()
+{
+  return isAvx2FmaSupported ();
+}
+
+#else
+
+void
+shadePhongAvx2 (const MaterialUniforms& material, const float eyePosition[3],
+                const LightUniforms* lights, size_t lightCount,
+                const PhongFragments& fragments, PhongColors& colors)
+{
+  shadePhongScalar (material, eyePosition, lights, lightCount, fragments,
+                    colors);
+}
+
+bool
+hasAvx2PhongKernel ()
+{
+  return false;
+}
+
+#endif
+
+void
+shadePhong (const MaterialUniforms& material, const float eyePosition[3],
+            const LightUniforms* lights, size_t lightCount,
+            const PhongFragments& fragments, PhongColors& colors)
+{
+  if (hasAvx2PhongKernel ())
+  {
+    shadePhongAvx2 (material, eyePosition, lights, lightCount, fragments,
+                    colors);
+  }
+  else
+  {
+    shadePhongScalar (material, eyePosition, lights, lightCount, fragments,
+                      colors);
+  }
+}
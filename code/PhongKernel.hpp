@@ -0,0 +1,90 @@
+/// \file PhongKernel.hpp
+/// \brief Declaration of the CPU versions of PhongShader.frag's lighting,
+///   which shade a batch of fragments at a time.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef PHONG_KERNEL_HPP
+#define PHONG_KERNEL_HPP
+
+#include <cstddef>
+
+#include "UniformBlocks.hpp"
+
+/// \brief The number of fragments shaded by one call to a Phong kernel, which
+///   is the number of floats in an AVX2 register.
+const int PHONG_BATCH_SIZE = 8;
+
+/// \brief A batch of fragments in structure-of-arrays form, so that each
+///   array fills one AVX2 register.
+/// Everything is in world space, which is the space LightSource::writeUniforms
+///   publishes lights in, so lighting can be computed without a camera (for
+///   example, for the texels of a lightmap).
+/// The kernels do not need the alignment, since C++14 containers do not
+///   always honor it, but it keeps batches on the stack from splitting cache
+///   lines.
+struct alignas (32) PhongFragments
+{
+  float positionX[PHONG_BATCH_SIZE];
+  float positionY[PHONG_BATCH_SIZE];
+  float positionZ[PHONG_BATCH_SIZE];
+  /// Must be unit length.
+  float normalX[PHONG_BATCH_SIZE];
+  float normalY[PHONG_BATCH_SIZE];
+  float normalZ[PHONG_BATCH_SIZE];
+  /// The diffuse reflection, which is read from the texture if the object has
+  ///   one and is the material's otherwise.
+  float diffuseR[PHONG_BATCH_SIZE];
+  float diffuseG[PHONG_BATCH_SIZE];
+  float diffuseB[PHONG_BATCH_SIZE];
+};
+
+/// \brief The colors of a batch of fragments.
+struct alignas (32) PhongColors
+{
+  float red[PHONG_BATCH_SIZE];
+  float green[PHONG_BATCH_SIZE];
+  float blue[PHONG_BATCH_SIZE];
+};
+
+/// \brief Adds the light from each light source to each fragment, the way
+///   calculateLighting in PhongShader.frag does, one fragment at a time.
+/// This is the reference the AVX2 kernel is validated against.
+/// \param[in] material The material's uniforms.  Only the specular
+///   reflection and power are used.
+/// \param[in] eyePosition The world-space position the fragments are viewed
+///   from.
+/// \param[in] lights The lights, as filled in by LightSource::writeUniforms.
+/// \param[in] lightCount The number of elements of lights.
+/// \param[in] fragments The fragments to shade.
+/// \param[in, out] colors The colors to add to.  They are not clamped, so the
+///   caller can add ambient and emissive light before or after.
+void
+shadePhongScalar (const MaterialUniforms& material, const float eyePosition[3],
+                  const LightUniforms* lights, size_t lightCount,
+                  const PhongFragments& fragments, PhongColors& colors);
+
+/// \brief Does the same as shadePhongScalar with AVX2 and FMA instructions.
+/// Every light is applied to all fragments at once, and lanes that face away
+///   from a light or are outside a spot light's cone are masked off.  The
+///   powers are computed with exp2 and log2 polynomials, which agree with
+///   std::pow to a relative error of about 1e-5.
+/// \pre hasAvx2PhongKernel () is true.
+void
+shadePhongAvx2 (const MaterialUniforms& material, const float eyePosition[3],
+                const LightUniforms* lights, size_t lightCount,
+                const PhongFragments& fragments, PhongColors& colors);
+
+/// \brief Whether this CPU, and the compiler this was built with, can run
+///   shadePhongAvx2.
+bool
+hasAvx2PhongKernel ();
+
+/// \brief Calls shadePhongAvx2 if this CPU supports it and shadePhongScalar
+///   otherwise.
+void
+shadePhong (const MaterialUniforms& material, const float eyePosition[3],
+            const LightUniforms* lights, size_t lightCount,
+            const PhongFragments& fragments, PhongColors& colors);
+
+#endif//PHONG_KERNEL_HPP
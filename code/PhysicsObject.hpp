@@ -8,6 +8,7 @@
 
 #include "Vector3.hpp"
 #include "Mesh.hpp"
+#include "EntitySystems.hpp"
 
 class PhysicsObject 
 {
@@ -25,9 +26,7 @@ public:
 private:
   Mesh* m_mesh;
   Vector3 m_velocity;
-  Vector3 m_xBound;
-  Vector3 m_yBound;
-  Vector3 m_zBound;
+  Walls m_walls;
   float m_radius;
 };
 
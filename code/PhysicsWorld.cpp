@@ -0,0 +1,454 @@
+/// \file PhysicsWorld.cpp
+/// \brief Definition of PhysicsWorld class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "PhysicsWorld.hpp"
+
+namespace
+{
+  /// The bits of a cell key given to each axis.
+  const unsigned CELL_BITS = 21;
+  const int64_t CELL_MASK = (int64_t (1) << CELL_BITS) - 1;
+
+  /// \brief Packs the coordinates of a grid cell into one key.
+  uint64_t
+  cellKey (int64_t x, int64_t y, int64_t z)
+  {
+    return static_cast<uint64_t> (((x & CELL_MASK) << (2 * CELL_BITS))
+                                  | ((y & CELL_MASK) << CELL_BITS)
+                                  | (z & CELL_MASK));
+  }
+
+  /// \brief Gets the cell a coordinate falls in.
+  int64_t
+  cellOf (float coordinate, float inverseCellSize)
+  {
+    return static_cast<int64_t> (std::floor (coordinate * inverseCellSize));
+  }
+}
+
+PhysicsWorld::PhysicsWorld ()
+  : m_restitution (1.0f),
+    m_minBound { -std::numeric_limits<float>::max (),
+                 -std::numeric_limits<float>::max (),
+                 -std::numeric_limits<float>::max () },
+    m_maxBound { std::numeric_limits<float>::max (),
+                 std::numeric_limits<float>::max (),
+                 std::numeric_limits<float>::max () },
+    m_broadphase (Broadphase::SWEEP_AND_PRUNE),
+    m_cellSize (0.0f)
+{
+
+}
+
+unsigned
+PhysicsWorld::addSphere (const Vector3& position, const Vector3& velocity,
+                         float radius)
+{
+  float volume = 4.0f / 3.0f * 3.14159265f * radius * radius * radius;
+  return addBody (Shape::SPHERE, position, velocity,
+                  Vector3 (radius, radius, radius), volume);
+}
+
+unsigned
+PhysicsWorld::addBox (const Vector3& position, const Vector3& velocity,
+                      const Vector3& halfSize)
+{
+  float volume = 8.0f * halfSize.m_x * halfSize.m_y * halfSize.m_z;
+  return addBody (Shape::BOX, position, velocity, halfSize, volume);
+}
+
+unsigned
+PhysicsWorld::addBody (Shape shape, const Vector3& position,
+                       const Vector3& velocity, const Vector3& halfSize,
+                       float mass)
+{
+  unsigned body = static_cast<unsigned> (m_shapes.size ());
+  m_shapes.push_back (shape);
+  m_x.push_back (position.m_x);
+  m_y.push_back (position.m_y);
+  m_z.push_back (position.m_z);
+  m_vx.push_back (velocity.m_x);
+  m_vy.push_back (velocity.m_y);
+  m_vz.push_back (velocity.m_z);
+  m_hx.push_back (halfSize.m_x);
+  m_hy.push_back (halfSize.m_y);
+  m_hz.push_back (halfSize.m_z);
+  m_inverseMasses.push_back (0.0f);
+  setMass (body, mass);
+  // New bodies go at the end of the order; the next sort moves them into
+  //   place.
+  m_order.push_back (body);
+  return body;
+}
+
+void
+PhysicsWorld::setMass (unsigned body, float mass)
+{
+  m_inverseMasses[body] = mass > 0.0f ? 1.0f / mass : 0.0f;
+}
+
+void
+PhysicsWorld::setRestitution (float restitution)
+{
+  m_restitution = restitution;
+}
+
+void
+PhysicsWorld::setBounds (float left, float right, float up, float down,
+                         float near, float far)
+{
+  m_minBound[0] = left;
+  m_maxBound[0] = right;
+  m_minBound[1] = down;
+  m_maxBound[1] = up;
+  m_minBound[2] = far;
+  m_maxBound[2] = near;
+}
+
+void
+PhysicsWorld::setBroadphase (Broadphase broadphase, float cellSize)
+{
+  m_broadphase = broadphase;
+  m_cellSize = cellSize;
+}
+
+void
+PhysicsWorld::step (float deltaTime)
+{
+  integrate (deltaTime);
+  if (m_broadphase == Broadphase::SWEEP_AND_PRUNE)
+  {
+    sweepAndPrune ();
+  }
+  else
+  {
+    findPairsInGrid ();
+  }
+  m_contacts.clear ();
+  for (const Pair& pair : m_pairs)
+  {
+    if (resolve (pair.first, pair.second))
+    {
+      m_contacts.push_back (pair);
+    }
+  }
+}
+
+void
+PhysicsWorld::integrate (float deltaTime)
+{
+  // One axis at a time, so each loop touches three arrays.
+  float* positions[3] = { m_x.data (), m_y.data (), m_z.data () };
+  float* velocities[3] = { m_vx.data (), m_vy.data (), m_vz.data () };
+  const float* halfSizes[3] = { m_hx.data (), m_hy.data (), m_hz.data () };
+  size_t count = m_shapes.size ();
+  for (unsigned axis = 0; axis < 3; ++axis)
+  {
+    float* position = positions[axis];
+    float* velocity = velocities[axis];
+    const float* halfSize = halfSizes[axis];
+    float low = m_minBound[axis];
+    float high = m_maxBound[axis];
+    for (size_t body = 0; body < count; ++body)
+    {
+      position[body] += velocity[body] * deltaTime;
+      // Only turn around bodies still heading out, so that one that went
+      //   too far does not flip back and forth outside the wall.
+      if ((position[body] - halfSize[body] < low && velocity[body] < 0.0f)
+          || (position[body] + halfSize[body] > high && velocity[body] > 0.0f))
+      {
+        velocity[body] = -velocity[body];
+      }
+    }
+  }
+}
+
+void
+PhysicsWorld::sweepAndPrune ()
+{
+  size_t count = m_order.size ();
+  m_sortedMinX.resize (count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    unsigned body = m_order[i];
+    m_sortedMinX[i] = m_x[body] - m_hx[body];
+  }
+  // The order is last step's, which is nearly sorted, so an insertion sort
+  //   only does work for bodies that passed each other.
+  for (size_t i = 1; i < count; ++i)
+  {
+    float minX = m_sortedMinX[i];
+    unsigned body = m_order[i];
+    size_t j = i;
+    while (j > 0 && m_sortedMinX[j - 1] > minX)
+    {
+      m_sortedMinX[j] = m_sortedMinX[j - 1];
+      m_order[j] = m_order[j - 1];
+      --j;
+    }
+    m_sortedMinX[j] = minX;
+    m_order[j] = body;
+  }
+
+  m_pairs.clear ();
+  for (size_t i = 0; i < count; ++i)
+  {
+    unsigned a = m_order[i];
+    float maxX = m_x[a] + m_hx[a];
+    for (size_t j = i + 1; j < count && m_sortedMinX[j] <= maxX; ++j)
+    {
+      unsigned b = m_order[j];
+      if (overlapsInYz (a, b))
+      {
+        m_pairs.emplace_back (std::min (a, b), std::max (a, b));
+      }
+    }
+  }
+}
+
+void
+PhysicsWorld::findPairsInGrid ()
+{
+  size_t count = m_shapes.size ();
+  float cellSize = m_cellSize;
+  if (cellSize <= 0.0f)
+  {
+    float largest = 0.0f;
+    for (size_t body = 0; body < count; ++body)
+    {
+      largest = std::max ({ largest, m_hx[body], m_hy[body], m_hz[body] });
+    }
+    cellSize = std::max (2.0f * largest, std::numeric_limits<float>::min ());
+  }
+  float inverseCellSize = 1.0f / cellSize;
+
+  m_cellEntries.clear ();
+  for (unsigned body = 0; body < count; ++body)
+  {
+    int64_t x0 = cellOf (m_x[body] - m_hx[body], inverseCellSize);
+    int64_t x1 = cellOf (m_x[body] + m_hx[body], inverseCellSize);
+    int64_t y0 = cellOf (m_y[body] - m_hy[body], inverseCellSize);
+    int64_t y1 = cellOf (m_y[body] + m_hy[body], inverseCellSize);
+    int64_t z0 = cellOf (m_z[body] - m_hz[body], inverseCellSize);
+    int64_t z1 = cellOf (m_z[body] + m_hz[body], inverseCellSize);
+    for (int64_t x = x0; x <= x1; ++x)
+      for (int64_t y = y0; y <= y1; ++y)
+        for (int64_t z = z0; z <= z1; ++z)
+          m_cellEntries.emplace_back (cellKey (x, y, z), body);
+  }
+  std::sort (m_cellEntries.begin (), m_cellEntries.end ());
+
+  m_pairs.clear ();
+  for (size_t first = 0; first < m_cellEntries.size (); )
+  {
+    uint64_t key = m_cellEntries[first].first;
+    size_t last = first + 1;
+    while (last < m_cellEntries.size () && m_cellEntries[last].first == key)
+    {
+      ++last;
+    }
+    for (size_t i = first; i < last; ++i)
+    {
+      unsigned a = m_cellEntries[i].second;
+      for (size_t j = i + 1; j < last; ++j)
+      {
+        unsigned b = m_cellEntries[j].second;
+        // The same x test as sweep and prune, so both find the same pairs.
+        if (std::max (m_x[a] - m_hx[a], m_x[b] - m_hx[b])
+              > std::min (m_x[a] + m_hx[a], m_x[b] + m_hx[b])
+            || !overlapsInYz (a, b))
+        {
+          continue;
+        }
+        // Bodies that share several cells are only paired in the one holding
+        //   the low corner of their overlap.
+        int64_t x = cellOf (std::max (m_x[a] - m_hx[a], m_x[b] - m_hx[b]),
+                            inverseCellSize);
+        int64_t y = cellOf (std::max (m_y[a] - m_hy[a], m_y[b] - m_hy[b]),
+                            inverseCellSize);
+        int64_t z = cellOf (std::max (m_z[a] - m_hz[a], m_z[b] - m_hz[b]),
+                            inverseCellSize);
+        if (cellKey (x, y, z) == key)
+        {
+          m_pairs.emplace_back (std::min (a, b), std::max (a, b));
+        }
+      }
+    }
+    first = last;
+  }
+}
+
+bool
+PhysicsWorld::overlapsInYz (unsigned a, unsigned b) const
+{
+  return std::abs (m_y[a] - m_y[b]) <= m_hy[a] + m_hy[b]
+    && std::abs (m_z[a] - m_z[b]) <= m_hz[a] + m_hz[b];
+}
+
+bool
+PhysicsWorld::resolve (unsigned a, unsigned b)
+{
+  float weightA = m_inverseMasses[a];
+  float weightB = m_inverseMasses[b];
+  if (weightA + weightB == 0.0f)
+  {
+    return false;
+  }
+
+  // Find the normal (from a to b) and how far they overlap along it.
+  Vector3 normal;
+  float depth = 0.0f;
+  Vector3 positionA (m_x[a], m_y[a], m_z[a]);
+  Vector3 positionB (m_x[b], m_y[b], m_z[b]);
+  if (m_shapes[a] == Shape::SPHERE && m_shapes[b] == Shape::SPHERE)
+  {
+    Vector3 offset = positionB - positionA;
+    float distance = offset.length ();
+    depth = m_hx[a] + m_hx[b] - distance;
+    if (depth <= 0.0f)
+    {
+      return false;
+    }
+    normal = distance > 0.0f ? offset / distance : Vector3 (1.0f, 0.0f, 0.0f);
+  }
+  else if (m_shapes[a] == Shape::BOX && m_shapes[b] == Shape::BOX)
+  {
+    // The broadphase already knows the boxes overlap, so push them apart
+    //   along the axis they overlap least on.
+    Vector3 offset = positionB - positionA;
+    float overlaps[3] = { m_hx[a] + m_hx[b] - std::abs (offset.m_x),
+                          m_hy[a] + m_hy[b] - std::abs (offset.m_y),
+                          m_hz[a] + m_hz[b] - std::abs (offset.m_z) };
+    unsigned axis = static_cast<unsigned> (
+      std::min_element (overlaps, overlaps + 3) - overlaps);
+    depth = overlaps[axis];
+    if (depth <= 0.0f)
+    {
+      return false;
+    }
+    float along[3] = { offset.m_x, offset.m_y, offset.m_z };
+    float direction = along[axis] < 0.0f ? -1.0f : 1.0f;
+    normal = Vector3 (axis == 0 ? direction : 0.0f,
+                      axis == 1 ? direction : 0.0f,
+                      axis == 2 ? direction : 0.0f);
+  }
+  else
+  {
+    // The same closest-point test as Ball::collides3D.
+    bool isSphereA = m_shapes[a] == Shape::SPHERE;
+    unsigned sphere = isSphereA ? a : b;
+    unsigned box = isSphereA ? b : a;
+    Vector3 center (m_x[sphere], m_y[sphere], m_z[sphere]);
+    Vector3 closest (
+      std::max (m_x[box] - m_hx[box], std::min (center.m_x, m_x[box] + m_hx[box])),
+      std::max (m_y[box] - m_hy[box], std::min (center.m_y, m_y[box] + m_hy[box])),
+      std::max (m_z[box] - m_hz[box], std::min (center.m_z, m_z[box] + m_hz[box])));
+    Vector3 offset = center - closest;
+    float distance = offset.length ();
+    float radius = m_hx[sphere];
+    if (distance >= radius)
+    {
+      return false;
+    }
+    Vector3 boxToSphere;
+    if (distance > 0.0f)
+    {
+      boxToSphere = offset / distance;
+      depth = radius - distance;
+    }
+    else
+    {
+      // The center is inside the box, so leave through the nearest face.
+      Vector3 inside = center - Vector3 (m_x[box], m_y[box], m_z[box]);
+      float overlaps[3] = { m_hx[box] - std::abs (inside.m_x),
+                            m_hy[box] - std::abs (inside.m_y),
+                            m_hz[box] - std::abs (inside.m_z) };
+      unsigned axis = static_cast<unsigned> (
+        std::min_element (overlaps, overlaps + 3) - overlaps);
+      float along[3] = { inside.m_x, inside.m_y, inside.m_z };
+      float direction = along[axis] < 0.0f ? -1.0f : 1.0f;
+      boxToSphere = Vector3 (axis == 0 ? direction : 0.0f,
+                             axis == 1 ? direction : 0.0f,
+                             axis == 2 ? direction : 0.0f);
+      depth = overlaps[axis] + radius;
+    }
+    normal = isSphereA ? -boxToSphere : boxToSphere;
+  }
+
+  // Separate them in proportion to how easily each is pushed.
+  float totalWeight = weightA + weightB;
+  Vector3 correction = normal * (depth / totalWeight);
+  m_x[a] -= correction.m_x * weightA;
+  m_y[a] -= correction.m_y * weightA;
+  m_z[a] -= correction.m_z * weightA;
+  m_x[b] += correction.m_x * weightB;
+  m_y[b] += correction.m_y * weightB;
+  m_z[b] += correction.m_z * weightB;
+
+  // Bounce them if they are still approaching.
+  Vector3 relative (m_vx[b] - m_vx[a], m_vy[b] - m_vy[a], m_vz[b] - m_vz[a]);
+  float approach = relative.dot (normal);
+  if (approach < 0.0f)
+  {
+    Vector3 impulse = normal * (-(1.0f + m_restitution) * approach
+                                / totalWeight);
+    m_vx[a] -= impulse.m_x * weightA;
+    m_vy[a] -= impulse.m_y * weightA;
+    m_vz[a] -= impulse.m_z * weightA;
+    m_vx[b] += impulse.m_x * weightB;
+    m_vy[b] += impulse.m_y * weightB;
+    m_vz[b] += impulse.m_z * weightB;
+  }
+  return true;
+}
+
+size_t
+PhysicsWorld::getBodyCount () const
+{
+  return m_shapes.size ();
+}
+
+PhysicsWorld::Shape
+PhysicsWorld::getShape (unsigned body) const
+{
+  return m_shapes[body];
+}
+
+Vector3
+PhysicsWorld::getPosition (unsigned body) const
+{
+  return Vector3 (m_x[body], m_y[body], m_z[body]);
+}
+
+Vector3
+PhysicsWorld::getVelocity (unsigned body) const
+{
+  return Vector3 (m_vx[body], m_vy[body], m_vz[body]);
+}
+
+void
+PhysicsWorld::setVelocity (unsigned body, const Vector3& velocity)
+{
+  m_vx[body] = velocity.m_x;
+  m_vy[body] = velocity.m_y;
+  m_vz[body] = velocity.m_z;
+}
+
+const std::vector<PhysicsWorld::Pair>&
+PhysicsWorld::getCandidatePairs () const
+{
+  return m_pairs;
+}
+
+const std::vector<PhysicsWorld::Pair>&
+PhysicsWorld::getContacts () const
+{
+  return m_contacts;
+}
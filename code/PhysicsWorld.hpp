@@ -0,0 +1,214 @@
+/// \file PhysicsWorld.hpp
+/// \brief Declaration of PhysicsWorld class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef PHYSICS_WORLD_HPP
+#define PHYSICS_WORLD_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Vector3.hpp"
+
+/// \brief Moves spheres and axis-aligned boxes, bounces them off the walls of
+///   a box, and bounces them off each other.
+/// Bodies are stored in structure-of-arrays form, one array per coordinate,
+///   so that each pass over them reads only what it needs.  Each step moves
+///   every body, finds the pairs whose bounding boxes overlap (the
+///   broadphase), tests those pairs against the bodies' actual shapes (the
+///   narrowphase), and pushes touching bodies apart and bounces them.
+/// There are two broadphases:
+///   - Sweep and prune keeps the bodies sorted by the left edge of their
+///     bounding boxes.  Bodies move little from step to step, so re-sorting
+///     with an insertion sort is close to linear, and a sweep along the sorted
+///     order only compares bodies whose x-intervals overlap.
+///   - A uniform grid puts each body in every cell its bounding box touches
+///     and only compares bodies that share a cell.  It does better than sweep
+///     and prune in large crowds, where the number of bodies whose
+///     x-intervals overlap grows faster than the number of bodies.
+/// Both find the same pairs, though not in the same order.  Bodies know
+///   nothing of Meshes or OpenGL, so the world can be stepped and timed
+///   headlessly; whoever owns it copies positions out to whatever draws them.
+class PhysicsWorld
+{
+public:
+
+  /// \brief The shape of a body.
+  enum class Shape : unsigned char
+  {
+    SPHERE,
+    BOX
+  };
+
+  /// \brief How to find the pairs of bodies that might touch.
+  enum class Broadphase
+  {
+    SWEEP_AND_PRUNE,
+    UNIFORM_GRID
+  };
+
+  /// \brief Two bodies, the lower index first.
+  using Pair = std::pair<unsigned, unsigned>;
+
+  /// \brief Constructs an empty world with sweep and prune and walls far
+  ///   enough away to never be touched.
+  PhysicsWorld ();
+
+  /// \brief Adds a sphere.
+  /// \param[in] position Where its center starts.
+  /// \param[in] velocity Its velocity, in units per second.
+  /// \param[in] radius Its radius.
+  /// \return The sphere's index, which it keeps.
+  /// \post Its mass is its volume.
+  unsigned
+  addSphere (const Vector3& position, const Vector3& velocity, float radius);
+
+  /// \brief Adds an axis-aligned box.
+  /// \param[in] position Where its center starts.
+  /// \param[in] velocity Its velocity, in units per second.
+  /// \param[in] halfSize Half its width, height, and depth.
+  /// \return The box's index, which it keeps.
+  /// \post Its mass is its volume.
+  unsigned
+  addBox (const Vector3& position, const Vector3& velocity,
+          const Vector3& halfSize);
+
+  /// \brief Changes how heavy a body is.
+  /// \param[in] body The body's index.
+  /// \param[in] mass Its mass, or 0 for a body that nothing can push, such as
+  ///   a paddle.
+  void
+  setMass (unsigned body, float mass);
+
+  /// \brief Sets how much speed a collision keeps.
+  /// \param[in] restitution 1 for perfectly bouncy bodies, 0 for bodies that
+  ///   stop against each other.
+  void
+  setRestitution (float restitution);
+
+  /// \brief Sets the walls that bodies bounce off, in the same order as
+  ///   PhysicsObject::setBounds.
+  /// \param[in] left The lowest x.
+  /// \param[in] right The highest x.
+  /// \param[in] up The highest y.
+  /// \param[in] down The lowest y.
+  /// \param[in] near The highest z.
+  /// \param[in] far The lowest z.
+  void
+  setBounds (float left, float right, float up, float down, float near,
+             float far);
+
+  /// \brief Chooses the broadphase.
+  /// \param[in] broadphase The broadphase.
+  /// \param[in] cellSize The width of a grid cell; 0 makes it twice the
+  ///   largest half size of any body at each step.  Ignored by sweep and
+  ///   prune.
+  void
+  setBroadphase (Broadphase broadphase, float cellSize = 0.0f);
+
+  /// \brief Moves every body, then bounces the ones that touch.
+  /// \param[in] deltaTime How long the step is, in seconds.
+  /// \post getCandidatePairs and getContacts describe this step.
+  void
+  step (float deltaTime);
+
+  /// \brief Gets the number of bodies.
+  /// \return The number of bodies.
+  size_t
+  getBodyCount () const;
+
+  /// \brief Gets the shape of a body.
+  /// \param[in] body The body's index.
+  /// \return Its shape.
+  Shape
+  getShape (unsigned body) const;
+
+  /// \brief Gets where a body is.
+  /// \param[in] body The body's index.
+  /// \return The position of its center.
+  Vector3
+  getPosition (unsigned body) const;
+
+  /// \brief Gets how fast a body is going.
+  /// \param[in] body The body's index.
+  /// \return Its velocity.
+  Vector3
+  getVelocity (unsigned body) const;
+
+  /// \brief Changes how fast a body is going.
+  /// \param[in] body The body's index.
+  /// \param[in] velocity Its new velocity.
+  void
+  setVelocity (unsigned body, const Vector3& velocity);
+
+  /// \brief Gets the pairs whose bounding boxes overlapped in the last step.
+  /// \return The pairs found by the broadphase.
+  const std::vector<Pair>&
+  getCandidatePairs () const;
+
+  /// \brief Gets the pairs whose shapes touched in the last step.
+  /// \return The pairs the narrowphase bounced.
+  const std::vector<Pair>&
+  getContacts () const;
+
+private:
+  /// \brief Adds a body of either shape.
+  unsigned
+  addBody (Shape shape, const Vector3& position, const Vector3& velocity,
+           const Vector3& halfSize, float mass);
+
+  /// \brief Moves every body and bounces it off the walls.
+  void
+  integrate (float deltaTime);
+
+  /// \brief Fills m_pairs with sweep and prune.
+  void
+  sweepAndPrune ();
+
+  /// \brief Fills m_pairs with a uniform grid.
+  void
+  findPairsInGrid ();
+
+  /// \brief Checks whether two bodies' bounding boxes overlap along y and z.
+  bool
+  overlapsInYz (unsigned a, unsigned b) const;
+
+  /// \brief Tests a pair against its shapes and, if they touch, separates
+  ///   and bounces them.
+  /// \return True if they touched.
+  bool
+  resolve (unsigned a, unsigned b);
+
+  std::vector<Shape> m_shapes;
+  /// Positions.
+  std::vector<float> m_x, m_y, m_z;
+  /// Velocities.
+  std::vector<float> m_vx, m_vy, m_vz;
+  /// Half sizes; all three are the radius for a sphere.
+  std::vector<float> m_hx, m_hy, m_hz;
+  /// 0 for bodies that cannot be pushed.
+  std::vector<float> m_inverseMasses;
+
+  float m_restitution;
+  /// The walls: the lowest and highest coordinate along each axis.
+  float m_minBound[3];
+  float m_maxBound[3];
+
+  Broadphase m_broadphase;
+  float m_cellSize;
+  /// Every body, sorted by the left edge of its bounding box as of the last
+  ///   step.
+  std::vector<unsigned> m_order;
+  /// The left edges of the bodies in m_order.
+  std::vector<float> m_sortedMinX;
+  /// A cell key and a body in it, for the grid.
+  std::vector<std::pair<uint64_t, unsigned>> m_cellEntries;
+
+  std::vector<Pair> m_pairs;
+  std::vector<Pair> m_contacts;
+};
+
+#endif//PHYSICS_WORLD_HPP
@@ -0,0 +1,242 @@
+/// \file Quaternion.cpp
+/// \brief Implementation of Quaternion class and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include "Quaternion.hpp"
+
+Quaternion::Quaternion ()
+: m_w(1.0f), m_x(0.0f), m_y(0.0f), m_z(0.0f)
+{
+
+}
+
+Quaternion::Quaternion (float w, float x, float y, float z)
+: m_w(w), m_x(x), m_y(y), m_z(z)
+{
+
+}
+
+Quaternion::Quaternion (float angleDegrees, const Vector3& axis)
+{
+  setFromAngleAxis (angleDegrees, axis);
+}
+
+void
+Quaternion::setToIdentity ()
+{
+  m_w = 1.0f;
+  m_x = 0.0f;
+  m_y = 0.0f;
+  m_z = 0.0f;
+}
+
+void
+Quaternion::setFromAngleAxis (float angleDegrees, const Vector3& axis)
+{
+  double pi = 3.14159265358979323846;
+  float halfAngle = (angleDegrees * pi / 180.0) / 2.0;
+
+  Vector3 copy = axis;
+  copy.normalize();
+  float s = sin (halfAngle);
+
+  m_w = cos (halfAngle);
+  m_x = copy.m_x * s;
+  m_y = copy.m_y * s;
+  m_z = copy.m_z * s;
+}
+
+void
+Quaternion::setFromMatrix (const Matrix3& m)
+{
+  Vector3 r = m.getRight();
+  Vector3 u = m.getUp();
+  Vector3 b = m.getBack();
+
+  // Pick the largest of w, x, y, z to divide by so that we never divide by
+  //   something close to zero.
+  float trace = r.m_x + u.m_y + b.m_z;
+  if (trace > 0.0f)
+  {
+    float s = 0.5f / std::sqrt (trace + 1.0f);
+    m_w = 0.25f / s;
+    m_x = (u.m_z - b.m_y) * s;
+    m_y = (b.m_x - r.m_z) * s;
+    m_z = (r.m_y - u.m_x) * s;
+  }
+  else if (r.m_x > u.m_y && r.m_x > b.m_z)
+  {
+    float s = 2.0f * std::sqrt (1.0f + r.m_x - u.m_y - b.m_z);
+    m_w = (u.m_z - b.m_y) / s;
+    m_x = 0.25f * s;
+    m_y = (u.m_x + r.m_y) / s;
+    m_z = (b.m_x + r.m_z) / s;
+  }
+  else if (u.m_y > b.m_z)
+  {
+    float s = 2.0f * std::sqrt (1.0f + u.m_y - r.m_x - b.m_z);
+    m_w = (b.m_x - r.m_z) / s;
+    m_x = (u.m_x + r.m_y) / s;
+    m_y = 0.25f * s;
+    m_z = (b.m_y + u.m_z) / s;
+  }
+  else
+  {
+    float s = 2.0f * std::sqrt (1.0f + b.m_z - r.m_x - u.m_y);
+    m_w = (r.m_y - u.m_x) / s;
+    m_x = (b.m_x + r.m_z) / s;
+    m_y = (b.m_y + u.m_z) / s;
+    m_z = 0.25f * s;
+  }
+  normalize();
+}
+
+float
+Quaternion::dot (const Quaternion& q) const
+{
+  return (m_w * q.m_w) + (m_x * q.m_x) + (m_y * q.m_y) + (m_z * q.m_z);
+}
+
+float
+Quaternion::length () const
+{
+  return std::sqrt (dot (*this));
+}
+
+void
+Quaternion::normalize ()
+{
+  float length = this->length();
+  m_w /= length;
+  m_x /= length;
+  m_y /= length;
+  m_z /= length;
+}
+
+void
+Quaternion::conjugate ()
+{
+  m_x = -m_x;
+  m_y = -m_y;
+  m_z = -m_z;
+}
+
+Vector3
+Quaternion::rotate (const Vector3& v) const
+{
+  // v' = v + 2w(q x v) + 2q x (q x v), which is cheaper than q * v * q^-1
+  Vector3 q (m_x, m_y, m_z);
+  Vector3 t = 2.0f * q.cross (v);
+  return v + (m_w * t) + q.cross (t);
+}
+
+Matrix3
+Quaternion::toMatrix3 () const
+{
+  float xx = m_x * m_x;
+  float yy = m_y * m_y;
+  float zz = m_z * m_z;
+  float xy = m_x * m_y;
+  float xz = m_x * m_z;
+  float yz = m_y * m_z;
+  float wx = m_w * m_x;
+  float wy = m_w * m_y;
+  float wz = m_w * m_z;
+
+  return Matrix3 (1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy),
+                  2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx),
+                  2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+}
+
+Quaternion&
+Quaternion::operator*= (const Quaternion& q)
+{
+  float w = (m_w * q.m_w) - (m_x * q.m_x) - (m_y * q.m_y) - (m_z * q.m_z);
+  float x = (m_w * q.m_x) + (m_x * q.m_w) + (m_y * q.m_z) - (m_z * q.m_y);
+  float y = (m_w * q.m_y) - (m_x * q.m_z) + (m_y * q.m_w) + (m_z * q.m_x);
+  float z = (m_w * q.m_z) + (m_x * q.m_y) - (m_y * q.m_x) + (m_z * q.m_w);
+
+  m_w = w;
+  m_x = x;
+  m_y = y;
+  m_z = z;
+  return *this;
+}
+
+Quaternion
+operator* (const Quaternion& q1, const Quaternion& q2)
+{
+  Quaternion copy = q1;
+  copy *= q2;
+  return copy;
+}
+
+Quaternion
+slerp (const Quaternion& q1, const Quaternion& q2, float t)
+{
+  // q and -q are the same rotation, so flip one to take the shorter arc.
+  Quaternion end = q2;
+  float cosTheta = q1.dot (q2);
+  if (cosTheta < 0.0f)
+  {
+    end = Quaternion (-q2.m_w, -q2.m_x, -q2.m_y, -q2.m_z);
+    cosTheta = -cosTheta;
+  }
+
+  // Nearly parallel, so sin(theta) would be close to zero.
+  if (cosTheta > 0.9995f)
+  {
+    return nlerp (q1, end, t);
+  }
+
+  float theta = std::acos (cosTheta);
+  float sinTheta = std::sin (theta);
+  float a = std::sin ((1.0f - t) * theta) / sinTheta;
+  float b = std::sin (t * theta) / sinTheta;
+
+  return Quaternion (a * q1.m_w + b * end.m_w,
+                     a * q1.m_x + b * end.m_x,
+                     a * q1.m_y + b * end.m_y,
+                     a * q1.m_z + b * end.m_z);
+}
+
+Quaternion
+nlerp (const Quaternion& q1, const Quaternion& q2, float t)
+{
+  float sign = (q1.dot (q2) < 0.0f) ? -1.0f : 1.0f;
+  float a = 1.0f - t;
+  float b = t * sign;
+
+  Quaternion result (a * q1.m_w + b * q2.m_w,
+                     a * q1.m_x + b * q2.m_x,
+                     a * q1.m_y + b * q2.m_y,
+                     a * q1.m_z + b * q2.m_z);
+  result.normalize();
+  return result;
+}
+
+std::ostream&
+operator<< (std::ostream& out, const Quaternion& q)
+{
+  out << std::fixed << std::setprecision(2);
+
+  out << std::setw(10) << q.m_w;
+  out << std::setw(10) << q.m_x;
+  out << std::setw(10) << q.m_y;
+  out << std::setw(10) << q.m_z;
+
+  return out;
+}
+
+bool
+operator== (const Quaternion& q1, const Quaternion& q2)
+{
+  float tolerance = 0.00001;
+
+  if (std::abs(q1.m_w - q2.m_w) > tolerance) return false;
+  else if (std::abs(q1.m_x - q2.m_x) > tolerance) return false;
+  else if (std::abs(q1.m_y - q2.m_y) > tolerance) return false;
+  else if (std::abs(q1.m_z - q2.m_z) > tolerance) return false;
+  return true;
+}
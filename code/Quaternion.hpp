@@ -0,0 +1,161 @@
+/// \file Quaternion.hpp
+/// \brief Declaration of Quaternion class and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef QUATERNION_HPP
+#define QUATERNION_HPP
+
+// For overload of shift operator
+#include <iostream>
+
+#include "Vector3.hpp"
+#include "Matrix3.hpp"
+
+/// \brief A quaternion (w + xi + yj + zk) used to represent a rotation.
+/// Only unit quaternions represent rotations, so every operation that builds
+///   a rotation produces a unit quaternion.  Composition follows the same
+///   order as Matrix3: q1 * q2 rotates by q2 first and then by q1.
+/// Like Vector3 the components are public, because any combination of values
+///   is a legal quaternion.
+class Quaternion
+{
+public:
+
+  /// \brief Initializes a new quaternion to the identity rotation.
+  /// \post w is 1.0f while x, y, and z are 0.0f.
+  Quaternion ();
+
+  /// \brief Initializes a new quaternion from its four components.
+  /// \param[in] w The scalar part.
+  /// \param[in] x The coefficient of i.
+  /// \param[in] y The coefficient of j.
+  /// \param[in] z The coefficient of k.
+  /// \post The components are equal to w, x, y, and z respectively.
+  Quaternion (float w, float x, float y, float z);
+
+  /// \brief Initializes a new quaternion that rotates around an axis.
+  /// \param[in] angleDegrees How much to rotate.
+  /// \param[in] axis The vector to rotate around (need not be unit length).
+  /// \post This is a unit quaternion rotating angleDegrees around axis.
+  Quaternion (float angleDegrees, const Vector3& axis);
+
+  /// \brief Sets this to the identity rotation.
+  /// \post w is 1.0f while x, y, and z are 0.0f.
+  void
+  setToIdentity ();
+
+  /// \brief Makes this into a rotation around an arbitrary vector.
+  /// \param[in] angleDegrees How much to rotate.
+  /// \param[in] axis The vector to rotate around (need not be unit length).
+  /// \post This is a unit quaternion rotating angleDegrees around axis.
+  void
+  setFromAngleAxis (float angleDegrees, const Vector3& axis);
+
+  /// \brief Makes this into the rotation stored in a matrix.
+  /// \param[in] m A matrix whose columns are orthonormal (a pure rotation).
+  /// \post This is a unit quaternion representing the same rotation as m.
+  void
+  setFromMatrix (const Matrix3& m);
+
+  /// \brief Computes the 4-D dot product of this with another quaternion.
+  /// \param[in] q The other quaternion.
+  /// \return The dot product of this and q.
+  float
+  dot (const Quaternion& q) const;
+
+  /// \brief Computes the length (norm) of this quaternion.
+  /// \return The length of this quaternion.
+  float
+  length () const;
+
+  /// \brief Normalizes this quaternion.
+  /// \post This quaternion has a length of 1.
+  void
+  normalize ();
+
+  /// \brief Replaces this quaternion with its conjugate, which for a unit
+  ///   quaternion is the inverse rotation.
+  /// \post x, y, and z have been negated.
+  void
+  conjugate ();
+
+  /// \brief Rotates a vector by this quaternion.
+  /// \param[in] v The vector to rotate.
+  /// \return v rotated by this quaternion.
+  /// \pre This is a unit quaternion.
+  Vector3
+  rotate (const Vector3& v) const;
+
+  /// \brief Converts this rotation into a matrix.
+  /// \return A rotation matrix equivalent to this quaternion.
+  /// \pre This is a unit quaternion.
+  Matrix3
+  toMatrix3 () const;
+
+  /// \brief Multiplies this quaternion by another one.
+  /// \param[in] q The quaternion to multiply by.
+  /// \return This quaternion.
+  /// \post This quaternion contains the product of itself with q, which
+  ///   rotates by q first and then by the original value of this.
+  Quaternion&
+  operator*= (const Quaternion& q);
+
+  /// \brief The scalar part.
+  float m_w;
+  /// \brief The coefficient of i.
+  float m_x;
+  /// \brief The coefficient of j.
+  float m_y;
+  /// \brief The coefficient of k.
+  float m_z;
+};
+
+/// \brief Multiplies two quaternions.
+/// \param[in] q1 The left quaternion.
+/// \param[in] q2 The right quaternion.
+/// \return A new quaternion that is q1 * q2.
+Quaternion
+operator* (const Quaternion& q1, const Quaternion& q2);
+
+/// \brief Spherically interpolates between two rotations at constant angular
+///   speed.
+/// \param[in] q1 The rotation at t = 0.
+/// \param[in] q2 The rotation at t = 1.
+/// \param[in] t How far along the arc to go, from 0 to 1.
+/// \return A unit quaternion on the shortest arc between q1 and q2.
+/// \pre q1 and q2 are unit quaternions.
+Quaternion
+slerp (const Quaternion& q1, const Quaternion& q2, float t);
+
+/// \brief Linearly interpolates between two rotations and renormalizes.
+/// This is much cheaper than slerp and is accurate enough when q1 and q2 are
+///   close together, such as two consecutive animation frames.
+/// \param[in] q1 The rotation at t = 0.
+/// \param[in] q2 The rotation at t = 1.
+/// \param[in] t How far to go, from 0 to 1.
+/// \return A unit quaternion on the shortest path between q1 and q2.
+/// \pre q1 and q2 are unit quaternions.
+Quaternion
+nlerp (const Quaternion& q1, const Quaternion& q2, float t);
+
+/// \brief Inserts a quaternion into an output stream.
+/// Each component should have 2 digits of precision and a field width of 10,
+///   in the order w, x, y, z.
+/// \param[in] out An output stream.
+/// \param[in] q A quaternion.
+/// \return The output stream.
+/// \post The quaternion has been inserted into the output stream.
+std::ostream&
+operator<< (std::ostream& out, const Quaternion& q);
+
+/// \brief Checks whether or not two quaternions are equal.
+/// Quaternions are equal if each of their respective components are within
+///   0.00001f of each other due to floating-point imprecision.
+/// \param[in] q1 A quaternion.
+/// \param[in] q2 Another quaternion.
+/// \return Whether or not q1 and q2 are equal.
+bool
+operator== (const Quaternion& q1, const Quaternion& q2);
+
+#endif//QUATERNION_HPP
@@ -0,0 +1,279 @@
+/// \file QuaternionTransform.cpp
+/// \brief Implementation of QuaternionTransform class and any associated
+///   global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include "QuaternionTransform.hpp"
+
+QuaternionTransform::QuaternionTransform ()
+: m_rotation(), m_scale(1.0f, 1.0f, 1.0f), m_position()
+{
+
+}
+
+QuaternionTransform::QuaternionTransform (const Quaternion& rotation,
+                                          const Vector3& scale,
+                                          const Vector3& position)
+: m_rotation(rotation), m_scale(scale), m_position(position)
+{
+  m_rotation.normalize();
+}
+
+QuaternionTransform::QuaternionTransform (const Transform& t)
+: m_rotation(), m_scale(), m_position(t.getPosition())
+{
+  Vector3 r = t.getRight();
+  Vector3 u = t.getUp();
+  Vector3 b = t.getBack();
+  m_scale.set (r.length(), u.length(), b.length());
+
+  r /= m_scale.m_x;
+  u /= m_scale.m_y;
+  b /= m_scale.m_z;
+  m_rotation.setFromMatrix (Matrix3 (r, u, b));
+}
+
+void
+QuaternionTransform::reset ()
+{
+  m_rotation.setToIdentity();
+  m_scale.set (1.0f, 1.0f, 1.0f);
+  m_position.set (0.0f, 0.0f, 0.0f);
+}
+
+Matrix4
+QuaternionTransform::getTransform () const
+{
+  Vector3 r = getRight();
+  Vector3 u = getUp();
+  Vector3 b = getBack();
+  return Matrix4 (Vector4 (r.m_x, r.m_y, r.m_z, 0.0f),
+                  Vector4 (u.m_x, u.m_y, u.m_z, 0.0f),
+                  Vector4 (b.m_x, b.m_y, b.m_z, 0.0f),
+                  Vector4 (m_position.m_x, m_position.m_y, m_position.m_z,
+                           1.0f));
+}
+
+Transform
+QuaternionTransform::toTransform () const
+{
+  return Transform (Matrix3 (getRight(), getUp(), getBack()), m_position);
+}
+
+Vector3
+QuaternionTransform::getPosition () const
+{
+  return m_position;
+}
+
+void
+QuaternionTransform::setPosition (const Vector3& position)
+{
+  m_position = position;
+}
+
+void
+QuaternionTransform::setPosition (float x, float y, float z)
+{
+  m_position.set (x, y, z);
+}
+
+Quaternion
+QuaternionTransform::getRotation () const
+{
+  return m_rotation;
+}
+
+void
+QuaternionTransform::setRotation (const Quaternion& rotation)
+{
+  m_rotation = rotation;
+  m_rotation.normalize();
+}
+
+Vector3
+QuaternionTransform::getScale () const
+{
+  return m_scale;
+}
+
+void
+QuaternionTransform::setScale (const Vector3& scale)
+{
+  m_scale = scale;
+}
+
+Vector3
+QuaternionTransform::getRight () const
+{
+  return m_rotation.rotate (Vector3 (m_scale.m_x, 0.0f, 0.0f));
+}
+
+Vector3
+QuaternionTransform::getUp () const
+{
+  return m_rotation.rotate (Vector3 (0.0f, m_scale.m_y, 0.0f));
+}
+
+Vector3
+QuaternionTransform::getBack () const
+{
+  return m_rotation.rotate (Vector3 (0.0f, 0.0f, m_scale.m_z));
+}
+
+void
+QuaternionTransform::moveRight (float distance)
+{
+  moveLocal (distance, Vector3 (1.0f, 0.0f, 0.0f));
+}
+
+void
+QuaternionTransform::moveUp (float distance)
+{
+  moveLocal (distance, Vector3 (0.0f, 1.0f, 0.0f));
+}
+
+void
+QuaternionTransform::moveBack (float distance)
+{
+  moveLocal (distance, Vector3 (0.0f, 0.0f, 1.0f));
+}
+
+void
+QuaternionTransform::moveLocal (float distance, const Vector3& localDirection)
+{
+  // Same as Transform: the local direction is scaled along with the axes.
+  Vector3 scaled (localDirection.m_x * m_scale.m_x,
+                  localDirection.m_y * m_scale.m_y,
+                  localDirection.m_z * m_scale.m_z);
+  m_position += distance * m_rotation.rotate (scaled);
+}
+
+void
+QuaternionTransform::moveWorld (float distance, const Vector3& worldDirection)
+{
+  m_position += distance * worldDirection;
+}
+
+void
+QuaternionTransform::pitch (float angleDegrees)
+{
+  rotateLocal (angleDegrees, Vector3 (1.0f, 0.0f, 0.0f));
+}
+
+void
+QuaternionTransform::yaw (float angleDegrees)
+{
+  rotateLocal (angleDegrees, Vector3 (0.0f, 1.0f, 0.0f));
+}
+
+void
+QuaternionTransform::roll (float angleDegrees)
+{
+  rotateLocal (angleDegrees, Vector3 (0.0f, 0.0f, 1.0f));
+}
+
+void
+QuaternionTransform::rotateLocal (float angleDegrees, const Vector3& axis)
+{
+  m_rotation *= Quaternion (angleDegrees, axis);
+  // Cheap, and keeps repeated small rotations from drifting off unit length.
+  m_rotation.normalize();
+}
+
+void
+QuaternionTransform::rotateWorld (float angleDegrees, const Vector3& axis)
+{
+  Quaternion q (angleDegrees, axis);
+  m_rotation = q * m_rotation;
+  m_rotation.normalize();
+  m_position = q.rotate (m_position);
+}
+
+void
+QuaternionTransform::alignWithWorldY ()
+{
+  Vector3 back = m_rotation.rotate (Vector3 (0.0f, 0.0f, 1.0f));
+  back.m_y = 0.0f;
+  if (back.length() < 0.00001f)
+  {
+    m_rotation.setToIdentity();
+  }
+  else
+  {
+    double pi = 3.14159265358979323846;
+    float yawDegrees = std::atan2 (back.m_x, back.m_z) * 180.0 / pi;
+    m_rotation.setFromAngleAxis (yawDegrees, Vector3 (0.0f, 1.0f, 0.0f));
+  }
+}
+
+void
+QuaternionTransform::scaleLocal (float scale)
+{
+  scaleLocal (scale, scale, scale);
+}
+
+void
+QuaternionTransform::scaleLocal (float scaleX, float scaleY, float scaleZ)
+{
+  m_scale.m_x *= scaleX;
+  m_scale.m_y *= scaleY;
+  m_scale.m_z *= scaleZ;
+}
+
+void
+QuaternionTransform::scaleWorld (float scale)
+{
+  m_scale *= scale;
+  m_position *= scale;
+}
+
+void
+QuaternionTransform::invertRt ()
+{
+  m_rotation.conjugate();
+  m_position = m_rotation.rotate (-m_position);
+}
+
+void
+QuaternionTransform::combine (const QuaternionTransform& t)
+{
+  Vector3 scaled (t.m_position.m_x * m_scale.m_x,
+                  t.m_position.m_y * m_scale.m_y,
+                  t.m_position.m_z * m_scale.m_z);
+  m_position += m_rotation.rotate (scaled);
+
+  m_rotation *= t.m_rotation;
+  m_rotation.normalize();
+
+  m_scale.m_x *= t.m_scale.m_x;
+  m_scale.m_y *= t.m_scale.m_y;
+  m_scale.m_z *= t.m_scale.m_z;
+}
+
+QuaternionTransform
+operator* (const QuaternionTransform& t1, const QuaternionTransform& t2)
+{
+  QuaternionTransform copy = t1;
+  copy.combine (t2);
+  return copy;
+}
+
+QuaternionTransform
+interpolate (const QuaternionTransform& t1, const QuaternionTransform& t2,
+             float alpha)
+{
+  float beta = 1.0f - alpha;
+  return QuaternionTransform (
+    nlerp (t1.getRotation(), t2.getRotation(), alpha),
+    beta * t1.getScale() + alpha * t2.getScale(),
+    beta * t1.getPosition() + alpha * t2.getPosition());
+}
+
+std::ostream&
+operator<< (std::ostream& out, const QuaternionTransform& t)
+{
+  out << t.toTransform();
+  return out;
+}
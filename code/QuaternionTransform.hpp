@@ -0,0 +1,280 @@
+/// \file QuaternionTransform.hpp
+/// \brief Declaration of QuaternionTransform class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef QUATERNION_TRANSFORM_HPP
+#define QUATERNION_TRANSFORM_HPP
+
+#include <iostream>
+
+#include "Quaternion.hpp"
+#include "Matrix3.hpp"
+#include "Matrix4.hpp"
+#include "Transform.hpp"
+#include "Vector3.hpp"
+
+/// \brief An affine transform stored as a rotation, a non-uniform scale, and
+///   a position rather than as a 3x3 matrix.
+/// The transform it represents is T * R * S: points are scaled along their
+///   local axes, then rotated, then translated.
+/// Compared with Transform this needs less storage (10 floats instead of
+///   12), composes rotations with a cheaper quaternion product, and never
+///   needs orthonormalize(), since renormalizing a quaternion only removes
+///   the rounding error without changing which way it points.  The price is
+///   that it cannot represent shear.
+/// The equivalent 4x4 matrix is built each time it is asked for rather than
+///   cached, which would more than double the size.
+class QuaternionTransform
+{
+public:
+  /// \brief Initializes a new transform to the identity transform.
+  /// \post The rotation is the identity, the scale is 1, and the position is
+  ///   the zero vector.
+  QuaternionTransform ();
+
+  /// \brief Initializes a new transform from its components.
+  /// \param[in] rotation The orientation of the new transform.
+  /// \param[in] scale The local scale factors along right, up, and back.
+  /// \param[in] position The position of the new transform.
+  /// \post The components have been copied from the parameters, and the
+  ///   rotation has been normalized.
+  QuaternionTransform (const Quaternion& rotation, const Vector3& scale,
+                       const Vector3& position);
+
+  /// \brief Initializes a new transform from a matrix-based one.
+  /// \param[in] t A transform that contains only scale, rotation, and
+  ///   translation (no shear or reflection).
+  /// \post The scale is the length of each basis vector of t, and the rotation
+  ///   is built from the normalized basis vectors.
+  explicit
+  QuaternionTransform (const Transform& t);
+
+  /// \brief Resets to the identity transform.
+  /// \post The rotation is the identity, the scale is 1, and the position is
+  ///   the zero vector.
+  void
+  reset ();
+
+  /// \brief Builds the equivalent 4x4 matrix.
+  /// \return The matrix T * R * S.
+  Matrix4
+  getTransform () const;
+
+  /// \brief Converts this into a matrix-based transform.
+  /// \return A Transform that represents the same transformation.
+  Transform
+  toTransform () const;
+
+  /// \brief Gets the position component.
+  /// \return A copy of the position in this transformation.
+  Vector3
+  getPosition () const;
+
+  /// \brief Sets the position component.
+  /// \param[in] position The new position component.
+  /// \post The position in this transformation has been set to position.
+  void
+  setPosition (const Vector3& position);
+
+  /// \brief Sets the position component.
+  /// \param[in] x The new x-coordinate of the position.
+  /// \param[in] y The new y-coordinate of the position.
+  /// \param[in] z The new z-coordinate of the position.
+  /// \post The position in this transformation has been set to [x, y, z].
+  void
+  setPosition (float x, float y, float z);
+
+  /// \brief Gets the rotation component.
+  /// \return A copy of the unit quaternion holding the orientation.
+  Quaternion
+  getRotation () const;
+
+  /// \brief Sets the rotation component.
+  /// \param[in] rotation The new orientation.
+  /// \post The rotation has been set to the normalized parameter.
+  void
+  setRotation (const Quaternion& rotation);
+
+  /// \brief Gets the scale component.
+  /// \return A copy of the local scale factors.
+  Vector3
+  getScale () const;
+
+  /// \brief Sets the scale component.
+  /// \param[in] scale The new local scale factors.
+  /// \post The scale has been set to the parameter.
+  void
+  setScale (const Vector3& scale);
+
+  /// \brief Gets the right basis vector.
+  /// \return The scaled local X axis in world coordinates.
+  Vector3
+  getRight () const;
+
+  /// \brief Gets the up basis vector.
+  /// \return The scaled local Y axis in world coordinates.
+  Vector3
+  getUp () const;
+
+  /// \brief Gets the back basis vector.
+  /// \return The scaled local Z axis in world coordinates.
+  Vector3
+  getBack () const;
+
+  /// \brief Moves "distance" units along the right vector.
+  /// \param[in] distance How far to move.
+  /// \post The position has been moved that far in the local right direction.
+  void
+  moveRight (float distance);
+
+  /// \brief Moves "distance" units along the up vector.
+  /// \param[in] distance How far to move.
+  /// \post The position has been moved that far in the local up direction.
+  void
+  moveUp (float distance);
+
+  /// \brief Moves "distance" units along the back vector.
+  /// \param[in] distance How far to move.
+  /// \post The position has been moved that far in the local back direction.
+  void
+  moveBack (float distance);
+
+  /// \brief Moves "distance" units in "localDirection", which is relative
+  ///   to the coordinate system defined by this transform.
+  /// \param[in] distance How far to move.
+  /// \param[in] localDirection The (local) direction to move in.
+  /// \post The position has been moved that far in that direction.
+  void
+  moveLocal (float distance, const Vector3& localDirection);
+
+  /// \brief Moves "distance" units in "worldDirection", which is relative
+  ///   to the world coodinate system.
+  /// \param[in] distance How far to move.
+  /// \param[in] worldDirection The (world) direction to move in.
+  /// \post The position has been moved that far in that direction.
+  void
+  moveWorld (float distance, const Vector3& worldDirection);
+
+  /// \brief Rotates about the local X axis.
+  /// \param[in] angleDegrees How much to rotate.
+  /// \post The rotation includes this rotation before whatever it already
+  ///   encoded.
+  void
+  pitch (float angleDegrees);
+
+  /// \brief Rotates about the local Y axis.
+  /// \param[in] angleDegrees How much to rotate.
+  /// \post The rotation includes this rotation before whatever it already
+  ///   encoded.
+  void
+  yaw (float angleDegrees);
+
+  /// \brief Rotates about the local Z axis.
+  /// \param[in] angleDegrees How much to rotate.
+  /// \post The rotation includes this rotation before whatever it already
+  ///   encoded.
+  void
+  roll (float angleDegrees);
+
+  /// \brief Rotates locally about an arbitrary local vector "axis".
+  /// \param[in] angleDegrees How much to rotate.
+  /// \param[in] axis The (local) vector to rotate around.
+  /// \post The rotation includes this rotation before whatever it already
+  ///   encoded.
+  void
+  rotateLocal (float angleDegrees, const Vector3& axis);
+
+  /// \brief Rotates around the world vector "axis".
+  /// \param[in] angleDegrees How much to rotate.
+  /// \param[in] axis The (world) vector to rotate around.
+  /// \post The rotation and position include this rotation after whatever
+  ///   they already encoded.
+  void
+  rotateWorld (float angleDegrees, const Vector3& axis);
+
+  /// \brief Removes any pitch and roll, keeping only the rotation around the
+  ///   world Y axis.
+  /// If "back" is pointing in the Y or -Y direction the rotation becomes the
+  ///   identity.
+  /// \post The up vector is [0, 1, 0] (times the Y scale).
+  void
+  alignWithWorldY ();
+
+  /// \brief Scales locally using a uniform scale.
+  /// \param[in] scale The scaling factor.
+  /// \post Every local scale factor has been multiplied by scale.
+  void
+  scaleLocal (float scale);
+
+  /// \brief Scales locally using a non-uniform scale.
+  /// \param[in] scaleX The scaling factor for the local X direction.
+  /// \param[in] scaleY The scaling factor for the local Y direction.
+  /// \param[in] scaleZ The scaling factor for the local Z direction.
+  /// \post The local scale factors have been multiplied by the parameters.
+  void
+  scaleLocal (float scaleX, float scaleY, float scaleZ);
+
+  /// \brief Scales with regard to world using a uniform scale.
+  /// Non-uniform world scales would introduce shear, so they are not offered.
+  /// \param[in] scale The scaling factor.
+  /// \post The scale and the position have been multiplied by scale.
+  void
+  scaleWorld (float scale);
+
+  /// \brief Inverts this transform assuming it consists of a pure rotation
+  ///   and a translation.
+  /// \pre The scale is 1 in every direction.
+  /// \post This transform has been inverted.
+  void
+  invertRt ();
+
+  /// \brief Combines this with "t" in the order this * t.
+  /// \param[in] t Another transform that should be combined with this.
+  /// \pre This has a uniform scale, or t has no rotation; otherwise the
+  ///   product contains shear and cannot be represented.
+  /// \post This transform consists of itself times t.
+  void
+  combine (const QuaternionTransform& t);
+
+private:
+  /// \brief A unit quaternion that stores the orientation.
+  Quaternion m_rotation;
+  /// \brief The scale factors along the local right, up, and back axes.
+  Vector3 m_scale;
+  /// \brief A 3D vector that stores the position/translation vector.
+  Vector3 m_position;
+};
+
+static_assert (sizeof (QuaternionTransform) == 10 * sizeof (float),
+               "QuaternionTransform must hold nothing but its rotation, "
+               "scale, and position");
+
+/// \brief Combines two transforms into their product.
+/// \param[in] t1 A transform.
+/// \param[in] t2 Another transform.
+/// \return A new transform that is t1 * t2.
+QuaternionTransform
+operator* (const QuaternionTransform& t1, const QuaternionTransform& t2);
+
+/// \brief Interpolates between two transforms.
+/// Positions and scales are interpolated linearly, and rotations with nlerp.
+/// \param[in] t1 The transform at alpha = 0.
+/// \param[in] t2 The transform at alpha = 1.
+/// \param[in] alpha How far to go, from 0 to 1.
+/// \return The blended transform.
+QuaternionTransform
+interpolate (const QuaternionTransform& t1, const QuaternionTransform& t2,
+             float alpha);
+
+/// \brief Prints the complete 4x4 matrix the transform represents, in the
+///   same format as a Transform.
+/// \param[inout] out An output stream.
+/// \param[in] t A transform.
+/// \return The output stream.
+/// \post The transform has been inserted into the output stream.
+std::ostream&
+operator<< (std::ostream& out, const QuaternionTransform& t);
+
+#endif//QUATERNION_TRANSFORM_HPP
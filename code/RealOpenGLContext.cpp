@@ -15,6 +15,12 @@ RealOpenGLContext::~RealOpenGLContext ()
 }
 
 
+void
+RealOpenGLContext::activeTexture (GLenum texture)
+{
+  glActiveTexture (texture);
+}
+
 void
 RealOpenGLContext::attachShader (GLuint program, GLuint shader)
 {
@@ -27,6 +33,18 @@ RealOpenGLContext::bindBuffer (GLenum target, GLuint buffer)
   glBindBuffer (target, buffer);
 }
 
+void
+RealOpenGLContext::bindBufferBase (GLenum target, GLuint index, GLuint buffer)
+{
+  glBindBufferBase (target, index, buffer);
+}
+
+void
+RealOpenGLContext::bindTexture (GLenum target, GLuint texture)
+{
+  glBindTexture (target, texture);
+}
+
 void
 RealOpenGLContext::bindVertexArray (GLuint array)
 {
@@ -39,6 +57,12 @@ RealOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* dat
   glBufferData (target, size, data, usage);
 }
 
+void
+RealOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  glBufferSubData (target, offset, size, data);
+}
+
 void
 RealOpenGLContext::clear (GLbitfield mask)
 {
@@ -93,6 +117,12 @@ RealOpenGLContext::deleteShader (GLuint shader)
   glDeleteShader (shader);
 }
 
+void
+RealOpenGLContext::deleteTextures (GLsizei n, const GLuint* textures)
+{
+  glDeleteTextures (n, textures);
+}
+
 void
 RealOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
 {
@@ -141,6 +171,18 @@ RealOpenGLContext::genBuffers (GLsizei n, GLuint* buffers)
   glGenBuffers (n, buffers);
 }
 
+void
+RealOpenGLContext::generateMipmap (GLenum target)
+{
+  glGenerateMipmap (target);
+}
+
+void
+RealOpenGLContext::genTextures (GLsizei n, GLuint* textures)
+{
+  glGenTextures (n, textures);
+}
+
 void
 RealOpenGLContext::genVertexArrays (GLsizei n, GLuint* arrays)
 {
@@ -183,6 +225,12 @@ RealOpenGLContext::getString (GLenum name)
   return glGetString (name);
 }
 
+GLuint
+RealOpenGLContext::getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName)
+{
+  return glGetUniformBlockIndex (program, uniformBlockName);
+}
+
 GLint
 RealOpenGLContext::getUniformLocation (GLuint program, const GLchar* name)
 {
@@ -195,12 +243,66 @@ RealOpenGLContext::linkProgram (GLuint program)
   glLinkProgram (program);
 }
 
+void
+RealOpenGLContext::multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+{
+  glMultiDrawElementsIndirect (mode, type, indirect, drawcount, stride);
+}
+
 void
 RealOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
 {
   glShaderSource (shader, count, string, length);
 }
 
+void
+RealOpenGLContext::texBuffer (GLenum target, GLenum internalFormat, GLuint buffer)
+{
+  glTexBuffer (target, internalFormat, buffer);
+}
+
+void
+RealOpenGLContext::texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data)
+{
+  glTexImage2D (target, level, internalFormat, width, height, border, format, type, data);
+}
+
+void
+RealOpenGLContext::texParameteri (GLenum target, GLenum pname, GLint param)
+{
+  glTexParameteri (target, pname, param);
+}
+
+void
+RealOpenGLContext::uniform1f (GLint location, GLfloat v0)
+{
+  glUniform1f (location, v0);
+}
+
+void
+RealOpenGLContext::uniform1i (GLint location, GLint v0)
+{
+  glUniform1i (location, v0);
+}
+
+void
+RealOpenGLContext::uniform3fv (GLint location, GLsizei count, const GLfloat* value)
+{
+  glUniform3fv (location, count, value);
+}
+
+void
+RealOpenGLContext::uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+  glUniformBlockBinding (program, uniformBlockIndex, uniformBlockBinding);
+}
+
+void
+RealOpenGLContext::uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  glUniformMatrix3fv (location, count, transpose, value);
+}
+
 void
 RealOpenGLContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
@@ -213,6 +315,12 @@ RealOpenGLContext::useProgram (GLuint program)
   glUseProgram (program);
 }
 
+void
+RealOpenGLContext::vertexAttribDivisor (GLuint index, GLuint divisor)
+{
+  glVertexAttribDivisor (index, divisor);
+}
+
 void
 RealOpenGLContext::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
 {
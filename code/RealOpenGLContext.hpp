@@ -36,18 +36,30 @@ public:
   operator= (const RealOpenGLContext&) = delete;
 
 
+  virtual void
+  activeTexture (GLenum texture);
+
   virtual void
   attachShader (GLuint program, GLuint shader);
   
   virtual void
   bindBuffer (GLenum target, GLuint buffer);
 
+  virtual void
+  bindBufferBase (GLenum target, GLuint index, GLuint buffer);
+
+  virtual void
+  bindTexture (GLenum target, GLuint texture);
+
   virtual void
   bindVertexArray (GLuint array);
 
   virtual void
   bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
 
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
   virtual void
   clear (GLbitfield mask);
 
@@ -75,6 +87,9 @@ public:
   virtual void
   deleteShader (GLuint shader);
 
+  virtual void
+  deleteTextures (GLsizei n, const GLuint* textures);
+
   virtual void
   deleteVertexArrays (GLsizei n, const GLuint* arrays);
 
@@ -99,6 +114,12 @@ public:
   virtual void
   genBuffers (GLsizei n, GLuint* buffers);
 
+  virtual void
+  generateMipmap (GLenum target);
+
+  virtual void
+  genTextures (GLsizei n, GLuint* textures);
+
   virtual void
   genVertexArrays (GLsizei n, GLuint* arrays);
 
@@ -120,21 +141,54 @@ public:
   virtual const GLubyte*
   getString (GLenum name);
 
+  virtual GLuint
+  getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName);
+
   virtual GLint
   getUniformLocation (GLuint program, const GLchar* name);
 
   virtual void
   linkProgram (GLuint program);
 
+  virtual void
+  multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
   virtual void
   shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
 
+  virtual void
+  texBuffer (GLenum target, GLenum internalFormat, GLuint buffer);
+
+  virtual void
+  texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data);
+
+  virtual void
+  texParameteri (GLenum target, GLenum pname, GLint param);
+
+  virtual void
+  uniform1f (GLint location, GLfloat v0);
+
+  virtual void
+  uniform1i (GLint location, GLint v0);
+
+  virtual void
+  uniform3fv (GLint location, GLsizei count, const GLfloat* value);
+
+  virtual void
+  uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
+  virtual void
+  uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
   virtual void
   uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
 
   virtual void
   useProgram (GLuint program);
   
+  virtual void
+  vertexAttribDivisor (GLuint index, GLuint divisor);
+
   virtual void
   vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
 
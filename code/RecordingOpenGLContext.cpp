@@ -0,0 +1,439 @@
+/// \file RecordingOpenGLContext.cpp
+/// \brief Definitions of RecordingOpenGLContext member and associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include "RecordingOpenGLContext.hpp"
+
+RecordingOpenGLContext::CallTimer::CallTimer (RecordingOpenGLContext& context)
+  : m_context (context), m_start (std::chrono::steady_clock::now ())
+{
+}
+
+RecordingOpenGLContext::CallTimer::~CallTimer ()
+{
+  m_context.m_time += std::chrono::steady_clock::now () - m_start;
+  ++m_context.m_callCount;
+}
+
+RecordingOpenGLContext::RecordingOpenGLContext (OpenGLContext* context)
+  : m_context (context), m_callCount (0), m_drawCallCount (0),
+    m_indirectCommandCount (0),
+    m_time (std::chrono::steady_clock::duration::zero ())
+{
+}
+
+RecordingOpenGLContext::~RecordingOpenGLContext ()
+{
+  delete m_context;
+}
+
+unsigned long
+RecordingOpenGLContext::getCallCount () const
+{
+  return m_callCount;
+}
+
+unsigned long
+RecordingOpenGLContext::getDrawCallCount () const
+{
+  return m_drawCallCount;
+}
+
+unsigned long
+RecordingOpenGLContext::getIndirectCommandCount () const
+{
+  return m_indirectCommandCount;
+}
+
+double
+RecordingOpenGLContext::getSeconds () const
+{
+  return std::chrono::duration<double> (m_time).count ();
+}
+
+void
+RecordingOpenGLContext::resetStatistics ()
+{
+  m_callCount = 0;
+  m_drawCallCount = 0;
+  m_indirectCommandCount = 0;
+  m_time = std::chrono::steady_clock::duration::zero ();
+}
+
+
+void
+RecordingOpenGLContext::activeTexture (GLenum texture)
+{
+  CallTimer timer (*this);
+  m_context->activeTexture (texture);
+}
+
+void
+RecordingOpenGLContext::attachShader (GLuint program, GLuint shader)
+{
+  CallTimer timer (*this);
+  m_context->attachShader (program, shader);
+}
+
+void
+RecordingOpenGLContext::bindBuffer (GLenum target, GLuint buffer)
+{
+  CallTimer timer (*this);
+  m_context->bindBuffer (target, buffer);
+}
+
+void
+RecordingOpenGLContext::bindBufferBase (GLenum target, GLuint index, GLuint buffer)
+{
+  CallTimer timer (*this);
+  m_context->bindBufferBase (target, index, buffer);
+}
+
+void
+RecordingOpenGLContext::bindTexture (GLenum target, GLuint texture)
+{
+  CallTimer timer (*this);
+  m_context->bindTexture (target, texture);
+}
+
+void
+RecordingOpenGLContext::bindVertexArray (GLuint array)
+{
+  CallTimer timer (*this);
+  m_context->bindVertexArray (array);
+}
+
+void
+RecordingOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+  CallTimer timer (*this);
+  m_context->bufferData (target, size, data, usage);
+}
+
+void
+RecordingOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  CallTimer timer (*this);
+  m_context->bufferSubData (target, offset, size, data);
+}
+
+void
+RecordingOpenGLContext::clear (GLbitfield mask)
+{
+  CallTimer timer (*this);
+  m_context->clear (mask);
+}
+
+void
+RecordingOpenGLContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+  CallTimer timer (*this);
+  m_context->clearColor (red, green, blue, alpha);
+}
+
+void
+RecordingOpenGLContext::compileShader (GLuint shader)
+{
+  CallTimer timer (*this);
+  m_context->compileShader (shader);
+}
+
+GLuint
+RecordingOpenGLContext::createProgram ()
+{
+  CallTimer timer (*this);
+  return m_context->createProgram ();
+}
+
+GLuint
+RecordingOpenGLContext::createShader (GLenum shaderType)
+{
+  CallTimer timer (*this);
+  return m_context->createShader (shaderType);
+}
+
+void
+RecordingOpenGLContext::cullFace (GLenum mode)
+{
+  CallTimer timer (*this);
+  m_context->cullFace (mode);
+}
+
+void
+RecordingOpenGLContext::deleteBuffers (GLsizei n, const GLuint* buffers)
+{
+  CallTimer timer (*this);
+  m_context->deleteBuffers (n, buffers);
+}
+
+void
+RecordingOpenGLContext::deleteProgram (GLuint program)
+{
+  CallTimer timer (*this);
+  m_context->deleteProgram (program);
+}
+
+void
+RecordingOpenGLContext::deleteShader (GLuint shader)
+{
+  CallTimer timer (*this);
+  m_context->deleteShader (shader);
+}
+
+void
+RecordingOpenGLContext::deleteTextures (GLsizei n, const GLuint* textures)
+{
+  CallTimer timer (*this);
+  m_context->deleteTextures (n, textures);
+}
+
+void
+RecordingOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
+{
+  CallTimer timer (*this);
+  m_context->deleteVertexArrays (n, arrays);
+}
+
+void
+RecordingOpenGLContext::detachShader (GLuint program, GLuint shader)
+{
+  CallTimer timer (*this);
+  m_context->detachShader (program, shader);
+}
+
+void
+RecordingOpenGLContext::drawArrays (GLenum mode, GLint first, GLsizei count)
+{
+  CallTimer timer (*this);
+  ++m_drawCallCount;
+  m_context->drawArrays (mode, first, count);
+}
+
+void
+RecordingOpenGLContext::drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+  CallTimer timer (*this);
+  ++m_drawCallCount;
+  m_context->drawElements (mode, count, type, indices);
+}
+
+void
+RecordingOpenGLContext::enable (GLenum cap)
+{
+  CallTimer timer (*this);
+  m_context->enable (cap);
+}
+
+void
+RecordingOpenGLContext::enableVertexAttribArray (GLuint index)
+{
+  CallTimer timer (*this);
+  m_context->enableVertexAttribArray (index);
+}
+
+void
+RecordingOpenGLContext::frontFace (GLenum mode)
+{
+  CallTimer timer (*this);
+  m_context->frontFace (mode);
+}
+
+void
+RecordingOpenGLContext::genBuffers (GLsizei n, GLuint* buffers)
+{
+  CallTimer timer (*this);
+  m_context->genBuffers (n, buffers);
+}
+
+void
+RecordingOpenGLContext::generateMipmap (GLenum target)
+{
+  CallTimer timer (*this);
+  m_context->generateMipmap (target);
+}
+
+void
+RecordingOpenGLContext::genTextures (GLsizei n, GLuint* textures)
+{
+  CallTimer timer (*this);
+  m_context->genTextures (n, textures);
+}
+
+void
+RecordingOpenGLContext::genVertexArrays (GLsizei n, GLuint* arrays)
+{
+  CallTimer timer (*this);
+  m_context->genVertexArrays (n, arrays);
+}
+
+GLint
+RecordingOpenGLContext::getAttribLocation (GLuint program, const GLchar* name)
+{
+  CallTimer timer (*this);
+  return m_context->getAttribLocation (program, name);
+}
+
+void
+RecordingOpenGLContext::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  CallTimer timer (*this);
+  m_context->getProgramInfoLog (program, maxLength, length, infoLog);
+}
+
+void
+RecordingOpenGLContext::getProgramiv (GLuint program, GLenum pname, GLint* params)
+{
+  CallTimer timer (*this);
+  m_context->getProgramiv (program, pname, params);
+}
+
+void
+RecordingOpenGLContext::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  CallTimer timer (*this);
+  m_context->getShaderInfoLog (shader, maxLength, length, infoLog);
+}
+
+void
+RecordingOpenGLContext::getShaderiv (GLuint shader, GLenum pname, GLint* params)
+{
+  CallTimer timer (*this);
+  m_context->getShaderiv (shader, pname, params);
+}
+
+const GLubyte*
+RecordingOpenGLContext::getString (GLenum name)
+{
+  CallTimer timer (*this);
+  return m_context->getString (name);
+}
+
+GLuint
+RecordingOpenGLContext::getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName)
+{
+  CallTimer timer (*this);
+  return m_context->getUniformBlockIndex (program, uniformBlockName);
+}
+
+GLint
+RecordingOpenGLContext::getUniformLocation (GLuint program, const GLchar* name)
+{
+  CallTimer timer (*this);
+  return m_context->getUniformLocation (program, name);
+}
+
+void
+RecordingOpenGLContext::linkProgram (GLuint program)
+{
+  CallTimer timer (*this);
+  m_context->linkProgram (program);
+}
+
+void
+RecordingOpenGLContext::multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+{
+  CallTimer timer (*this);
+  ++m_drawCallCount;
+  m_indirectCommandCount += drawcount;
+  m_context->multiDrawElementsIndirect (mode, type, indirect, drawcount, stride);
+}
+
+void
+RecordingOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+{
+  CallTimer timer (*this);
+  m_context->shaderSource (shader, count, string, length);
+}
+
+void
+RecordingOpenGLContext::texBuffer (GLenum target, GLenum internalFormat, GLuint buffer)
+{
+  CallTimer timer (*this);
+  m_context->texBuffer (target, internalFormat, buffer);
+}
+
+void
+RecordingOpenGLContext::texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data)
+{
+  CallTimer timer (*this);
+  m_context->texImage2D (target, level, internalFormat, width, height, border, format, type, data);
+}
+
+void
+RecordingOpenGLContext::texParameteri (GLenum target, GLenum pname, GLint param)
+{
+  CallTimer timer (*this);
+  m_context->texParameteri (target, pname, param);
+}
+
+void
+RecordingOpenGLContext::uniform1f (GLint location, GLfloat v0)
+{
+  CallTimer timer (*this);
+  m_context->uniform1f (location, v0);
+}
+
+void
+RecordingOpenGLContext::uniform1i (GLint location, GLint v0)
+{
+  CallTimer timer (*this);
+  m_context->uniform1i (location, v0);
+}
+
+void
+RecordingOpenGLContext::uniform3fv (GLint location, GLsizei count, const GLfloat* value)
+{
+  CallTimer timer (*this);
+  m_context->uniform3fv (location, count, value);
+}
+
+void
+RecordingOpenGLContext::uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+  CallTimer timer (*this);
+  m_context->uniformBlockBinding (program, uniformBlockIndex, uniformBlockBinding);
+}
+
+void
+RecordingOpenGLContext::uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  CallTimer timer (*this);
+  m_context->uniformMatrix3fv (location, count, transpose, value);
+}
+
+void
+RecordingOpenGLContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  CallTimer timer (*this);
+  m_context->uniformMatrix4fv (location, count, transpose, value);
+}
+
+void
+RecordingOpenGLContext::useProgram (GLuint program)
+{
+  CallTimer timer (*this);
+  m_context->useProgram (program);
+}
+
+void
+RecordingOpenGLContext::vertexAttribDivisor (GLuint index, GLuint divisor)
+{
+  CallTimer timer (*this);
+  m_context->vertexAttribDivisor (index, divisor);
+}
+
+void
+RecordingOpenGLContext::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+  CallTimer timer (*this);
+  m_context->vertexAttribPointer (index, size, type, normalized, stride, pointer);
+}
+
+void
+RecordingOpenGLContext::viewport (GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  CallTimer timer (*this);
+  m_context->viewport (x, y, width, height);
+}
@@ -0,0 +1,256 @@
+/// \file RecordingOpenGLContext.hpp
+/// \brief Declaration of RecordingOpenGLContext and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef RECORDING_OPENGL_CONTEXT_HPP
+#define RECORDING_OPENGL_CONTEXT_HPP
+
+#include <chrono>
+
+#include "OpenGLContext.hpp"
+
+/// \brief A subclass of OpenGLContext that passes every call on to another
+///   context while recording how many calls were made and how long they
+///   took.
+///
+/// Wrapping the RealOpenGLContext in one of these measures how much of a
+///   frame is spent submitting work to OpenGL, as opposed to simulating or
+///   waiting.  The statistics are not synchronized, so only the thread that
+///   makes the calls should read them.
+class RecordingOpenGLContext : public OpenGLContext
+{
+public:
+
+  /// Constructs a RecordingOpenGLContext.
+  /// \param context The context to pass calls on to, which this one now owns
+  ///   and will delete.
+  explicit RecordingOpenGLContext (OpenGLContext* context);
+
+  /// Destructs a RecordingOpenGLContext and the context it wraps.
+  virtual
+  ~RecordingOpenGLContext ();
+
+  /// Copy constructor deleted because you should not be copying
+  ///   RecordingOpenGLContexts.
+  RecordingOpenGLContext (const RecordingOpenGLContext&) = delete;
+
+  /// Assignment operator deleted because you should not be assigning
+  ///   RecordingOpenGLContexts.
+  RecordingOpenGLContext&
+  operator= (const RecordingOpenGLContext&) = delete;
+
+  /// \brief Gets the number of calls made since the statistics were reset.
+  /// \return The number of calls.
+  unsigned long
+  getCallCount () const;
+
+  /// \brief Gets the number of drawArrays, drawElements, and
+  ///   multiDrawElementsIndirect calls made since the statistics were reset.
+  /// \return The number of draw calls.
+  unsigned long
+  getDrawCallCount () const;
+
+  /// \brief Gets the number of draws submitted through
+  ///   multiDrawElementsIndirect since the statistics were reset, which
+  ///   getDrawCallCount counts as one per call.
+  /// \return The number of indirect draw commands.
+  unsigned long
+  getIndirectCommandCount () const;
+
+  /// \brief Gets the time spent inside calls since the statistics were reset.
+  /// \return The time, in seconds.
+  double
+  getSeconds () const;
+
+  /// \brief Starts the statistics over.
+  /// \post The counts and time are 0.
+  void
+  resetStatistics ();
+
+
+  virtual void
+  activeTexture (GLenum texture);
+
+  virtual void
+  attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  bindBuffer (GLenum target, GLuint buffer);
+
+  virtual void
+  bindBufferBase (GLenum target, GLuint index, GLuint buffer);
+
+  virtual void
+  bindTexture (GLenum target, GLuint texture);
+
+  virtual void
+  bindVertexArray (GLuint array);
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+  virtual void
+  clear (GLbitfield mask);
+
+  virtual void
+  clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+  virtual void
+  compileShader (GLuint shader);
+
+  virtual GLuint
+  createProgram ();
+
+  virtual GLuint
+  createShader (GLenum shaderType);
+
+  virtual void
+  cullFace (GLenum mode);
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers);
+
+  virtual void
+  deleteProgram (GLuint program);
+
+  virtual void
+  deleteShader (GLuint shader);
+
+  virtual void
+  deleteTextures (GLsizei n, const GLuint* textures);
+
+  virtual void
+  deleteVertexArrays (GLsizei n, const GLuint* arrays);
+
+  virtual void
+  detachShader (GLuint program, GLuint shader);
+
+  virtual void
+  drawArrays (GLenum mode, GLint first, GLsizei count);
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+  virtual void
+  enable (GLenum cap);
+
+  virtual void
+  enableVertexAttribArray (GLuint index);
+
+  virtual void
+  frontFace (GLenum mode);
+
+  virtual void
+  genBuffers (GLsizei n, GLuint* buffers);
+
+  virtual void
+  generateMipmap (GLenum target);
+
+  virtual void
+  genTextures (GLsizei n, GLuint* textures);
+
+  virtual void
+  genVertexArrays (GLsizei n, GLuint* arrays);
+
+  virtual GLint
+  getAttribLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getProgramiv (GLuint program, GLenum pname, GLint* params);
+
+  virtual void
+  getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getShaderiv (GLuint shader, GLenum pname, GLint* params);
+
+  virtual const GLubyte*
+  getString (GLenum name);
+
+  virtual GLuint
+  getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName);
+
+  virtual GLint
+  getUniformLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  linkProgram (GLuint program);
+
+  virtual void
+  multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+
+  virtual void
+  texBuffer (GLenum target, GLenum internalFormat, GLuint buffer);
+
+  virtual void
+  texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data);
+
+  virtual void
+  texParameteri (GLenum target, GLenum pname, GLint param);
+
+  virtual void
+  uniform1f (GLint location, GLfloat v0);
+
+  virtual void
+  uniform1i (GLint location, GLint v0);
+
+  virtual void
+  uniform3fv (GLint location, GLsizei count, const GLfloat* value);
+
+  virtual void
+  uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
+  virtual void
+  uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  useProgram (GLuint program);
+
+  virtual void
+  vertexAttribDivisor (GLuint index, GLuint divisor);
+
+  virtual void
+  vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+  virtual void
+  viewport (GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+
+  /// \brief Adds the time from its construction to its destruction, and one
+  ///   call, to a context's statistics.
+  class CallTimer
+  {
+  public:
+    explicit CallTimer (RecordingOpenGLContext& context);
+
+    ~CallTimer ();
+
+  private:
+    RecordingOpenGLContext& m_context;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  /// The context calls are passed on to.
+  OpenGLContext* m_context;
+  unsigned long m_callCount;
+  unsigned long m_drawCallCount;
+  unsigned long m_indirectCommandCount;
+  std::chrono::steady_clock::duration m_time;
+};
+
+#endif//RECORDING_OPENGL_CONTEXT_HPP
@@ -0,0 +1,127 @@
+/// \file RenderHeadless.cpp
+/// \brief Renders one frame of a PhysicsScene on the CPU and saves it as a
+///   PNG, for machines without a GPU or a display.
+/// \author Justin Stevens
+/// \version A09
+///
+/// Usage: RenderHeadless.out [output.png [width height [samples [mesh]]]]
+///
+/// With samples, the frame is path traced with that many samples per pixel
+///   instead of rasterized, and with a mesh name, that Mesh's lightmap is
+///   also baked and saved next to the frame.
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "SoftwareOpenGLContext.hpp"
+#include "PathTracer.hpp"
+#include "ShaderProgram.hpp"
+#include "UniformBlocks.hpp"
+#include "Camera.hpp"
+#include "Vector3.hpp"
+#include "Scenes/PhysicsScene.hpp"
+
+/// \brief Creates a ShaderProgram and sets the bindings Main::initShaders
+///   sets.
+/// \param context The context to create the program through.
+/// \param[in] vertexShader The vertex shader's filename.
+/// \param[in] fragmentShader The fragment shader's filename.
+/// \return The linked program.
+static ShaderProgram*
+createShaderProgram (OpenGLContext* context, const std::string& vertexShader,
+                     const std::string& fragmentShader)
+{
+  ShaderProgram* program = new ShaderProgram (context);
+  program->createVertexShader (vertexShader);
+  program->createFragmentShader (fragmentShader);
+  program->link ();
+  program->bindUniformBlock ("FrameBlock", FRAME_BLOCK_BINDING);
+  program->bindUniformBlock ("MaterialBlock", MATERIAL_BLOCK_BINDING);
+  program->bindUniformBlock ("ObjectBlock", OBJECT_BLOCK_BINDING);
+  return program;
+}
+
+/// \brief Renders the frame.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The output filename, then the width and height.
+int
+main (int argc, char* argv[])
+{
+  std::string filename = argc > 1 ? argv[1] : "PhysicsScene.png";
+  GLsizei width = argc > 3 ? std::atoi (argv[2]) : 800;
+  GLsizei height = argc > 3 ? std::atoi (argv[3]) : 450;
+  int samples = argc > 4 ? std::atoi (argv[4]) : 0;
+  if (width <= 0 || height <= 0)
+  {
+    fprintf (stderr, "Width and height must be positive\n");
+    return EXIT_FAILURE;
+  }
+
+  SoftwareOpenGLContext* context = new SoftwareOpenGLContext (width, height);
+  context->clearColor (0.0f, 0.0f, 0.0f, 1.0f);
+  context->enable (GL_DEPTH_TEST);
+  context->enable (GL_CULL_FACE);
+  context->frontFace (GL_CCW);
+  context->cullFace (GL_BACK);
+
+  ShaderProgram* colorShaderProgram =
+    createShaderProgram (context, "Shaders/Vec3.vert", "Shaders/Vec3.frag");
+  ShaderProgram* normalShaderProgram =
+    createShaderProgram (context, "Shaders/PhongShader.vert",
+                         "Shaders/PhongShader.frag");
+  normalShaderProgram->enable ();
+  normalShaderProgram->setUniformInt ("uDiffuseSampler", 0);
+  normalShaderProgram->setUniformInt ("uClusterLights", CLUSTER_LIGHTS_UNIT);
+  normalShaderProgram->setUniformInt ("uClusterGrid", CLUSTER_GRID_UNIT);
+  normalShaderProgram->setUniformInt ("uClusterIndices", CLUSTER_INDICES_UNIT);
+  normalShaderProgram->disable ();
+
+  Camera* camera = new Camera (Vector3 (0.0f, 0.0f, 12.0f),
+                               Vector3 (0.0f, 0.0f, 1.0f), 0.01, 90.0,
+                               static_cast<double> (width) / height, 60.0);
+  Scene* scene = new PhysicsScene (context, colorShaderProgram,
+                                   normalShaderProgram);
+  scene->resetCamera (camera);
+
+  bool isSaved;
+  if (samples > 0)
+  {
+    PathTracer tracer (*scene);
+    tracer.setSeed (375);
+    tracer.render (camera, width, height, samples);
+    isSaved = tracer.writePng (filename);
+    if (argc > 5)
+    {
+      std::string lightmapName = filename + "." + argv[5] + ".lightmap.png";
+      try
+      {
+        Lightmap lightmap = tracer.bakeLightmap (argv[5], 256, 256, samples);
+        if (lightmap.writePng (lightmapName))
+          fprintf (stdout, "Wrote %s\n", lightmapName.c_str ());
+      }
+      catch (const std::invalid_argument& e)
+      {
+        fprintf (stderr, "%s\n", e.what ());
+      }
+    }
+  }
+  else
+  {
+    context->clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    scene->draw (camera);
+    isSaved = context->writePng (filename);
+  }
+  if (isSaved)
+    fprintf (stdout, "Wrote %s\n", filename.c_str ());
+  else
+    fprintf (stderr, "Failed to write %s\n", filename.c_str ());
+
+  delete scene;
+  delete camera;
+  delete colorShaderProgram;
+  delete normalShaderProgram;
+  delete context;
+  return isSaved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,234 @@
+/// \file SceneGraph.cpp
+/// \brief Definition of SceneGraph class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "SceneGraph.hpp"
+
+const unsigned SceneGraph::NO_PARENT;
+const unsigned SceneGraph::NONE;
+
+// Computes parent * local, like Transform's operator*, but on the raw columns
+//   so that it inlines into the update loop instead of going through a copy
+//   and a dozen getter and setter calls.  Transform is twelve floats: right,
+//   up, back, then position.
+static void
+compose (const Transform& parent, const Transform& local, Transform& world)
+{
+  float p[12], l[12], w[12];
+  std::memcpy (p, &parent, sizeof (p));
+  std::memcpy (l, &local, sizeof (l));
+  for (int column = 0; column < 4; ++column)
+  {
+    const float* c = l + 3 * column;
+    for (int row = 0; row < 3; ++row)
+    {
+      w[3 * column + row] = p[row] * c[0] + p[3 + row] * c[1] + p[6 + row] * c[2];
+    }
+  }
+  for (int row = 0; row < 3; ++row)
+  {
+    w[9 + row] += p[9 + row];
+  }
+  std::memcpy (&world, w, sizeof (w));
+}
+
+SceneGraph::SceneGraph ()
+  : m_isOrderDirty (false)
+{
+
+}
+
+unsigned
+SceneGraph::add (const Transform& local, unsigned parent)
+{
+  assert (parent == NO_PARENT || m_slots[parent] != NONE);
+  unsigned node;
+  if (m_freeIds.empty ())
+  {
+    node = static_cast<unsigned> (m_parents.size ());
+    m_parents.push_back (parent);
+    m_slots.push_back (NONE);
+  }
+  else
+  {
+    node = m_freeIds.back ();
+    m_freeIds.pop_back ();
+    m_parents[node] = parent;
+  }
+  // The end of the array is after the parent, so the node is usable before
+  //   the next sort.
+  m_slots[node] = static_cast<unsigned> (m_ids.size ());
+  m_ids.push_back (node);
+  m_parentSlots.push_back (parent == NO_PARENT ? NONE : m_slots[parent]);
+  m_locals.push_back (local);
+  m_worlds.push_back (local);
+  m_isDirty.push_back (1);
+  m_isOrderDirty = true;
+  return node;
+}
+
+void
+SceneGraph::remove (unsigned node)
+{
+  assert (std::find (m_parents.begin (), m_parents.end (), node)
+          == m_parents.end ());
+  // The slot is left empty until the next sort drops it.
+  m_ids[m_slots[node]] = NONE;
+  m_slots[node] = NONE;
+  m_parents[node] = NO_PARENT;
+  m_freeIds.push_back (node);
+  m_isOrderDirty = true;
+}
+
+void
+SceneGraph::setParent (unsigned node, unsigned parent)
+{
+  m_parents[node] = parent;
+  m_isDirty[m_slots[node]] = 1;
+  m_isOrderDirty = true;
+}
+
+unsigned
+SceneGraph::getParent (unsigned node) const
+{
+  return m_parents[node];
+}
+
+void
+SceneGraph::setLocal (unsigned node, const Transform& local)
+{
+  unsigned slot = m_slots[node];
+  m_locals[slot] = local;
+  m_isDirty[slot] = 1;
+}
+
+const Transform&
+SceneGraph::getLocal (unsigned node) const
+{
+  return m_locals[m_slots[node]];
+}
+
+const Transform&
+SceneGraph::getWorld (unsigned node) const
+{
+  return m_worlds[m_slots[node]];
+}
+
+size_t
+SceneGraph::getNodeCount () const
+{
+  return m_parents.size () - m_freeIds.size ();
+}
+
+size_t
+SceneGraph::update ()
+{
+  if (m_isOrderDirty)
+  {
+    sortBreadthFirst ();
+  }
+  size_t recomputed = 0;
+  for (size_t slot = 0; slot < m_ids.size (); ++slot)
+  {
+    unsigned parentSlot = m_parentSlots[slot];
+    // Parents come first, so a parent's flag already says whether its world
+    //   transform changed in this pass.
+    if (parentSlot != NONE && m_isDirty[parentSlot])
+    {
+      m_isDirty[slot] = 1;
+    }
+    if (m_isDirty[slot])
+    {
+      if (parentSlot == NONE)
+      {
+        m_worlds[slot] = m_locals[slot];
+      }
+      else
+      {
+        compose (m_worlds[parentSlot], m_locals[slot], m_worlds[slot]);
+      }
+      ++recomputed;
+    }
+  }
+  std::fill (m_isDirty.begin (), m_isDirty.end (), 0);
+  return recomputed;
+}
+
+void
+SceneGraph::sortBreadthFirst ()
+{
+  // Group each node's children together, in order of id.
+  std::vector<unsigned> firstChild (m_parents.size () + 1, 0);
+  for (unsigned node = 0; node < m_parents.size (); ++node)
+  {
+    if (m_slots[node] != NONE && m_parents[node] != NO_PARENT)
+    {
+      ++firstChild[m_parents[node] + 1];
+    }
+  }
+  for (size_t node = 0; node < m_parents.size (); ++node)
+  {
+    firstChild[node + 1] += firstChild[node];
+  }
+  std::vector<unsigned> children (firstChild.back ());
+  std::vector<unsigned> filled (firstChild.begin (), firstChild.end () - 1);
+  for (unsigned node = 0; node < m_parents.size (); ++node)
+  {
+    if (m_slots[node] != NONE && m_parents[node] != NO_PARENT)
+    {
+      children[filled[m_parents[node]]++] = node;
+    }
+  }
+
+  // The order doubles as the breadth-first queue.
+  std::vector<unsigned> order;
+  order.reserve (getNodeCount ());
+  for (unsigned node = 0; node < m_parents.size (); ++node)
+  {
+    if (m_slots[node] != NONE && m_parents[node] == NO_PARENT)
+    {
+      order.push_back (node);
+    }
+  }
+  for (size_t next = 0; next < order.size (); ++next)
+  {
+    unsigned node = order[next];
+    order.insert (order.end (), children.begin () + firstChild[node],
+                  children.begin () + firstChild[node + 1]);
+  }
+  assert (order.size () == getNodeCount ());
+
+  std::vector<unsigned> parentSlots (order.size ());
+  std::vector<Transform> locals (order.size ());
+  std::vector<Transform> worlds (order.size ());
+  std::vector<unsigned char> isDirty (order.size ());
+  for (size_t slot = 0; slot < order.size (); ++slot)
+  {
+    unsigned node = order[slot];
+    unsigned oldSlot = m_slots[node];
+    locals[slot] = m_locals[oldSlot];
+    worlds[slot] = m_worlds[oldSlot];
+    isDirty[slot] = m_isDirty[oldSlot];
+  }
+  for (size_t slot = 0; slot < order.size (); ++slot)
+  {
+    m_slots[order[slot]] = static_cast<unsigned> (slot);
+  }
+  for (size_t slot = 0; slot < order.size (); ++slot)
+  {
+    unsigned parent = m_parents[order[slot]];
+    parentSlots[slot] = parent == NO_PARENT ? NONE : m_slots[parent];
+  }
+  m_ids.swap (order);
+  m_parentSlots.swap (parentSlots);
+  m_locals.swap (locals);
+  m_worlds.swap (worlds);
+  m_isDirty.swap (isDirty);
+  m_isOrderDirty = false;
+}
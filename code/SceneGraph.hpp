@@ -0,0 +1,121 @@
+/// \file SceneGraph.hpp
+/// \brief Declaration of SceneGraph class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef SCENE_GRAPH_HPP
+#define SCENE_GRAPH_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Transform.hpp"
+
+/// \brief A hierarchy of transforms, where each node is placed relative to
+///   its parent, so that moving a node carries everything attached to it.
+/// Nodes are kept in one flat array in breadth-first order, so every parent
+///   comes before its children, and world transforms are brought up to date
+///   in a single pass over it.  Changing a node only marks it dirty; the pass
+///   recomputes the world transforms of dirty nodes and their descendants and
+///   skips everything else.
+/// Nodes are named by ids, which stay the same while the array is reordered.
+class SceneGraph
+{
+public:
+
+  /// \brief The parent of a node that has none, whose local transform is its
+  ///   world transform.
+  static const unsigned NO_PARENT = ~0u;
+
+  /// \brief Constructs an empty graph.
+  SceneGraph ();
+
+  /// \brief Adds a node.
+  /// \param[in] local Where it is relative to its parent.
+  /// \param[in] parent Its parent's id, or NO_PARENT.
+  /// \return Its id, which may be one a removed node had.
+  unsigned
+  add (const Transform& local, unsigned parent = NO_PARENT);
+
+  /// \brief Removes a node.
+  /// \param[in] node Its id.
+  /// \pre The node has no children.
+  void
+  remove (unsigned node);
+
+  /// \brief Moves a node, and everything below it, under another parent.
+  /// Its local transform is kept, so it is now placed relative to the new
+  ///   parent.
+  /// \param[in] node Its id.
+  /// \param[in] parent The new parent's id, or NO_PARENT.
+  /// \pre The parent is neither the node nor one of its descendants.
+  void
+  setParent (unsigned node, unsigned parent);
+
+  /// \brief Gets a node's parent.
+  /// \param[in] node Its id.
+  /// \return Its parent's id, or NO_PARENT.
+  unsigned
+  getParent (unsigned node) const;
+
+  /// \brief Places a node relative to its parent.
+  /// \param[in] node Its id.
+  /// \param[in] local Its new local transform.
+  /// \post It and its descendants will be recomputed by the next update.
+  void
+  setLocal (unsigned node, const Transform& local);
+
+  /// \brief Gets where a node is relative to its parent.
+  /// \param[in] node Its id.
+  /// \return Its local transform.
+  const Transform&
+  getLocal (unsigned node) const;
+
+  /// \brief Gets where a node is in the world.
+  /// \param[in] node Its id.
+  /// \return Its world transform as of the last update.
+  const Transform&
+  getWorld (unsigned node) const;
+
+  /// \brief Gets the number of nodes.
+  /// \return The number of nodes.
+  size_t
+  getNodeCount () const;
+
+  /// \brief Recomputes the world transforms of every changed node and its
+  ///   descendants, re-sorting the array first if nodes were added, removed,
+  ///   or moved to other parents.
+  /// \return The number of world transforms recomputed.
+  size_t
+  update ();
+
+private:
+  /// \brief Lays the live nodes out breadth-first, starting from the roots in
+  ///   order of id.
+  void
+  sortBreadthFirst ();
+
+  /// Marks an id that names no node, or a slot that holds none.
+  static const unsigned NONE = ~0u;
+
+  /// By id: the parent's id, and the node's place in the array.
+  std::vector<unsigned> m_parents;
+  std::vector<unsigned> m_slots;
+  /// Ids of removed nodes, to be given out again.
+  std::vector<unsigned> m_freeIds;
+
+  /// By slot, breadth-first: which node it holds, and the slot of its parent.
+  std::vector<unsigned> m_ids;
+  std::vector<unsigned> m_parentSlots;
+  std::vector<Transform> m_locals;
+  std::vector<Transform> m_worlds;
+  /// Whether the node's world transform is out of date.
+  std::vector<unsigned char> m_isDirty;
+
+  /// Whether nodes have been added, removed, or reparented since the array
+  ///   was last sorted.
+  bool m_isOrderDirty;
+};
+
+#endif//SCENE_GRAPH_HPP
@@ -0,0 +1,106 @@
+/// \file SceneTestFixture.hpp
+/// \brief Definition of the helpers shared by the Catch2 tests that draw
+///   Scenes and Meshes on the CPU and compare the frames.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef SCENE_TEST_FIXTURE_HPP
+#define SCENE_TEST_FIXTURE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Geometry.hpp"
+#include "Material.hpp"
+#include "Mesh.hpp"
+#include "NormalsMesh.hpp"
+#include "OpenGLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "SoftwareOpenGLContext.hpp"
+#include "UniformBlocks.hpp"
+
+/// \brief Builds a program from a pair of shaders in Shaders/, with the
+///   block bindings and sampler units Main::initShaders sets.
+/// \param[in] context The context to build the program in.
+/// \param[in] name The name the vertex and fragment shaders share.
+/// \param[in] isIndirect Whether to compile with INDIRECT_DRAW, as the
+///   programs for multi-draw indirect calls are.
+/// \return The linked program, which the caller deletes.
+inline ShaderProgram*
+createShaderProgram (OpenGLContext* context,
+                     const std::string& name = "PhongShader",
+                     bool isIndirect = false)
+{
+  std::string defines = isIndirect ? "#define INDIRECT_DRAW\n" : "";
+  ShaderProgram* program = new ShaderProgram (context);
+  program->createVertexShader ("Shaders/" + name + ".vert", defines);
+  program->createFragmentShader ("Shaders/" + name + ".frag", defines);
+  program->link ();
+  program->bindUniformBlock ("FrameBlock", FRAME_BLOCK_BINDING);
+  program->bindUniformBlock ("MaterialBlock", MATERIAL_BLOCK_BINDING);
+  program->bindUniformBlock ("ObjectBlock", OBJECT_BLOCK_BINDING);
+  program->enable ();
+  program->setUniformInt ("uClusterLights", CLUSTER_LIGHTS_UNIT);
+  program->setUniformInt ("uClusterGrid", CLUSTER_GRID_UNIT);
+  program->setUniformInt ("uClusterIndices", CLUSTER_INDICES_UNIT);
+  program->setUniformInt ("uObjects", INDIRECT_OBJECTS_UNIT);
+  program->setUniformInt ("uMaterials", INDIRECT_MATERIALS_UNIT);
+  program->disable ();
+  return program;
+}
+
+/// \brief Fills a Mesh with a unit cube, with normals or colors as it
+///   expects, and uploads it.
+/// \param[in] mesh An empty Mesh.
+/// \param[in] hasNormals Whether the Mesh takes normals rather than colors.
+inline void
+addCube (Mesh* mesh, bool hasNormals = true)
+{
+  std::vector<Triangle> faces = buildCube ();
+  std::vector<float> data;
+  std::vector<unsigned> indices;
+  indexData (hasNormals
+             ? dataWithFaceNormals (faces, computeFaceNormals (faces))
+             : dataWithFaceColors (faces, generateRandomFaceColors (faces)),
+             mesh->getFloatsPerVertex (), data, indices);
+  mesh->addGeometry (data);
+  mesh->addIndices (indices);
+  mesh->prepareVao ();
+}
+
+/// \brief Builds a lit unit cube.
+/// \param[in] context The context to upload the cube to.
+/// \param[in] program The program to draw it with.
+/// \param[in] material The material to light it with.
+/// \return The new NormalsMesh, which the caller (or its Scene) deletes.
+inline Mesh*
+createCube (OpenGLContext* context, ShaderProgram* program,
+            Material* material)
+{
+  Mesh* mesh = new NormalsMesh (context, program, material);
+  addCube (mesh);
+  return mesh;
+}
+
+/// \brief Reads every pixel of a framebuffer, row by row from the bottom.
+/// \param[in] context The context that drew the frame.
+/// \param[in] width The width of its framebuffer.
+/// \param[in] height The height of its framebuffer.
+/// \return The pixels, as getPixel gives them.
+inline std::vector<std::uint32_t>
+readPixels (const SoftwareOpenGLContext& context, GLsizei width,
+            GLsizei height)
+{
+  std::vector<std::uint32_t> pixels;
+  for (GLsizei y = 0; y < height; ++y)
+  {
+    for (GLsizei x = 0; x < width; ++x)
+    {
+      pixels.push_back (context.getPixel (x, y));
+    }
+  }
+  return pixels;
+}
+
+#endif//SCENE_TEST_FIXTURE_HPP
@@ -6,7 +6,7 @@
 #include "MyScene.hpp"
 
 MyScene::MyScene (OpenGLContext* context, ShaderProgram* colorShaderProgram, ShaderProgram* normalShaderProgram) 
-  : Scene::Scene(normalShaderProgram)
+  : Scene::Scene(context, normalShaderProgram)
 {
   // Top Pyramid
   std::vector<float> pyramid {
@@ -400,6 +400,14 @@ MyScene::MyScene (OpenGLContext* context, ShaderProgram* colorShaderProgram, Sha
 
   bear1->prepareVao();
   add("Bear1", bear1);
+
+  // The column of cubes stays where it is, so the cubes that are drawn alike
+  //   can be drawn together.
+  cube1->setStatic(true);
+  cube2->setStatic(true);
+  cube3->setStatic(true);
+  cube4->setStatic(true);
+  batchStaticMeshes();
 }
 
 void 
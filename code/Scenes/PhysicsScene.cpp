@@ -6,7 +6,7 @@
 #include "PhysicsScene.hpp"
 
 PhysicsScene::PhysicsScene (OpenGLContext* context, ShaderProgram* colorShaderProgram, ShaderProgram* normalShaderProgram) 
-  : Scene::Scene(normalShaderProgram)
+  : Scene::Scene(context, normalShaderProgram)
 {
   Material* brickMaterial = new Material(
     Vector3(0.6f, 0.6f, 0.6f),
@@ -147,10 +147,23 @@ PhysicsScene::PhysicsScene (OpenGLContext* context, ShaderProgram* colorShaderPr
 
   float paddleSpeed = 20.0f;
   m_player = new Player(player, Vector3(6.0, 6.0, 1.0), paddleSpeed);
-  m_AI = new AI(opponent, Vector3(6.0, 6.0, 1.0), paddleSpeed);
+  m_AI = new Player(opponent, Vector3(6.0, 6.0, 1.0), paddleSpeed);
+  m_opponent = addEntity("Opponent");
+  m_paddleAis.add(m_opponent, { { DEFAULT_MARGIN_3D, paddleSpeed }, Vector3(6.0f, 6.0f, 1.0f) });
+  m_walls = { Vector3(-20.0f, -20.0f, -20.0f), Vector3(20.0f, 10.0f, 20.0f) };
   m_ball = new Ball(sphere, Vector3(1.5f, 1.5f, 1.5f), Vector3(7.0f, 7.0f, 20.0f));
 
   m_gamestate = 0;
+
+  // The room never moves.
+  brickMeshWall->setStatic(true);
+  brickMeshFloor->setStatic(true);
+  brickMeshRoof->setStatic(true);
+  batchStaticMeshes();
+  // Nothing outside the room can be seen through it.
+  brickMeshWall->setOccluder(true);
+  brickMeshFloor->setOccluder(true);
+  brickMeshRoof->setOccluder(true);
 }
 
 void 
@@ -158,18 +171,15 @@ PhysicsScene::update (float deltaTime)
 {
   if (m_gamestate != 0)
   {
-    if (m_ball->update3D(deltaTime, -20.0f, 20.0f, 10.0f, -20.0f, 20.0, -20.0))
+    if (m_ball->update3D(deltaTime, { m_player, m_AI }, -20.0f, 20.0f, 10.0f, -20.0f, 20.0, -20.0))
     {
       m_gamestate = 0;
     }
-    m_AI->update3D(m_ball, deltaTime, -20.0f, 10.0f, -20.0f, 20.0f);
-    if (m_ball->collides3D(m_player) || m_ball->collides3D(m_AI))
-    {
-      m_ball->bounce3D();
-    }
+    steerPaddles(m_paddleAis, m_transforms, m_ball->getPosition(), m_walls, deltaTime);
   } else {
     m_ball->setVelocity(Vector3(7.0f, 7.0f, 20.0f));
   }
+  Scene::update(deltaTime);
 }
 
 void
@@ -52,7 +52,10 @@ public:
   private:
   unsigned int m_gamestate;
   Player* m_player;
-  AI* m_AI;
+  /// The AI's paddle, for the ball to bounce off; it is moved by the
+  ///   steerPaddles system through m_opponent's components.
+  Player* m_AI;
+  Entity m_opponent;
   Ball* m_ball;
 };
 
@@ -8,6 +8,7 @@
 
 #include "Player.hpp"
 #include "Ball.hpp"
+#include "PongAi.hpp"
 #include <algorithm>
 
 class AI : public Player
@@ -19,21 +20,6 @@ public:
 
   void
   update(Ball* ball, float deltaTime, float bottomBound, float topBound, float centerBoardX, float centerBoardY);
-
-  void
-  update3D(Ball* ball, float deltaTime, float bottomBound, float topBound, float leftBound, float rightBound);
-
-  void
-  moveUp3D(float deltaTime, float topBound, Ball* ball);
-
-  void
-  moveDown3D(float deltaTime, float bottomBound, Ball* ball);
-
-  void
-  moveLeft3D(float deltaTime, float leftBound, Ball* ball);
-
-  void
-  moveRight3D(float deltaTime, float rightBound, Ball* ball);
 };
 
 
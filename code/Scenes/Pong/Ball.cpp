@@ -4,6 +4,7 @@
 /// \version A09
 
 #include "Ball.hpp"
+#include "../../SweptCollision.hpp"
 
 Ball::Ball(Mesh* mesh,  Vector3 size, Vector3 velocity)
   : m_mesh(mesh), m_size(size), m_velocity(velocity)
@@ -35,9 +36,34 @@ Ball::update(float deltaTime, float leftBound, float rightBound, float topBound,
 }
 
 bool
-Ball::update3D(float deltaTime, float leftBound, float rightBound, float topBound, float bottomBound, float nearBound, float farBound)
+Ball::update3D(float deltaTime, const std::vector<const Player*>& paddles, float leftBound, float rightBound, float topBound, float bottomBound, float nearBound, float farBound)
 {
-  m_mesh->moveWorld(1.0f * deltaTime, m_velocity);
+  float radius = m_size.m_x / 2.0f;
+  float remaining = deltaTime;
+  for (unsigned bounces = 0; bounces <= MAX_BOUNCES_PER_STEP && remaining > 0.0f; ++bounces)
+  {
+    //Find the first paddle in the way
+    Vector3 motion = m_velocity * remaining;
+    SweepHit first;
+    first.time = 2.0f;
+    for (const Player* paddle : paddles)
+    {
+      SweepHit hit;
+      if (sweepSphereAabb(m_mesh->getPosition(), motion, radius, paddle->getPosition(), paddle->getSize() / 2.0f, hit) && hit.time < first.time)
+      {
+        first = hit;
+      }
+    }
+    if (first.time > 1.0f || bounces == MAX_BOUNCES_PER_STEP)
+    {
+      m_mesh->moveWorld(remaining, m_velocity);
+      break;
+    }
+    //Move up to it, bounce, and carry on with the rest of the step
+    m_mesh->moveWorld(first.time * remaining, m_velocity);
+    remaining *= 1.0f - first.time;
+    bounce3D(first.normal);
+  }
   Vector3 pos = m_mesh->getPosition();
   //Vertical Bounds
   if ((pos.m_y + (m_size.m_y / 2.0f) > topBound && m_velocity.m_y > 0.0f) || (pos.m_y - (m_size.m_y / 2.0f) < bottomBound && m_velocity.m_y < 0.0f)) 
@@ -109,6 +135,13 @@ Ball::bounce3D()
   m_velocity *= 1.01;
 }
 
+void
+Ball::bounce3D(const Vector3& normal)
+{
+  m_velocity -= normal * (2.0f * m_velocity.dot(normal));
+  m_velocity *= 1.01;
+}
+
 Vector3
 Ball::getPosition() const
 {
@@ -125,12 +158,15 @@ void
 Ball::reset() {
   Vector3 pos = m_mesh->getPosition();
   m_mesh->moveWorld(1.0f, Vector3(-pos.m_x, -pos.m_y, 0.0f));
+  // Jump straight to the center instead of sliding there.
+  m_mesh->storePreviousWorld();
 }
 
 void
 Ball::reset3D() {
   Vector3 pos = m_mesh->getPosition();
   m_mesh->moveWorld(1.0f, Vector3(-pos.m_x, -pos.m_y, -pos.m_z));
+  m_mesh->storePreviousWorld();
 }
 
 void
@@ -6,6 +6,8 @@
 #ifndef BALL_HPP
 #define BALL_HPP
 
+#include <vector>
+
 #include "../../Vector3.hpp"
 #include "../../Mesh.hpp"
 #include "Player.hpp"
@@ -21,8 +23,18 @@ public:
   bool
   update(float deltaTime, float leftBound, float rightBound, float topBound, float bottomBound);
 
+  /// \brief Moves the ball for one step, bouncing it off any paddle it
+  ///   reaches on the way, then off the walls.
+  /// The ball is swept along its path instead of being moved and then tested
+  ///   for overlap, so it cannot pass through a paddle however fast it goes.
+  ///   After each bounce it moves on for the rest of the step, up to
+  ///   MAX_BOUNCES_PER_STEP times.  Paddles are treated as standing still
+  ///   during the step, since they are much slower than the ball.
+  /// \param[in] deltaTime The length of the step.
+  /// \param[in] paddles The paddles it can hit.
+  /// \return True if it went past the near or far bound.
   bool
-  update3D(float deltaTime, float leftBound, float rightBound, float topBound, float bottomBound, float nearBound, float farBound);
+  update3D(float deltaTime, const std::vector<const Player*>& paddles, float leftBound, float rightBound, float topBound, float bottomBound, float nearBound, float farBound);
 
   bool
   collides(Player* paddle);
@@ -36,6 +48,11 @@ public:
   void
   bounce3D();
 
+  /// \brief Reflects the ball off a surface and speeds it up like bounce3D.
+  /// \param[in] normal The surface's unit normal, facing the ball.
+  void
+  bounce3D(const Vector3& normal);
+
   Vector3
   getPosition() const;
 
@@ -54,6 +71,9 @@ public:
   Vector3
   getVelocity();
 
+  /// The most paddles the ball may bounce off in one step.
+  static const unsigned MAX_BOUNCES_PER_STEP = 4;
+
 private:
   Mesh* m_mesh;
   Vector3 m_size;
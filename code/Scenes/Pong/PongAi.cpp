@@ -0,0 +1,59 @@
+/// \file PongAi.cpp
+/// \brief Definition of the decisions the Pong AI makes, apart from any Mesh,
+///   and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+
+#include "PongAi.hpp"
+
+int
+trackBall2D (const Vector3& ball, float paddleY, float centerBoardX,
+             float centerBoardY, float margin)
+{
+  //Track ball
+  if (ball.m_x - margin > centerBoardX)
+  {
+    if (ball.m_y > paddleY)
+    {
+      return 1;
+    }
+    else if (ball.m_y + margin < paddleY)
+    {
+      return -1;
+    }
+  }
+  else
+  {
+    if (centerBoardY - margin > paddleY)
+    {
+      return 1;
+    }
+    else if (centerBoardY + margin < paddleY)
+    {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+float
+getChaseSpeed (float speed, float distance)
+{
+  return std::min (speed, 10 + distance);
+}
+
+float
+trackBall3D (float ball, float paddle, const PongAiParameters& parameters)
+{
+  if (ball - parameters.margin > paddle)
+  {
+    return getChaseSpeed (parameters.speed, ball - paddle);
+  }
+  else if (ball + parameters.margin < paddle)
+  {
+    return -getChaseSpeed (parameters.speed, paddle - ball);
+  }
+  return 0.0f;
+}
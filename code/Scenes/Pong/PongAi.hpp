@@ -0,0 +1,57 @@
+/// \file PongAi.hpp
+/// \brief Declaration of the decisions the Pong AI makes, apart from any Mesh,
+///   and any associated global functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef PONG_AI_HPP
+#define PONG_AI_HPP
+
+#include "../../Vector3.hpp"
+
+/// \brief What can be tuned about an AI paddle.
+struct PongAiParameters
+{
+  /// How far the ball may be from the paddle before the paddle chases it.
+  float margin;
+  /// The paddle's top speed, in units per second.
+  float speed;
+};
+
+/// The margin AI::update uses.
+const float DEFAULT_MARGIN_2D = 0.5f;
+
+/// The margin PhysicsScene's AI paddle uses.
+const float DEFAULT_MARGIN_3D = 1.0f;
+
+/// \brief Decides which way a 2D paddle on the right of the board moves.
+/// While the ball is on the paddle's half it follows the ball, otherwise it
+///   returns to the middle.
+/// \param[in] ball Where the ball is.
+/// \param[in] paddleY The height of the paddle's center.
+/// \param[in] centerBoardX Where the board's halves meet.
+/// \param[in] centerBoardY The height of the board's middle.
+/// \param[in] margin How far off the paddle may be before it moves.
+/// \return 1 to move up, -1 to move down, or 0 to stay.
+int
+trackBall2D (const Vector3& ball, float paddleY, float centerBoardX,
+             float centerBoardY, float margin);
+
+/// \brief Gets how fast a 3D paddle chases the ball along one axis: its top
+///   speed, or less while the ball is close.
+/// \param[in] speed The paddle's top speed.
+/// \param[in] distance How far the ball is ahead of the paddle along the axis.
+/// \return The speed, which is positive while distance is.
+float
+getChaseSpeed (float speed, float distance);
+
+/// \brief Decides how fast a 3D paddle moves along one axis.
+/// \param[in] ball The ball's coordinate.
+/// \param[in] paddle The paddle's coordinate.
+/// \param[in] parameters The paddle's margin and top speed.
+/// \return The paddle's velocity along the axis, 0 if the ball is within the
+///   margin.
+float
+trackBall3D (float ball, float paddle, const PongAiParameters& parameters);
+
+#endif//PONG_AI_HPP
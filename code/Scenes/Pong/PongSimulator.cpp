@@ -0,0 +1,333 @@
+/// \file PongSimulator.cpp
+/// \brief Definition of PongSimulator class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+
+#include "PongSimulator.hpp"
+#include "../../SweptCollision.hpp"
+
+namespace
+{
+  // Pong2DScene's board, paddles, and ball.
+  const float LEFT_2D = -10.0f;
+  const float RIGHT_2D = 10.0f;
+  const float TOP_2D = 5.0f;
+  const float BOTTOM_2D = -5.0f;
+  const float PADDLE_X_2D = 8.0f;
+  const Vector3 PADDLE_SIZE_2D (0.25f, 2.0f, 0.0f);
+  const float PADDLE_SPEED_2D = 5.0f;
+  const Vector3 BALL_SIZE_2D (0.4f, 0.4f, 0.0f);
+  const Vector3 SERVE_2D (6.0f, 3.0f, 0.0f);
+  const float BOUNCE_SPEEDUP_2D = 1.025f;
+
+  // PhysicsScene's room, paddles, and ball.
+  const float LEFT_3D = -20.0f;
+  const float RIGHT_3D = 20.0f;
+  const float TOP_3D = 10.0f;
+  const float BOTTOM_3D = -20.0f;
+  const float NEAR_3D = 20.0f;
+  const float FAR_3D = -20.0f;
+  const Vector3 PADDLE_3D (0.0f, -10.0f, 18.0f);
+  const Vector3 PADDLE_SIZE_3D (6.0f, 6.0f, 1.0f);
+  const float PADDLE_SPEED_3D = 20.0f;
+  const Vector3 BALL_SIZE_3D (1.5f, 1.5f, 1.5f);
+  const Vector3 SERVE_3D (7.0f, 7.0f, 20.0f);
+  const float BOUNCE_SPEEDUP_3D = 1.01f;
+  // Ball::MAX_BOUNCES_PER_STEP.
+  const unsigned MAX_BOUNCES_PER_STEP = 4;
+
+  /// \brief Checks whether two boxes overlap in x and y, as Ball::collides
+  ///   does.
+  bool
+  overlaps2D (const Vector3& center1, const Vector3& size1,
+              const Vector3& center2, const Vector3& size2)
+  {
+    Vector3 half1 = size1 / 2.0f;
+    Vector3 half2 = size2 / 2.0f;
+    return center1.m_x - half1.m_x < center2.m_x + half2.m_x
+      && center1.m_x + half1.m_x > center2.m_x - half2.m_x
+      && center1.m_y - half1.m_y < center2.m_y + half2.m_y
+      && center1.m_y + half1.m_y > center2.m_y - half2.m_y;
+  }
+
+  /// \brief Checks whether a moving sphere might touch a box, by whether the
+  ///   box around its whole motion overlaps the box, which is much cheaper
+  ///   than sweepSphereAabb and rules out nearly every step.
+  bool
+  mayTouch (const Vector3& center, const Vector3& motion, float radius,
+            const Vector3& boxCenter, const Vector3& halfSize)
+  {
+    Vector3 end = center + motion;
+    Vector3 low (std::min (center.m_x, end.m_x), std::min (center.m_y, end.m_y),
+                 std::min (center.m_z, end.m_z));
+    Vector3 high (std::max (center.m_x, end.m_x),
+                  std::max (center.m_y, end.m_y),
+                  std::max (center.m_z, end.m_z));
+    Vector3 reach (radius + halfSize.m_x, radius + halfSize.m_y,
+                   radius + halfSize.m_z);
+    return low.m_x - reach.m_x <= boxCenter.m_x
+      && high.m_x + reach.m_x >= boxCenter.m_x
+      && low.m_y - reach.m_y <= boxCenter.m_y
+      && high.m_y + reach.m_y >= boxCenter.m_y
+      && low.m_z - reach.m_z <= boxCenter.m_z
+      && high.m_z + reach.m_z >= boxCenter.m_z;
+  }
+
+  /// \brief Moves a paddle along one axis unless its edge is already past
+  ///   the bound it is moving toward, as Player and AI do.
+  void
+  movePaddle (float& position, float halfSize, float velocity,
+              float deltaTime, float low, float high)
+  {
+    if ((velocity > 0.0f && position + halfSize < high)
+        || (velocity < 0.0f && position - halfSize > low))
+    {
+      position += velocity * deltaTime;
+    }
+  }
+}
+
+PongSimulator::PongSimulator (Rules rules, size_t gameCount, unsigned seed)
+  : m_rules (rules), m_games (gameCount), m_steps (0)
+{
+  m_ai[0] = m_ai[1] = getDefaultAi (rules);
+  std::mt19937 seeds (seed);
+  for (Game& game : m_games)
+  {
+    game.random.seed (seeds ());
+    if (m_rules == Rules::PONG_2D)
+    {
+      game.paddles[0] = Vector3 (-PADDLE_X_2D, 0.0f, 0.0f);
+      game.paddles[1] = Vector3 (PADDLE_X_2D, 0.0f, 0.0f);
+    }
+    else
+    {
+      game.paddles[0] = PADDLE_3D;
+      game.paddles[1] = Vector3 (PADDLE_3D.m_x, PADDLE_3D.m_y,
+                                 -PADDLE_3D.m_z);
+    }
+    game.scores[0] = game.scores[1] = 0;
+    game.rally = 0;
+    game.longestRally = 0;
+    game.hits = 0;
+    // The scenes serve toward the AI in 2D and toward the player in 3D.
+    serve (game, m_rules == Rules::PONG_2D ? 1 : 0);
+  }
+}
+
+PongAiParameters
+PongSimulator::getDefaultAi (Rules rules)
+{
+  if (rules == Rules::PONG_2D)
+  {
+    return PongAiParameters { DEFAULT_MARGIN_2D, PADDLE_SPEED_2D };
+  }
+  return PongAiParameters { DEFAULT_MARGIN_3D, PADDLE_SPEED_3D };
+}
+
+void
+PongSimulator::setAi (unsigned side, const PongAiParameters& parameters)
+{
+  m_ai[side] = parameters;
+}
+
+void
+PongSimulator::step (float deltaTime, JobSystem* jobs)
+{
+  auto stepGames = [this, deltaTime] (size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      if (m_rules == Rules::PONG_2D)
+      {
+        step2D (m_games[i], deltaTime);
+      }
+      else
+      {
+        step3D (m_games[i], deltaTime);
+      }
+    }
+  };
+  if (jobs == nullptr)
+  {
+    stepGames (0, m_games.size ());
+  }
+  else
+  {
+    jobs->parallelFor (0, m_games.size (), GAMES_PER_JOB, stepGames);
+  }
+  ++m_steps;
+}
+
+size_t
+PongSimulator::getGameCount () const
+{
+  return m_games.size ();
+}
+
+unsigned
+PongSimulator::getScore (size_t game, unsigned side) const
+{
+  return m_games[game].scores[side];
+}
+
+PongSimulator::Totals
+PongSimulator::getTotals () const
+{
+  Totals totals { m_steps, { 0, 0 }, 0, 0 };
+  for (const Game& game : m_games)
+  {
+    totals.points[0] += game.scores[0];
+    totals.points[1] += game.scores[1];
+    totals.hits += game.hits;
+    totals.longestRally = std::max ({ totals.longestRally, game.longestRally,
+                                      game.rally });
+  }
+  return totals;
+}
+
+void
+PongSimulator::serve (Game& game, unsigned toward) const
+{
+  game.ball = Vector3 ();
+  // Side 0 is toward -x in 2D but toward +z in 3D.
+  if (m_rules == Rules::PONG_2D)
+  {
+    std::uniform_real_distribution<float> angle (-SERVE_2D.m_y, SERVE_2D.m_y);
+    game.ballVelocity = Vector3 (toward == 1 ? SERVE_2D.m_x : -SERVE_2D.m_x,
+                                 angle (game.random), 0.0f);
+  }
+  else
+  {
+    std::uniform_real_distribution<float> across (-SERVE_3D.m_x,
+                                                  SERVE_3D.m_x);
+    std::uniform_real_distribution<float> up (-SERVE_3D.m_y, SERVE_3D.m_y);
+    float x = across (game.random);
+    float y = up (game.random);
+    game.ballVelocity = Vector3 (x, y, toward == 0 ? SERVE_3D.m_z
+                                                   : -SERVE_3D.m_z);
+  }
+}
+
+void
+PongSimulator::step2D (Game& game, float deltaTime) const
+{
+  // Ball::update.
+  Vector3& ball = game.ball;
+  Vector3& velocity = game.ballVelocity;
+  ball += velocity * deltaTime;
+  float halfWidth = BALL_SIZE_2D.m_x / 2.0f;
+  float halfHeight = BALL_SIZE_2D.m_y / 2.0f;
+  if ((ball.m_y + halfHeight > TOP_2D && velocity.m_y > 0.0f)
+      || (ball.m_y - halfHeight < BOTTOM_2D && velocity.m_y < 0.0f))
+  {
+    velocity.m_y = -velocity.m_y;
+  }
+  bool isOut = ball.m_x + halfWidth > RIGHT_2D
+    || ball.m_x - halfWidth < LEFT_2D;
+
+  // AI::update, with the board mirrored for the left paddle.
+  for (unsigned side = 0; side < 2; ++side)
+  {
+    Vector3 seen (side == 0 ? -ball.m_x : ball.m_x, ball.m_y, 0.0f);
+    int direction = trackBall2D (seen, game.paddles[side].m_y, 0.0f, 0.0f,
+                                 m_ai[side].margin);
+    movePaddle (game.paddles[side].m_y, PADDLE_SIZE_2D.m_y / 2.0f,
+                direction * m_ai[side].speed, deltaTime, BOTTOM_2D, TOP_2D);
+  }
+
+  if (isOut)
+  {
+    endPoint (game, ball.m_x > 0.0f ? 0 : 1);
+    return;
+  }
+  // Ball::bounce.
+  if ((velocity.m_x < 0.0f
+       && overlaps2D (ball, BALL_SIZE_2D, game.paddles[0], PADDLE_SIZE_2D))
+      || (velocity.m_x > 0.0f
+          && overlaps2D (ball, BALL_SIZE_2D, game.paddles[1], PADDLE_SIZE_2D)))
+  {
+    velocity.m_x = -velocity.m_x;
+    velocity *= BOUNCE_SPEEDUP_2D;
+    ++game.rally;
+  }
+}
+
+void
+PongSimulator::step3D (Game& game, float deltaTime) const
+{
+  // Ball::update3D.
+  Vector3& ball = game.ball;
+  Vector3& velocity = game.ballVelocity;
+  float radius = BALL_SIZE_3D.m_x / 2.0f;
+  Vector3 paddleHalfSize = PADDLE_SIZE_3D / 2.0f;
+  float remaining = deltaTime;
+  for (unsigned bounces = 0;
+       bounces <= MAX_BOUNCES_PER_STEP && remaining > 0.0f; ++bounces)
+  {
+    Vector3 motion = velocity * remaining;
+    SweepHit first;
+    first.time = 2.0f;
+    for (const Vector3& paddle : game.paddles)
+    {
+      SweepHit hit;
+      if (mayTouch (ball, motion, radius, paddle, paddleHalfSize)
+          && sweepSphereAabb (ball, motion, radius, paddle, paddleHalfSize,
+                              hit)
+          && hit.time < first.time)
+      {
+        first = hit;
+      }
+    }
+    if (first.time > 1.0f || bounces == MAX_BOUNCES_PER_STEP)
+    {
+      ball += velocity * remaining;
+      break;
+    }
+    ball += velocity * (first.time * remaining);
+    remaining *= 1.0f - first.time;
+    velocity -= first.normal * (2.0f * velocity.dot (first.normal));
+    velocity *= BOUNCE_SPEEDUP_3D;
+    ++game.rally;
+  }
+  if ((ball.m_y + radius > TOP_3D && velocity.m_y > 0.0f)
+      || (ball.m_y - radius < BOTTOM_3D && velocity.m_y < 0.0f))
+  {
+    velocity.m_y = -velocity.m_y;
+  }
+  if (ball.m_x + radius > RIGHT_3D || ball.m_x - radius < LEFT_3D)
+  {
+    velocity.m_x = -velocity.m_x;
+  }
+  bool isOut = ball.m_z + radius > NEAR_3D || ball.m_z - radius < FAR_3D;
+
+  // steerPaddles.
+  for (unsigned side = 0; side < 2; ++side)
+  {
+    Vector3& paddle = game.paddles[side];
+    movePaddle (paddle.m_y, paddleHalfSize.m_y,
+                trackBall3D (ball.m_y, paddle.m_y, m_ai[side]), deltaTime,
+                BOTTOM_3D, TOP_3D);
+    movePaddle (paddle.m_x, paddleHalfSize.m_x,
+                trackBall3D (ball.m_x, paddle.m_x, m_ai[side]), deltaTime,
+                LEFT_3D, RIGHT_3D);
+  }
+
+  if (isOut)
+  {
+    endPoint (game, ball.m_z > 0.0f ? 1 : 0);
+  }
+}
+
+void
+PongSimulator::endPoint (Game& game, unsigned winner) const
+{
+  ++game.scores[winner];
+  game.hits += game.rally;
+  game.longestRally = std::max (game.longestRally, game.rally);
+  game.rally = 0;
+  serve (game, 1 - winner);
+}
@@ -0,0 +1,139 @@
+/// \file PongSimulator.hpp
+/// \brief Declaration of PongSimulator class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef PONG_SIMULATOR_HPP
+#define PONG_SIMULATOR_HPP
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "../../JobSystem.hpp"
+#include "../../Vector3.hpp"
+#include "PongAi.hpp"
+
+/// \brief Plays many games of Pong at once with the AI on both sides, without
+///   a window, OpenGL, or any Mesh, to evaluate the AI.
+/// Each game follows the rules of Pong2DScene or PhysicsScene: the ball,
+///   paddles, walls, and AI behave as Ball, Player, and AI do there, with
+///   positions kept as plain vectors.  Side 0 is where the player stands
+///   (the left in 2D, the near end in 3D) and side 1 is the AI's.  Instead
+///   of waiting for a key, a point is served as soon as the last one ends,
+///   from the middle toward the side that lost it, at a random angle.
+/// Games are independent, so steps are split across a JobSystem, and each
+///   game has its own random numbers, so results do not depend on how many
+///   threads there are.
+class PongSimulator
+{
+public:
+
+  /// \brief Which scene's rules to play by.
+  enum class Rules
+  {
+    PONG_2D,
+    PONG_3D
+  };
+
+  /// \brief What happened across all games.
+  struct Totals
+  {
+    /// The number of steps each game has taken.
+    unsigned long long steps;
+    /// The points each side has won.
+    unsigned long long points[2];
+    /// The number of times the ball was hit by a paddle in points that have
+    ///   ended, so that hits divided by points is the mean rally length.
+    unsigned long long hits;
+    /// The most hits in one point of any game, including points still being
+    ///   played.
+    unsigned longestRally;
+  };
+
+  /// \brief The most games one job steps.
+  static const size_t GAMES_PER_JOB = 256;
+
+  /// \brief Sets up games with both paddles centered, the first point about
+  ///   to be served, and each side's AI set as the scene's AI.
+  /// \param[in] rules Which scene to play.
+  /// \param[in] gameCount How many games to play.
+  /// \param[in] seed Seeds the serves; games are seeded from it in turn.
+  PongSimulator (Rules rules, size_t gameCount, unsigned seed);
+
+  /// \brief Gets the AI the scene plays with.
+  /// \param[in] rules Which scene.
+  /// \return The margin and speed of its AI.
+  static PongAiParameters
+  getDefaultAi (Rules rules);
+
+  /// \brief Changes how one side plays.
+  /// \param[in] side 0 or 1.
+  /// \param[in] parameters Its margin and speed.
+  void
+  setAi (unsigned side, const PongAiParameters& parameters);
+
+  /// \brief Steps every game.
+  /// \param[in] deltaTime The length of the step, in seconds.
+  /// \param jobs The JobSystem to split the games across, or nullptr to step
+  ///   them all on this thread.
+  void
+  step (float deltaTime, JobSystem* jobs = nullptr);
+
+  /// \brief Gets the number of games.
+  /// \return The number of games.
+  size_t
+  getGameCount () const;
+
+  /// \brief Gets how many points one side has won in one game.
+  /// \param[in] game The game's index.
+  /// \param[in] side 0 or 1.
+  /// \return The side's score.
+  unsigned
+  getScore (size_t game, unsigned side) const;
+
+  /// \brief Adds up what has happened in every game.
+  /// \return The totals.
+  Totals
+  getTotals () const;
+
+private:
+  /// \brief One game.
+  struct Game
+  {
+    Vector3 ball;
+    Vector3 ballVelocity;
+    Vector3 paddles[2];
+    unsigned scores[2];
+    /// Hits so far in this point.
+    unsigned rally;
+    unsigned longestRally;
+    /// Hits in points that have ended.
+    unsigned long long hits;
+    std::minstd_rand random;
+  };
+
+  /// \brief Puts the ball in the middle and sends it toward a side.
+  void
+  serve (Game& game, unsigned toward) const;
+
+  /// \brief Steps one game by Pong2DScene's rules.
+  void
+  step2D (Game& game, float deltaTime) const;
+
+  /// \brief Steps one game by PhysicsScene's rules.
+  void
+  step3D (Game& game, float deltaTime) const;
+
+  /// \brief Counts a point and serves the next one.
+  void
+  endPoint (Game& game, unsigned winner) const;
+
+  Rules m_rules;
+  PongAiParameters m_ai[2];
+  std::vector<Game> m_games;
+  unsigned long long m_steps;
+};
+
+#endif//PONG_SIMULATOR_HPP
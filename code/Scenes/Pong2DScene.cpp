@@ -6,7 +6,7 @@
 #include "Pong2DScene.hpp"
 
 Pong2DScene::Pong2DScene (OpenGLContext* context, ShaderProgram* colorShaderProgram, ShaderProgram* normalShaderProgram) 
-  : Scene::Scene(normalShaderProgram)
+  : Scene::Scene(context, normalShaderProgram)
 {
   Material* material = new Material(
     Vector3(1.0f, 1.0f, 1.0f),
@@ -6,7 +6,7 @@
 #include "Pong2DScene2P.hpp"
 
 Pong2DScene2P::Pong2DScene2P (OpenGLContext* context, ShaderProgram* colorShaderProgram, ShaderProgram* normalShaderProgram) 
-  : Scene::Scene(normalShaderProgram)
+  : Scene::Scene(context, normalShaderProgram)
 {
   Material* material = new Material(
     Vector3(0.01f, 0.01f, 0.01f),
@@ -3,10 +3,33 @@
 /// \author Justin Stevens
 /// \version A09
 
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <typeindex>
+
 #include "Scene.hpp"
+#include "../Geometry.hpp"
 
-Scene::Scene (ShaderProgram* shader)
-  : m_shaderProgram(shader)
+Scene::Scene (OpenGLContext* context, ShaderProgram* shader)
+  : m_shaderProgram(shader),
+    m_context(context),
+    m_frameBuffer(context, sizeof(FrameUniforms)),
+    m_frameUniforms(),
+    m_frameCamera(nullptr),
+    m_frameViewCount(0),
+    m_frameProjectionCount(0),
+    m_areLightsDirty(true),
+    m_clusterLightBuffer(context, GL_RGBA32F),
+    m_clusterGridBuffer(context, GL_RG32UI),
+    m_clusterIndexBuffer(context, GL_R32UI),
+    m_dynamicBatchLimit(DEFAULT_DYNAMIC_BATCH_LIMIT),
+    m_dynamicBatchStats(),
+    m_recordingJobs(nullptr),
+    m_meshesPerList(DEFAULT_MESHES_PER_LIST),
+    m_isOcclusionCulling(false),
+    m_occlusionJobs(nullptr),
+    m_areIndirectListsDirty(false)
 {
 
 }
@@ -19,8 +42,17 @@ Scene::~Scene ()
 void
 Scene::add (const std::string& meshName, Mesh* mesh) 
 {
-  if (!hasMesh(meshName)) 
+  if (!hasMesh(meshName)) {
     m_meshes.insert( {meshName, mesh} ); 
+    unsigned node = m_graph.add(mesh->getWorld());
+    m_nodes.insert( {meshName, node} );
+    if (node >= m_nodeMeshes.size()) {
+      m_nodeMeshes.resize(node + 1, nullptr);
+      m_isNodeBatched.resize(node + 1, 0);
+    }
+    m_nodeMeshes[node] = mesh;
+    m_areIndirectListsDirty = true;
+  }
   if (m_meshes.size() == 1) 
     m_activeMesh = m_meshes.begin();
 }
@@ -31,16 +63,236 @@ Scene::remove (const std::string& meshName)
   if (m_activeMesh->first == meshName) 
     activateNextMesh();
   if (hasMesh(meshName)) {
+    Mesh* mesh = m_meshes.at(meshName);
+    std::vector<Entity> drawn;
+    for (size_t i = 0; i < m_meshHandles.size(); ++i)
+      if (m_meshHandles.getComponents()[i] == mesh)
+        drawn.push_back(m_meshHandles.getEntities()[i]);
+    for (Entity entity : drawn)
+      destroyEntity(entity);
+    unsigned node = m_nodes.at(meshName);
+    for (size_t batch = 0; m_isNodeBatched[node]; ++batch)
+      for (const BatchRange& range : m_staticBatches[batch].ranges)
+        if (range.meshName == meshName) {
+          unbatch(batch);
+          break;
+        }
+    for (auto const& it : m_nodes)
+      if (m_graph.getParent(it.second) == node)
+        m_graph.setParent(it.second, SceneGraph::NO_PARENT);
+    m_graph.remove(node);
+    m_nodeMeshes[node] = nullptr;
+    m_nodes.erase(meshName);
     delete m_meshes.find(meshName)->second;
     m_meshes.erase(meshName);
+    m_areIndirectListsDirty = true;
+  }
+}
+
+Entity
+Scene::addEntity (const std::string& meshName)
+{
+  Mesh* mesh = m_meshes.at(meshName);
+  Entity entity = m_entities.create();
+  m_transforms.add(entity, mesh->getWorld());
+  m_meshHandles.add(entity, mesh);
+  return entity;
+}
+
+void
+Scene::destroyEntity (Entity entity)
+{
+  m_transforms.remove(entity);
+  m_bodies.remove(entity);
+  m_paddleAis.remove(entity);
+  m_meshHandles.remove(entity);
+  m_entities.destroy(entity);
+}
+
+void
+Scene::attach (const std::string& meshName, const std::string& parentName)
+{
+  m_graph.setParent(m_nodes.at(meshName), parentName.empty()
+                    ? SceneGraph::NO_PARENT : m_nodes.at(parentName));
+}
+
+Transform
+Scene::getWorld (const std::string& meshName) const
+{
+  // Walks up from the Mesh itself, since the graph is only brought up to
+  //   date when the Scene is drawn or captured.
+  unsigned node = m_nodes.at(meshName);
+  Transform world = m_nodeMeshes[node]->getWorld();
+  for (unsigned parent = m_graph.getParent(node);
+       parent != SceneGraph::NO_PARENT; parent = m_graph.getParent(parent))
+    world = m_nodeMeshes[parent]->getWorld() * world;
+  return world;
+}
+
+void
+Scene::batchStaticMeshes ()
+{
+  while (!m_staticBatches.empty())
+    unbatch(m_staticBatches.size() - 1);
+
+  std::map<BatchKey, std::vector<std::string>> groups;
+  for (auto const& it : m_meshes)
+  {
+    if (it.second->isStatic())
+      groups[getBatchKey(it.second)].push_back(it.first);
+  }
+
+  for (auto const& group : groups)
+  {
+    if (group.second.size() < 2)
+      continue;
+    const Mesh* first = m_meshes.at(group.second.front());
+    StaticBatch batch { first->createEmpty(), {} };
+    std::vector<float> vertices;
+    std::vector<unsigned> indices;
+    for (const std::string& name : group.second)
+    {
+      const Mesh* mesh = m_meshes.at(name);
+      BatchRange range;
+      range.meshName = name;
+      range.firstIndex = indices.size();
+      appendTransformedGeometry(mesh->getVertices(), mesh->getIndices(),
+                                mesh->getFloatsPerVertex(),
+                                mesh->getVertexLayout().normalOffset,
+                                getWorld(name), vertices, indices, range.low,
+                                range.high);
+      range.indexCount = indices.size() - range.firstIndex;
+      batch.ranges.push_back(range);
+      m_isNodeBatched[m_nodes.at(name)] = 1;
+    }
+    batch.mesh->addGeometry(vertices);
+    batch.mesh->addIndices(indices);
+    batch.mesh->prepareVao();
+    m_staticBatches.push_back(batch);
+  }
+  m_areIndirectListsDirty = true;
+}
+
+const std::vector <Scene::StaticBatch>&
+Scene::getStaticBatches () const
+{
+  return m_staticBatches;
+}
+
+void
+Scene::setDynamicBatchLimit (unsigned maxVertices)
+{
+  m_dynamicBatchLimit = maxVertices;
+}
+
+unsigned
+Scene::getDynamicBatchLimit () const
+{
+  return m_dynamicBatchLimit;
+}
+
+const Scene::DynamicBatchStats&
+Scene::getDynamicBatchStats () const
+{
+  return m_dynamicBatchStats;
+}
+
+void
+Scene::setIndirectProgram (ShaderProgram* program,
+                           ShaderProgram* indirectProgram)
+{
+  if (indirectProgram == nullptr)
+    m_indirectPrograms.erase(program);
+  else
+    m_indirectPrograms[program] = indirectProgram;
+  m_areIndirectListsDirty = true;
+}
+
+void
+Scene::setRecordingJobs (JobSystem* jobs, size_t meshesPerList)
+{
+  m_recordingJobs = jobs;
+  m_meshesPerList = std::max<size_t>(meshesPerList, 1);
+}
+
+void
+Scene::setOcclusionCulling (bool isCulling, JobSystem* jobs)
+{
+  m_isOcclusionCulling = isCulling;
+  m_occlusionJobs = jobs;
+}
+
+const OcclusionCuller::Stats&
+Scene::getOcclusionStats () const
+{
+  return m_occlusionCuller.getStats();
+}
+
+ShaderProgram*
+Scene::getIndirectProgram (const Mesh* mesh) const
+{
+  // Textured Meshes each bind their own texture, so cannot share a draw.
+  auto program = m_indirectPrograms.find(mesh->getShaderProgram());
+  if (program == m_indirectPrograms.end() || mesh->getTexture() != nullptr
+      || mesh->getIndices().empty())
+    return nullptr;
+  return program->second;
+}
+
+void
+Scene::buildIndirectLists ()
+{
+  std::map<IndirectKey, std::vector<const Mesh*>> groups;
+  auto node = m_nodes.begin();
+  for (auto const& it : m_meshes) {
+    if (!m_isNodeBatched[node->second] && getIndirectProgram(it.second))
+      groups[IndirectKey(typeid(*it.second), it.second->getShaderProgram())]
+        .push_back(it.second);
+    ++node;
+  }
+  for (auto const& batch : m_staticBatches)
+    if (getIndirectProgram(batch.mesh))
+      groups[IndirectKey(typeid(*batch.mesh), batch.mesh->getShaderProgram())]
+        .push_back(batch.mesh);
+
+  m_indirectLists.clear();
+  for (auto const& group : groups) {
+    std::unique_ptr<IndirectDrawList> list(new IndirectDrawList(m_context,
+      getIndirectProgram(group.second.front())));
+    list->setMeshes(group.second);
+    m_indirectLists[group.first] = std::move(list);
   }
+  m_areIndirectListsDirty = false;
+}
+
+Scene::BatchKey
+Scene::getBatchKey (const Mesh* mesh)
+{
+  return BatchKey(typeid(*mesh), mesh->getShaderProgram(),
+                  mesh->getMaterial(), mesh->getTexture());
+}
+
+void
+Scene::unbatch (size_t batch)
+{
+  for (const BatchRange& range : m_staticBatches[batch].ranges)
+    m_isNodeBatched[m_nodes.at(range.meshName)] = 0;
+  delete m_staticBatches[batch].mesh;
+  m_staticBatches.erase(m_staticBatches.begin() + batch);
+  m_areIndirectListsDirty = true;
 }
 
 void
 Scene::clear () {
+  // The lists only point at the Meshes.
+  m_indirectLists.clear();
   //Unallocate meshes
   for (auto& it : m_meshes) 
     delete it.second;
+  for (auto& batch : m_staticBatches)
+    delete batch.mesh;
+  for (auto& batch : m_dynamicBatches)
+    delete batch.second.mesh;
   //Unallocate light sources
   for (auto& light : m_lights) 
     delete light;
@@ -53,19 +305,308 @@ Scene::clear () {
 }
 
 void
-Scene::draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPostion) {
-  m_shaderProgram->enable();
-  m_shaderProgram->setUniformInt("uNumLights", m_lights.size());
+Scene::draw (Camera* camera, float interpolation) {
+  updateWorlds();
+  auto node = m_nodes.begin();
+  for (auto const& it : m_meshes) {
+    it.second->setDrawnWorlds(getPreviousWorld(node->second),
+                              m_graph.getWorld(node->second), interpolation);
+    ++node;
+  }
+  drawMeshes(camera);
+}
+
+void
+Scene::draw (Camera* camera, const FrameState& frame, float interpolation)
+{
+  size_t i = 0;
+  for (auto const& it : m_meshes)
+  {
+    it.second->setDrawnWorlds(frame.previousWorlds[i], frame.worlds[i],
+                              interpolation);
+    ++i;
+  }
+  drawMeshes(camera);
+}
+
+void
+Scene::capture (FrameState& frame)
+{
+  frame.scene = this;
+  frame.previousWorlds.clear();
+  frame.worlds.clear();
+  updateWorlds();
+  for (auto const& it : m_nodes)
+  {
+    frame.previousWorlds.push_back(getPreviousWorld(it.second));
+    frame.worlds.push_back(m_graph.getWorld(it.second));
+  }
+}
+
+void
+Scene::updateWorlds ()
+{
+  // m_nodes has the same names as m_meshes, so they are walked together.
+  auto node = m_nodes.begin();
+  for (auto const& it : m_meshes)
+  {
+    // Only Meshes that moved are marked, so that the graph skips the rest.
+    Transform local = it.second->getWorld();
+    if (std::memcmp(&local, &m_graph.getLocal(node->second),
+                    sizeof(Transform)) != 0)
+      m_graph.setLocal(node->second, local);
+    ++node;
+  }
+  m_graph.update();
+}
+
+Transform
+Scene::getPreviousWorld (unsigned node) const
+{
+  // Combined from the Meshes' own previous transforms rather than kept from
+  //   the last update, so that a Mesh moved since, or placed without
+  //   interpolation by storing its previous world, is drawn from where it
+  //   was.
+  Transform world = m_nodeMeshes[node]->getPreviousWorld();
+  for (unsigned parent = m_graph.getParent(node);
+       parent != SceneGraph::NO_PARENT; parent = m_graph.getParent(parent))
+    world = m_nodeMeshes[parent]->getPreviousWorld() * world;
+  return world;
+}
 
-  m_shaderProgram->setUniformVector("uAmbientIntensity", Vector3(0.001f, 0.01f, 0.001f));
+void
+Scene::drawMeshes (Camera* camera)
+{
+  updateFrameUniforms(camera);
+  m_frameBuffer.bind(FRAME_BLOCK_BINDING);
+  m_clusterLightBuffer.bind(CLUSTER_LIGHTS_UNIT);
+  m_clusterGridBuffer.bind(CLUSTER_GRID_UNIT);
+  m_clusterIndexBuffer.bind(CLUSTER_INDICES_UNIT);
+  m_context->activeTexture(GL_TEXTURE0);
+  if (m_areIndirectListsDirty)
+    buildIndirectLists();
 
-  for (int i = 0; i < m_lights.size(); ++i)
-    m_lights[i]->setUniforms(m_shaderProgram, i);
+  m_isNodeOccluded.assign(m_nodeMeshes.size(), 0);
+  if (m_isOcclusionCulling)
+    cullOccludedMeshes(camera);
 
-  for (auto const& it : m_meshes) 
-    it.second->draw(viewMatrix, projectionMatrix, cameraPostion);
-  
-  m_shaderProgram->disable();
+  // Small Meshes are gathered by what they are drawn with, and drawn once
+  //   the rest have been.  Meshes drawn indirectly are drawn last of all.
+  auto node = m_nodes.begin();
+  for (auto const& it : m_meshes) {
+    Mesh* mesh = it.second;
+    size_t vertexCount = mesh->getVertices().size() / mesh->getFloatsPerVertex();
+    if (!m_isNodeBatched[node->second] && !getIndirectProgram(mesh)
+        && !m_isNodeOccluded[node->second]) {
+      if (vertexCount > 0 && vertexCount <= m_dynamicBatchLimit)
+        m_dynamicBatches[getBatchKey(mesh)].members.push_back(mesh);
+      else
+        m_individualMeshes.push_back(mesh);
+    }
+    ++node;
+  }
+  drawIndividualMeshes(camera);
+  drawDynamicBatches(camera);
+  for (auto const& batch : m_staticBatches)
+    if (!getIndirectProgram(batch.mesh))
+      batch.mesh->draw(camera);
+  for (auto const& list : m_indirectLists)
+    list.second->draw();
+}
+
+void
+Scene::cullOccludedMeshes (Camera* camera)
+{
+  m_occlusionCuller.beginFrame(camera->getViewProjectionMatrix());
+  m_occludeeBoxes.clear();
+  m_occludeeNodes.clear();
+  auto node = m_nodes.begin();
+  for (auto const& it : m_meshes) {
+    Mesh* mesh = it.second;
+    // Batched occluders still hide what is behind them, where they were
+    //   batched, which is where their own transforms put them.
+    if (mesh->isOccluder())
+      m_occlusionCuller.addOccluder(mesh->getVertices(), mesh->getIndices(),
+                                    mesh->getFloatsPerVertex(),
+                                    mesh->getWorldMatrix());
+    else if (!m_isNodeBatched[node->second] && !getIndirectProgram(mesh)
+             && !mesh->getVertices().empty()) {
+      OcclusionCuller::Box box;
+      mesh->getLocalBounds(box.low, box.high);
+      box.world = &mesh->getWorldMatrix();
+      m_occludeeBoxes.push_back(box);
+      m_occludeeNodes.push_back(node->second);
+    }
+    ++node;
+  }
+  m_occlusionCuller.rasterize(m_occlusionJobs);
+  m_occlusionCuller.testBoxes(m_occludeeBoxes, m_isOccludeeHidden,
+                              m_occlusionJobs);
+  for (size_t i = 0; i < m_occludeeNodes.size(); ++i)
+    m_isNodeOccluded[m_occludeeNodes[i]] = m_isOccludeeHidden[i];
+}
+
+void
+Scene::drawIndividualMeshes (Camera* camera)
+{
+  size_t listCount = m_recordingJobs == nullptr ? 0
+    : (m_individualMeshes.size() + m_meshesPerList - 1) / m_meshesPerList;
+  if (listCount < 2)
+  {
+    for (Mesh* mesh : m_individualMeshes)
+      mesh->draw(camera);
+    m_individualMeshes.clear();
+    return;
+  }
+
+  // Materials are shared between Meshes, so they are uploaded here, before
+  //   the jobs start, and the jobs only read them.
+  for (Mesh* mesh : m_individualMeshes)
+    mesh->prepareDraw();
+  while (m_commandLists.size() < listCount)
+    m_commandLists.emplace_back(new CommandList());
+  m_recordingJobs->parallelFor(0, listCount, 1,
+    [this] (size_t first, size_t last)
+    {
+      for (size_t list = first; list < last; ++list)
+      {
+        CommandList* commands = m_commandLists[list].get();
+        commands->reset();
+        size_t end = std::min(m_individualMeshes.size(),
+                              (list + 1) * m_meshesPerList);
+        for (size_t i = list * m_meshesPerList; i < end; ++i)
+          m_individualMeshes[i]->drawThrough(commands);
+      }
+    });
+  // Replayed in the order the Meshes were gathered, as if drawn directly.
+  for (size_t list = 0; list < listCount; ++list)
+    m_commandLists[list]->replay(m_context);
+  m_individualMeshes.clear();
+}
+
+void
+Scene::drawDynamicBatches (Camera* camera)
+{
+  m_dynamicBatchStats = DynamicBatchStats();
+  for (auto& it : m_dynamicBatches)
+  {
+    DynamicBatch& batch = it.second;
+    if (batch.members.size() < 2)
+    {
+      // A Mesh with nothing to share its draw with is drawn on its own.
+      for (Mesh* mesh : batch.members)
+        mesh->draw(camera);
+      batch.members.clear();
+      continue;
+    }
+    if (batch.mesh == nullptr)
+    {
+      batch.mesh = batch.members.front()->createEmpty();
+      batch.mesh->prepareVao();
+    }
+
+    // Moved to where they are drawn this frame, interpolation and all, so
+    //   the batch matches what drawing them one at a time would show.
+    m_batchVertices.clear();
+    m_batchIndices.clear();
+    Vector3 low, high;
+    for (const Mesh* mesh : batch.members)
+    {
+      appendTransformedGeometry(mesh->getVertices(), mesh->getIndices(),
+                                mesh->getFloatsPerVertex(),
+                                mesh->getVertexLayout().normalOffset,
+                                mesh->getWorldMatrix(),
+                                mesh->getNormalMatrix(), m_batchVertices,
+                                m_batchIndices, low, high);
+    }
+    batch.mesh->stream(m_batchVertices, m_batchIndices);
+    batch.mesh->draw(camera);
+
+    ++m_dynamicBatchStats.batches;
+    m_dynamicBatchStats.verticesProcessed +=
+      m_batchVertices.size() / batch.mesh->getFloatsPerVertex();
+    m_dynamicBatchStats.drawsSaved += batch.members.size() - 1;
+    batch.members.clear();
+  }
+}
+
+void
+Scene::storePreviousWorlds ()
+{
+  for (auto const& it : m_meshes)
+    it.second->storePreviousWorld();
+}
+
+void
+Scene::updateFrameUniforms (Camera* camera)
+{
+  // Brings the view update count up to date before it is compared.
+  const Matrix4& view = camera->getViewMatrix();
+
+  bool hasProjectionChanged = m_frameCamera != camera
+    || m_frameProjectionCount != camera->getProjectionUpdateCount();
+  bool hasCameraChanged = hasProjectionChanged
+    || m_frameViewCount != camera->getViewUpdateCount();
+  if (!hasCameraChanged && !m_areLightsDirty)
+    return;
+
+  if (hasProjectionChanged)
+    m_lightCuller.setProjection(camera->getInverseProjectionMatrix());
+
+  copyToBlock(m_frameUniforms.view, view);
+  copyToBlock(m_frameUniforms.inverseView, camera->getInverseViewMatrix());
+  copyToBlock(m_frameUniforms.projection, camera->getProjectionMatrix());
+  copyToBlock(m_frameUniforms.ambientIntensity, Vector3(0.001f, 0.01f, 0.001f));
+  m_frameUniforms.numLights = m_directionalLights.size();
+  m_frameUniforms.clusterCounts[0] = m_lightCuller.getTilesX();
+  m_frameUniforms.clusterCounts[1] = m_lightCuller.getTilesY();
+  m_frameUniforms.clusterCounts[2] = m_lightCuller.getSlices();
+  m_frameUniforms.clusterDepthScale = m_lightCuller.getDepthScale();
+  m_frameUniforms.clusterDepthBias = m_lightCuller.getDepthBias();
+
+  if (m_areLightsDirty)
+  {
+    std::copy(m_directionalLights.begin(), m_directionalLights.end(),
+              m_frameUniforms.lights);
+    m_frameBuffer.update(&m_frameUniforms, sizeof(m_frameUniforms));
+    m_clusterLightBuffer.setData(m_localLights.data(),
+                                 m_localLights.size() * sizeof(LightUniforms));
+  }
+  else
+  {
+    // The lights have not changed, so only the part before them is written.
+    m_frameBuffer.update(&m_frameUniforms, offsetof(FrameUniforms, lights));
+  }
+  cullLights(view);
+
+  m_frameCamera = camera;
+  m_frameViewCount = camera->getViewUpdateCount();
+  m_frameProjectionCount = camera->getProjectionUpdateCount();
+  m_areLightsDirty = false;
+}
+
+void
+Scene::cullLights (const Matrix4& view)
+{
+  size_t count = m_localLights.size();
+  m_lightX.resize(count);
+  m_lightY.resize(count);
+  m_lightZ.resize(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const float* p = m_localLights[i].position;
+    Vector4 position = view * Vector4(p[0], p[1], p[2], 1.0f);
+    m_lightX[i] = position.m_x;
+    m_lightY[i] = position.m_y;
+    m_lightZ[i] = position.m_z;
+  }
+  m_lightCuller.cull(m_lightX, m_lightY, m_lightZ, m_localLightRadii);
+
+  const std::vector<unsigned>& grid = m_lightCuller.getClusterGrid();
+  const std::vector<unsigned>& indices = m_lightCuller.getLightIndices();
+  m_clusterGridBuffer.setData(grid.data(), grid.size() * sizeof(unsigned));
+  m_clusterIndexBuffer.setData(indices.data(),
+                               indices.size() * sizeof(unsigned));
 }
 
 bool
@@ -82,6 +623,18 @@ Scene::getMesh (const std::string& meshName) {
   return mesh->second;
 }
 
+const std::map <std::string, Mesh*>&
+Scene::getMeshes () const
+{
+  return m_meshes;
+}
+
+const std::vector <LightSource*>&
+Scene::getLightSources () const
+{
+  return m_lights;
+}
+
 void
 Scene::setActiveMesh (const std::string& meshName)
 {
@@ -97,29 +650,54 @@ Scene::getActiveMesh ()
 void
 Scene::activateNextMesh ()
 {
-  ++m_activeMesh;
-  if (m_activeMesh == m_meshes.end()) 
-    m_activeMesh = m_meshes.begin();
+  // Gives up after going all the way around, in case every mesh is static.
+  for (size_t tries = 0; tries < m_meshes.size(); ++tries) {
+    ++m_activeMesh;
+    if (m_activeMesh == m_meshes.end()) 
+      m_activeMesh = m_meshes.begin();
+    if (!m_activeMesh->second->isStatic())
+      return;
+  }
 }
 
 void
 Scene::activatePreviousMesh ()
 {
-  if (m_activeMesh == m_meshes.begin()) 
-    m_activeMesh = --m_meshes.end();
-  else 
-    --m_activeMesh;
+  for (size_t tries = 0; tries < m_meshes.size(); ++tries) {
+    if (m_activeMesh == m_meshes.begin()) 
+      m_activeMesh = --m_meshes.end();
+    else 
+      --m_activeMesh;
+    if (!m_activeMesh->second->isStatic())
+      return;
+  }
 }
 
 void 
 Scene::addLightSource (LightSource* light)
 {
-  if (m_lights.size() < MAX_LIGHT_SOURCES)
+  LightUniforms uniforms = LightUniforms();
+  light->writeUniforms(uniforms);
+  if (uniforms.type == 0)
   {
-    m_lights.push_back(light);
-  } else {
-    throw std::invalid_argument( "Number of light sources exceeds" + std::to_string(MAX_LIGHT_SOURCES) );
+    // Directional lights reach everything, so they cannot be culled.
+    if (m_directionalLights.size() >= MAX_LIGHT_SOURCES)
+      throw std::invalid_argument( "Number of directional light sources exceeds " + std::to_string(MAX_LIGHT_SOURCES) );
+    m_directionalLights.push_back(uniforms);
   }
+  else
+  {
+    float intensity = 0.0f;
+    for (int i = 0; i < 3; ++i)
+      intensity = std::max({intensity, uniforms.diffuseIntensity[i],
+                            uniforms.specularIntensity[i]});
+    const float* a = uniforms.attenuationCoefficients;
+    m_localLights.push_back(uniforms);
+    m_localLightRadii.push_back(ClusteredLightCuller::attenuationRadius(
+      Vector3(a[0], a[1], a[2]), intensity));
+  }
+  m_lights.push_back(light);
+  m_areLightsDirty = true;
 }
 
 void 
@@ -143,7 +721,17 @@ Scene::addTexture (Texture* texture)
 void 
 Scene::update (float deltaTime)
 {
+  moveBodies(m_bodies, m_transforms, m_walls, deltaTime);
+  writeMeshWorlds();
+}
 
+void
+Scene::writeMeshWorlds ()
+{
+  const std::vector<Mesh*>& meshes = m_meshHandles.getComponents();
+  const std::vector<Entity>& entities = m_meshHandles.getEntities();
+  for (size_t i = 0; i < meshes.size(); ++i)
+    meshes[i]->setWorld(m_transforms.get(entities[i]));
 }
 
 void
@@ -8,7 +8,11 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <stdexcept>
+#include <tuple>
+#include <typeindex>
+#include <vector>
 
 #include "../Mesh.hpp"
 #include "../ShaderProgram.hpp"
@@ -20,14 +24,77 @@
 #include "../Texture.hpp"
 #include "../KeyBuffer.hpp"
 #include "../Camera.hpp"
+#include "../CommandList.hpp"
+#include "../JobSystem.hpp"
+#include "../UniformBlocks.hpp"
+#include "../UniformBuffer.hpp"
+#include "../TextureBuffer.hpp"
+#include "../ClusteredLightCuller.hpp"
+#include "../IndirectDrawList.hpp"
+#include "../OcclusionCuller.hpp"
+#include "../FrameState.hpp"
+#include "../SceneGraph.hpp"
+#include "../EntityRegistry.hpp"
+#include "../ComponentStore.hpp"
+#include "../EntitySystems.hpp"
 
 /// \brief A collection of all the objects that exist in the world.
 class Scene
 {
 public:
+
+  /// \brief Where one Mesh's triangles are within a static batch.
+  struct BatchRange
+  {
+    /// The name of the Mesh.
+    std::string meshName;
+    /// Its first index within the batch's indices.
+    unsigned firstIndex;
+    /// How many indices it has.
+    unsigned indexCount;
+    /// The lowest and highest world coordinates of its vertices, for culling
+    ///   it on its own.
+    Vector3 low;
+    Vector3 high;
+  };
+
+  /// \brief Static Meshes that are drawn alike, merged into one Mesh in world
+  ///   space so that they are drawn with one call.
+  struct StaticBatch
+  {
+    /// The merged Mesh, owned by the Scene, with an identity world transform.
+    Mesh* mesh;
+    /// Where each of the merged Meshes is within it.
+    std::vector<BatchRange> ranges;
+  };
+
+  /// \brief What dynamic batching did in the last frame drawn.
+  struct DynamicBatchStats
+  {
+    /// How many batches were drawn.
+    unsigned batches;
+    /// How many vertices were moved into world space to fill them.
+    unsigned verticesProcessed;
+    /// How many draw calls they saved: one fewer than their Meshes, each.
+    unsigned drawsSaved;
+  };
+
+  /// The most vertices a Mesh may have to be batched dynamically, unless
+  ///   setDynamicBatchLimit says otherwise.  Past a few hundred, moving the
+  ///   vertices on the CPU costs more than the draw call it saves.
+  static const unsigned DEFAULT_DYNAMIC_BATCH_LIMIT = 300;
+
+  /// How many Meshes each CommandList holds, unless setRecordingJobs says
+  ///   otherwise: enough that recording one outweighs queuing its job.
+  static const size_t DEFAULT_MESHES_PER_LIST = 256;
   
   /// \brief Constructs an empty Scene.
-  Scene (ShaderProgram* shader);
+  /// \param context A pointer to an object through which the Scene will be
+  ///   able to make OpenGL calls.
+  /// \param[in] shader The ShaderProgram used for lit objects.
+  /// \post Buffers for the FrameBlock uniform block and the clustered lights
+  ///   have been allocated.
+  Scene (OpenGLContext* context, ShaderProgram* shader);
 
   /// \brief Destructs a Scene, freeing the memory used by any Meshes in it.
   /// \post Any Meshes that were part of the Scene have been freed.
@@ -57,10 +124,128 @@ public:
   /// \param[in] meshName The name of the Mesh that should be removed.
   /// \pre This Scene contains a Mesh associated with meshName.
   /// \post This Scene no longer associates meshName with anything.
+  /// \post Entities drawn by the Mesh have been destroyed.
+  /// \post If the Mesh was batched, the rest of its batch is drawn on its own
+  ///   until batchStaticMeshes is called again.
+  /// \post Meshes that were attached to it are detached.
   /// \post The Mesh that had been associated with meshName has been freed.
   void
   remove (const std::string& meshName);
 
+  /// \brief Attaches a Mesh to another, so that it moves along with it.
+  /// From then on the Mesh's own transform places it relative to the Mesh it
+  ///   is attached to, rather than in the world.
+  /// \param[in] meshName The name of the Mesh to attach.
+  /// \param[in] parentName The name of the Mesh to attach it to, or "" to
+  ///   detach it, so that its own transform places it in the world again.
+  /// \pre This Scene contains both Meshes, and the parent is neither the
+  ///   Mesh nor attached to it, directly or not.
+  void
+  attach (const std::string& meshName, const std::string& parentName);
+
+  /// \brief Gets where a Mesh is in the world.
+  /// \param[in] meshName The name of the Mesh.
+  /// \pre This Scene contains a Mesh associated with meshName.
+  /// \return Its transform combined with those of the Meshes it is attached
+  ///   to, as they are now.
+  Transform
+  getWorld (const std::string& meshName) const;
+
+  /// \brief Creates an entity drawn by a Mesh.
+  /// It starts with a Transform component, copied from the Mesh, which
+  ///   update copies back to the Mesh after running the systems.  From then on
+  ///   the entity should be moved through its components, not the Mesh.
+  /// \param[in] meshName The name of the Mesh.
+  /// \pre This Scene contains a Mesh associated with meshName.
+  /// \return The entity, which has a Transform and a Mesh handle.
+  Entity
+  addEntity (const std::string& meshName);
+
+  /// \brief Destroys an entity, removing all of its components.
+  /// Its Mesh, if it had one, stays where it was last put.
+  /// \param[in] entity The entity.
+  /// \pre The entity is alive.
+  void
+  destroyEntity (Entity entity);
+
+  /// \brief Merges the Meshes marked static into batches, one for each kind
+  ///   of Mesh, ShaderProgram, Material, and texture that more than one of
+  ///   them share.
+  /// Each Mesh's vertices are moved into world space where it is now, so call
+  ///   this once the Scene has been built.  A batched Mesh is no longer drawn
+  ///   on its own, and moving it afterward does not move what is drawn; it is
+  ///   still found by name, and still seen by the path tracer.
+  /// \post Meshes batched by an earlier call have been batched again.
+  void
+  batchStaticMeshes ();
+
+  /// \brief Gets the static batches.
+  /// \return The batches made by batchStaticMeshes.
+  const std::vector <StaticBatch>&
+  getStaticBatches () const;
+
+  /// \brief Sets how small a Mesh must be to be batched dynamically.
+  /// Every frame, Meshes outside static batches with at most this many
+  ///   vertices are moved into world space where they are drawn, and those
+  ///   drawn alike are streamed into one Mesh and drawn with one call.
+  /// \param[in] maxVertices The most vertices a batched Mesh may have, or 0
+  ///   to draw every Mesh on its own.
+  void
+  setDynamicBatchLimit (unsigned maxVertices);
+
+  /// \brief Gets how small a Mesh must be to be batched dynamically.
+  /// \return The most vertices a batched Mesh may have.
+  unsigned
+  getDynamicBatchLimit () const;
+
+  /// \brief Gets what dynamic batching did in the last frame drawn.
+  /// \return The counts, which each draw starts over.
+  const DynamicBatchStats&
+  getDynamicBatchStats () const;
+
+  /// \brief Draws the untextured Meshes that use a ShaderProgram with
+  ///   another, compiled with INDIRECT_DRAW, instead, so that all of them of
+  ///   each kind are drawn with a single glMultiDrawElementsIndirect call.
+  /// Their geometry is copied into shared buffers whenever Meshes are added,
+  ///   removed, or batched, and their world matrices and Materials are
+  ///   rewritten every frame, so they may still move.  They are not batched
+  ///   dynamically, since they already share a call; static batches are
+  ///   drawn with them.  This needs OpenGL 4.3 or ARB_multi_draw_indirect.
+  /// \param[in] program The ShaderProgram the Meshes were made with.
+  /// \param[in] indirectProgram The ShaderProgram to draw them with, or
+  ///   nullptr to draw them one at a time again.
+  void
+  setIndirectProgram (ShaderProgram* program, ShaderProgram* indirectProgram);
+
+  /// \brief Records the Meshes drawn one at a time into CommandLists on a
+  ///   JobSystem's threads, so that their matrices and uniform blocks are
+  ///   prepared on every core, then replays the lists in order on this
+  ///   thread.  The frame is the same as when they are drawn directly.
+  /// \param jobs The JobSystem to record on, which must outlive the Scene or
+  ///   be replaced first, or nullptr to draw the Meshes directly again.
+  /// \param[in] meshesPerList How many Meshes each job records; with fewer
+  ///   than twice this many Meshes, they are drawn directly.
+  void
+  setRecordingJobs (JobSystem* jobs,
+                    size_t meshesPerList = DEFAULT_MESHES_PER_LIST);
+
+  /// \brief Skips drawing the Meshes hidden behind those marked with
+  ///   Mesh::setOccluder, as an OcclusionCuller finds them each frame.
+  /// Every occluder is drawn into the culler's depth buffer, batched or not,
+  ///   and each Mesh drawn on its own or batched dynamically is tested
+  ///   against it before it is gathered.  Occluders themselves, static
+  ///   batches, and Meshes drawn indirectly are always drawn.
+  /// \param[in] isCulling Whether to cull occluded Meshes.
+  /// \param jobs The JobSystem to rasterize and test on, which must outlive
+  ///   the Scene or be replaced first, or nullptr to cull on this thread.
+  void
+  setOcclusionCulling (bool isCulling, JobSystem* jobs = nullptr);
+
+  /// \brief Gets what occlusion culling did in the last frame drawn.
+  /// \return The counts and times, which each draw starts over.
+  const OcclusionCuller::Stats&
+  getOcclusionStats () const;
+
   /// \brief Removes all Meshes from this Scene.
   /// \post This Scene is empty.
   /// \post All Meshes that had been part of this Scene have been freed.
@@ -68,12 +253,39 @@ public:
   clear ();
 
   /// \brief Draws all of the elements in this Scene.
-  /// \param[in] viewMatrix The view matrix that should be used when drawing
-  ///   the Scene.
-  /// \param[in] projectionMatrix The projection matrix that should be used when drawing
-  ///   the Scene.
+  /// The FrameBlock (camera and lights) is rewritten, and the point and spot
+  ///   lights are re-culled into clusters, only when the camera or the lights
+  ///   have changed since the last frame.  Both are bound once for every
+  ///   Mesh.  Small Meshes are batched dynamically, as setDynamicBatchLimit
+  ///   describes.
+  /// \param[in] camera The camera the Scene should be viewed through.
+  /// \param[in] interpolation Where between the last two simulation steps to
+  ///   draw the Meshes, from 0 (the previous step) to 1 (the current one).
+  void
+  draw (Camera* camera, float interpolation = 1.0f);
+
+  /// \brief Draws this Scene as it was when a FrameState was captured from
+  ///   it, without reading the Meshes' current world transforms, so that
+  ///   another thread may be moving them.
+  /// \param[in] camera The camera the Scene should be viewed through.
+  /// \param[in] frame A FrameState this Scene captured.
+  /// \param[in] interpolation Where between the frame's previous and current
+  ///   transforms to draw the Meshes.
+  void
+  draw (Camera* camera, const FrameState& frame, float interpolation);
+
+  /// \brief Copies every Mesh's previous and current world transforms into a
+  ///   FrameState.
+  /// \param[out] frame The FrameState, whose scene is set to this one.
   void
-  draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPostion);
+  capture (FrameState& frame);
+
+  /// \brief Remembers where every Mesh is, so that drawing can interpolate
+  ///   from there to wherever the next step moves them.
+  /// Call this before every simulation step, and when the Scene becomes the
+  ///   one being simulated.
+  void
+  storePreviousWorlds ();
 
   /// \brief Tests whether or not this Scene contains a Mesh associated with a
   ///   name.
@@ -92,6 +304,16 @@ public:
   Mesh*
   getMesh (const std::string& meshName);
 
+  /// \brief Gets every Mesh in this Scene.
+  /// \return The Meshes, by name.  The pointers are owned by the Scene.
+  const std::map <std::string, Mesh*>&
+  getMeshes () const;
+
+  /// \brief Gets every light in this Scene.
+  /// \return The lights, which are owned by the Scene.
+  const std::vector <LightSource*>&
+  getLightSources () const;
+
   /// \brief Sets the active mesh to the mesh named "meshName".
   /// The active mesh is the one affected by transforms.
   /// \param[in] meshName The name of the mesh that should be active.
@@ -107,6 +329,7 @@ public:
   getActiveMesh ();
 
   /// \brief Switches active meshes in the forward direction.
+  /// Static meshes are skipped, since moving them may not move what is drawn.
   /// \pre The scene has at least one mesh.
   /// \post The next mesh becomes active.  If the last mesh was active, the
   ///   first mesh becomes active.
@@ -114,12 +337,20 @@ public:
   activateNextMesh ();
 
   /// \brief Switches active meshes in the backward direction.
+  /// Static meshes are skipped, since moving them may not move what is drawn.
   /// \pre The scene has at least one mesh.
   /// \post The previous mesh becomes active.  If the first mesh was active,
   ///   the last mesh becomes active.
   void
   activatePreviousMesh ();
 
+  /// \brief Adds a light to this Scene.
+  /// Point and spot lights are unlimited, since each fragment is only lit by
+  ///   the ones whose attenuation lets them reach its cluster.
+  /// \param[in] light A pointer to a dynamically allocated light, which the
+  ///   Scene will now own.
+  /// \throws std::invalid_argument If light is directional and the Scene
+  ///   already has MAX_LIGHT_SOURCES directional lights.
   void 
   addLightSource (LightSource* light);
 
@@ -132,6 +363,11 @@ public:
   void 
   addTexture (Texture* texture);
 
+  /// \brief Steps the simulation.
+  /// This runs the systems over the Scene's components, then copies the
+  ///   entities' transforms to their Meshes.  Scenes that override it should
+  ///   call it once their own systems have run.
+  /// \param[in] deltaTime The length of the step, in seconds.
   virtual void 
   update (float deltaTime);
   
@@ -144,15 +380,210 @@ public:
 protected:
   /// Keep track of the light sources in the scene.
   std::vector <LightSource*> m_lights;
-  ///
-  const int MAX_LIGHT_SOURCES = 8;
+  /// Must match the size of the uLights array in the shaders, which only
+  ///   holds directional lights.
+  const size_t MAX_LIGHT_SOURCES = MAX_LIGHTS;
 
   std::vector <PhysicsObject*> m_physicsObjects;
 
   ShaderProgram* m_shaderProgram;
+
+  /// Hands out the entities whose components are stored below.
+  EntityRegistry m_entities;
+  /// Components, each packed so that systems walk them in order.
+  ComponentStore <Transform> m_transforms;
+  ComponentStore <Body> m_bodies;
+  ComponentStore <PaddleAi> m_paddleAis;
+  /// The Mesh that draws each entity, which its transform is copied to.
+  ComponentStore <Mesh*> m_meshHandles;
+  /// What Body components bounce off and PaddleAi components stay within.
+  Walls m_walls;
 private:
+  /// Meshes can only share a draw call if everything the draw binds is the
+  ///   same, and their vertices are laid out alike: their kind, ShaderProgram,
+  ///   Material, and texture.
+  using BatchKey = std::tuple <std::type_index, const ShaderProgram*,
+                               const Material*, const Texture*>;
+
+  /// \brief Small Meshes that are drawn alike, gathered each frame.
+  struct DynamicBatch
+  {
+    /// The Mesh they are streamed into, owned by the Scene, with an identity
+    ///   world transform.  It is made the first time the batch has more than
+    ///   one Mesh, and kept for later frames.
+    Mesh* mesh;
+    /// The Meshes gathered into it this frame.
+    std::vector <Mesh*> members;
+  };
+
+  /// Meshes can only share an indirect draw if their vertices are laid out
+  ///   alike and they are drawn with the same ShaderProgram.
+  using IndirectKey = std::pair <std::type_index, const ShaderProgram*>;
+
+  /// \brief Works out which Meshes a Mesh can be batched with.
+  /// \param[in] mesh The Mesh.
+  /// \return What its draw binds.
+  static BatchKey
+  getBatchKey (const Mesh* mesh);
+
+  /// \brief Finds the ShaderProgram that draws a Mesh indirectly.
+  /// \param[in] mesh The Mesh.
+  /// \return The program set by setIndirectProgram, or nullptr if the Mesh is
+  ///   drawn on its own.
+  ShaderProgram*
+  getIndirectProgram (const Mesh* mesh) const;
+
+  /// \brief Gathers the Meshes that are drawn indirectly into lists, one for
+  ///   each kind of Mesh and ShaderProgram.
+  /// \post m_indirectLists is up to date.
+  void
+  buildIndirectLists ();
+
+  /// \brief Streams each dynamic batch with more than one Mesh and draws it,
+  ///   and draws the Meshes in the rest on their own.
+  /// \param[in] camera The camera the Scene is being viewed through.
+  /// \post m_dynamicBatchStats counts what was batched.
+  void
+  drawDynamicBatches (Camera* camera);
+
+  /// \brief Draws the Meshes gathered to be drawn on their own, recording
+  ///   them on m_recordingJobs if there are enough of them.
+  /// \param[in] camera The camera the Scene is being viewed through.
+  /// \post m_individualMeshes is empty.
+  void
+  drawIndividualMeshes (Camera* camera);
+
+  /// \brief Draws the occluders into m_occlusionCuller and tests the Meshes
+  ///   that could be hidden against them.
+  /// \param[in] camera The camera the Scene is being viewed through.
+  /// \post m_isNodeOccluded flags the nodes whose Meshes are hidden.
+  void
+  cullOccludedMeshes (Camera* camera);
+
+  /// \brief Binds the Scene's uniform blocks and lights and draws every Mesh
+  ///   with the transforms it was last given.
+  /// \param[in] camera The camera the Scene is being viewed through.
+  void
+  drawMeshes (Camera* camera);
+
+  /// \brief Gives the scene graph the transforms of the Meshes that moved,
+  ///   and brings the world transforms up to date.
+  void
+  updateWorlds ();
+
+  /// \brief Deletes a static batch, so that its Meshes are drawn on their
+  ///   own again.
+  /// \param[in] batch The batch's index in m_staticBatches.
+  void
+  unbatch (size_t batch);
+
+  /// \brief Copies every entity's Transform component to the Mesh that
+  ///   draws it.
+  void
+  writeMeshWorlds ();
+
+  /// \brief Combines the previous transforms of a Mesh and the Meshes it is
+  ///   attached to.
+  /// \param[in] node The Mesh's node in m_graph.
+  /// \return Where it was in the world before the current step.
+  Transform
+  getPreviousWorld (unsigned node) const;
+
+  /// \brief Rewrites whatever part of the FrameBlock is out of date.
+  /// \param[in] camera The camera the Scene is being viewed through.
+  /// \post m_frameBuffer matches the camera and the lights.
+  void
+  updateFrameUniforms (Camera* camera);
+
+  /// \brief Assigns the point and spot lights to clusters and uploads the
+  ///   result.
+  /// \param[in] view The camera's view matrix.
+  /// \post m_clusterGridBuffer and m_clusterIndexBuffer match the lights.
+  void
+  cullLights (const Matrix4& view);
+
+  /// A pointer to the object through which the Scene makes OpenGL calls.
+  OpenGLContext* m_context;
+  /// Buffer that backs the FrameBlock uniform block.
+  UniformBuffer m_frameBuffer;
+  /// CPU copy of the FrameBlock.
+  FrameUniforms m_frameUniforms;
+  /// The camera whose matrices are in m_frameBuffer.
+  const Camera* m_frameCamera;
+  /// The camera's view update count when m_frameBuffer was written.
+  unsigned m_frameViewCount;
+  /// The camera's projection update count when m_frameBuffer was written.
+  unsigned m_frameProjectionCount;
+  /// Whether a light has been added since m_frameBuffer was written.
+  bool m_areLightsDirty;
+  /// The directional lights, as written to the FrameBlock.
+  std::vector <LightUniforms> m_directionalLights;
+  /// The point and spot lights, in world space, as written to
+  ///   m_clusterLightBuffer.
+  std::vector <LightUniforms> m_localLights;
+  /// How far each of m_localLights reaches.
+  std::vector <float> m_localLightRadii;
+  /// View-space positions of m_localLights, reused from frame to frame.
+  std::vector <float> m_lightX, m_lightY, m_lightZ;
+  /// Assigns m_localLights to clusters of the view frustum.
+  ClusteredLightCuller m_lightCuller;
+  /// Texture buffers read by the Phong shader as uClusterLights,
+  ///   uClusterGrid, and uClusterIndices.
+  TextureBuffer m_clusterLightBuffer;
+  TextureBuffer m_clusterGridBuffer;
+  TextureBuffer m_clusterIndexBuffer;
   /// Keeps track of all the meshes in the scene with an associated name.
   std::map <std::string, Mesh*> m_meshes;
+  /// Places each Mesh relative to the one it is attached to.  A Mesh's own
+  ///   transform is its node's local transform.
+  SceneGraph m_graph;
+  /// The node of each Mesh, by the same names as m_meshes.
+  std::map <std::string, unsigned> m_nodes;
+  /// The Mesh at each node, by node id.
+  std::vector <Mesh*> m_nodeMeshes;
+  /// Whether each node's Mesh is drawn by a static batch, by node id.
+  std::vector <unsigned char> m_isNodeBatched;
+  /// The static batches, drawn after the Meshes that are not in one.
+  std::vector <StaticBatch> m_staticBatches;
+  /// The most vertices a dynamically batched Mesh may have, or 0 for none.
+  unsigned m_dynamicBatchLimit;
+  /// The dynamic batches, by what their Meshes are drawn with, kept from
+  ///   frame to frame so that their Meshes and vectors are reused.
+  std::map <BatchKey, DynamicBatch> m_dynamicBatches;
+  /// Vertices and indices of the batch being filled, reused from batch to
+  ///   batch.
+  std::vector <float> m_batchVertices;
+  std::vector <unsigned> m_batchIndices;
+  /// What dynamic batching did in the last frame drawn.
+  DynamicBatchStats m_dynamicBatchStats;
+  /// The Meshes to draw on their own this frame, in drawing order.
+  std::vector <Mesh*> m_individualMeshes;
+  /// The JobSystem that records them, or nullptr to draw them directly.
+  JobSystem* m_recordingJobs;
+  size_t m_meshesPerList;
+  /// One list for each run of m_meshesPerList Meshes, kept from frame to
+  ///   frame so that their memory is reused.
+  std::vector <std::unique_ptr <CommandList>> m_commandLists;
+  /// Whether hidden Meshes are skipped, and the JobSystem that finds them.
+  bool m_isOcclusionCulling;
+  JobSystem* m_occlusionJobs;
+  /// Draws the occluders on the CPU and tests the other Meshes' boxes.
+  OcclusionCuller m_occlusionCuller;
+  /// The boxes tested this frame, their nodes, and whether each is hidden,
+  ///   reused from frame to frame.
+  std::vector <OcclusionCuller::Box> m_occludeeBoxes;
+  std::vector <unsigned> m_occludeeNodes;
+  std::vector <unsigned char> m_isOccludeeHidden;
+  /// Whether each node's Mesh is hidden this frame, by node id.
+  std::vector <unsigned char> m_isNodeOccluded;
+  /// The ShaderProgram that draws indirectly, by the one the Meshes were
+  ///   made with.
+  std::map <const ShaderProgram*, ShaderProgram*> m_indirectPrograms;
+  /// The Meshes drawn indirectly, drawn after everything else.
+  std::map <IndirectKey, std::unique_ptr <IndirectDrawList>> m_indirectLists;
+  /// Whether Meshes have been added, removed, or batched since
+  ///   m_indirectLists was built.
+  bool m_areIndirectListsDirty;
   /// Keeps track of the active mesh in the scene.
   std::map <std::string, Mesh*>::iterator m_activeMesh;
   /// Keeps track of all the materials.
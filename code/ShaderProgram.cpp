@@ -38,6 +38,16 @@ ShaderProgram::getUniformLocation (const std::string& uniformName) const
   return m_context->getUniformLocation (m_programId, uniformName.c_str ());
 }
 
+void
+ShaderProgram::bindUniformBlock (const std::string& blockName, GLuint bindingPoint)
+{
+  GLuint index = m_context->getUniformBlockIndex (m_programId, blockName.c_str ());
+  // Shaders that do not use the block (or whose compiler removed it) have
+  //   nothing to bind.
+  if (index != GL_INVALID_INDEX)
+    m_context->uniformBlockBinding (m_programId, index, bindingPoint);
+}
+
 void
 ShaderProgram::setUniformMatrix (const std::string& uniform, const Matrix4& value)
 {
@@ -49,25 +59,26 @@ void
 ShaderProgram::setUniformVector (const std::string& uniform, const Vector3& value)
 {
   GLint location = getUniformLocation (uniform);
-  glUniform3fv (location, 1, &(value.m_x) );
+  m_context->uniform3fv (location, 1, &(value.m_x) );
 }
 
 void
 ShaderProgram::setUniformInt (const std::string& uniform, const int& value)
 {
   GLint location = getUniformLocation (uniform);
-  glUniform1i (location, value);
+  m_context->uniform1i (location, value);
 }
 
 void
 ShaderProgram::setUniformFloat (const std::string& uniform, const float& value)
 {
   GLint location = getUniformLocation (uniform);
-  glUniform1f (location, value);
+  m_context->uniform1f (location, value);
 }
 
 void
-ShaderProgram::createVertexShader (const std::string& vertexShaderFilename)
+ShaderProgram::createVertexShader (const std::string& vertexShaderFilename,
+                                   const std::string& defines)
 {
   m_vertexShaderId = m_context->createShader (GL_VERTEX_SHADER);
   if (m_vertexShaderId == 0)
@@ -75,11 +86,12 @@ ShaderProgram::createVertexShader (const std::string& vertexShaderFilename)
     fprintf (stderr, "Failed to create vertex shader object; exiting\n");
     exit (-1);
   }
-  compileShader (vertexShaderFilename, m_vertexShaderId);
+  compileShader (vertexShaderFilename, m_vertexShaderId, defines);
 }
 
 void
-ShaderProgram::createFragmentShader (const std::string& fragmentShaderFilename)
+ShaderProgram::createFragmentShader (const std::string& fragmentShaderFilename,
+                                     const std::string& defines)
 {
   m_fragmentShaderId = m_context->createShader (GL_FRAGMENT_SHADER);
   if (m_fragmentShaderId == 0)
@@ -87,14 +99,29 @@ ShaderProgram::createFragmentShader (const std::string& fragmentShaderFilename)
     fprintf (stderr, "Failed to create fragment shader object; exiting\n");
     exit (-1);
   }
-  compileShader (fragmentShaderFilename, m_fragmentShaderId);
+  compileShader (fragmentShaderFilename, m_fragmentShaderId, defines);
 }
 
 void
 ShaderProgram::compileShader (const std::string& shaderFilename,
-			      GLuint shaderId)
+			      GLuint shaderId, const std::string& defines)
 {
   std::string sourceCode = readShaderSource (shaderFilename);
+  // GLSL requires #version to come first, so defines go on the line after it.
+  if (!defines.empty ())
+  {
+    size_t version = sourceCode.find ("#version");
+    size_t lineEnd = version == std::string::npos
+      ? std::string::npos : sourceCode.find ('\n', version);
+    if (lineEnd == std::string::npos)
+    {
+      sourceCode.insert (0, defines);
+    }
+    else
+    {
+      sourceCode.insert (lineEnd + 1, defines);
+    }
+  }
   const GLchar* sourceCodePtr = sourceCode.c_str ();
   // One array of char*. Do not need to specify length if null-terminated.
   m_context->shaderSource (shaderId, 1, &sourceCodePtr, nullptr);
@@ -134,13 +161,25 @@ ShaderProgram::link () const
 void
 ShaderProgram::enable ()
 {
-  m_context->useProgram (m_programId);
+  enable (m_context);
+}
+
+void
+ShaderProgram::enable (OpenGLContext* context) const
+{
+  context->useProgram (m_programId);
 }
 
 void
 ShaderProgram::disable ()
 {
-  m_context->useProgram (0);
+  disable (m_context);
+}
+
+void
+ShaderProgram::disable (OpenGLContext* context) const
+{
+  context->useProgram (0);
 }
 
 std::string
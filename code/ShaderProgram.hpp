@@ -52,6 +52,16 @@ public:
   GLint
   getUniformLocation (const std::string& uniformName) const;
 
+  /// \brief Assigns a uniform block to a binding point.
+  /// Blocks only need to be assigned once, after linking; afterward they read
+  ///   from whatever buffer is bound to that point.
+  /// \param[in] blockName The name of the uniform block.
+  /// \param[in] bindingPoint The binding point to assign it to.
+  /// \post If the program uses the block it reads from bindingPoint;
+  ///   otherwise nothing has happened.
+  void
+  bindUniformBlock (const std::string& blockName, GLuint bindingPoint);
+
   /// \brief Sets the value of a uniform 4x4 matrix of floats.
   /// \param[in] uniform The name of the uniform.
   /// \param[in] value The matrix to use.
@@ -72,16 +82,21 @@ public:
   /// \brief Creates and attaches a vertex shader.
   /// \param[in] vertexShaderFilename The name of a file that contains the
   ///   vertex shader's source code.
+  /// \param[in] defines Lines to insert after the source's #version line,
+  ///   such as "#define INDIRECT_DRAW\n", to pick between its variants.
   /// \pre No vertex shader was previously created.
   void
-  createVertexShader (const std::string& vertexShaderFilename);
+  createVertexShader (const std::string& vertexShaderFilename,
+                      const std::string& defines = "");
 
   /// \brief Creates and attaches a fragment shader.
   /// \param[in] fragmentShaderFilename The name of a file that contains the
   ///   fragment shader's source code.
+  /// \param[in] defines Lines to insert after the source's #version line.
   /// \pre No fragment shader was previously created.
   void
-  createFragmentShader (const std::string& fragmentShaderFilename);
+  createFragmentShader (const std::string& fragmentShaderFilename,
+                        const std::string& defines = "");
 
   /// \brief Links the attached shaders into this ShaderProgram.
   /// \pre A vertex and fragment shader had been created.
@@ -94,19 +109,33 @@ public:
   void
   enable ();
 
+  /// \brief Makes this ShaderProgram the one used by calls made through
+  ///   another context, such as a CommandList.
+  /// \param context The context to make the call through.
+  void
+  enable (OpenGLContext* context) const;
+
   /// \brief Ensures that future OpenGL calls will not affect this
   ///   ShaderProgram (until it is subsequently re-enabled).
   void
   disable ();
 
+  /// \brief Ensures that calls made through another context, such as a
+  ///   CommandList, will not affect this ShaderProgram.
+  /// \param context The context to make the call through.
+  void
+  disable (OpenGLContext* context) const;
+
 private:
 
   /// \brief Compiles a shader.
   /// \param[in] shaderFilename The name of a file that contains the shader's
   ///   source code.
   /// \param[in] shaderId The OpenGL identifier associated with the shader.
+  /// \param[in] defines Lines to insert after the source's #version line.
   void
-  compileShader (const std::string& shaderFilename, GLuint shaderId);
+  compileShader (const std::string& shaderFilename, GLuint shaderId,
+                 const std::string& defines);
 
   /// \brief Reads the source code for a shader from a file.
   /// \param[in] filename The name of a file that contains the shader's source
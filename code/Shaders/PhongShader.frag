@@ -11,56 +11,97 @@
 // By default, all float variables will use high precision.
 precision highp float;
 
-// The C++ code will tell us how many light sources there are (maximum 8).
-uniform int uNumLights;
-
 // Information about one light source.
 // Because different light sources store different information, not every type
 //   will use every data member.
+// Members are ordered so that each scalar fills the padding after a vec3; the
+//   C++ mirror is LightUniforms in UniformBlocks.hpp.
 struct Light
 {
-  // 0 if directional, 1 if point, 2 if spot -- other values illegal.
-  int type;
-
   // All lights have these parameters.
   vec3 diffuseIntensity;
+  // 0 if directional, 1 if point, 2 if spot -- other values illegal.
+  int type;
   vec3 specularIntensity;
 
+  // Spot light parameters.
+  float cutoffCosAngle;
+
   // Point and spot light parameters.
   vec3 position;
+  float falloff;
   vec3 attenuationCoefficients;
 
   // Directional and spot light parameter.
   vec3 direction;
-
-  // Spot light parameters.
-  float cutoffCosAngle;
-  float falloff;
 };
 
-// An array of lights that will be filled by the C++ code.
+// Only directional lights go in uLights; point and spot lights are read from
+//   the clustered light buffers below.
 const int MAX_LIGHTS = 8;
-uniform Light uLights[MAX_LIGHTS];
 
-// Single ambient light, provided by the C++ code.
-uniform vec3  uAmbientIntensity;
+// Everything shared by all objects in a frame, written by the Scene only when
+//   the camera or the lights change (FrameUniforms in C++).
+layout (std140) uniform FrameBlock
+{
+  mat4 uView;
+  // Inverse of uView, computed once per camera move in C++.
+  mat4 uInverseView;
+  mat4 uProjection;
+  // Single ambient light.
+  vec3 uAmbientIntensity;
+  // How many of uLights are in use.
+  int uNumLights;
+  // The number of light clusters across, up, and into the view frustum.
+  ivec3 uClusterCounts;
+  // The slice of a point at distance d is log (d) * scale + bias.
+  float uClusterDepthScale;
+  float uClusterDepthBias;
+  Light uLights[MAX_LIGHTS];
+};
 
-// Material properties, provided by the C++ code.
-uniform vec3  uAmbientReflection;
-uniform vec3  uDiffuseReflection;
-uniform vec3  uSpecularReflection;
-uniform float uSpecularPower;
-uniform vec3  uEmissiveIntensity;
+#ifdef INDIRECT_DRAW
+// Every material, 4 texels each (MaterialUniforms in C++); the vertex shader
+//   says which one this object uses.
+uniform samplerBuffer uMaterials;
+flat in int vMaterialIndex;
+
+// Read from uMaterials at the start of main.
+vec3  uDiffuseReflection;
+vec3  uSpecularReflection;
+float uSpecularPower;
+// Textured meshes are never drawn indirectly.
+const int uHasTexture = 0;
+#else
+// Material properties, written once per Material (MaterialUniforms in C++).
+layout (std140) uniform MaterialBlock
+{
+  vec3  uAmbientReflection;
+  vec3  uDiffuseReflection;
+  vec3  uSpecularReflection;
+  vec3  uEmissiveIntensity;
+  float uSpecularPower;
+};
 
-// Transformation matrices, provided by C++ code.
-uniform mat4 uView;
-uniform mat4 uProjection;
-uniform mat4 uWorld;
+// Per-object data, written only when the object moves (ObjectUniforms in C++).
+layout (std140) uniform ObjectBlock
+{
+  mat4 uWorld;
+  // Inverse transpose of mat3 (uWorld), computed in C++.
+  mat3 uWorldNormal;
+  int  uHasTexture;
+};
+#endif
 
-// Eye position, in world space, provided by C++ code.
-uniform vec3 uEyePosition;
 uniform sampler2D uDiffuseSampler;
-uniform int uHasTexture;
+
+// Every point and spot light, 5 texels each, laid out like a Light but with the
+//   type's bits stored in the first texel's w.
+uniform samplerBuffer uClusterLights;
+// For each cluster, the offset and count of its lights in uClusterIndices.
+uniform usamplerBuffer uClusterGrid;
+// Indices into uClusterLights, grouped by cluster.
+uniform usamplerBuffer uClusterIndices;
 
 // First, the inputs from earlier in the pipeline
 // Computed vertex color outputted by the vertex shader
@@ -71,7 +112,6 @@ in vec3 vColor;
 in vec3 positionEye;
 in vec3 normalEye;
 in vec2 UV;
-in mat4 inverseView;
 
 // Second, the outputs the shader produces
 // We output a color with an alpha channel (R, G, B, A)
@@ -83,20 +123,42 @@ out vec4 fColor;
 vec3
 calculateLighting (Light light, vec3 vertexPosition, vec3 vertexNormal);
 
+// Read one point or spot light from uClusterLights.
+Light
+fetchLight (int index);
+
+// Find the index of the cluster containing a point in eye space.
+int
+findCluster (vec3 vertexPosition);
+
 // **
 
 void
 main ()
 {
+#ifdef INDIRECT_DRAW
+  uDiffuseReflection = texelFetch (uMaterials, vMaterialIndex * 4 + 1).xyz;
+  uSpecularReflection = texelFetch (uMaterials, vMaterialIndex * 4 + 2).xyz;
+  uSpecularPower = texelFetch (uMaterials, vMaterialIndex * 4 + 3).w;
+#endif
   fColor = vec4(vColor, 1);
 
-  // Iterate over all lights and calculate diffuse and specular contributions
+  // Directional lights reach every fragment
   for (int i = 0; i < uNumLights; ++i)
   {
     fColor
         += vec4(calculateLighting (uLights[i], positionEye, normalEye), 1);
   }
 
+  // Point and spot lights only reach the clusters they were assigned to
+  uvec2 range = texelFetch (uClusterGrid, findCluster (positionEye)).xy;
+  for (uint i = 0u; i < range.y; ++i)
+  {
+    int index = int (texelFetch (uClusterIndices, int (range.x + i)).r);
+    fColor
+        += vec4(calculateLighting (fetchLight (index), positionEye, normalEye), 1);
+  }
+
   // Stay in bounds [0, 1], Output fragment color, with red, green, blue, and alpha components (RGBA)
   fColor = clamp (fColor, 0.0, 1.0);
 }
@@ -108,7 +170,8 @@ calculateLighting (Light light, vec3 vertexPosition, vec3 vertexNormal)
   vec3 lightVector;
   if (light.type == 0)
   { // Directional
-    light.direction = vec3(inverseView * vec4(light.direction, 1));
+    // v * M is transpose (M) * v, so this is the inverse transpose of uView.
+    light.direction = light.direction * mat3 (uInverseView);
     lightVector = normalize (-light.direction);
   }
   else
@@ -136,7 +199,8 @@ calculateLighting (Light light, vec3 vertexPosition, vec3 vertexNormal)
     // See how light reflects off of vertex
     vec3 reflectionVector = reflect (-lightVector, vertexNormal);
     // Compute view vector, which points toward the eye
-    vec3 eyeVector = normalize (uEyePosition - vertexPosition);
+    // The eye is at the origin in eye space.
+    vec3 eyeVector = normalize (-vertexPosition);
     // Light intensity is proportional to angle between reflection vector
     //   and eye vector
     float specularCoef = max (dot (eyeVector, reflectionVector), 0.0);
@@ -154,7 +218,7 @@ calculateLighting (Light light, vec3 vertexPosition, vec3 vertexNormal)
     float spotFactor = 1.0f;
     if (light.type == 2)
     { // Spot light
-      light.direction = vec3(inverseView * vec4(light.direction, 1));
+      light.direction = light.direction * mat3 (uInverseView);
       float cosTheta = dot (-lightVector, light.direction);
       cosTheta = max (cosTheta, 0.0f);
       spotFactor = (cosTheta >= light.cutoffCosAngle) ? cosTheta : 0.0f;
@@ -165,4 +229,40 @@ calculateLighting (Light light, vec3 vertexPosition, vec3 vertexNormal)
   }
 
   return diffuseAndSpecular;
-}
\ No newline at end of file
+}
+
+Light
+fetchLight (int index)
+{
+  int texel = index * 5;
+  vec4 diffuseAndType = texelFetch (uClusterLights, texel);
+  vec4 specularAndCutoff = texelFetch (uClusterLights, texel + 1);
+  vec4 positionAndFalloff = texelFetch (uClusterLights, texel + 2);
+  vec4 attenuation = texelFetch (uClusterLights, texel + 3);
+  vec4 direction = texelFetch (uClusterLights, texel + 4);
+
+  Light light;
+  light.diffuseIntensity = diffuseAndType.xyz;
+  light.type = floatBitsToInt (diffuseAndType.w);
+  light.specularIntensity = specularAndCutoff.xyz;
+  light.cutoffCosAngle = specularAndCutoff.w;
+  light.position = positionAndFalloff.xyz;
+  light.falloff = positionAndFalloff.w;
+  light.attenuationCoefficients = attenuation.xyz;
+  light.direction = direction.xyz;
+  return light;
+}
+
+int
+findCluster (vec3 vertexPosition)
+{
+  // Project to find the screen tile, so the viewport size is not needed
+  vec4 clip = uProjection * vec4 (vertexPosition, 1);
+  vec2 ndc = clip.xy / clip.w;
+  ivec2 tile = clamp (ivec2 ((ndc * 0.5 + 0.5) * vec2 (uClusterCounts.xy)),
+                      ivec2 (0), uClusterCounts.xy - 1);
+  int slice = clamp (int (floor (log (-vertexPosition.z) * uClusterDepthScale
+                                 + uClusterDepthBias)),
+                     0, uClusterCounts.z - 1);
+  return (slice * uClusterCounts.y + tile.y) * uClusterCounts.x + tile.x;
+}
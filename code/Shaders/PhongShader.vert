@@ -12,46 +12,90 @@
 // By default, all float variables will use high precision.
 precision highp float;
 
-// The C++ code will tell us how many light sources there are (maximum 8).
-uniform int uNumLights;
-
 // Information about one light source.
 // Because different light sources store different information, not every type
 //   will use every data member.
+// Members are ordered so that each scalar fills the padding after a vec3; the
+//   C++ mirror is LightUniforms in UniformBlocks.hpp.
 struct Light
 {
-  // 0 if directional, 1 if point, 2 if spot -- other values illegal.
-  int type;
-
   // All lights have these parameters.
   vec3 diffuseIntensity;
+  // 0 if directional, 1 if point, 2 if spot -- other values illegal.
+  int type;
   vec3 specularIntensity;
 
+  // Spot light parameters.
+  float cutoffCosAngle;
+
   // Point and spot light parameters.
   vec3 position;
+  float falloff;
   vec3 attenuationCoefficients;
 
   // Directional and spot light parameter.
   vec3 direction;
-
-  // Spot light parameters.
-  float cutoffCosAngle;
-  float falloff;
 };
 
-// An array of lights that will be filled by the C++ code.
 const int MAX_LIGHTS = 8;
-uniform Light uLights[MAX_LIGHTS];
 
-// Single ambient light, provided by the C++ code.
-uniform vec3  uAmbientIntensity;
+// Everything shared by all objects in a frame, written by the Scene only when
+//   the camera or the lights change (FrameUniforms in C++).
+layout (std140) uniform FrameBlock
+{
+  mat4 uView;
+  // Inverse of uView, computed once per camera move in C++.
+  mat4 uInverseView;
+  mat4 uProjection;
+  // Single ambient light.
+  vec3 uAmbientIntensity;
+  // How many of uLights are in use.
+  int uNumLights;
+  // The number of light clusters across, up, and into the view frustum.
+  ivec3 uClusterCounts;
+  // The slice of a point at distance d is log (d) * scale + bias.
+  float uClusterDepthScale;
+  float uClusterDepthBias;
+  Light uLights[MAX_LIGHTS];
+};
 
-// Material properties, provided by the C++ code.
-uniform vec3  uAmbientReflection;
-uniform vec3  uDiffuseReflection;
-uniform vec3  uSpecularReflection;
-uniform float uSpecularPower;
-uniform vec3  uEmissiveIntensity;
+#ifdef INDIRECT_DRAW
+// Drawn by glMultiDrawElementsIndirect, so each draw's object is chosen by
+//   its baseInstance, through aObjectIndex, rather than by rebinding blocks.
+// Every object, 8 texels each (IndirectObjectUniforms in C++).
+uniform samplerBuffer uObjects;
+// Every material, 4 texels each (MaterialUniforms in C++).
+uniform samplerBuffer uMaterials;
+layout (location = 4) in float aObjectIndex;
+
+// Read from the buffers above at the start of main.
+mat4 uWorld;
+mat3 uWorldNormal;
+vec3 uAmbientReflection;
+vec3 uEmissiveIntensity;
+
+// Passed on so the fragment shader reads the same material.
+flat out int vMaterialIndex;
+#else
+// Material properties, written once per Material (MaterialUniforms in C++).
+layout (std140) uniform MaterialBlock
+{
+  vec3  uAmbientReflection;
+  vec3  uDiffuseReflection;
+  vec3  uSpecularReflection;
+  vec3  uEmissiveIntensity;
+  float uSpecularPower;
+};
+
+// Per-object data, written only when the object moves (ObjectUniforms in C++).
+layout (std140) uniform ObjectBlock
+{
+  mat4 uWorld;
+  // Inverse transpose of mat3 (uWorld), computed in C++.
+  mat3 uWorldNormal;
+  int  uHasTexture;
+};
+#endif
 
 // Inputs from the VBO.
 in vec3 aPosition;
@@ -63,20 +107,21 @@ out vec3 vColor;
 out vec3 positionEye;
 out vec3 normalEye;
 out vec2 UV;
-out mat4 inverseView;
-
-// Transformation matrices, provided by C++ code.
-uniform mat4 uView;
-uniform mat4 uProjection;
-uniform mat4 uWorld;
-
-// Eye position, in world space, provided by C++ code.
-uniform vec3 uEyePosition;
-uniform bool uHasTexture;
 
 void
 main (void)
 {
+#ifdef INDIRECT_DRAW
+  int object = int (aObjectIndex) * 8;
+  uWorld = mat4 (texelFetch (uObjects, object), texelFetch (uObjects, object + 1),
+                 texelFetch (uObjects, object + 2), texelFetch (uObjects, object + 3));
+  uWorldNormal = mat3 (texelFetch (uObjects, object + 4).xyz,
+                       texelFetch (uObjects, object + 5).xyz,
+                       texelFetch (uObjects, object + 6).xyz);
+  vMaterialIndex = int (texelFetch (uObjects, object + 7).x);
+  uAmbientReflection = texelFetch (uMaterials, vMaterialIndex * 4).xyz;
+  uEmissiveIntensity = texelFetch (uMaterials, vMaterialIndex * 4 + 3).xyz;
+#endif
   mat4 worldViewProjection = uProjection * uView * uWorld;
   // Transform vertex into clip space
   gl_Position = worldViewProjection * vec4 (aPosition, 1);
@@ -84,10 +129,8 @@ main (void)
   positionEye = vec3 (uView * uWorld * vec4 (aPosition, 1));
 
   // Do calculation in eye space.
-  mat3 normalTransform = mat3 (uView * uWorld);
-  normalTransform = transpose (inverse (normalTransform));
-  // Normal matrix is eye inverse transpose
-  normalEye = normalize (normalTransform * aNormal);
+  // uView is rigid, so mat3 (uView) is its own inverse transpose.
+  normalEye = normalize (mat3 (uView) * (uWorldNormal * aNormal));
 
   // Handle ambient and emissive light
   //   It's independent of any particular light
@@ -97,6 +140,5 @@ main (void)
   // Stay in bounds [0, 1]
   vColor = clamp (vColor, 0.0, 1.0);
 
-  inverseView = transpose (inverse (uView));
   UV = aUV;
 }
\ No newline at end of file
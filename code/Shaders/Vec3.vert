@@ -17,10 +17,29 @@ layout (location = 1) in vec3 aColor;
 
 // Second, we specify uniform inputs that are the same for all vertices in a
 //   single draw command
-// Matrix to transform world space to eye space
-uniform mat4 uModelView;
-// Matrix to transform eye space to clip space
-uniform mat4 uProjection;
+// These are leading parts of the blocks declared in PhongShader.vert; std140
+//   fixes their offsets, so they read the same buffers.
+layout (std140) uniform FrameBlock
+{
+  // Matrix to transform world space to eye space
+  mat4 uView;
+  mat4 uInverseView;
+  // Matrix to transform eye space to clip space
+  mat4 uProjection;
+};
+#ifdef INDIRECT_DRAW
+// Drawn by glMultiDrawElementsIndirect: aObjectIndex picks this draw's object
+//   from uObjects, 8 texels each, whose first 4 are its world matrix.
+uniform samplerBuffer uObjects;
+layout (location = 4) in float aObjectIndex;
+mat4 uWorld;
+#else
+layout (std140) uniform ObjectBlock
+{
+  // Matrix to transform model space to world space
+  mat4 uWorld;
+};
+#endif
 
 // Finally, we specify any additional outputs our shader produces
 // We want to output a color, which is a 3-D vector (R, G, B)
@@ -31,10 +50,15 @@ out vec3 vColor;
 void
 main ()
 {
+#ifdef INDIRECT_DRAW
+  int object = int (aObjectIndex) * 8;
+  uWorld = mat4 (texelFetch (uObjects, object), texelFetch (uObjects, object + 1),
+                 texelFetch (uObjects, object + 2), texelFetch (uObjects, object + 3));
+#endif
   // Every vertex shader must write gl_Position
   // It is a 4-D vector (X, Y, Z, W)
   // Transform the vertex from world space to clip space
-  gl_Position = uProjection * uModelView * vec4 (aPosition, 1.0);
+  gl_Position = uProjection * uView * uWorld * vec4 (aPosition, 1.0);
   // Just pass along the color unchanged to the next stage
   vColor = aColor;
 }
@@ -0,0 +1,46 @@
+/// \file Simd.hpp
+/// \brief Definition of what the AVX2 kernels share: the attributes that
+///   compile them for AVX2, and the checks for whether this CPU can run
+///   them.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+// The AVX2 kernels are compiled for AVX2 on their own, through target
+//   attributes, so the rest of the program still runs on CPUs without it.
+//   Other compilers and CPUs only get the scalar kernels.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAS_AVX2_TARGET
+#include <immintrin.h>
+
+/// \brief Compiles one function for AVX2.
+/// Kernels that must match their scalar versions exactly use this one, since
+///   with FMA enabled the compiler may fuse their multiplies and adds.
+#define AVX2_TARGET __attribute__ ((target ("avx2")))
+
+/// \brief Compiles one function for AVX2 and FMA.
+#define AVX2_FMA_TARGET __attribute__ ((target ("avx2,fma")))
+
+/// \brief Checks, once, whether this CPU can run AVX2_TARGET functions.
+/// \return Whether it supports AVX2.
+inline bool
+isAvx2Supported ()
+{
+  static const bool isSupported = __builtin_cpu_supports ("avx2");
+  return isSupported;
+}
+
+/// \brief Checks, once, whether this CPU can run AVX2_FMA_TARGET functions.
+/// \return Whether it supports both AVX2 and FMA.
+inline bool
+isAvx2FmaSupported ()
+{
+  static const bool isSupported = isAvx2Supported ()
+    && __builtin_cpu_supports ("fma");
+  return isSupported;
+}
+#endif
+
+#endif//SIMD_HPP
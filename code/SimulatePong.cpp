@@ -0,0 +1,88 @@
+/// \file SimulatePong.cpp
+/// \brief Plays many games of Pong between two AIs without a window, OpenGL,
+///   or meshes, and reports how each side did and how fast it ran.
+/// \author Justin Stevens
+/// \version A09
+///
+/// Usage: SimulatePong.out [2d|3d [games [seconds [threads [margin speed]]]]]
+///
+/// Side 0 plays as the scene's AI does.  With a margin and speed, side 1
+///   plays with those instead, so they can be compared with the scene's.
+///   Seconds is simulated time per game, stepped at the game's 60 steps per
+///   second.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "Scenes/Pong/PongSimulator.hpp"
+
+static const double STEPS_PER_SECOND = 60.0;
+
+/// \brief Plays the games and prints the results.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The rules, then the number of games, the simulated
+///   seconds, the number of threads, and side 1's AI.
+int
+main (int argc, char* argv[])
+{
+  std::string rulesName = argc > 1 ? argv[1] : "3d";
+  if (rulesName != "2d" && rulesName != "3d")
+  {
+    fprintf (stderr, "Rules must be 2d or 3d\n");
+    return EXIT_FAILURE;
+  }
+  PongSimulator::Rules rules = rulesName == "2d"
+    ? PongSimulator::Rules::PONG_2D : PongSimulator::Rules::PONG_3D;
+  long games = argc > 2 ? std::atol (argv[2]) : 10000;
+  double seconds = argc > 3 ? std::atof (argv[3]) : 600.0;
+  int threads = argc > 4 ? std::atoi (argv[4])
+    : static_cast<int> (std::max (1u, std::thread::hardware_concurrency ()));
+  if (games <= 0 || seconds <= 0.0 || threads <= 0)
+  {
+    fprintf (stderr, "Games, seconds, and threads must be positive\n");
+    return EXIT_FAILURE;
+  }
+
+  PongSimulator simulator (rules, static_cast<size_t> (games), 2024);
+  if (argc > 6)
+  {
+    float margin = static_cast<float> (std::atof (argv[5]));
+    float speed = static_cast<float> (std::atof (argv[6]));
+    simulator.setAi (1, PongAiParameters { margin, speed });
+  }
+  JobSystem jobs (static_cast<unsigned> (threads));
+
+  long steps = static_cast<long> (seconds * STEPS_PER_SECOND);
+  float deltaTime = static_cast<float> (1.0 / STEPS_PER_SECOND);
+  auto start = std::chrono::steady_clock::now ();
+  for (long step = 0; step < steps; ++step)
+  {
+    simulator.step (deltaTime, &jobs);
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now () - start;
+
+  PongSimulator::Totals totals = simulator.getTotals ();
+  unsigned long long points = totals.points[0] + totals.points[1];
+  double gameSteps = static_cast<double> (totals.steps) * games;
+  printf ("%s: %ld games, %.0f simulated seconds each, %d threads\n",
+          rulesName.c_str (), games, seconds, threads);
+  printf ("%8s %14s %10s\n", "side", "points", "share");
+  for (unsigned side = 0; side < 2; ++side)
+  {
+    printf ("%8u %14llu %9.2f%%\n", side, totals.points[side],
+            points > 0 ? 100.0 * totals.points[side] / points : 0.0);
+  }
+  printf ("rallies:        %llu\n", points);
+  printf ("mean rally:     %.2f hits\n",
+          points > 0 ? static_cast<double> (totals.hits) / points : 0.0);
+  printf ("longest rally:  %u hits\n", totals.longestRally);
+  printf ("wall time:      %.3f s\n", elapsed.count ());
+  printf ("steps/s:        %.3g\n", gameSteps / elapsed.count ());
+  printf ("rallies/minute: %.3g\n", 60.0 * points / elapsed.count ());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,1177 @@
+/// \file SoftwareOpenGLContext.cpp
+/// \brief Implementation of SoftwareOpenGLContext and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <FreeImagePlus.h>
+
+#include "SoftwareOpenGLContext.hpp"
+
+// The uniform blocks the shaders declare, in block index order.
+static const char* const BLOCK_NAMES[] = {
+  "FrameBlock", "MaterialBlock", "ObjectBlock"
+};
+
+// The attributes the shaders declare, in location order.
+static const char* const ATTRIBUTE_NAMES[] = {
+  "aPosition", "aColor", "aNormal", "aUV", "aObjectIndex"
+};
+
+// Packs a color in [0, 1] as 0xAABBGGRR.
+static std::uint32_t
+packColor (const float color[4])
+{
+  std::uint32_t packed = 0;
+  for (int channel = 3; channel >= 0; --channel)
+  {
+    float value = std::min (std::max (color[channel], 0.0f), 1.0f);
+    packed = (packed << 8)
+      | static_cast<std::uint32_t> (value * 255.0f + 0.5f);
+  }
+  return packed;
+}
+
+// Linearly interpolates between two shaded vertices.
+template <typename Vertex>
+static Vertex
+lerp (const Vertex& a, const Vertex& b, float t, int varyingCount)
+{
+  Vertex result;
+  for (int i = 0; i < 4; ++i)
+  {
+    result.position[i] = a.position[i] + t * (b.position[i] - a.position[i]);
+  }
+  for (int i = 0; i < varyingCount; ++i)
+  {
+    result.varyings[i] = a.varyings[i] + t * (b.varyings[i] - a.varyings[i]);
+  }
+  return result;
+}
+
+SoftwareOpenGLContext::SoftwareOpenGLContext (GLsizei width, GLsizei height,
+                                              unsigned threadCount)
+  : m_width(width), m_height(height),
+    m_colorBuffer(width * height, 0xFF000000),
+    m_depthBuffer(width * height, 1.0f),
+    m_clearColor{ 0.0f, 0.0f, 0.0f, 0.0f },
+    m_isDepthTestEnabled(false), m_isCullFaceEnabled(false),
+    m_cullFace(GL_BACK), m_frontFace(GL_CCW),
+    m_viewportX(0), m_viewportY(0),
+    m_viewportWidth(width), m_viewportHeight(height),
+    m_nextName(1), m_currentVertexArray(0), m_currentProgram(0),
+    m_activeTextureUnit(0), m_boundTextures2D(), m_boundTextureBuffers(),
+    m_tilesX((width + TILE_SIZE - 1) / TILE_SIZE),
+    m_tilesY((height + TILE_SIZE - 1) / TILE_SIZE),
+    m_jobs(threadCount > 1 ? new JobSystem (threadCount) : nullptr)
+{
+  // Vertex array 0 holds the state used when no other one is bound.
+  m_vertexArrays[0] = VertexArray ();
+  m_tileBins.resize (m_tilesX * m_tilesY);
+}
+
+SoftwareOpenGLContext::~SoftwareOpenGLContext ()
+{
+}
+
+bool
+SoftwareOpenGLContext::writePng (const std::string& filename) const
+{
+  FIBITMAP* image = FreeImage_Allocate (m_width, m_height, 24);
+  if (image == nullptr)
+  {
+    return false;
+  }
+  // FreeImage also stores the bottom row first.
+  for (GLsizei y = 0; y < m_height; ++y)
+  {
+    BYTE* line = FreeImage_GetScanLine (image, y);
+    for (GLsizei x = 0; x < m_width; ++x)
+    {
+      std::uint32_t color = m_colorBuffer[y * m_width + x];
+      line[3 * x + FI_RGBA_RED] = color & 0xFF;
+      line[3 * x + FI_RGBA_GREEN] = (color >> 8) & 0xFF;
+      line[3 * x + FI_RGBA_BLUE] = (color >> 16) & 0xFF;
+    }
+  }
+  bool isSaved = FreeImage_Save (FIF_PNG, image, filename.c_str ()) != 0;
+  FreeImage_Unload (image);
+  return isSaved;
+}
+
+std::uint32_t
+SoftwareOpenGLContext::getPixel (GLsizei x, GLsizei y) const
+{
+  return m_colorBuffer[y * m_width + x];
+}
+
+void
+SoftwareOpenGLContext::activeTexture (GLenum texture)
+{
+  m_activeTextureUnit = std::min<unsigned> (texture - GL_TEXTURE0,
+                                            MAX_TEXTURE_UNITS - 1);
+}
+
+void
+SoftwareOpenGLContext::attachShader (GLuint program, GLuint shader)
+{
+  m_programs[program].shaders.push_back (shader);
+}
+
+void
+SoftwareOpenGLContext::bindBuffer (GLenum target, GLuint buffer)
+{
+  // Like OpenGL, the element buffer binding belongs to the vertex array.
+  if (target == GL_ELEMENT_ARRAY_BUFFER)
+  {
+    m_vertexArrays[m_currentVertexArray].elementBuffer = buffer;
+  }
+  else
+  {
+    m_boundBuffers[target] = buffer;
+  }
+}
+
+void
+SoftwareOpenGLContext::bindBufferBase (GLenum target, GLuint index, GLuint buffer)
+{
+  m_boundBuffers[target] = buffer;
+  if (target == GL_UNIFORM_BUFFER)
+  {
+    m_uniformBufferBindings[index] = buffer;
+  }
+}
+
+void
+SoftwareOpenGLContext::bindTexture (GLenum target, GLuint texture)
+{
+  if (target == GL_TEXTURE_2D)
+  {
+    m_boundTextures2D[m_activeTextureUnit] = texture;
+  }
+  else if (target == GL_TEXTURE_BUFFER)
+  {
+    m_boundTextureBuffers[m_activeTextureUnit] = texture;
+  }
+}
+
+void
+SoftwareOpenGLContext::bindVertexArray (GLuint array)
+{
+  m_currentVertexArray = array;
+}
+
+void
+SoftwareOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+  std::vector<unsigned char>& buffer = getBoundBuffer (target);
+  if (data == nullptr)
+  {
+    buffer.assign (size, 0);
+  }
+  else
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*> (data);
+    buffer.assign (bytes, bytes + size);
+  }
+}
+
+void
+SoftwareOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  std::vector<unsigned char>& buffer = getBoundBuffer (target);
+  if (offset >= 0 && static_cast<size_t> (offset + size) <= buffer.size ())
+  {
+    std::memcpy (buffer.data () + offset, data, size);
+  }
+}
+
+void
+SoftwareOpenGLContext::clear (GLbitfield mask)
+{
+  if (mask & GL_COLOR_BUFFER_BIT)
+  {
+    std::fill (m_colorBuffer.begin (), m_colorBuffer.end (),
+               packColor (m_clearColor));
+  }
+  if (mask & GL_DEPTH_BUFFER_BIT)
+  {
+    std::fill (m_depthBuffer.begin (), m_depthBuffer.end (), 1.0f);
+  }
+}
+
+void
+SoftwareOpenGLContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+  m_clearColor[0] = red;
+  m_clearColor[1] = green;
+  m_clearColor[2] = blue;
+  m_clearColor[3] = alpha;
+}
+
+void
+SoftwareOpenGLContext::compileShader (GLuint shader)
+{
+  // Nothing to compile; linkProgram looks at the source instead.
+}
+
+GLuint
+SoftwareOpenGLContext::createProgram ()
+{
+  GLuint name = m_nextName++;
+  m_programs[name].blockBindings[0] = 0;
+  m_programs[name].blockBindings[1] = 0;
+  m_programs[name].blockBindings[2] = 0;
+  m_programs[name].isIndirect = false;
+  return name;
+}
+
+GLuint
+SoftwareOpenGLContext::createShader (GLenum shaderType)
+{
+  GLuint name = m_nextName++;
+  m_shaders[name].type = shaderType;
+  return name;
+}
+
+void
+SoftwareOpenGLContext::cullFace (GLenum mode)
+{
+  m_cullFace = mode;
+}
+
+void
+SoftwareOpenGLContext::deleteBuffers (GLsizei n, const GLuint* buffers)
+{
+  for (GLsizei i = 0; i < n; ++i)
+  {
+    m_buffers.erase (buffers[i]);
+  }
+}
+
+void
+SoftwareOpenGLContext::deleteProgram (GLuint program)
+{
+  m_programs.erase (program);
+}
+
+void
+SoftwareOpenGLContext::deleteShader (GLuint shader)
+{
+  m_shaders.erase (shader);
+}
+
+void
+SoftwareOpenGLContext::deleteTextures (GLsizei n, const GLuint* textures)
+{
+  for (GLsizei i = 0; i < n; ++i)
+  {
+    m_textures.erase (textures[i]);
+  }
+}
+
+void
+SoftwareOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
+{
+  for (GLsizei i = 0; i < n; ++i)
+  {
+    if (arrays[i] != 0)
+    {
+      m_vertexArrays.erase (arrays[i]);
+    }
+  }
+}
+
+void
+SoftwareOpenGLContext::detachShader (GLuint program, GLuint shader)
+{
+  std::vector<GLuint>& shaders = m_programs[program].shaders;
+  shaders.erase (std::remove (shaders.begin (), shaders.end (), shader),
+                 shaders.end ());
+}
+
+void
+SoftwareOpenGLContext::drawArrays (GLenum mode, GLint first, GLsizei count)
+{
+  if (mode != GL_TRIANGLES)
+  {
+    return;
+  }
+  std::vector<GLuint> indices (count);
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    indices[i] = first + i;
+  }
+  SoftwareShaderInputs inputs;
+  gatherInputs (inputs);
+  drawTriangles (indices, inputs);
+}
+
+void
+SoftwareOpenGLContext::drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+  std::vector<GLuint> list;
+  if (mode != GL_TRIANGLES
+      || !readElements (type, reinterpret_cast<size_t> (indices), count, 0,
+                        list))
+  {
+    return;
+  }
+  SoftwareShaderInputs inputs;
+  gatherInputs (inputs);
+  drawTriangles (list, inputs);
+}
+
+void
+SoftwareOpenGLContext::enable (GLenum cap)
+{
+  if (cap == GL_DEPTH_TEST)
+  {
+    m_isDepthTestEnabled = true;
+  }
+  else if (cap == GL_CULL_FACE)
+  {
+    m_isCullFaceEnabled = true;
+  }
+}
+
+void
+SoftwareOpenGLContext::enableVertexAttribArray (GLuint index)
+{
+  if (index < MAX_ATTRIBUTES)
+  {
+    m_vertexArrays[m_currentVertexArray].attributes[index].isEnabled = true;
+  }
+}
+
+void
+SoftwareOpenGLContext::frontFace (GLenum mode)
+{
+  m_frontFace = mode;
+}
+
+void
+SoftwareOpenGLContext::genBuffers (GLsizei n, GLuint* buffers)
+{
+  for (GLsizei i = 0; i < n; ++i)
+  {
+    buffers[i] = m_nextName++;
+    m_buffers[buffers[i]];
+  }
+}
+
+void
+SoftwareOpenGLContext::generateMipmap (GLenum target)
+{
+  // Textures are always sampled bilinearly from level 0.
+}
+
+void
+SoftwareOpenGLContext::genTextures (GLsizei n, GLuint* textures)
+{
+  for (GLsizei i = 0; i < n; ++i)
+  {
+    textures[i] = m_nextName++;
+    m_textures[textures[i]] = Texture ();
+  }
+}
+
+void
+SoftwareOpenGLContext::genVertexArrays (GLsizei n, GLuint* arrays)
+{
+  for (GLsizei i = 0; i < n; ++i)
+  {
+    arrays[i] = m_nextName++;
+    m_vertexArrays[arrays[i]] = VertexArray ();
+  }
+}
+
+GLint
+SoftwareOpenGLContext::getAttribLocation (GLuint program, const GLchar* name)
+{
+  for (GLint location = 0; location < MAX_ATTRIBUTES; ++location)
+  {
+    if (std::strcmp (name, ATTRIBUTE_NAMES[location]) == 0)
+    {
+      return location;
+    }
+  }
+  return -1;
+}
+
+void
+SoftwareOpenGLContext::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  const std::string& log = m_programs[program].infoLog;
+  GLsizei copied = std::min<GLsizei> (log.size (), std::max (maxLength - 1, 0));
+  std::copy (log.begin (), log.begin () + copied, infoLog);
+  if (maxLength > 0)
+  {
+    infoLog[copied] = '\0';
+  }
+  if (length != nullptr)
+  {
+    *length = copied;
+  }
+}
+
+void
+SoftwareOpenGLContext::getProgramiv (GLuint program, GLenum pname, GLint* params)
+{
+  const Program& state = m_programs[program];
+  if (pname == GL_LINK_STATUS)
+  {
+    *params = state.pipeline ? GL_TRUE : GL_FALSE;
+  }
+  else if (pname == GL_INFO_LOG_LENGTH)
+  {
+    *params = state.infoLog.empty () ? 0 : state.infoLog.size () + 1;
+  }
+}
+
+void
+SoftwareOpenGLContext::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  if (maxLength > 0)
+  {
+    infoLog[0] = '\0';
+  }
+  if (length != nullptr)
+  {
+    *length = 0;
+  }
+}
+
+void
+SoftwareOpenGLContext::getShaderiv (GLuint shader, GLenum pname, GLint* params)
+{
+  if (pname == GL_COMPILE_STATUS)
+  {
+    *params = GL_TRUE;
+  }
+  else if (pname == GL_INFO_LOG_LENGTH)
+  {
+    *params = 0;
+  }
+}
+
+const GLubyte*
+SoftwareOpenGLContext::getString (GLenum name)
+{
+  const char* value = name == GL_VERSION ? "3.3 (software)"
+    : "SoftwareOpenGLContext";
+  return reinterpret_cast<const GLubyte*> (value);
+}
+
+GLuint
+SoftwareOpenGLContext::getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName)
+{
+  for (GLuint index = 0; index < 3; ++index)
+  {
+    if (std::strcmp (uniformBlockName, BLOCK_NAMES[index]) == 0)
+    {
+      return index;
+    }
+  }
+  return GL_INVALID_INDEX;
+}
+
+GLint
+SoftwareOpenGLContext::getUniformLocation (GLuint program, const GLchar* name)
+{
+  std::vector<std::string>& names = m_programs[program].uniformNames;
+  auto found = std::find (names.begin (), names.end (), name);
+  if (found != names.end ())
+  {
+    return found - names.begin ();
+  }
+  names.push_back (name);
+  return names.size () - 1;
+}
+
+void
+SoftwareOpenGLContext::linkProgram (GLuint program)
+{
+  Program& state = m_programs[program];
+  bool isPhong = false;
+  state.isIndirect = false;
+  for (GLuint shader : state.shaders)
+  {
+    const Shader& source = m_shaders[shader];
+    if (source.type == GL_FRAGMENT_SHADER
+        && source.source.find ("calculateLighting") != std::string::npos)
+    {
+      isPhong = true;
+    }
+    if (source.source.find ("#define INDIRECT_DRAW") != std::string::npos)
+    {
+      state.isIndirect = true;
+    }
+  }
+  if (isPhong)
+  {
+    state.pipeline = std::make_shared<PhongSoftwareShader> ();
+  }
+  else
+  {
+    state.pipeline = std::make_shared<Vec3SoftwareShader> ();
+  }
+}
+
+void
+SoftwareOpenGLContext::multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+{
+  if (mode != GL_TRIANGLES)
+  {
+    return;
+  }
+  const std::vector<unsigned char>& commands =
+    m_buffers[m_boundBuffers[GL_DRAW_INDIRECT_BUFFER]];
+  size_t commandStride =
+    stride == 0 ? sizeof (DrawElementsIndirectCommand) : stride;
+  size_t size = type == GL_UNSIGNED_INT ? 4 : type == GL_UNSIGNED_SHORT ? 2 : 1;
+  SoftwareShaderInputs inputs;
+  gatherInputs (inputs);
+  std::vector<GLuint> list;
+  for (GLsizei i = 0; i < drawcount; ++i)
+  {
+    size_t offset = reinterpret_cast<size_t> (indirect) + i * commandStride;
+    if (offset + sizeof (DrawElementsIndirectCommand) > commands.size ())
+    {
+      return;
+    }
+    DrawElementsIndirectCommand command;
+    std::memcpy (&command, commands.data () + offset, sizeof (command));
+    if (!readElements (type, command.firstIndex * size, command.count,
+                       command.baseVertex, list))
+    {
+      continue;
+    }
+    for (GLuint instance = 0; instance < command.instanceCount; ++instance)
+    {
+      readIndirectObject (command.baseInstance, instance, inputs);
+      drawTriangles (list, inputs);
+    }
+  }
+}
+
+void
+SoftwareOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+{
+  std::string& source = m_shaders[shader].source;
+  source.clear ();
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    if (length == nullptr || length[i] < 0)
+    {
+      source += string[i];
+    }
+    else
+    {
+      source.append (string[i], length[i]);
+    }
+  }
+}
+
+void
+SoftwareOpenGLContext::texBuffer (GLenum target, GLenum internalFormat, GLuint buffer)
+{
+  // The format is implied by the sampler that reads the buffer.
+  m_textures[m_boundTextureBuffers[m_activeTextureUnit]].buffer = buffer;
+}
+
+void
+SoftwareOpenGLContext::texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data)
+{
+  if (target != GL_TEXTURE_2D || level != 0 || type != GL_UNSIGNED_BYTE)
+  {
+    return;
+  }
+  SoftwareImage& image = m_textures[m_boundTextures2D[m_activeTextureUnit]].image;
+  image.width = width;
+  image.height = height;
+  image.texels.assign (4 * width * height, 255);
+  if (data == nullptr)
+  {
+    return;
+  }
+
+  int components = (format == GL_RGBA || format == GL_BGRA) ? 4
+    : (format == GL_RGB || format == GL_BGR) ? 3 : 1;
+  bool isReversed = format == GL_BGR || format == GL_BGRA;
+  // Rows start on 4-byte boundaries, OpenGL's default unpack alignment.
+  size_t rowSize = (components * width + 3) / 4 * 4;
+  const unsigned char* bytes = static_cast<const unsigned char*> (data);
+  for (GLsizei y = 0; y < height; ++y)
+  {
+    for (GLsizei x = 0; x < width; ++x)
+    {
+      const unsigned char* in = bytes + y * rowSize + x * components;
+      unsigned char* out = &image.texels[4 * (y * width + x)];
+      for (int c = 0; c < std::min (components, 3); ++c)
+      {
+        out[isReversed ? 2 - c : c] = in[c];
+      }
+      if (components == 1)
+      {
+        out[1] = out[2] = 0;
+      }
+      if (components == 4)
+      {
+        out[3] = in[3];
+      }
+    }
+  }
+}
+
+void
+SoftwareOpenGLContext::texParameteri (GLenum target, GLenum pname, GLint param)
+{
+  // Textures are always sampled bilinearly with GL_REPEAT.
+}
+
+void
+SoftwareOpenGLContext::uniform1f (GLint location, GLfloat v0)
+{
+  // The shaders read everything but their samplers from uniform blocks.
+}
+
+void
+SoftwareOpenGLContext::uniform1i (GLint location, GLint v0)
+{
+  Program& program = m_programs[m_currentProgram];
+  if (location >= 0
+      && static_cast<size_t> (location) < program.uniformNames.size ())
+  {
+    program.intUniforms[program.uniformNames[location]] = v0;
+  }
+}
+
+void
+SoftwareOpenGLContext::uniform3fv (GLint location, GLsizei count, const GLfloat* value)
+{
+  // The shaders read everything but their samplers from uniform blocks.
+}
+
+void
+SoftwareOpenGLContext::uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+  if (uniformBlockIndex < 3)
+  {
+    m_programs[program].blockBindings[uniformBlockIndex] = uniformBlockBinding;
+  }
+}
+
+void
+SoftwareOpenGLContext::uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  // The shaders read everything but their samplers from uniform blocks.
+}
+
+void
+SoftwareOpenGLContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  // The shaders read everything but their samplers from uniform blocks.
+}
+
+void
+SoftwareOpenGLContext::useProgram (GLuint program)
+{
+  m_currentProgram = program;
+}
+
+void
+SoftwareOpenGLContext::vertexAttribDivisor (GLuint index, GLuint divisor)
+{
+  if (index < MAX_ATTRIBUTES)
+  {
+    m_vertexArrays[m_currentVertexArray].attributes[index].divisor = divisor;
+  }
+}
+
+void
+SoftwareOpenGLContext::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+  if (index >= MAX_ATTRIBUTES || type != GL_FLOAT)
+  {
+    return;
+  }
+  VertexAttribute& attribute =
+    m_vertexArrays[m_currentVertexArray].attributes[index];
+  attribute.buffer = m_boundBuffers[GL_ARRAY_BUFFER];
+  attribute.size = size;
+  attribute.stride = stride == 0 ? size * sizeof (float) : stride;
+  attribute.offset = reinterpret_cast<size_t> (pointer);
+}
+
+void
+SoftwareOpenGLContext::viewport (GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  m_viewportX = x;
+  m_viewportY = y;
+  m_viewportWidth = width;
+  m_viewportHeight = height;
+}
+
+void
+SoftwareOpenGLContext::drawTriangles (const std::vector<GLuint>& indices,
+                                      const SoftwareShaderInputs& inputs)
+{
+  auto program = m_programs.find (m_currentProgram);
+  if (indices.empty () || program == m_programs.end ()
+      || !program->second.pipeline)
+  {
+    return;
+  }
+  const SoftwareShader& pipeline = *program->second.pipeline;
+  int varyingCount = pipeline.getVaryingCount ();
+
+  // Find where each enabled attribute's values are.  Instanced attributes
+  //   are read once per draw, by readIndirectObject, rather than per vertex.
+  const VertexArray& vertexArray = m_vertexArrays[m_currentVertexArray];
+  const std::vector<unsigned char>* sources[MAX_ATTRIBUTES] = { };
+  for (int i = 0; i < MAX_ATTRIBUTES; ++i)
+  {
+    if (vertexArray.attributes[i].isEnabled
+        && vertexArray.attributes[i].divisor == 0)
+    {
+      sources[i] = &m_buffers[vertexArray.attributes[i].buffer];
+    }
+  }
+
+  // Shade every vertex between the smallest and largest index, in parallel,
+  //   since one draw of an indirect batch may start far into the buffer.
+  auto range = std::minmax_element (indices.begin (), indices.end ());
+  GLuint firstVertex = *range.first;
+  GLuint vertexCount = *range.second + 1;
+  m_shadedVertices.resize (vertexCount);
+  const size_t VERTICES_PER_JOB = 256;
+  auto shadeVertices = [&] (size_t first, size_t last)
+  {
+    for (size_t vertex = first; vertex < last; ++vertex)
+    {
+      float attributes[MAX_ATTRIBUTES][4];
+      for (int i = 0; i < MAX_ATTRIBUTES; ++i)
+      {
+        float* value = attributes[i];
+        value[0] = value[1] = value[2] = 0.0f;
+        value[3] = 1.0f;
+        const VertexAttribute& attribute = vertexArray.attributes[i];
+        size_t start = attribute.offset + vertex * attribute.stride;
+        if (sources[i] != nullptr
+            && start + attribute.size * sizeof (float) <= sources[i]->size ())
+        {
+          std::memcpy (value, sources[i]->data () + start,
+                       attribute.size * sizeof (float));
+        }
+      }
+      ShadedVertex& shaded = m_shadedVertices[vertex];
+      pipeline.shadeVertex (inputs, attributes, shaded.position,
+                            shaded.varyings);
+    }
+  };
+  if (m_jobs == nullptr)
+  {
+    shadeVertices (firstVertex, vertexCount);
+  }
+  else
+  {
+    m_jobs->parallelFor (firstVertex, vertexCount, VERTICES_PER_JOB,
+                         shadeVertices);
+  }
+
+  m_triangles.clear ();
+  for (size_t i = 0; i + 2 < indices.size (); i += 3)
+  {
+    const ShadedVertex* vertices[3] = {
+      &m_shadedVertices[indices[i]],
+      &m_shadedVertices[indices[i + 1]],
+      &m_shadedVertices[indices[i + 2]]
+    };
+    assembleTriangle (vertices, varyingCount);
+  }
+
+  // Sort the triangles into the tiles they touch, keeping them in order so
+  //   that equal depths resolve the same way OpenGL would.
+  for (unsigned tile : m_activeTiles)
+  {
+    m_tileBins[tile].clear ();
+  }
+  m_activeTiles.clear ();
+  for (unsigned i = 0; i < m_triangles.size (); ++i)
+  {
+    const ScreenTriangle& triangle = m_triangles[i];
+    for (int tileY = triangle.minY / TILE_SIZE;
+         tileY <= triangle.maxY / TILE_SIZE; ++tileY)
+    {
+      for (int tileX = triangle.minX / TILE_SIZE;
+           tileX <= triangle.maxX / TILE_SIZE; ++tileX)
+      {
+        std::vector<unsigned>& bin = m_tileBins[tileY * m_tilesX + tileX];
+        if (bin.empty ())
+        {
+          m_activeTiles.push_back (tileY * m_tilesX + tileX);
+        }
+        bin.push_back (i);
+      }
+    }
+  }
+
+  // Each tile is one job, so no two threads touch the same pixel, and only
+  //   the tiles with triangles in them are queued.
+  auto rasterizeTiles = [&] (size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      rasterizeTile (m_activeTiles[i], pipeline, inputs, varyingCount);
+    }
+  };
+  if (m_jobs == nullptr)
+  {
+    rasterizeTiles (0, m_activeTiles.size ());
+  }
+  else
+  {
+    m_jobs->parallelFor (0, m_activeTiles.size (), 1, rasterizeTiles);
+  }
+}
+
+bool
+SoftwareOpenGLContext::readElements (GLenum type, size_t offset, GLsizei count,
+                                     GLint baseVertex,
+                                     std::vector<GLuint>& list)
+{
+  const std::vector<unsigned char>& elements =
+    m_buffers[m_vertexArrays[m_currentVertexArray].elementBuffer];
+  size_t size = type == GL_UNSIGNED_INT ? 4 : type == GL_UNSIGNED_SHORT ? 2 : 1;
+  if (offset + count * size > elements.size ())
+  {
+    return false;
+  }
+
+  list.resize (count);
+  const unsigned char* start = elements.data () + offset;
+  for (GLsizei i = 0; i < count; ++i)
+  {
+    if (type == GL_UNSIGNED_INT)
+    {
+      std::memcpy (&list[i], start + 4 * i, 4);
+    }
+    else if (type == GL_UNSIGNED_SHORT)
+    {
+      GLushort index;
+      std::memcpy (&index, start + 2 * i, 2);
+      list[i] = index;
+    }
+    else
+    {
+      list[i] = start[i];
+    }
+    list[i] += baseVertex;
+  }
+  return true;
+}
+
+void
+SoftwareOpenGLContext::gatherInputs (SoftwareShaderInputs& inputs)
+{
+  inputs = SoftwareShaderInputs ();
+  Program& program = m_programs[m_currentProgram];
+
+  void* blocks[3] = { &inputs.frame, &inputs.material, &inputs.object };
+  size_t sizes[3] = { sizeof (inputs.frame), sizeof (inputs.material),
+                      sizeof (inputs.object) };
+  for (int i = 0; i < 3; ++i)
+  {
+    auto binding = m_uniformBufferBindings.find (program.blockBindings[i]);
+    if (binding != m_uniformBufferBindings.end ())
+    {
+      const std::vector<unsigned char>& buffer = m_buffers[binding->second];
+      std::memcpy (blocks[i], buffer.data (), std::min (sizes[i], buffer.size ()));
+    }
+  }
+
+  auto texture = m_textures.find (
+    m_boundTextures2D[getSamplerUnit (program, "uDiffuseSampler")]);
+  if (texture != m_textures.end () && !texture->second.image.texels.empty ())
+  {
+    inputs.diffuseImage = &texture->second.image;
+  }
+
+  auto bufferOf = [this, &program] (const std::string& sampler)
+  {
+    return getSamplerBuffer (program, sampler);
+  };
+  if (const std::vector<unsigned char>* lights = bufferOf ("uClusterLights"))
+  {
+    inputs.clusterLights = reinterpret_cast<const LightUniforms*> (lights->data ());
+    inputs.clusterLightCount = lights->size () / sizeof (LightUniforms);
+  }
+  if (const std::vector<unsigned char>* grid = bufferOf ("uClusterGrid"))
+  {
+    inputs.clusterGrid = reinterpret_cast<const GLuint*> (grid->data ());
+    inputs.clusterGridSize = grid->size () / sizeof (GLuint);
+  }
+  if (const std::vector<unsigned char>* indices = bufferOf ("uClusterIndices"))
+  {
+    inputs.clusterIndices = reinterpret_cast<const GLuint*> (indices->data ());
+    inputs.clusterIndexCount = indices->size () / sizeof (GLuint);
+  }
+}
+
+void
+SoftwareOpenGLContext::readIndirectObject (GLuint baseInstance,
+                                           GLuint instance,
+                                           SoftwareShaderInputs& inputs)
+{
+  const Program& program = m_programs[m_currentProgram];
+  if (!program.isIndirect)
+  {
+    return;
+  }
+
+  // aObjectIndex, which only advances per instance.
+  const VertexAttribute& attribute =
+    m_vertexArrays[m_currentVertexArray].attributes[OBJECT_INDEX_ATTRIBUTE];
+  float objectIndex = 0.0f;
+  if (attribute.isEnabled && attribute.divisor != 0)
+  {
+    const std::vector<unsigned char>& source = m_buffers[attribute.buffer];
+    size_t start = attribute.offset
+      + (baseInstance + instance / attribute.divisor) * attribute.stride;
+    if (start + sizeof (float) <= source.size ())
+    {
+      std::memcpy (&objectIndex, source.data () + start, sizeof (float));
+    }
+  }
+
+  const std::vector<unsigned char>* objects =
+    getSamplerBuffer (program, "uObjects");
+  size_t object = static_cast<size_t> (objectIndex);
+  if (objects == nullptr
+      || (object + 1) * sizeof (IndirectObjectUniforms) > objects->size ())
+  {
+    return;
+  }
+  IndirectObjectUniforms record;
+  std::memcpy (&record, objects->data () + object * sizeof (record),
+               sizeof (record));
+  std::memcpy (inputs.object.world, record.world, sizeof (record.world));
+  std::memcpy (inputs.object.worldNormal, record.worldNormal,
+               sizeof (record.worldNormal));
+  inputs.object.hasTexture = 0;
+
+  const std::vector<unsigned char>* materials =
+    getSamplerBuffer (program, "uMaterials");
+  size_t material = static_cast<size_t> (record.materialIndex);
+  if (materials != nullptr
+      && (material + 1) * sizeof (MaterialUniforms) <= materials->size ())
+  {
+    std::memcpy (&inputs.material,
+                 materials->data () + material * sizeof (MaterialUniforms),
+                 sizeof (MaterialUniforms));
+  }
+}
+
+GLint
+SoftwareOpenGLContext::getSamplerUnit (const Program& program,
+                                       const std::string& sampler)
+{
+  auto value = program.intUniforms.find (sampler);
+  GLint unit = value == program.intUniforms.end () ? 0 : value->second;
+  return std::min (std::max (unit, 0), MAX_TEXTURE_UNITS - 1);
+}
+
+const std::vector<unsigned char>*
+SoftwareOpenGLContext::getSamplerBuffer (const Program& program,
+                                         const std::string& sampler)
+{
+  auto texture = m_textures.find (
+    m_boundTextureBuffers[getSamplerUnit (program, sampler)]);
+  if (texture == m_textures.end ())
+  {
+    return nullptr;
+  }
+  auto buffer = m_buffers.find (texture->second.buffer);
+  return buffer == m_buffers.end () ? nullptr : &buffer->second;
+}
+
+void
+SoftwareOpenGLContext::assembleTriangle (const ShadedVertex* vertices[3],
+                                         int varyingCount)
+{
+  // Clip against the near plane, z >= -w, which can leave a quadrilateral.
+  // A small margin keeps w away from zero.
+  const float EPSILON = 1.0e-5f;
+  ShadedVertex clipped[4];
+  int clippedCount = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const ShadedVertex& current = *vertices[i];
+    const ShadedVertex& next = *vertices[(i + 1) % 3];
+    float currentDistance = current.position[2] + current.position[3] - EPSILON;
+    float nextDistance = next.position[2] + next.position[3] - EPSILON;
+    if (currentDistance >= 0.0f)
+    {
+      clipped[clippedCount++] = current;
+    }
+    if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+    {
+      float t = currentDistance / (currentDistance - nextDistance);
+      clipped[clippedCount++] = lerp (current, next, t, varyingCount);
+    }
+  }
+  for (int i = 1; i + 1 < clippedCount; ++i)
+  {
+    ShadedVertex triangle[3] = { clipped[0], clipped[i], clipped[i + 1] };
+    setupTriangle (triangle, varyingCount);
+  }
+}
+
+void
+SoftwareOpenGLContext::setupTriangle (const ShadedVertex vertices[3],
+                                      int varyingCount)
+{
+  ScreenTriangle triangle;
+  for (int i = 0; i < 3; ++i)
+  {
+    const float* position = vertices[i].position;
+    float inverseW = 1.0f / position[3];
+    triangle.x[i] = m_viewportX
+      + (position[0] * inverseW + 1.0f) * 0.5f * m_viewportWidth;
+    triangle.y[i] = m_viewportY
+      + (position[1] * inverseW + 1.0f) * 0.5f * m_viewportHeight;
+    triangle.z[i] = (position[2] * inverseW + 1.0f) * 0.5f;
+    triangle.inverseW[i] = inverseW;
+    for (int v = 0; v < varyingCount; ++v)
+    {
+      triangle.varyings[i][v] = vertices[i].varyings[v] * inverseW;
+    }
+  }
+
+  // Counter-clockwise triangles have a positive area, since y points up.
+  triangle.area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0])
+    - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+  if (triangle.area == 0.0f || !std::isfinite (triangle.area))
+  {
+    return;
+  }
+  bool isFrontFacing = (triangle.area > 0.0f) == (m_frontFace == GL_CCW);
+  if (m_isCullFaceEnabled
+      && (m_cullFace == GL_FRONT_AND_BACK
+          || (m_cullFace == GL_BACK && !isFrontFacing)
+          || (m_cullFace == GL_FRONT && isFrontFacing)))
+  {
+    return;
+  }
+
+  // The pixels whose centers can be inside, limited to the viewport.
+  float minX = std::min ({ triangle.x[0], triangle.x[1], triangle.x[2] });
+  float maxX = std::max ({ triangle.x[0], triangle.x[1], triangle.x[2] });
+  float minY = std::min ({ triangle.y[0], triangle.y[1], triangle.y[2] });
+  float maxY = std::max ({ triangle.y[0], triangle.y[1], triangle.y[2] });
+  triangle.minX = std::max ({ static_cast<int> (std::ceil (minX - 0.5f)),
+                              m_viewportX, 0 });
+  triangle.minY = std::max ({ static_cast<int> (std::ceil (minY - 0.5f)),
+                              m_viewportY, 0 });
+  triangle.maxX = std::min ({ static_cast<int> (std::floor (maxX - 0.5f)),
+                              m_viewportX + m_viewportWidth - 1, m_width - 1 });
+  triangle.maxY = std::min ({ static_cast<int> (std::floor (maxY - 0.5f)),
+                              m_viewportY + m_viewportHeight - 1, m_height - 1 });
+  if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+  {
+    return;
+  }
+  m_triangles.push_back (triangle);
+}
+
+void
+SoftwareOpenGLContext::rasterizeTile (unsigned tile,
+                                      const SoftwareShader& pipeline,
+                                      const SoftwareShaderInputs& inputs,
+                                      int varyingCount)
+{
+  int tileMinX = (tile % m_tilesX) * TILE_SIZE;
+  int tileMinY = (tile / m_tilesX) * TILE_SIZE;
+  for (unsigned index : m_tileBins[tile])
+  {
+    const ScreenTriangle& t = m_triangles[index];
+    int minX = std::max (t.minX, tileMinX);
+    int maxX = std::min (t.maxX, tileMinX + TILE_SIZE - 1);
+    int minY = std::max (t.minY, tileMinY);
+    int maxY = std::min (t.maxY, tileMinY + TILE_SIZE - 1);
+
+    // Barycentric coordinate i is a * x + b * y + c, from the edge opposite
+    //   vertex i.  Dividing by the signed area makes the inside positive
+    //   whichever way the triangle winds.
+    float a[3], b[3], c[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      int from = (i + 1) % 3;
+      int to = (i + 2) % 3;
+      float dx = t.x[to] - t.x[from];
+      float dy = t.y[to] - t.y[from];
+      a[i] = -dy / t.area;
+      b[i] = dx / t.area;
+      c[i] = (dy * t.x[from] - dx * t.y[from]) / t.area;
+    }
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+      float centerY = y + 0.5f;
+      for (int x = minX; x <= maxX; ++x)
+      {
+        float centerX = x + 0.5f;
+        float weights[3];
+        for (int i = 0; i < 3; ++i)
+        {
+          weights[i] = a[i] * centerX + b[i] * centerY + c[i];
+        }
+        if (weights[0] < 0.0f || weights[1] < 0.0f || weights[2] < 0.0f)
+        {
+          continue;
+        }
+        float depth = weights[0] * t.z[0] + weights[1] * t.z[1]
+          + weights[2] * t.z[2];
+        size_t pixel = static_cast<size_t> (y) * m_width + x;
+        if (depth < 0.0f || depth > 1.0f
+            || (m_isDepthTestEnabled && depth >= m_depthBuffer[pixel]))
+        {
+          continue;
+        }
+
+        float w = 1.0f / (weights[0] * t.inverseW[0]
+                          + weights[1] * t.inverseW[1]
+                          + weights[2] * t.inverseW[2]);
+        float varyings[MAX_SOFTWARE_VARYINGS];
+        for (int v = 0; v < varyingCount; ++v)
+        {
+          varyings[v] = w * (weights[0] * t.varyings[0][v]
+                             + weights[1] * t.varyings[1][v]
+                             + weights[2] * t.varyings[2][v]);
+        }
+        float color[4];
+        pipeline.shadeFragment (inputs, varyings, color);
+        if (m_isDepthTestEnabled)
+        {
+          m_depthBuffer[pixel] = depth;
+        }
+        m_colorBuffer[pixel] = packColor (color);
+      }
+    }
+  }
+}
+
+std::vector<unsigned char>&
+SoftwareOpenGLContext::getBoundBuffer (GLenum target)
+{
+  if (target == GL_ELEMENT_ARRAY_BUFFER)
+  {
+    return m_buffers[m_vertexArrays[m_currentVertexArray].elementBuffer];
+  }
+  return m_buffers[m_boundBuffers[target]];
+}
@@ -0,0 +1,434 @@
+/// \file SoftwareOpenGLContext.hpp
+/// \brief Declaration of SoftwareOpenGLContext and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef SOFTWARE_OPENGL_CONTEXT_HPP
+#define SOFTWARE_OPENGL_CONTEXT_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "OpenGLContext.hpp"
+#include "SoftwareShaders.hpp"
+
+/// \brief A subclass of OpenGLContext that draws into memory on the CPU, so
+///   that scenes can be rendered on machines without a GPU.
+///
+/// Buffers, vertex arrays, uniform blocks, textures, and texture buffers are
+///   stored in memory.  Instead of compiling GLSL, linking a program picks the
+///   SoftwareShader that matches its source: PhongSoftwareShader if the
+///   fragment shader has a calculateLighting function, and Vec3SoftwareShader
+///   otherwise.
+/// Only GL_TRIANGLES are drawn.  Triangles are clipped against the near
+///   plane, culled according to cullFace and frontFace, and sorted into
+///   screen tiles, and then the tiles are rasterized in parallel with a
+///   depth test.  Vertices are shaded and tiles rasterized as jobs on the
+///   context's own JobSystem.
+class SoftwareOpenGLContext : public OpenGLContext
+{
+public:
+
+  /// \brief Constructs a SoftwareOpenGLContext with its own framebuffer.
+  /// \param[in] width The width of the framebuffer, in pixels.
+  /// \param[in] height The height of the framebuffer, in pixels.
+  /// \param[in] threadCount How many threads shade and rasterize, including
+  ///   the caller.
+  /// \post The viewport covers the whole framebuffer, which is black with a
+  ///   depth of 1.
+  SoftwareOpenGLContext (GLsizei width, GLsizei height,
+                         unsigned threadCount
+                           = std::thread::hardware_concurrency ());
+
+  /// Destructs a SoftwareOpenGLContext, stopping its threads.
+  virtual
+  ~SoftwareOpenGLContext ();
+
+  /// Copy constructor deleted because you should not be copying
+  ///   SoftwareOpenGLContexts.
+  SoftwareOpenGLContext (const SoftwareOpenGLContext&) = delete;
+
+  /// Assignment operator deleted because you should not be assigning
+  ///   SoftwareOpenGLContexts.
+  void
+  operator= (const SoftwareOpenGLContext&) = delete;
+
+  /// \brief Saves the framebuffer as an image.
+  /// \param[in] filename The name of the PNG file to write.
+  /// \return Whether the file was written.
+  bool
+  writePng (const std::string& filename) const;
+
+  /// \brief Gets the color of one pixel of the framebuffer.
+  /// \param[in] x The column, counting from the left.
+  /// \param[in] y The row, counting from the bottom.
+  /// \return The color packed as 0xAABBGGRR.
+  std::uint32_t
+  getPixel (GLsizei x, GLsizei y) const;
+
+  virtual void
+  activeTexture (GLenum texture);
+
+  virtual void
+  attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  bindBuffer (GLenum target, GLuint buffer);
+
+  virtual void
+  bindBufferBase (GLenum target, GLuint index, GLuint buffer);
+
+  virtual void
+  bindTexture (GLenum target, GLuint texture);
+
+  virtual void
+  bindVertexArray (GLuint array);
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+  virtual void
+  clear (GLbitfield mask);
+
+  virtual void
+  clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+  virtual void
+  compileShader (GLuint shader);
+
+  virtual GLuint
+  createProgram ();
+
+  virtual GLuint
+  createShader (GLenum shaderType);
+
+  virtual void
+  cullFace (GLenum mode);
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers);
+
+  virtual void
+  deleteProgram (GLuint program);
+
+  virtual void
+  deleteShader (GLuint shader);
+
+  virtual void
+  deleteTextures (GLsizei n, const GLuint* textures);
+
+  virtual void
+  deleteVertexArrays (GLsizei n, const GLuint* arrays);
+
+  virtual void
+  detachShader (GLuint program, GLuint shader);
+
+  virtual void
+  drawArrays (GLenum mode, GLint first, GLsizei count);
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+  virtual void
+  enable (GLenum cap);
+
+  virtual void
+  enableVertexAttribArray (GLuint index);
+
+  virtual void
+  frontFace (GLenum mode);
+
+  virtual void
+  genBuffers (GLsizei n, GLuint* buffers);
+
+  virtual void
+  generateMipmap (GLenum target);
+
+  virtual void
+  genTextures (GLsizei n, GLuint* textures);
+
+  virtual void
+  genVertexArrays (GLsizei n, GLuint* arrays);
+
+  virtual GLint
+  getAttribLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getProgramiv (GLuint program, GLenum pname, GLint* params);
+
+  virtual void
+  getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getShaderiv (GLuint shader, GLenum pname, GLint* params);
+
+  virtual const GLubyte*
+  getString (GLenum name);
+
+  virtual GLuint
+  getUniformBlockIndex (GLuint program, const GLchar* uniformBlockName);
+
+  virtual GLint
+  getUniformLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  linkProgram (GLuint program);
+
+  virtual void
+  multiDrawElementsIndirect (GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+
+  virtual void
+  texBuffer (GLenum target, GLenum internalFormat, GLuint buffer);
+
+  virtual void
+  texImage2D (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data);
+
+  virtual void
+  texParameteri (GLenum target, GLenum pname, GLint param);
+
+  virtual void
+  uniform1f (GLint location, GLfloat v0);
+
+  virtual void
+  uniform1i (GLint location, GLint v0);
+
+  virtual void
+  uniform3fv (GLint location, GLsizei count, const GLfloat* value);
+
+  virtual void
+  uniformBlockBinding (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
+  virtual void
+  uniformMatrix3fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  useProgram (GLuint program);
+
+  virtual void
+  vertexAttribDivisor (GLuint index, GLuint divisor);
+
+  virtual void
+  vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+  virtual void
+  viewport (GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+  /// The number of vertex attribute locations the shaders use, the last of
+  ///   which is aObjectIndex, read once per instance by indirect draws.
+  static const int MAX_ATTRIBUTES = 5;
+  /// The location of aObjectIndex.
+  static const int OBJECT_INDEX_ATTRIBUTE = 4;
+  /// The number of texture units.
+  static const int MAX_TEXTURE_UNITS = 16;
+  /// The width and height of a screen tile, in pixels.
+  static const int TILE_SIZE = 32;
+
+  /// Where a vertex attribute's values come from.
+  struct VertexAttribute
+  {
+    bool isEnabled;
+    GLuint buffer;
+    GLint size;
+    GLsizei stride;
+    size_t offset;
+    /// 0 if it advances once per vertex, or else how many instances share
+    ///   each value.
+    GLuint divisor;
+  };
+
+  /// The state captured by a vertex array object.
+  struct VertexArray
+  {
+    VertexAttribute attributes[MAX_ATTRIBUTES];
+    GLuint elementBuffer;
+  };
+
+  /// A shader object: just its source, since it is never compiled.
+  struct Shader
+  {
+    GLenum type;
+    std::string source;
+  };
+
+  /// A program object.
+  struct Program
+  {
+    std::vector<GLuint> shaders;
+    /// The C++ shader chosen by linkProgram, or nullptr if not linked.
+    std::shared_ptr<SoftwareShader> pipeline;
+    std::string infoLog;
+    /// Uniform names, indexed by location.
+    std::vector<std::string> uniformNames;
+    /// The values of integer uniforms (samplers), by name.
+    std::map<std::string, GLint> intUniforms;
+    /// The binding point of each uniform block, by block index.
+    GLuint blockBindings[3];
+    /// Whether its shaders were compiled with INDIRECT_DRAW defined, so that
+    ///   they read each object from uObjects and uMaterials rather than from
+    ///   the ObjectBlock and MaterialBlock.
+    bool isIndirect;
+  };
+
+  /// A texture object: a 2-D image, or a view of a buffer.
+  struct Texture
+  {
+    SoftwareImage image;
+    GLuint buffer;
+  };
+
+  /// A vertex after the vertex shader has run.
+  struct ShadedVertex
+  {
+    float position[4];
+    float varyings[MAX_SOFTWARE_VARYINGS];
+  };
+
+  /// A triangle that has been projected to the screen and is ready to be
+  ///   rasterized.
+  struct ScreenTriangle
+  {
+    /// Window coordinates of the vertices, with z in [0, 1].
+    float x[3], y[3], z[3];
+    /// 1 / w for each vertex, for perspective-correct interpolation.
+    float inverseW[3];
+    /// Each vertex's varyings divided by its w.
+    float varyings[3][MAX_SOFTWARE_VARYINGS];
+    /// Twice the signed area, in pixels.
+    float area;
+    /// The pixels the triangle can touch, inclusive.
+    int minX, minY, maxX, maxY;
+  };
+
+  /// \brief Runs a draw call on a list of vertex indices.
+  /// \param[in] indices Every 3 indices form a triangle.
+  /// \param[in] inputs The uniforms and textures the program reads.
+  void
+  drawTriangles (const std::vector<GLuint>& indices,
+                 const SoftwareShaderInputs& inputs);
+
+  /// \brief Reads indices from the element buffer of the bound vertex array.
+  /// \param[in] type GL_UNSIGNED_INT, GL_UNSIGNED_SHORT, or
+  ///   GL_UNSIGNED_BYTE.
+  /// \param[in] offset Where the first index is, in bytes.
+  /// \param[in] count How many indices to read.
+  /// \param[in] baseVertex What to add to each index.
+  /// \param[out] list The indices.
+  /// \return Whether the element buffer holds all of them.
+  bool
+  readElements (GLenum type, size_t offset, GLsizei count, GLint baseVertex,
+                std::vector<GLuint>& list);
+
+  /// \brief Collects the uniforms and textures the current program reads.
+  /// \param[out] inputs Filled in from the bound buffers and textures.
+  void
+  gatherInputs (SoftwareShaderInputs& inputs);
+
+  /// \brief Does what an indirect program's shaders do to find the object
+  ///   an instance draws: reads its aObjectIndex, then its world matrices
+  ///   from uObjects and its Material from uMaterials.
+  /// \param[in] baseInstance The draw's first instance.
+  /// \param[in] instance The instance, counting from 0 within the draw.
+  /// \param[in,out] inputs Whose object and material are replaced.
+  void
+  readIndirectObject (GLuint baseInstance, GLuint instance,
+                      SoftwareShaderInputs& inputs);
+
+  /// \brief Finds the texture unit a sampler reads.  Samplers that were never
+  ///   set read unit 0, as in OpenGL.
+  /// \param[in] program The program whose sampler it is.
+  /// \param[in] sampler The sampler's name.
+  /// \return The texture unit.
+  static GLint
+  getSamplerUnit (const Program& program, const std::string& sampler);
+
+  /// \brief Finds the buffer viewed by the texture a sampler reads.
+  /// \param[in] program The program whose sampler it is.
+  /// \param[in] sampler The sampler's name.
+  /// \return The buffer, or nullptr if there is none.
+  const std::vector<unsigned char>*
+  getSamplerBuffer (const Program& program, const std::string& sampler);
+
+  /// \brief Clips a triangle against the near plane and adds what is left to
+  ///   m_triangles, unless it is culled.
+  void
+  assembleTriangle (const ShadedVertex* vertices[3], int varyingCount);
+
+  /// \brief Projects a clipped triangle to the screen and adds it to
+  ///   m_triangles, unless it is culled or degenerate.
+  void
+  setupTriangle (const ShadedVertex vertices[3], int varyingCount);
+
+  /// \brief Rasterizes every binned triangle that touches one tile.
+  void
+  rasterizeTile (unsigned tile, const SoftwareShader& pipeline,
+                 const SoftwareShaderInputs& inputs, int varyingCount);
+
+  /// \brief Gets the buffer bound to a target, creating it if needed.
+  std::vector<unsigned char>&
+  getBoundBuffer (GLenum target);
+
+  /// The framebuffer, bottom row first.
+  GLsizei m_width, m_height;
+  std::vector<std::uint32_t> m_colorBuffer;
+  std::vector<float> m_depthBuffer;
+
+  /// Fixed-function state.
+  float m_clearColor[4];
+  bool m_isDepthTestEnabled;
+  bool m_isCullFaceEnabled;
+  GLenum m_cullFace;
+  GLenum m_frontFace;
+  GLint m_viewportX, m_viewportY;
+  GLsizei m_viewportWidth, m_viewportHeight;
+
+  /// Objects, by name.
+  GLuint m_nextName;
+  std::map<GLuint, std::vector<unsigned char>> m_buffers;
+  std::map<GLuint, VertexArray> m_vertexArrays;
+  std::map<GLuint, Shader> m_shaders;
+  std::map<GLuint, Program> m_programs;
+  std::map<GLuint, Texture> m_textures;
+
+  /// Bindings.
+  std::map<GLenum, GLuint> m_boundBuffers;
+  std::map<GLuint, GLuint> m_uniformBufferBindings;
+  GLuint m_currentVertexArray;
+  GLuint m_currentProgram;
+  unsigned m_activeTextureUnit;
+  GLuint m_boundTextures2D[MAX_TEXTURE_UNITS];
+  GLuint m_boundTextureBuffers[MAX_TEXTURE_UNITS];
+
+  /// Scratch space for draw calls, reused from call to call.
+  std::vector<ShadedVertex> m_shadedVertices;
+  std::vector<ScreenTriangle> m_triangles;
+  std::vector<std::vector<unsigned>> m_tileBins;
+  int m_tilesX, m_tilesY;
+
+  /// The tiles that triangles were binned into by the current draw.
+  std::vector<unsigned> m_activeTiles;
+
+  /// The threads that shade and rasterize, or null to do both on the
+  ///   calling thread.
+  std::unique_ptr<JobSystem> m_jobs;
+};
+
+#endif//SOFTWARE_OPENGL_CONTEXT_HPP
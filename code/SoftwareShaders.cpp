@@ -0,0 +1,299 @@
+/// \file SoftwareShaders.cpp
+/// \brief Implementation of the C++ versions of the shader programs.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+
+#include "SoftwareShaders.hpp"
+#include "Vector3.hpp"
+
+// Where each Phong varying is stored.
+static const int PHONG_COLOR = 0;
+static const int PHONG_POSITION_EYE = 3;
+static const int PHONG_NORMAL_EYE = 6;
+static const int PHONG_UV = 9;
+
+// GLSL's m * v, for a column-major 4x4 matrix.
+static void
+transform (const float m[16], const float v[4], float out[4])
+{
+  for (int row = 0; row < 4; ++row)
+  {
+    out[row] = m[row] * v[0] + m[4 + row] * v[1] + m[8 + row] * v[2]
+      + m[12 + row] * v[3];
+  }
+}
+
+// GLSL's vec3 (m * vec4 (p, 1)).
+static Vector3
+transformPoint (const float m[16], const Vector3& p)
+{
+  float v[4] = { p.m_x, p.m_y, p.m_z, 1.0f };
+  float out[4];
+  transform (m, v, out);
+  return Vector3 (out[0], out[1], out[2]);
+}
+
+// GLSL's mat3 (m) * v, where the columns of m are 4 floats apart, as in a
+//   mat4 or a std140 mat3.
+static Vector3
+transformDirection (const float* m, const Vector3& v)
+{
+  return Vector3 (m[0] * v.m_x + m[4] * v.m_y + m[8] * v.m_z,
+                  m[1] * v.m_x + m[5] * v.m_y + m[9] * v.m_z,
+                  m[2] * v.m_x + m[6] * v.m_y + m[10] * v.m_z);
+}
+
+// GLSL's v * mat3 (m), which is transpose (mat3 (m)) * v.
+static Vector3
+transposeTransformDirection (const float m[16], const Vector3& v)
+{
+  return Vector3 (m[0] * v.m_x + m[1] * v.m_y + m[2] * v.m_z,
+                  m[4] * v.m_x + m[5] * v.m_y + m[6] * v.m_z,
+                  m[8] * v.m_x + m[9] * v.m_y + m[10] * v.m_z);
+}
+
+// The component-wise product GLSL uses for vec3 * vec3.
+static Vector3
+multiply (const Vector3& a, const Vector3& b)
+{
+  return Vector3 (a.m_x * b.m_x, a.m_y * b.m_y, a.m_z * b.m_z);
+}
+
+static Vector3
+toVector (const float* v)
+{
+  return Vector3 (v[0], v[1], v[2]);
+}
+
+static float
+clamp01 (float x)
+{
+  return std::min (std::max (x, 0.0f), 1.0f);
+}
+
+// Bilinearly samples an image with GL_REPEAT wrapping.
+static Vector3
+sample (const SoftwareImage* image, float u, float v)
+{
+  if (image == nullptr || image->width == 0 || image->height == 0)
+  {
+    return Vector3 (0.0f, 0.0f, 0.0f);
+  }
+  float x = (u - std::floor (u)) * image->width - 0.5f;
+  float y = (v - std::floor (v)) * image->height - 0.5f;
+  float x0 = std::floor (x);
+  float y0 = std::floor (y);
+  float fx = x - x0;
+  float fy = y - y0;
+  Vector3 result (0.0f, 0.0f, 0.0f);
+  for (int corner = 0; corner < 4; ++corner)
+  {
+    int dx = corner % 2;
+    int dy = corner / 2;
+    int column = (static_cast<int> (x0) + dx) % image->width;
+    int row = (static_cast<int> (y0) + dy) % image->height;
+    column += column < 0 ? image->width : 0;
+    row += row < 0 ? image->height : 0;
+    const unsigned char* texel = &image->texels[4 * (row * image->width
+                                                     + column)];
+    float weight = (dx ? fx : 1.0f - fx) * (dy ? fy : 1.0f - fy);
+    result += (weight / 255.0f) * Vector3 (texel[0], texel[1], texel[2]);
+  }
+  return result;
+}
+
+// The C++ version of calculateLighting in PhongShader.frag.  The diffuse
+//   reflection has already been read from the texture if there is one.
+static Vector3
+calculateLighting (const SoftwareShaderInputs& inputs,
+                   const LightUniforms& light, const Vector3& vertexPosition,
+                   const Vector3& vertexNormal,
+                   const Vector3& diffuseReflection)
+{
+  Vector3 lightVector;
+  Vector3 lightPosition;
+  if (light.type == 0)
+  {
+    lightVector = -transposeTransformDirection (inputs.frame.inverseView,
+                                                toVector (light.direction));
+    lightVector.normalize ();
+  }
+  else
+  {
+    lightPosition = transformPoint (inputs.frame.view,
+                                    toVector (light.position));
+    lightVector = lightPosition - vertexPosition;
+    lightVector.normalize ();
+  }
+  float lambertianCoef = std::max (lightVector.dot (vertexNormal), 0.0f);
+  if (lambertianCoef <= 0.0f)
+  {
+    return Vector3 (0.0f, 0.0f, 0.0f);
+  }
+
+  Vector3 diffuseColor = lambertianCoef
+    * multiply (diffuseReflection, toVector (light.diffuseIntensity));
+
+  Vector3 specularColor = multiply (toVector (inputs.material.specularReflection),
+                                    toVector (light.specularIntensity));
+  // reflect (-L, N) is -L + 2 * dot (N, L) * N.
+  Vector3 reflectionVector = 2.0f * vertexNormal.dot (lightVector)
+    * vertexNormal - lightVector;
+  Vector3 eyeVector = -vertexPosition;
+  eyeVector.normalize ();
+  float specularCoef = std::max (eyeVector.dot (reflectionVector), 0.0f);
+  specularColor *= std::pow (specularCoef, inputs.material.specularPower);
+
+  float attenuation = 1.0f;
+  if (light.type != 0)
+  {
+    float distance = (vertexPosition - lightPosition).length ();
+    const float* coefficients = light.attenuationCoefficients;
+    attenuation = 1.0f / (coefficients[0] + coefficients[1] * distance
+                          + coefficients[2] * distance * distance);
+  }
+  float spotFactor = 1.0f;
+  if (light.type == 2)
+  {
+    Vector3 direction = transposeTransformDirection (inputs.frame.inverseView,
+                                                     toVector (light.direction));
+    float cosTheta = std::max ((-lightVector).dot (direction), 0.0f);
+    spotFactor = (cosTheta >= light.cutoffCosAngle) ? cosTheta : 0.0f;
+    spotFactor = std::pow (spotFactor, light.falloff);
+  }
+  return (spotFactor * attenuation) * (diffuseColor + specularColor);
+}
+
+// The C++ version of findCluster in PhongShader.frag.
+static size_t
+findCluster (const FrameUniforms& frame, const Vector3& vertexPosition)
+{
+  float eye[4] = { vertexPosition.m_x, vertexPosition.m_y, vertexPosition.m_z,
+                   1.0f };
+  float clip[4];
+  transform (frame.projection, eye, clip);
+  const int* counts = frame.clusterCounts;
+  int tile[2];
+  for (int axis = 0; axis < 2; ++axis)
+  {
+    float ndc = clip[axis] / clip[3];
+    tile[axis] = static_cast<int> (std::floor ((ndc * 0.5f + 0.5f)
+                                               * counts[axis]));
+    tile[axis] = std::min (std::max (tile[axis], 0), counts[axis] - 1);
+  }
+  int slice = static_cast<int> (std::floor (std::log (-vertexPosition.m_z)
+                                            * frame.clusterDepthScale
+                                            + frame.clusterDepthBias));
+  slice = std::min (std::max (slice, 0), counts[2] - 1);
+  return (static_cast<size_t> (slice) * counts[1] + tile[1]) * counts[0]
+    + tile[0];
+}
+
+SoftwareShader::~SoftwareShader ()
+{
+}
+
+int
+Vec3SoftwareShader::getVaryingCount () const
+{
+  return 3;
+}
+
+void
+Vec3SoftwareShader::shadeVertex (const SoftwareShaderInputs& inputs,
+                                 const float attributes[4][4],
+                                 float position[4], float* varyings) const
+{
+  float world[4], eye[4];
+  transform (inputs.object.world, attributes[0], world);
+  transform (inputs.frame.view, world, eye);
+  transform (inputs.frame.projection, eye, position);
+  std::copy (attributes[1], attributes[1] + 3, varyings);
+}
+
+void
+Vec3SoftwareShader::shadeFragment (const SoftwareShaderInputs& inputs,
+                                   const float* varyings, float color[4]) const
+{
+  std::copy (varyings, varyings + 3, color);
+  color[3] = 1.0f;
+}
+
+int
+PhongSoftwareShader::getVaryingCount () const
+{
+  return 11;
+}
+
+void
+PhongSoftwareShader::shadeVertex (const SoftwareShaderInputs& inputs,
+                                  const float attributes[4][4],
+                                  float position[4], float* varyings) const
+{
+  float world[4], eye[4];
+  transform (inputs.object.world, attributes[0], world);
+  transform (inputs.frame.view, world, eye);
+  transform (inputs.frame.projection, eye, position);
+
+  Vector3 normal = transformDirection (inputs.frame.view,
+    transformDirection (inputs.object.worldNormal, toVector (attributes[2])));
+  normal.normalize ();
+
+  Vector3 color = multiply (toVector (inputs.material.ambientReflection),
+                            toVector (inputs.frame.ambientIntensity))
+    + toVector (inputs.material.emissiveIntensity);
+
+  varyings[PHONG_COLOR + 0] = clamp01 (color.m_x);
+  varyings[PHONG_COLOR + 1] = clamp01 (color.m_y);
+  varyings[PHONG_COLOR + 2] = clamp01 (color.m_z);
+  std::copy (eye, eye + 3, varyings + PHONG_POSITION_EYE);
+  varyings[PHONG_NORMAL_EYE + 0] = normal.m_x;
+  varyings[PHONG_NORMAL_EYE + 1] = normal.m_y;
+  varyings[PHONG_NORMAL_EYE + 2] = normal.m_z;
+  std::copy (attributes[3], attributes[3] + 2, varyings + PHONG_UV);
+}
+
+void
+PhongSoftwareShader::shadeFragment (const SoftwareShaderInputs& inputs,
+                                    const float* varyings,
+                                    float color[4]) const
+{
+  Vector3 position = toVector (varyings + PHONG_POSITION_EYE);
+  Vector3 normal = toVector (varyings + PHONG_NORMAL_EYE);
+  Vector3 diffuseReflection = inputs.object.hasTexture == 1
+    ? sample (inputs.diffuseImage, varyings[PHONG_UV], varyings[PHONG_UV + 1])
+    : toVector (inputs.material.diffuseReflection);
+
+  Vector3 result = toVector (varyings + PHONG_COLOR);
+  int directionalCount = std::min (inputs.frame.numLights, MAX_LIGHTS);
+  for (int i = 0; i < directionalCount; ++i)
+  {
+    result += calculateLighting (inputs, inputs.frame.lights[i], position,
+                                 normal, diffuseReflection);
+  }
+
+  size_t cluster = findCluster (inputs.frame, position);
+  if (2 * cluster + 1 < inputs.clusterGridSize)
+  {
+    size_t offset = inputs.clusterGrid[2 * cluster];
+    size_t count = inputs.clusterGrid[2 * cluster + 1];
+    for (size_t i = offset; i < offset + count && i < inputs.clusterIndexCount;
+         ++i)
+    {
+      GLuint index = inputs.clusterIndices[i];
+      if (index < inputs.clusterLightCount)
+      {
+        result += calculateLighting (inputs, inputs.clusterLights[index],
+                                     position, normal, diffuseReflection);
+      }
+    }
+  }
+
+  color[0] = clamp01 (result.m_x);
+  color[1] = clamp01 (result.m_y);
+  color[2] = clamp01 (result.m_z);
+  color[3] = 1.0f;
+}
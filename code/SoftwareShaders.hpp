@@ -0,0 +1,123 @@
+/// \file SoftwareShaders.hpp
+/// \brief Declaration of the C++ versions of the shader programs, used by
+///   SoftwareOpenGLContext.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef SOFTWARE_SHADERS_HPP
+#define SOFTWARE_SHADERS_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "OpenGLContext.hpp"
+#include "UniformBlocks.hpp"
+
+/// \brief The most floats a software vertex shader can pass to its fragment
+///   shader.
+const int MAX_SOFTWARE_VARYINGS = 12;
+
+/// \brief An RGBA image as stored by SoftwareOpenGLContext.
+struct SoftwareImage
+{
+  GLsizei width;
+  GLsizei height;
+  /// 4 bytes per texel, starting with the bottom row, like OpenGL.
+  std::vector<unsigned char> texels;
+};
+
+/// \brief Everything a software shader reads other than its vertex
+///   attributes: the uniform blocks, and whatever is bound to the texture
+///   units its samplers use.
+/// Texture buffers that are missing or too short read as zeros, as in GLSL.
+struct SoftwareShaderInputs
+{
+  FrameUniforms frame;
+  MaterialUniforms material;
+  ObjectUniforms object;
+  /// The image read by uDiffuseSampler, or nullptr if there is none.
+  const SoftwareImage* diffuseImage;
+  /// The contents of uClusterLights.
+  const LightUniforms* clusterLights;
+  size_t clusterLightCount;
+  /// The contents of uClusterGrid, two numbers per cluster.
+  const GLuint* clusterGrid;
+  size_t clusterGridSize;
+  /// The contents of uClusterIndices.
+  const GLuint* clusterIndices;
+  size_t clusterIndexCount;
+};
+
+/// \brief A vertex and fragment shader pair written in C++.
+/// Each subclass does what one of the GLSL programs in Shaders/ does, so that
+///   scenes can be drawn without a GPU.
+class SoftwareShader
+{
+public:
+
+  /// \brief Destructs a SoftwareShader.
+  virtual
+  ~SoftwareShader ();
+
+  /// \brief Gets how many floats shadeVertex writes to varyings.
+  virtual int
+  getVaryingCount () const = 0;
+
+  /// \brief Runs the vertex shader for one vertex.
+  /// \param[in] inputs The uniforms.
+  /// \param[in] attributes The values of attribute locations 0 through 3,
+  ///   with missing components filled in as (0, 0, 0, 1).
+  /// \param[out] position The clip-space position (gl_Position).
+  /// \param[out] varyings The outputs to be interpolated.
+  virtual void
+  shadeVertex (const SoftwareShaderInputs& inputs,
+               const float attributes[4][4], float position[4],
+               float* varyings) const = 0;
+
+  /// \brief Runs the fragment shader for one fragment.
+  /// \param[in] inputs The uniforms.
+  /// \param[in] varyings The interpolated outputs of shadeVertex.
+  /// \param[out] color The RGBA color of the fragment.
+  virtual void
+  shadeFragment (const SoftwareShaderInputs& inputs, const float* varyings,
+                 float color[4]) const = 0;
+};
+
+/// \brief The C++ version of Shaders/Vec3.vert and Shaders/Vec3.frag.
+class Vec3SoftwareShader : public SoftwareShader
+{
+public:
+
+  virtual int
+  getVaryingCount () const;
+
+  virtual void
+  shadeVertex (const SoftwareShaderInputs& inputs,
+               const float attributes[4][4], float position[4],
+               float* varyings) const;
+
+  virtual void
+  shadeFragment (const SoftwareShaderInputs& inputs, const float* varyings,
+                 float color[4]) const;
+};
+
+/// \brief The C++ version of Shaders/PhongShader.vert and
+///   Shaders/PhongShader.frag, including the clustered point and spot lights.
+class PhongSoftwareShader : public SoftwareShader
+{
+public:
+
+  virtual int
+  getVaryingCount () const;
+
+  virtual void
+  shadeVertex (const SoftwareShaderInputs& inputs,
+               const float attributes[4][4], float position[4],
+               float* varyings) const;
+
+  virtual void
+  shadeFragment (const SoftwareShaderInputs& inputs, const float* varyings,
+                 float color[4]) const;
+};
+
+#endif//SOFTWARE_SHADERS_HPP
@@ -0,0 +1,339 @@
+/// \file SweptCollision.cpp
+/// \brief Definition of swept sphere tests, which find where a moving sphere
+///   first touches a box or a triangle.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SweptCollision.hpp"
+
+namespace
+{
+  /// \brief Gets one coordinate of a vector.
+  float
+  component (const Vector3& v, unsigned axis)
+  {
+    return axis == 0 ? v.m_x : (axis == 1 ? v.m_y : v.m_z);
+  }
+
+  /// \brief Makes a vector along one axis.
+  Vector3
+  axisVector (unsigned axis, float length)
+  {
+    return Vector3 (axis == 0 ? length : 0.0f, axis == 1 ? length : 0.0f,
+                    axis == 2 ? length : 0.0f);
+  }
+
+  /// \brief Finds when a moving point comes within radius of a fixed point,
+  ///   and keeps it if it is sooner than best.
+  /// \param[in] start Where the moving point starts.
+  /// \param[in] motion How far it moves.
+  /// \param[in] point The fixed point.
+  /// \param[in] radius The distance.
+  /// \param best The soonest time found so far.
+  /// \param normal The normal at the soonest time found so far.
+  void
+  sweepPointSphere (const Vector3& start, const Vector3& motion,
+                    const Vector3& point, float radius, float& best,
+                    Vector3& normal)
+  {
+    Vector3 offset = start - point;
+    float a = motion.dot (motion);
+    float b = offset.dot (motion);
+    float c = offset.dot (offset) - radius * radius;
+    // Starting inside is handled by the caller; moving away never touches.
+    if (a == 0.0f || c < 0.0f || b >= 0.0f)
+    {
+      return;
+    }
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f)
+    {
+      return;
+    }
+    float time = (-b - std::sqrt (discriminant)) / a;
+    if (time < best)
+    {
+      best = time;
+      normal = (offset + motion * time) / radius;
+    }
+  }
+
+  /// \brief Finds when a moving point comes within radius of a segment's
+  ///   interior, and keeps it if it is sooner than best.
+  /// \param[in] start Where the moving point starts.
+  /// \param[in] motion How far it moves.
+  /// \param[in] p One end of the segment.
+  /// \param[in] q The other end of the segment.
+  /// \param[in] radius The distance.
+  /// \param best The soonest time found so far.
+  /// \param normal The normal at the soonest time found so far.
+  void
+  sweepPointCylinder (const Vector3& start, const Vector3& motion,
+                      const Vector3& p, const Vector3& q, float radius,
+                      float& best, Vector3& normal)
+  {
+    Vector3 axis = q - p;
+    float length = axis.length ();
+    if (length == 0.0f)
+    {
+      return;
+    }
+    axis /= length;
+    // Work in the plane perpendicular to the segment, where the cylinder is
+    //   a circle.
+    Vector3 offset = start - p;
+    Vector3 offsetAcross = offset - axis * offset.dot (axis);
+    Vector3 motionAcross = motion - axis * motion.dot (axis);
+    float a = motionAcross.dot (motionAcross);
+    float b = offsetAcross.dot (motionAcross);
+    float c = offsetAcross.dot (offsetAcross) - radius * radius;
+    // Moving along the segment only ever reaches its ends' spheres.
+    if (a <= 1e-12f || c < 0.0f || b >= 0.0f)
+    {
+      return;
+    }
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f)
+    {
+      return;
+    }
+    float time = (-b - std::sqrt (discriminant)) / a;
+    if (time >= best)
+    {
+      return;
+    }
+    float along = (offset + motion * time).dot (axis);
+    if (along >= 0.0f && along <= length)
+    {
+      best = time;
+      normal = (offsetAcross + motionAcross * time) / radius;
+    }
+  }
+
+  /// \brief Gets the point of a segment closest to a point.
+  Vector3
+  closestOnSegment (const Vector3& point, const Vector3& p, const Vector3& q)
+  {
+    Vector3 axis = q - p;
+    float lengthSquared = axis.dot (axis);
+    float t = lengthSquared > 0.0f ? (point - p).dot (axis) / lengthSquared
+                                   : 0.0f;
+    return p + axis * std::max (0.0f, std::min (1.0f, t));
+  }
+
+  /// \brief Checks whether a point in a triangle's plane is inside it.
+  bool
+  isInTriangle (const Vector3& point, const Vector3& a, const Vector3& b,
+                const Vector3& c, const Vector3& normal)
+  {
+    return (b - a).cross (point - a).dot (normal) >= 0.0f
+      && (c - b).cross (point - b).dot (normal) >= 0.0f
+      && (a - c).cross (point - c).dot (normal) >= 0.0f;
+  }
+
+  /// \brief Reports a sphere that starts overlapping a shape.
+  /// \param[in] offset The sphere's center minus the closest point of the
+  ///   shape.
+  /// \param[in] motion How far the sphere moves.
+  /// \param[in] radius The sphere's radius.
+  /// \param[in] fallback The normal to use when the center is on the shape.
+  /// \param[out] hit Time 0 and the normal, if it is moving further in.
+  /// \return True if it overlaps and is not moving out.
+  bool
+  touchesAtStart (const Vector3& offset, const Vector3& motion, float radius,
+                  const Vector3& fallback, SweepHit& hit)
+  {
+    float distance = offset.length ();
+    if (distance >= radius)
+    {
+      return false;
+    }
+    Vector3 normal = distance > 0.0f ? offset / distance : fallback;
+    if (motion.dot (normal) >= 0.0f)
+    {
+      return false;
+    }
+    hit.time = 0.0f;
+    hit.normal = normal;
+    return true;
+  }
+}
+
+bool
+sweepSphereAabb (const Vector3& center, const Vector3& motion, float radius,
+                 const Vector3& boxCenter, const Vector3& halfSize,
+                 SweepHit& hit)
+{
+  Vector3 low = boxCenter - halfSize;
+  Vector3 high = boxCenter + halfSize;
+  Vector3 closest (std::max (low.m_x, std::min (center.m_x, high.m_x)),
+                   std::max (low.m_y, std::min (center.m_y, high.m_y)),
+                   std::max (low.m_z, std::min (center.m_z, high.m_z)));
+  Vector3 offset = center - closest;
+  if (offset.dot (offset) < radius * radius)
+  {
+    // A center inside the box leaves through the nearest face.
+    Vector3 inside = center - boxCenter;
+    unsigned nearest = 0;
+    float least = std::numeric_limits<float>::max ();
+    for (unsigned axis = 0; axis < 3; ++axis)
+    {
+      float depth = component (halfSize, axis)
+        - std::abs (component (inside, axis));
+      if (depth < least)
+      {
+        least = depth;
+        nearest = axis;
+      }
+    }
+    Vector3 fallback = axisVector (nearest,
+                                   component (inside, nearest) < 0.0f
+                                   ? -1.0f : 1.0f);
+    return touchesAtStart (offset, motion, radius, fallback, hit);
+  }
+
+  float best = std::numeric_limits<float>::max ();
+  Vector3 normal;
+  // The faces, pushed out by the radius.
+  for (unsigned axis = 0; axis < 3; ++axis)
+  {
+    for (float side : { -1.0f, 1.0f })
+    {
+      float distance = side * (component (center, axis)
+                               - component (boxCenter, axis))
+        - component (halfSize, axis);
+      float speed = side * component (motion, axis);
+      if (distance < radius || speed >= 0.0f)
+      {
+        continue;
+      }
+      float time = (distance - radius) / -speed;
+      if (time >= best)
+      {
+        continue;
+      }
+      Vector3 contact = center + motion * time;
+      bool isOnFace = true;
+      for (unsigned other = 0; other < 3; ++other)
+      {
+        if (other != axis
+            && (component (contact, other) < component (low, other)
+                || component (contact, other) > component (high, other)))
+        {
+          isOnFace = false;
+        }
+      }
+      if (isOnFace)
+      {
+        best = time;
+        normal = axisVector (axis, side);
+      }
+    }
+  }
+  // The edges and corners, rounded by the radius.
+  Vector3 corners[8];
+  for (unsigned corner = 0; corner < 8; ++corner)
+  {
+    corners[corner] = Vector3 ((corner & 1) ? high.m_x : low.m_x,
+                               (corner & 2) ? high.m_y : low.m_y,
+                               (corner & 4) ? high.m_z : low.m_z);
+    sweepPointSphere (center, motion, corners[corner], radius, best, normal);
+  }
+  for (unsigned corner = 0; corner < 8; ++corner)
+  {
+    for (unsigned bit = 1; bit < 8; bit <<= 1)
+    {
+      if ((corner & bit) == 0)
+      {
+        sweepPointCylinder (center, motion, corners[corner],
+                            corners[corner | bit], radius, best, normal);
+      }
+    }
+  }
+
+  if (best > 1.0f)
+  {
+    return false;
+  }
+  hit.time = best;
+  hit.normal = normal;
+  return true;
+}
+
+bool
+sweepSphereTriangle (const Vector3& center, const Vector3& motion,
+                     float radius, const Vector3& a, const Vector3& b,
+                     const Vector3& c, SweepHit& hit)
+{
+  // The winding's normal decides what is inside; planeNormal may be flipped.
+  Vector3 faceNormal = (b - a).cross (c - a);
+  float area = faceNormal.length ();
+  if (area == 0.0f)
+  {
+    return false;
+  }
+  Vector3 planeNormal = faceNormal / area;
+  // Face the side the sphere starts on.
+  float distance = planeNormal.dot (center - a);
+  if (distance < 0.0f)
+  {
+    planeNormal = -planeNormal;
+    distance = -distance;
+  }
+
+  Vector3 projection = center - planeNormal * distance;
+  Vector3 closest = projection;
+  if (!isInTriangle (projection, a, b, c, faceNormal))
+  {
+    closest = closestOnSegment (center, a, b);
+    for (const Vector3& candidate : { closestOnSegment (center, b, c),
+                                      closestOnSegment (center, c, a) })
+    {
+      if ((candidate - center).length () < (closest - center).length ())
+      {
+        closest = candidate;
+      }
+    }
+  }
+  Vector3 offset = center - closest;
+  if (offset.dot (offset) < radius * radius)
+  {
+    Vector3 fallback = motion.dot (planeNormal) > 0.0f ? -planeNormal
+                                                       : planeNormal;
+    return touchesAtStart (offset, motion, radius, fallback, hit);
+  }
+
+  float best = std::numeric_limits<float>::max ();
+  Vector3 normal;
+  // The face, pushed out by the radius.
+  float speed = planeNormal.dot (motion);
+  if (speed < 0.0f)
+  {
+    float time = (distance - radius) / -speed;
+    Vector3 contact = center + motion * time - planeNormal * radius;
+    if (isInTriangle (contact, a, b, c, faceNormal))
+    {
+      best = time;
+      normal = planeNormal;
+    }
+  }
+  // The edges and corners, rounded by the radius.
+  sweepPointCylinder (center, motion, a, b, radius, best, normal);
+  sweepPointCylinder (center, motion, b, c, radius, best, normal);
+  sweepPointCylinder (center, motion, c, a, radius, best, normal);
+  sweepPointSphere (center, motion, a, radius, best, normal);
+  sweepPointSphere (center, motion, b, radius, best, normal);
+  sweepPointSphere (center, motion, c, radius, best, normal);
+
+  if (best > 1.0f)
+  {
+    return false;
+  }
+  hit.time = best;
+  hit.normal = normal;
+  return true;
+}
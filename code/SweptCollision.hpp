@@ -0,0 +1,61 @@
+/// \file SweptCollision.hpp
+/// \brief Declaration of swept sphere tests, which find where a moving sphere
+///   first touches a box or a triangle.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef SWEPT_COLLISION_HPP
+#define SWEPT_COLLISION_HPP
+
+#include "Vector3.hpp"
+
+/// \brief Where a moving sphere first touches a shape.
+struct SweepHit
+{
+  /// How far along its motion the sphere is when it touches, from 0 (where it
+  ///   started) to 1 (where it would have ended up).
+  float time;
+  /// The unit normal of the shape where it is touched, pointing toward the
+  ///   sphere's center.
+  Vector3 normal;
+};
+
+/// \brief Finds where a sphere moving in a straight line first touches an
+///   axis-aligned box.
+/// Unlike testing for overlap after moving, this cannot miss a box thinner
+///   than the distance the sphere moves.  The box is swept against as the
+///   set of points within radius of it: its faces pushed out by the radius,
+///   with cylinders along its edges and spheres at its corners.
+/// \param[in] center Where the sphere's center starts.
+/// \param[in] motion How far and in what direction it moves.
+/// \param[in] radius The sphere's radius.
+/// \param[in] boxCenter The center of the box.
+/// \param[in] halfSize Half the box's width, height, and depth.
+/// \param[out] hit When and where it first touches.  A sphere that already
+///   overlaps the box and is moving further in touches at time 0.
+/// \return True if it touches the box during the motion.  A sphere that
+///   already overlaps the box but is moving out does not touch it, so that
+///   it can leave.
+bool
+sweepSphereAabb (const Vector3& center, const Vector3& motion, float radius,
+                 const Vector3& boxCenter, const Vector3& halfSize,
+                 SweepHit& hit);
+
+/// \brief Finds where a sphere moving in a straight line first touches a
+///   triangle, from either side.
+/// The triangle is swept against as its plane pushed out by the radius, with
+///   cylinders along its edges and spheres at its corners.
+/// \param[in] center Where the sphere's center starts.
+/// \param[in] motion How far and in what direction it moves.
+/// \param[in] radius The sphere's radius.
+/// \param[in] a The first corner of the triangle.
+/// \param[in] b The second corner of the triangle.
+/// \param[in] c The third corner of the triangle.
+/// \param[out] hit When and where it first touches, as for sweepSphereAabb.
+/// \return True if it touches the triangle during the motion.
+bool
+sweepSphereTriangle (const Vector3& center, const Vector3& motion,
+                     float radius, const Vector3& a, const Vector3& b,
+                     const Vector3& c, SweepHit& hit);
+
+#endif//SWEPT_COLLISION_HPP
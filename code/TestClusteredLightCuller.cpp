@@ -0,0 +1,282 @@
+/// \file TestClusteredLightCuller.cpp
+/// \brief A collection of Catch2 unit tests for the ClusteredLightCuller
+///   class.
+/// Build it once as it is and once with -U__SSE2__ to test both the SSE2
+///   and the scalar culling loops.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ClusteredLightCuller.hpp"
+#include "Matrix4.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+static const float FOV_Y = 60.0f;
+static const float ASPECT_RATIO = 1.5f;
+static const float NEAR_PLANE = 0.5f;
+static const float FAR_PLANE = 100.0f;
+
+// Lights in structure-of-arrays form, in view space.
+struct Lights
+{
+  std::vector<float> x, y, z, radius;
+};
+
+// Scatters lights through and around the frustum, some behind the camera and
+//   some past the far plane.
+static Lights
+makeLights (unsigned count, std::mt19937& random)
+{
+  std::uniform_real_distribution<float> side (-40.0f, 40.0f);
+  std::uniform_real_distribution<float> depth (-5.0f, FAR_PLANE + 10.0f);
+  std::uniform_real_distribution<float> radius (0.5f, 15.0f);
+  Lights lights;
+  for (unsigned i = 0; i < count; ++i)
+  {
+    lights.x.push_back (side (random));
+    lights.y.push_back (side (random));
+    lights.z.push_back (-depth (random));
+    lights.radius.push_back (radius (random));
+  }
+  return lights;
+}
+
+// A cluster's view-space bounding box, found from the frustum itself rather
+//   than from the culler.
+struct ClusterBox
+{
+  float minX, maxX, minY, maxY, minZ, maxZ;
+};
+
+static ClusterBox
+boundCluster (const ClusteredLightCuller& culler, unsigned cluster)
+{
+  unsigned i = cluster % culler.getTilesX ();
+  unsigned j = cluster / culler.getTilesX () % culler.getTilesY ();
+  unsigned k = cluster / (culler.getTilesX () * culler.getTilesY ());
+  float ratio = FAR_PLANE / NEAR_PLANE;
+  float nearDepth = NEAR_PLANE * std::pow (ratio, float (k) / culler.getSlices ());
+  float farDepth = NEAR_PLANE * std::pow (ratio,
+                                          float (k + 1) / culler.getSlices ());
+  float halfHeight = std::tan (FOV_Y * 3.14159265f / 360.0f);
+  float left = (-1.0f + 2.0f * i / culler.getTilesX ()) * halfHeight
+               * ASPECT_RATIO;
+  float right = (-1.0f + 2.0f * (i + 1) / culler.getTilesX ()) * halfHeight
+                * ASPECT_RATIO;
+  float bottom = (-1.0f + 2.0f * j / culler.getTilesY ()) * halfHeight;
+  float top = (-1.0f + 2.0f * (j + 1) / culler.getTilesY ()) * halfHeight;
+  // Each side of the tile is widest at whichever end of the slice is
+  //   farther from the view direction.
+  return ClusterBox { std::min (left * nearDepth, left * farDepth),
+                      std::max (right * nearDepth, right * farDepth),
+                      std::min (bottom * nearDepth, bottom * farDepth),
+                      std::max (top * nearDepth, top * farDepth),
+                      -farDepth, -nearDepth };
+}
+
+// The distance from a point to a cluster's view-space bounding box.
+static float
+distanceToCluster (const ClusteredLightCuller& culler, unsigned cluster,
+                   float x, float y, float z)
+{
+  ClusterBox box = boundCluster (culler, cluster);
+  float dx = std::max (std::max (box.minX - x, x - box.maxX), 0.0f);
+  float dy = std::max (std::max (box.minY - y, y - box.maxY), 0.0f);
+  float dz = std::max (std::max (box.minZ - z, z - box.maxZ), 0.0f);
+  return std::sqrt (dx * dx + dy * dy + dz * dz);
+}
+
+// Checks each cluster's lights against testing every light against it.
+//   Lights within a small tolerance of touching may go either way.
+static void
+requireMatchesBruteForce (const ClusteredLightCuller& culler,
+                          const Lights& lights)
+{
+  const std::vector<unsigned>& grid = culler.getClusterGrid ();
+  const std::vector<unsigned>& indices = culler.getLightIndices ();
+  for (unsigned cluster = 0; cluster < culler.getClusterCount (); ++cluster)
+  {
+    std::vector<unsigned> actual (indices.begin () + grid[2 * cluster],
+                                  indices.begin () + grid[2 * cluster]
+                                                   + grid[2 * cluster + 1]);
+    std::sort (actual.begin (), actual.end ());
+    REQUIRE (std::adjacent_find (actual.begin (), actual.end ())
+             == actual.end ());
+    for (unsigned light = 0; light < lights.x.size (); ++light)
+    {
+      float distance = distanceToCluster (culler, cluster, lights.x[light],
+                                          lights.y[light], lights.z[light]);
+      float tolerance = 1e-3f * std::max (1.0f, lights.radius[light]);
+      bool isAssigned = std::binary_search (actual.begin (), actual.end (),
+                                            light);
+      if (distance < lights.radius[light] - tolerance)
+        REQUIRE (isAssigned);
+      else if (distance > lights.radius[light] + tolerance)
+        REQUIRE_FALSE (isAssigned);
+    }
+    for (unsigned light : actual)
+      REQUIRE (light < lights.x.size ());
+  }
+}
+
+SCENARIO ("A ClusteredLightCuller assigns each light to the clusters it touches.", "[ClusteredLightCuller][A09]") {
+  GIVEN ("A culler over a perspective frustum.") {
+    Matrix4 inverseProjection;
+    inverseProjection.setToPerspectiveProjection (FOV_Y, ASPECT_RATIO,
+                                                  NEAR_PLANE, FAR_PLANE);
+    inverseProjection.invert ();
+    ClusteredLightCuller culler (8, 6, 12);
+    culler.setProjection (inverseProjection);
+    REQUIRE (culler.getClusterCount () == 8 * 6 * 12);
+    std::mt19937 random (375);
+
+    // Counts that are not multiples of 4 leave padding lanes in the slices.
+    for (unsigned count : { 1u, 3u, 4u, 7u, 97u })
+    {
+      WHEN ("It culls " + std::to_string (count) + " random lights.") {
+        Lights lights = makeLights (count, random);
+        culler.cull (lights.x, lights.y, lights.z, lights.radius);
+        THEN ("Every cluster has the lights a brute-force test gives it.") {
+          requireMatchesBruteForce (culler, lights);
+          REQUIRE (culler.getStats ().overflowedClusters == 0);
+          REQUIRE (culler.getStats ().droppedLights == 0);
+        }
+      }
+    }
+    WHEN ("It culls no lights.") {
+      Lights lights;
+      culler.cull (lights.x, lights.y, lights.z, lights.radius);
+      THEN ("No cluster has a light.") {
+        REQUIRE (culler.getLightIndices ().empty ());
+        for (unsigned cluster = 0; cluster < culler.getClusterCount ();
+             ++cluster)
+          REQUIRE (culler.getClusterGrid ()[2 * cluster + 1] == 0);
+      }
+    }
+    WHEN ("The only light is outside the frustum, so every lane beside it is padding.") {
+      Lights lights;
+      lights.x = { 0.0f };
+      lights.y = { 0.0f };
+      lights.z = { 10.0f };
+      lights.radius = { 1.0f };
+      culler.cull (lights.x, lights.y, lights.z, lights.radius);
+      THEN ("No cluster has a light, not even light 0 from the padding.") {
+        REQUIRE (culler.getLightIndices ().empty ());
+      }
+    }
+    WHEN ("A light never gets dim enough to be ignored.") {
+      Lights lights;
+      lights.x = { 0.0f, 0.0f };
+      lights.y = { 0.0f, 0.0f };
+      lights.z = { -10.0f, -20.0f };
+      lights.radius = { 1.0f, ClusteredLightCuller::attenuationRadius (
+                                Vector3 (1.0f, 0.0f, 0.0f), 1.0f) };
+      culler.cull (lights.x, lights.y, lights.z, lights.radius);
+      THEN ("Every cluster has it.") {
+        const std::vector<unsigned>& grid = culler.getClusterGrid ();
+        const std::vector<unsigned>& indices = culler.getLightIndices ();
+        for (unsigned cluster = 0; cluster < culler.getClusterCount ();
+             ++cluster)
+        {
+          REQUIRE (grid[2 * cluster + 1] >= 1);
+          REQUIRE (std::count (indices.begin () + grid[2 * cluster],
+                               indices.begin () + grid[2 * cluster]
+                                                + grid[2 * cluster + 1], 1u)
+                   == 1);
+        }
+      }
+    }
+    WHEN ("More lights than a cluster holds touch every cluster.") {
+      const unsigned COUNT = ClusteredLightCuller::MAX_LIGHTS_PER_CLUSTER + 72;
+      Lights lights = makeLights (COUNT, random);
+      lights.radius.assign (COUNT, 1.0e6f);
+      culler.cull (lights.x, lights.y, lights.z, lights.radius);
+      THEN ("Every cluster is full, and the lights left out are counted.") {
+        REQUIRE (culler.getStats ().overflowedClusters
+                 == culler.getClusterCount ());
+        REQUIRE (culler.getStats ().droppedLights
+                 == culler.getClusterCount () * 72);
+        REQUIRE (culler.getLightIndices ().size ()
+                 == culler.getClusterCount ()
+                    * ClusteredLightCuller::MAX_LIGHTS_PER_CLUSTER);
+      }
+      THEN ("Each cluster keeps the lights nearest its center, in order.") {
+        const std::vector<unsigned>& grid = culler.getClusterGrid ();
+        const std::vector<unsigned>& indices = culler.getLightIndices ();
+        for (unsigned cluster = 0; cluster < culler.getClusterCount ();
+             ++cluster)
+        {
+          REQUIRE (grid[2 * cluster + 1]
+                   == ClusteredLightCuller::MAX_LIGHTS_PER_CLUSTER);
+          std::vector<unsigned> kept (indices.begin () + grid[2 * cluster],
+                                      indices.begin () + grid[2 * cluster]
+                                                       + grid[2 * cluster + 1]);
+          REQUIRE (std::is_sorted (kept.begin (), kept.end ()));
+          ClusterBox box = boundCluster (culler, cluster);
+          std::vector<float> distances;
+          for (unsigned light = 0; light < COUNT; ++light)
+          {
+            float dx = lights.x[light] - 0.5f * (box.minX + box.maxX);
+            float dy = lights.y[light] - 0.5f * (box.minY + box.maxY);
+            float dz = lights.z[light] - 0.5f * (box.minZ + box.maxZ);
+            distances.push_back (std::sqrt (dx * dx + dy * dy + dz * dz));
+          }
+          float farthestKept = 0.0f;
+          for (unsigned light : kept)
+            farthestKept = std::max (farthestKept, distances[light]);
+          for (unsigned light = 0; light < COUNT; ++light)
+          {
+            if (!std::binary_search (kept.begin (), kept.end (), light))
+              REQUIRE (distances[light] >= farthestKept * (1.0f - 1e-3f));
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("attenuationRadius finds where a light stops mattering.", "[ClusteredLightCuller][A09]") {
+  const float THRESHOLD = 1.0f / 256.0f;
+  GIVEN ("A light with quadratic attenuation.") {
+    Vector3 coefficients (1.0f, 0.5f, 0.25f);
+    float radius = ClusteredLightCuller::attenuationRadius (coefficients,
+                                                            2.0f, THRESHOLD);
+    THEN ("Its attenuated intensity at the radius is the threshold.") {
+      float attenuation = 1.0f / (coefficients.m_x + coefficients.m_y * radius
+                                  + coefficients.m_z * radius * radius);
+      REQUIRE (2.0f * attenuation == Approx (THRESHOLD));
+    }
+  }
+  GIVEN ("A light with only linear attenuation (q = 0).") {
+    THEN ("The radius solves the linear equation.") {
+      float radius = ClusteredLightCuller::attenuationRadius (
+        Vector3 (1.0f, 0.5f, 0.0f), 2.0f, THRESHOLD);
+      REQUIRE (radius == Approx ((2.0f / THRESHOLD - 1.0f) / 0.5f));
+    }
+  }
+  GIVEN ("A light with only constant attenuation (q = 0, l = 0).") {
+    THEN ("It never fades, so its radius is as large as a float gets.") {
+      REQUIRE (ClusteredLightCuller::attenuationRadius (
+                 Vector3 (1.0f, 0.0f, 0.0f), 2.0f, THRESHOLD) == FLT_MAX);
+    }
+  }
+  GIVEN ("A light that is never brighter than the threshold (k <= 0).") {
+    THEN ("Its radius is 0.") {
+      REQUIRE (ClusteredLightCuller::attenuationRadius (
+                 Vector3 (1.0f, 0.5f, 0.25f), THRESHOLD, THRESHOLD) == 0.0f);
+      REQUIRE (ClusteredLightCuller::attenuationRadius (
+                 Vector3 (4.0f, 0.0f, 0.0f), 2.0f * THRESHOLD, THRESHOLD)
+               == 0.0f);
+      REQUIRE (ClusteredLightCuller::attenuationRadius (
+                 Vector3 (1.0f, 0.0f, 0.0f), 0.0f, THRESHOLD) == 0.0f);
+    }
+  }
+}
@@ -0,0 +1,139 @@
+/// \file TestCommandList.cpp
+/// \brief A collection of Catch2 unit tests for recording OpenGL calls into
+///   CommandLists on worker threads and replaying them, rendered on the CPU.
+/// \author Justin Stevens
+/// \version A09
+
+#include <stdexcept>
+#include <vector>
+
+#include "Camera.hpp"
+#include "CommandList.hpp"
+#include "JobSystem.hpp"
+#include "RecordingOpenGLContext.hpp"
+#include "SceneTestFixture.hpp"
+#include "SoftwareOpenGLContext.hpp"
+#include "Scenes/Scene.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+static const GLsizei WIDTH = 96;
+static const GLsizei HEIGHT = 64;
+
+SCENARIO ("A Scene records its Meshes on worker threads and replays them in order.", "[CommandList][A09]") {
+  GIVEN ("A Scene of overlapping lit cubes in two materials.") {
+    SoftwareOpenGLContext* software = new SoftwareOpenGLContext (WIDTH, HEIGHT, 2);
+    RecordingOpenGLContext context (software);
+    context.enable (GL_DEPTH_TEST);
+    context.enable (GL_CULL_FACE);
+    ShaderProgram* phong = createShaderProgram (&context);
+    JobSystem jobs (3);
+
+    {
+      Scene scene (&context, phong);
+      scene.setDynamicBatchLimit (0);
+      Material* red = new Material (Vector3 (0.2f, 0.0f, 0.0f),
+                                    Vector3 (0.8f, 0.1f, 0.1f),
+                                    Vector3 (0.5f), Vector3 (0.0f), 16.0f);
+      Material* blue = new Material (Vector3 (0.0f, 0.0f, 0.2f),
+                                     Vector3 (0.1f, 0.1f, 0.8f),
+                                     Vector3 (0.2f), Vector3 (0.05f), 4.0f);
+      scene.addMaterial (red);
+      scene.addMaterial (blue);
+      scene.addLightSource (new DirectionalLightSource (
+        Vector3 (0.9f), Vector3 (0.4f), Vector3 (-0.3f, -1.0f, -0.5f)));
+      const unsigned CUBE_COUNT = 40;
+      for (unsigned i = 0; i < CUBE_COUNT; ++i) {
+        Mesh* cube = createCube (&context, phong, i % 3 == 0 ? blue : red);
+        cube->moveWorld (1.0f, Vector3 (i % 8 * 1.1f - 4.0f, i / 8 * 0.9f - 2.0f,
+                                        -(i % 5 * 0.7f)));
+        cube->yaw (i * 17.0f);
+        cube->pitch (i * 11.0f);
+        scene.add ("Cube" + std::to_string (i), cube);
+      }
+      Camera camera (Vector3 (0.0f, 0.0f, 6.0f), Vector3 (0.0f, 0.0f, 1.0f),
+                     0.1, 50.0, static_cast<double> (WIDTH) / HEIGHT, 60.0);
+
+      // The first frame creates and fills buffers that later frames reuse.
+      scene.draw (&camera);
+      context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      context.resetStatistics ();
+      scene.draw (&camera);
+      unsigned long directCalls = context.getCallCount ();
+      std::vector<std::uint32_t> direct = readPixels (*software, WIDTH, HEIGHT);
+
+      WHEN ("Its Meshes are recorded eight to a list.") {
+        scene.setRecordingJobs (&jobs, 8);
+        context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        context.resetStatistics ();
+        scene.draw (&camera);
+        THEN ("The same calls are made, and the frame is exactly the direct one.") {
+          REQUIRE (context.getDrawCallCount () == CUBE_COUNT);
+          REQUIRE (context.getCallCount () == directCalls);
+          REQUIRE (readPixels (*software, WIDTH, HEIGHT) == direct);
+        }
+        AND_WHEN ("A cube moves and a Material changes between frames.") {
+          scene.getMesh ("Cube5")->moveWorld (0.8f, Vector3 (0.0f, 1.0f, 0.0f));
+          blue->m_diffuse = Vector3 (0.1f, 0.8f, 0.1f);
+          context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          scene.draw (&camera);
+          std::vector<std::uint32_t> recorded = readPixels (*software, WIDTH, HEIGHT);
+          scene.setRecordingJobs (nullptr);
+          context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          scene.draw (&camera);
+          THEN ("The recorded frame follows them.") {
+            REQUIRE (recorded != direct);
+            REQUIRE (recorded == readPixels (*software, WIDTH, HEIGHT));
+          }
+        }
+      }
+    }
+    delete phong;
+  }
+}
+
+SCENARIO ("A CommandList keeps the calls recorded into it.", "[CommandList][A09]") {
+  GIVEN ("A list holding a few calls.") {
+    RecordingOpenGLContext context (new SoftwareOpenGLContext (WIDTH, HEIGHT, 1));
+    CommandList commands;
+    commands.bindVertexArray (0);
+    commands.clearColor (0.5f, 0.5f, 0.5f, 1.0f);
+    commands.clear (GL_COLOR_BUFFER_BIT);
+    THEN ("It counts them.") {
+      REQUIRE (commands.getCommandCount () == 3);
+      REQUIRE (commands.getByteCount () > 0);
+    }
+    WHEN ("It is replayed twice.") {
+      commands.replay (&context);
+      commands.replay (&context);
+      THEN ("Every call is made each time.") {
+        REQUIRE (context.getCallCount () == 6);
+      }
+    }
+    WHEN ("Data larger than a block is recorded.") {
+      std::vector<unsigned char> data (200000, 7);
+      commands.bufferSubData (GL_UNIFORM_BUFFER, 0, data.size (), data.data ());
+      THEN ("A copy of all of it is kept.") {
+        REQUIRE (commands.getCommandCount () == 4);
+        REQUIRE (commands.getByteCount () >= data.size ());
+      }
+    }
+    WHEN ("It is reset.") {
+      commands.reset ();
+      commands.replay (&context);
+      THEN ("It is empty.") {
+        REQUIRE (commands.getCommandCount () == 0);
+        REQUIRE (commands.getByteCount () == 0);
+        REQUIRE (context.getCallCount () == 0);
+      }
+    }
+    THEN ("Calls that must return something at once are refused.") {
+      GLuint buffer;
+      REQUIRE_THROWS_AS (commands.genBuffers (1, &buffer), std::logic_error);
+      REQUIRE_THROWS_AS (commands.getUniformLocation (0, "uWorld"),
+                         std::logic_error);
+      REQUIRE (commands.getCommandCount () == 3);
+    }
+  }
+}
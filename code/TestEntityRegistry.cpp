@@ -0,0 +1,89 @@
+/// \file TestEntityRegistry.cpp
+/// \brief A collection of Catch2 unit tests for the EntityRegistry class and
+///   the ComponentStore class template.
+/// \author Justin Stevens
+/// \version A09
+
+#include "ComponentStore.hpp"
+#include "EntityRegistry.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("EntityRegistry reuses indexes without reviving old handles.", "[EntityRegistry][A09]") {
+  GIVEN ("A registry with three entities.") {
+    EntityRegistry registry;
+    Entity a = registry.create ();
+    Entity b = registry.create ();
+    Entity c = registry.create ();
+    THEN ("They are alive and distinct.") {
+      REQUIRE (registry.getCount () == 3);
+      REQUIRE (registry.isAlive (a));
+      REQUIRE (registry.isAlive (c));
+      REQUIRE (a != b);
+      REQUIRE (b.index == 1);
+    }
+    WHEN ("The middle one is destroyed and another is created.") {
+      registry.destroy (b);
+      Entity d = registry.create ();
+      THEN ("The new one takes the index, and the old handle is stale.") {
+        REQUIRE (d.index == b.index);
+        REQUIRE (d.generation == b.generation + 1);
+        REQUIRE (d != b);
+        REQUIRE_FALSE (registry.isAlive (b));
+        REQUIRE (registry.isAlive (d));
+        REQUIRE (registry.getCount () == 3);
+      }
+    }
+  }
+}
+
+SCENARIO ("ComponentStore keeps components packed.", "[ComponentStore][A09]") {
+  GIVEN ("Four entities, three with components.") {
+    EntityRegistry registry;
+    ComponentStore<int> store;
+    Entity e[4];
+    for (Entity& entity : e) {
+      entity = registry.create ();
+    }
+    store.add (e[0], 10);
+    store.add (e[1], 11);
+    store.add (e[3], 13);
+    THEN ("Each entity gets its own, and the one without has none.") {
+      REQUIRE (store.size () == 3);
+      REQUIRE (store.get (e[1]) == 11);
+      REQUIRE (store.get (e[3]) == 13);
+      REQUIRE_FALSE (store.has (e[2]));
+    }
+    WHEN ("A component is added again.") {
+      store.add (e[1], 21);
+      THEN ("It is replaced, not duplicated.") {
+        REQUIRE (store.size () == 3);
+        REQUIRE (store.get (e[1]) == 21);
+      }
+    }
+    WHEN ("The first is removed.") {
+      store.remove (e[0]);
+      THEN ("The last takes its place, and the rest are still found.") {
+        REQUIRE (store.size () == 2);
+        REQUIRE_FALSE (store.has (e[0]));
+        REQUIRE (store.getComponents ()[0] == 13);
+        REQUIRE (store.getEntities ()[0] == e[3]);
+        REQUIRE (store.get (e[3]) == 13);
+        REQUIRE (store.get (e[1]) == 11);
+      }
+    }
+    WHEN ("An entity is destroyed without removing its component, and its index is reused.") {
+      registry.destroy (e[1]);
+      Entity reused = registry.create ();
+      THEN ("The new handle does not find the old component, and adding replaces it.") {
+        REQUIRE_FALSE (store.has (reused));
+        store.add (reused, 31);
+        REQUIRE (store.size () == 3);
+        REQUIRE (store.get (reused) == 31);
+        REQUIRE (store.get (e[0]) == 10);
+        REQUIRE (store.get (e[3]) == 13);
+      }
+    }
+  }
+}
@@ -0,0 +1,103 @@
+/// \file TestEntitySystems.cpp
+/// \brief A collection of Catch2 unit tests for the systems that update
+///   scene objects.
+/// \author Justin Stevens
+/// \version A09
+
+#include "EntitySystems.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+// The room PhysicsScene plays 3D Pong in.
+static const Walls ROOM = { Vector3 (-20.0f, -20.0f, -20.0f),
+                            Vector3 (20.0f, 10.0f, 20.0f) };
+
+// An entity with a transform at a position.
+static Entity
+place (EntityRegistry& registry, ComponentStore<Transform>& transforms,
+       const Vector3& position)
+{
+  Entity entity = registry.create ();
+  transforms.add (entity, Transform ()).setPosition (position);
+  return entity;
+}
+
+SCENARIO ("moveBodies moves bodies and bounces them off the walls.", "[EntitySystems][A09]") {
+  GIVEN ("A body heading for the right wall and one in the middle of the room.") {
+    EntityRegistry registry;
+    ComponentStore<Transform> transforms;
+    ComponentStore<Body> bodies;
+    Entity fast = place (registry, transforms, Vector3 (18.5f, 0.0f, 0.0f));
+    Entity slow = place (registry, transforms, Vector3 (0.0f));
+    bodies.add (fast, { Vector3 (10.0f, 0.0f, 0.0f), 1.0f });
+    bodies.add (slow, { Vector3 (0.0f, -1.0f, 2.0f), 1.0f });
+    WHEN ("They move for a tenth of a second.") {
+      moveBodies (bodies, transforms, ROOM, 0.1f);
+      THEN ("The one that reached the wall turns around, and the other keeps going.") {
+        REQUIRE (transforms.get (fast).getPosition ().m_x == Approx (19.5f));
+        REQUIRE (bodies.get (fast).velocity.m_x == Approx (-10.0f));
+        REQUIRE (transforms.get (slow).getPosition ().m_y == Approx (-0.1f));
+        REQUIRE (transforms.get (slow).getPosition ().m_z == Approx (0.2f));
+        REQUIRE (bodies.get (slow).velocity.m_z == Approx (2.0f));
+      }
+    }
+  }
+  GIVEN ("Many bodies, some of them sharing entities with nothing else.") {
+    EntityRegistry registry;
+    ComponentStore<Transform> serialTransforms, threadedTransforms;
+    ComponentStore<Body> serialBodies, threadedBodies;
+    for (int i = 0; i < 20000; ++i) {
+      Vector3 position (i % 37 - 18.0f, i % 23 - 15.0f, i % 31 - 15.0f);
+      Entity entity = place (registry, serialTransforms, position);
+      threadedTransforms.add (entity, serialTransforms.get (entity));
+      Body body = { Vector3 (i % 7 - 3.0f, i % 5 - 2.0f, i % 3 - 1.0f), 0.5f };
+      serialBodies.add (entity, body);
+      threadedBodies.add (entity, body);
+    }
+    WHEN ("They move for many steps, on one thread and across a JobSystem.") {
+      JobSystem jobs (3);
+      for (int step = 0; step < 60; ++step) {
+        moveBodies (serialBodies, serialTransforms, ROOM, 1.0f / 60.0f);
+        moveBodies (threadedBodies, threadedTransforms, ROOM, 1.0f / 60.0f, &jobs);
+      }
+      THEN ("They end in exactly the same places.") {
+        for (Entity entity : serialBodies.getEntities ()) {
+          REQUIRE (threadedTransforms.get (entity) == serialTransforms.get (entity));
+          REQUIRE (threadedBodies.get (entity).velocity == serialBodies.get (entity).velocity);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("steerPaddles chases the ball within the walls.", "[EntitySystems][A09]") {
+  GIVEN ("A paddle below and left of the ball, and one against the top wall.") {
+    EntityRegistry registry;
+    ComponentStore<Transform> transforms;
+    ComponentStore<PaddleAi> paddles;
+    PaddleAi ai = { { DEFAULT_MARGIN_3D, 20.0f }, Vector3 (6.0f, 6.0f, 1.0f) };
+    Entity chasing = place (registry, transforms, Vector3 (-5.0f, -10.0f, -18.0f));
+    Entity blocked = place (registry, transforms, Vector3 (0.0f, 8.0f, 18.0f));
+    paddles.add (chasing, ai);
+    paddles.add (blocked, ai);
+    WHEN ("The ball is far above and to the right of both, for a tenth of a second.") {
+      steerPaddles (paddles, transforms, Vector3 (15.0f, 9.5f, 0.0f), ROOM, 0.1f);
+      THEN ("The first moves up and right at full speed, and the second only right.") {
+        Vector3 position = transforms.get (chasing).getPosition ();
+        REQUIRE (position.m_x == Approx (-3.0f));
+        REQUIRE (position.m_y == Approx (-8.0f));
+        REQUIRE (position.m_z == Approx (-18.0f));
+        position = transforms.get (blocked).getPosition ();
+        REQUIRE (position.m_x == Approx (2.0f));
+        REQUIRE (position.m_y == Approx (8.0f));
+      }
+    }
+    WHEN ("The ball is within the margin of the first.") {
+      steerPaddles (paddles, transforms, Vector3 (-4.5f, -10.5f, 0.0f), ROOM, 0.1f);
+      THEN ("It stays put.") {
+        REQUIRE (transforms.get (chasing).getPosition () == Vector3 (-5.0f, -10.0f, -18.0f));
+      }
+    }
+  }
+}
@@ -0,0 +1,48 @@
+/// \file TestFixedTimestep.cpp
+/// \brief A collection of Catch2 unit tests for the FixedTimestep class.
+/// \author Justin Stevens
+/// \version A09
+
+#include "FixedTimestep.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("FixedTimestep turns frame times into whole steps.", "[FixedTimestep][A09]") {
+  GIVEN ("A 64 step per second timestep that may take 4 steps per frame.") {
+    FixedTimestep timestep (64.0, 4);
+    REQUIRE (timestep.getStepSeconds () == 1.0 / 64.0);
+    WHEN ("Frames shorter than a step go by.") {
+      unsigned first = timestep.advance (0.4 / 64.0);
+      unsigned second = timestep.advance (0.4 / 64.0);
+      THEN ("No step is taken until a whole step has accumulated.") {
+        REQUIRE (first == 0);
+        REQUIRE (second == 0);
+        REQUIRE (timestep.getInterpolation () == Approx (0.8f));
+        REQUIRE (timestep.advance (0.4 / 64.0) == 1);
+        REQUIRE (timestep.getInterpolation () == Approx (0.2f).margin (1e-5));
+      }
+    }
+    WHEN ("The same total time is split into different frames.") {
+      FixedTimestep other (64.0, 4);
+      unsigned steps = 0;
+      for (int frame = 0; frame < 32; ++frame)
+        steps += timestep.advance (1.0 / 32.0);
+      unsigned otherSteps = 0;
+      for (int frame = 0; frame < 128; ++frame)
+        otherSteps += other.advance (1.0 / 128.0);
+      THEN ("Both take the same number of steps.") {
+        REQUIRE (steps == 64);
+        REQUIRE (otherSteps == 64);
+      }
+    }
+    WHEN ("One frame takes much longer than the catch-up limit.") {
+      unsigned steps = timestep.advance (1.0 + 0.5 / 64.0);
+      THEN ("Only the maximum is taken and the rest is dropped.") {
+        REQUIRE (steps == 4);
+        REQUIRE (timestep.getInterpolation () == Approx (0.5f).margin (1e-4));
+        REQUIRE (timestep.advance (0.0) == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,159 @@
+/// \file TestGeometry.cpp
+/// \brief A collection of Catch2 unit tests for the geometry functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include <random>
+
+#include "Geometry.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("Random vertex colors follow vertex positions.", "[Geometry][A09]") {
+  GIVEN ("A cube, whose corners are each shared by several faces.") {
+    std::vector<Triangle> cube = buildCube ();
+    WHEN ("Its vertices are colored.") {
+      std::vector<Vector3> colors = generateRandomVertexColors (cube);
+      THEN ("Every copy of a corner has the same color, and different corners differ.") {
+        REQUIRE (colors.size () == cube.size () * 3);
+        for (size_t i = 0; i < colors.size (); ++i) {
+          REQUIRE (colors[i].m_x >= 0.0f);
+          REQUIRE (colors[i].m_x < 1.0f);
+          for (size_t j = 0; j < i; ++j) {
+            bool isSamePosition = cube[i / 3][i % 3] == cube[j / 3][j % 3];
+            REQUIRE ((colors[i] == colors[j]) == isSamePosition);
+          }
+        }
+      }
+      THEN ("Coloring it again gives the same colors.") {
+        std::vector<Vector3> again = generateRandomVertexColors (cube);
+        for (size_t i = 0; i < colors.size (); ++i) {
+          REQUIRE (again[i].m_x == colors[i].m_x);
+          REQUIRE (again[i].m_y == colors[i].m_y);
+          REQUIRE (again[i].m_z == colors[i].m_z);
+        }
+      }
+    }
+  }
+  GIVEN ("A corner at 0 in one face and at -0 in another.") {
+    std::vector<Triangle> faces (2);
+    faces[0] = { Vector3 (0.0f, 1.0f, 2.0f), Vector3 (1.0f), Vector3 (2.0f) };
+    faces[1] = { Vector3 (3.0f), Vector3 (-0.0f, 1.0f, 2.0f), Vector3 (4.0f) };
+    THEN ("Both get the same color.") {
+      std::vector<Vector3> colors = generateRandomVertexColors (faces);
+      REQUIRE (colors[0].m_x == colors[4].m_x);
+      REQUIRE (colors[0].m_y == colors[4].m_y);
+      REQUIRE (colors[0].m_z == colors[4].m_z);
+    }
+  }
+  GIVEN ("Many faces built from a small set of positions.") {
+    std::mt19937 random (42);
+    std::uniform_int_distribution<int> grid (0, 20);
+    std::vector<Triangle> faces (50000);
+    for (Triangle& face : faces) {
+      for (Vector3& corner : face) {
+        corner = Vector3 (grid (random), grid (random), grid (random));
+      }
+    }
+    WHEN ("They are colored across a JobSystem.") {
+      JobSystem jobs (3);
+      std::vector<Vector3> serial = generateRandomVertexColors (faces);
+      std::vector<Vector3> threaded = generateRandomVertexColors (faces, &jobs);
+      THEN ("The colors are exactly those colored on one thread.") {
+        for (size_t i = 0; i < serial.size (); ++i) {
+          REQUIRE (threaded[i].m_x == serial[i].m_x);
+          REQUIRE (threaded[i].m_y == serial[i].m_y);
+          REQUIRE (threaded[i].m_z == serial[i].m_z);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("Geometry is appended to a batch in world space.", "[Geometry][A09]") {
+  GIVEN ("A batch holding one triangle, and a triangle with normals to add.") {
+    std::vector<float> batchVertices (18, 0.0f);
+    std::vector<unsigned> batchIndices { 0, 1, 2 };
+    std::vector<float> vertices {
+      0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f,
+      1.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f,
+      0.0f, 0.0f, 1.0f,  0.0f, 1.0f, 0.0f };
+    std::vector<unsigned> indices { 0, 2, 1 };
+    WHEN ("It is added, moved up, turned upside down, and stretched along x.") {
+      Transform world;
+      world.setPosition (0.0f, 5.0f, 0.0f);
+      world.roll (180.0f);
+      world.scaleLocal (2.0f, 1.0f, 1.0f);
+      Vector3 low, high;
+      appendTransformedGeometry (vertices, indices, 6, 3, world, batchVertices,
+                                 batchIndices, low, high);
+      THEN ("Its positions and normals are moved, and its indices follow the batch's.") {
+        REQUIRE (batchVertices.size () == 36);
+        REQUIRE (batchIndices == std::vector<unsigned> ({ 0, 1, 2, 3, 5, 4 }));
+        REQUIRE (batchVertices[24] == Approx (-2.0f));
+        REQUIRE (batchVertices[25] == Approx (5.0f));
+        REQUIRE (batchVertices[28] == Approx (-1.0f));
+        REQUIRE (batchVertices[27] == Approx (0.0f).margin (1e-6));
+        REQUIRE (low.m_x == Approx (-2.0f));
+        REQUIRE (high.m_z == Approx (1.0f));
+        REQUIRE (high.m_y == Approx (5.0f));
+      }
+    }
+    WHEN ("It is added with a world matrix and a normal matrix.") {
+      Transform world;
+      world.setPosition (1.5f, -2.0f, 3.25f);
+      world.yaw (30.0f);
+      world.scaleLocal (0.5f, 3.0f, 1.0f);
+      Matrix4 matrix = world.getTransform ();
+      Matrix3 normalMatrix = world.getOrientation ();
+      normalMatrix.invert ();
+      normalMatrix.transpose ();
+      Vector3 low, high;
+      appendTransformedGeometry (vertices, indices, 6, 3, matrix, normalMatrix,
+                                 batchVertices, batchIndices, low, high);
+      THEN ("Each position and normal is exactly the matrix product.") {
+        REQUIRE (batchVertices.size () == 36);
+        for (size_t v = 0; v < 3; ++v) {
+          const float* in = &vertices[v * 6];
+          const float* out = &batchVertices[18 + v * 6];
+          Vector4 position = matrix * Vector4 (in[0], in[1], in[2], 1.0f);
+          Vector3 normal = normalMatrix * Vector3 (in[3], in[4], in[5]);
+          REQUIRE (out[0] == position.m_x);
+          REQUIRE (out[1] == position.m_y);
+          REQUIRE (out[2] == position.m_z);
+          REQUIRE (out[3] == normal.m_x);
+          REQUIRE (out[4] == normal.m_y);
+          REQUIRE (out[5] == normal.m_z);
+          REQUIRE (low.m_y <= position.m_y);
+          REQUIRE (high.m_x >= position.m_x);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("Indices are narrowed to 16 bits when they fit.", "[Geometry][A09]") {
+  GIVEN ("Indices up to 65535.") {
+    std::vector<unsigned> indices = { 0, 65535, 7, 300 };
+    std::vector<std::uint16_t> shortIndices = { 9, 9, 9, 9, 9, 9 };
+    WHEN ("They are narrowed.") {
+      bool isNarrowed = narrowIndices (indices, shortIndices);
+      THEN ("Every index is kept, in 16 bits.") {
+        REQUIRE (isNarrowed);
+        REQUIRE (shortIndices == std::vector<std::uint16_t> ({ 0, 65535, 7, 300 }));
+      }
+    }
+  }
+  GIVEN ("Indices of which one is 65536.") {
+    std::vector<unsigned> indices = { 0, 1, 65536 };
+    std::vector<std::uint16_t> shortIndices;
+    WHEN ("They are narrowed.") {
+      bool isNarrowed = narrowIndices (indices, shortIndices);
+      THEN ("They are left to 32 bits.") {
+        REQUIRE_FALSE (isNarrowed);
+        REQUIRE (shortIndices.empty ());
+      }
+    }
+  }
+}
@@ -0,0 +1,144 @@
+/// \file TestIndirectDrawList.cpp
+/// \brief A collection of Catch2 unit tests for drawing a Scene's Meshes with
+///   multi-draw indirect commands, rendered on the CPU.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <vector>
+
+#include "Camera.hpp"
+#include "ColorsMesh.hpp"
+#include "IndirectDrawList.hpp"
+#include "RecordingOpenGLContext.hpp"
+#include "SceneTestFixture.hpp"
+#include "SoftwareOpenGLContext.hpp"
+#include "Scenes/Scene.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+static const GLsizei WIDTH = 96;
+static const GLsizei HEIGHT = 64;
+
+SCENARIO ("A Scene draws each kind of Mesh with one indirect call.", "[IndirectDrawList][A09]") {
+  GIVEN ("A Scene of lit cubes in two materials, and colored cubes.") {
+    SoftwareOpenGLContext* software = new SoftwareOpenGLContext (WIDTH, HEIGHT, 2);
+    RecordingOpenGLContext context (software);
+    context.enable (GL_DEPTH_TEST);
+    context.enable (GL_CULL_FACE);
+    ShaderProgram* phong = createShaderProgram (&context, "PhongShader", false);
+    ShaderProgram* indirectPhong =
+      createShaderProgram (&context, "PhongShader", true);
+    ShaderProgram* colors = createShaderProgram (&context, "Vec3", false);
+    ShaderProgram* indirectColors = createShaderProgram (&context, "Vec3", true);
+
+    {
+      Scene scene (&context, phong);
+      scene.setDynamicBatchLimit (0);
+      Material* red = new Material (Vector3 (0.2f, 0.0f, 0.0f),
+                                    Vector3 (0.8f, 0.1f, 0.1f),
+                                    Vector3 (0.5f), Vector3 (0.0f), 16.0f);
+      Material* blue = new Material (Vector3 (0.0f, 0.0f, 0.2f),
+                                     Vector3 (0.1f, 0.1f, 0.8f),
+                                     Vector3 (0.2f), Vector3 (0.05f), 4.0f);
+      scene.addMaterial (red);
+      scene.addMaterial (blue);
+      scene.addLightSource (new DirectionalLightSource (
+        Vector3 (0.9f), Vector3 (0.4f), Vector3 (-0.3f, -1.0f, -0.5f)));
+      const unsigned LIT_COUNT = 6;
+      for (unsigned i = 0; i < LIT_COUNT; ++i) {
+        Mesh* cube = createCube (&context, phong, i % 2 == 0 ? red : blue);
+        cube->moveWorld (1.0f, Vector3 (i * 1.6f - 4.0f, 1.0f, -(i % 3 * 1.0f)));
+        cube->yaw (i * 25.0f);
+        scene.add ("Lit" + std::to_string (i), cube);
+      }
+      const unsigned COLORED_COUNT = 3;
+      for (unsigned i = 0; i < COLORED_COUNT; ++i) {
+        Mesh* cube = new ColorsMesh (&context, colors);
+        addCube (cube, false);
+        cube->moveWorld (1.0f, Vector3 (i * 2.0f - 2.0f, -1.5f, 0.0f));
+        cube->pitch (i * 30.0f);
+        scene.add ("Colored" + std::to_string (i), cube);
+      }
+      Camera camera (Vector3 (0.0f, 0.0f, 5.0f), Vector3 (0.0f, 0.0f, 1.0f),
+                     0.1, 50.0, static_cast<double> (WIDTH) / HEIGHT, 60.0);
+
+      context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      context.resetStatistics ();
+      scene.draw (&camera);
+      unsigned long individualDraws = context.getDrawCallCount ();
+      std::vector<std::uint32_t> individual = readPixels (*software, WIDTH, HEIGHT);
+
+      WHEN ("Its Meshes are drawn indirectly.") {
+        scene.setIndirectProgram (phong, indirectPhong);
+        scene.setIndirectProgram (colors, indirectColors);
+        context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        context.resetStatistics ();
+        scene.draw (&camera);
+        THEN ("Each kind of Mesh takes one call, with one command per Mesh.") {
+          REQUIRE (individualDraws == LIT_COUNT + COLORED_COUNT);
+          REQUIRE (context.getDrawCallCount () == 2);
+          REQUIRE (context.getIndirectCommandCount () == LIT_COUNT + COLORED_COUNT);
+        }
+        THEN ("The frame is exactly the one drawn a Mesh at a time.") {
+          std::vector<std::uint32_t> indirect = readPixels (*software, WIDTH, HEIGHT);
+          REQUIRE (indirect == individual);
+          REQUIRE (std::count (indirect.begin (), indirect.end (), indirect[0])
+                   < WIDTH * HEIGHT * 7 / 8);
+        }
+        AND_WHEN ("A Mesh moves and another is removed.") {
+          scene.getMesh ("Lit2")->moveWorld (0.5f, Vector3 (0.0f, -1.0f, 0.0f));
+          scene.remove ("Lit3");
+          context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          context.resetStatistics ();
+          scene.draw (&camera);
+          std::vector<std::uint32_t> indirect = readPixels (*software, WIDTH, HEIGHT);
+          scene.setIndirectProgram (phong, nullptr);
+          scene.setIndirectProgram (colors, nullptr);
+          context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          scene.draw (&camera);
+          THEN ("The indirect frame follows them.") {
+            REQUIRE (context.getIndirectCommandCount () == LIT_COUNT + COLORED_COUNT - 1);
+            REQUIRE (indirect == readPixels (*software, WIDTH, HEIGHT));
+          }
+        }
+      }
+    }
+    delete phong;
+    delete indirectPhong;
+    delete colors;
+    delete indirectColors;
+  }
+}
+
+SCENARIO ("An IndirectDrawList makes one command per Mesh.", "[IndirectDrawList][A09]") {
+  GIVEN ("Two cubes and a list holding both.") {
+    SoftwareOpenGLContext context (WIDTH, HEIGHT, 1);
+    ShaderProgram* program = createShaderProgram (&context, "Vec3", true);
+    ColorsMesh first (&context, program);
+    ColorsMesh second (&context, program);
+    addCube (&first, false);
+    addCube (&second, false);
+    IndirectDrawList list (&context, program);
+    list.setMeshes ({ &first, &second });
+    THEN ("The commands address each cube's part of the shared buffers.") {
+      const std::vector<DrawElementsIndirectCommand>& commands = list.getCommands ();
+      REQUIRE (commands.size () == 2);
+      for (unsigned i = 0; i < 2; ++i) {
+        REQUIRE (commands[i].count == first.getIndices ().size ());
+        REQUIRE (commands[i].instanceCount == 1);
+        REQUIRE (commands[i].baseInstance == i);
+      }
+      REQUIRE (commands[0].firstIndex == 0);
+      REQUIRE (commands[0].baseVertex == 0);
+      REQUIRE (commands[1].firstIndex == first.getIndices ().size ());
+      REQUIRE (commands[1].baseVertex * first.getFloatsPerVertex ()
+               == first.getVertices ().size ());
+    }
+    THEN ("Their indices are shared in 16 bits, as each cube's fit.") {
+      REQUIRE (list.getIndexType () == GL_UNSIGNED_SHORT);
+    }
+    delete program;
+  }
+}
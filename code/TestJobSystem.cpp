@@ -0,0 +1,78 @@
+/// \file TestJobSystem.cpp
+/// \brief A collection of Catch2 unit tests for the JobSystem class.
+/// \author Justin Stevens
+/// \version A09
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "JobSystem.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("JobSystem runs every job before waiting returns.", "[JobSystem][A09]") {
+  for (unsigned threads : { 1u, 4u })
+  {
+    GIVEN ("A JobSystem with " + std::to_string (threads) + " threads.") {
+      JobSystem jobs (threads);
+      REQUIRE (jobs.getThreadCount () == threads);
+      WHEN ("parallelFor runs over a range with a small grain.") {
+        std::vector<int> visits (10007, 0);
+        jobs.parallelFor (5, visits.size (), 16,
+                          [&visits] (size_t first, size_t last)
+        {
+          for (size_t index = first; index < last; ++index)
+            ++visits[index];
+        });
+        THEN ("Every index in the range was visited once, and no other.") {
+          for (size_t index = 0; index < visits.size (); ++index)
+            REQUIRE (visits[index] == (index < 5 ? 0 : 1));
+        }
+      }
+      WHEN ("Parent jobs run children with their own Counter.") {
+        const int PARENTS = 50;
+        const int CHILDREN = 20;
+        std::atomic<int> ran (0);
+        JobSystem::Counter counter;
+        for (int parent = 0; parent < PARENTS; ++parent)
+        {
+          jobs.run ([&] ()
+          {
+            for (int child = 0; child < CHILDREN; ++child)
+            {
+              jobs.run ([&ran] () { ++ran; }, counter);
+            }
+            ++ran;
+          }, counter);
+        }
+        jobs.wait (counter);
+        THEN ("Waiting on it waits for the children too.") {
+          REQUIRE (counter.isDone ());
+          REQUIRE (ran == PARENTS * (CHILDREN + 1));
+        }
+      }
+      WHEN ("A job waits on a nested parallelFor.") {
+        std::vector<int> sums (8, 0);
+        jobs.parallelFor (0, sums.size (), 1,
+                          [&jobs, &sums] (size_t first, size_t)
+        {
+          std::vector<int> values (100, 0);
+          jobs.parallelFor (0, values.size (), 10,
+                            [&values, first] (size_t from, size_t to)
+          {
+            for (size_t index = from; index < to; ++index)
+              values[index] = static_cast<int> (first);
+          });
+          for (int value : values)
+            sums[first] += value;
+        });
+        THEN ("Every inner range finished before its outer job went on.") {
+          for (size_t outer = 0; outer < sums.size (); ++outer)
+            REQUIRE (sums[outer] == 100 * static_cast<int> (outer));
+        }
+      }
+    }
+  }
+}
@@ -117,7 +117,7 @@ SCENARIO ("Matrix3 constructors.", "[Matrix3][A05]") {
       Vector3 back = matrix.getBack();
       THEN ("The 3 vectors are orthogonal.") {
         REQUIRE (right.dot(back) == Approx (0.0f));
-        REQUIRE (right.dot(up) == Approx (0.0f))
+        REQUIRE (right.dot(up) == Approx (0.0f));
         REQUIRE (up.dot(back) == Approx (0.0f));
       }
       THEN ("The 3 vectors have length 1.") {
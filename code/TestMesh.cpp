@@ -0,0 +1,109 @@
+/// \file TestMesh.cpp
+/// \brief A collection of Catch2 unit tests for how Meshes upload and draw
+///   their indices, rendered on the CPU.
+/// \author Justin Stevens
+/// \version A09
+
+#include <cstdint>
+#include <vector>
+
+#include "Camera.hpp"
+#include "ColorsMesh.hpp"
+#include "Geometry.hpp"
+#include "SceneTestFixture.hpp"
+#include "SoftwareOpenGLContext.hpp"
+#include "UniformBlocks.hpp"
+#include "UniformBuffer.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+static const GLsizei WIDTH = 48;
+static const GLsizei HEIGHT = 32;
+
+// A colored unit cube, after skip unused vertices, so that its indices start
+//   at skip.
+static void
+addSkippingCube (Mesh* mesh, unsigned skip)
+{
+  std::vector<Triangle> faces = buildCube ();
+  std::vector<float> geometry;
+  std::vector<Vector3> colors = generateRandomVertexColors (faces);
+  for (size_t i = 0; i < faces.size () * 3; ++i)
+  {
+    const Vector3& position = faces[i / 3][i % 3];
+    geometry.insert (geometry.end (), { position.m_x, position.m_y,
+                                        position.m_z, colors[i].m_x,
+                                        colors[i].m_y, colors[i].m_z });
+  }
+  std::vector<float> data;
+  std::vector<unsigned> indices;
+  indexData (geometry, mesh->getFloatsPerVertex (), data, indices);
+  mesh->addGeometry (std::vector<float> (skip * mesh->getFloatsPerVertex (),
+                                         0.0f));
+  mesh->addGeometry (data);
+  for (unsigned& index : indices)
+  {
+    index += skip;
+  }
+  mesh->addIndices (indices);
+  mesh->prepareVao ();
+}
+
+// The frame with only a Mesh drawn in it.
+static std::vector<std::uint32_t>
+drawAlone (SoftwareOpenGLContext& context, Mesh* mesh, Camera& camera)
+{
+  context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  mesh->draw (&camera);
+  return readPixels (context, WIDTH, HEIGHT);
+}
+
+SCENARIO ("A Mesh uploads its indices in 16 bits when they fit.", "[Mesh][A09]") {
+  GIVEN ("Two cubes, one of whose indices reach past 65535.") {
+    SoftwareOpenGLContext context (WIDTH, HEIGHT, 1);
+    context.enable (GL_DEPTH_TEST);
+    ShaderProgram* program = createShaderProgram (&context, "Vec3");
+    Camera camera (Vector3 (1.0f, 1.5f, 3.0f), Vector3 (0.3f, 0.5f, 1.0f),
+                   0.1, 50.0, static_cast<double> (WIDTH) / HEIGHT, 60.0);
+    FrameUniforms frame = {};
+    copyToBlock (frame.view, camera.getViewMatrix ());
+    copyToBlock (frame.projection, camera.getProjectionMatrix ());
+    UniformBuffer frameBuffer (&context, sizeof (frame));
+    frameBuffer.update (&frame, sizeof (frame));
+    frameBuffer.bind (FRAME_BLOCK_BINDING);
+
+    ColorsMesh small (&context, program);
+    addSkippingCube (&small, 0);
+    ColorsMesh large (&context, program);
+    addSkippingCube (&large, 70000);
+    THEN ("Each picks the smallest type its indices fit, and sizes its buffer by it.") {
+      REQUIRE (small.getIndexType () == GL_UNSIGNED_SHORT);
+      REQUIRE (small.getIndexBufferSize () == small.getIndices ().size () * 2);
+      REQUIRE (large.getIndexType () == GL_UNSIGNED_INT);
+      REQUIRE (large.getIndexBufferSize () == large.getIndices ().size () * 4);
+    }
+    THEN ("Both draw the same cube.") {
+      std::vector<std::uint32_t> shortFrame = drawAlone (context, &small, camera);
+      std::vector<std::uint32_t> intFrame = drawAlone (context, &large, camera);
+      REQUIRE (shortFrame == intFrame);
+      REQUIRE (shortFrame != std::vector<std::uint32_t> (WIDTH * HEIGHT,
+                                                         shortFrame.front ()));
+    }
+    WHEN ("The small cube is streamed with indices past 65535.") {
+      std::vector<float> vertices (70000 * small.getFloatsPerVertex (), 0.0f);
+      vertices.insert (vertices.end (), small.getVertices ().begin (),
+                       small.getVertices ().end ());
+      std::vector<unsigned> indices = small.getIndices ();
+      std::vector<std::uint32_t> before = drawAlone (context, &small, camera);
+      for (unsigned& index : indices)
+        index += 70000;
+      small.stream (vertices, indices);
+      THEN ("It switches to 32 bits, and draws the same.") {
+        REQUIRE (small.getIndexType () == GL_UNSIGNED_INT);
+        REQUIRE (drawAlone (context, &small, camera) == before);
+      }
+    }
+    delete program;
+  }
+}
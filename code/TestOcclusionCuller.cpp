@@ -0,0 +1,263 @@
+/// \file TestOcclusionCuller.cpp
+/// \brief A collection of Catch2 unit tests for hiding Meshes behind
+///   occluders drawn into a depth buffer on the CPU.
+/// \author Justin Stevens
+/// \version A09
+
+#include <vector>
+
+#include "Camera.hpp"
+#include "JobSystem.hpp"
+#include "OcclusionCuller.hpp"
+#include "RecordingOpenGLContext.hpp"
+#include "SceneTestFixture.hpp"
+#include "SoftwareOpenGLContext.hpp"
+#include "Scenes/Scene.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+static const GLsizei WIDTH = 96;
+static const GLsizei HEIGHT = 64;
+
+// A square facing +z, 2 * halfSize across, centered on (x, 0, z).
+static void
+makeSquare (float x, float z, float halfSize, std::vector<float>& vertices,
+            std::vector<unsigned>& indices)
+{
+  vertices = { x - halfSize, -halfSize, z,  x + halfSize, -halfSize, z,
+               x + halfSize, halfSize, z,   x - halfSize, halfSize, z };
+  indices = { 0, 1, 2,  0, 2, 3 };
+}
+
+// A box of a given size centered on a point, placed by an identity world.
+static OcclusionCuller::Box
+makeBox (const Vector3& center, float halfSize, const Matrix4& world)
+{
+  OcclusionCuller::Box box;
+  box.low = center - Vector3 (halfSize);
+  box.high = center + Vector3 (halfSize);
+  box.world = &world;
+  return box;
+}
+
+SCENARIO ("An OcclusionCuller hides boxes behind occluders.", "[OcclusionCuller][A09]") {
+  GIVEN ("A camera at the origin looking down -z at a wall 10 away that covers the left half of the screen.") {
+    Matrix4 projection;
+    projection.setToPerspectiveProjection (60.0, 2.0, 0.1, 100.0);
+    Matrix4 identity;
+    std::vector<float> vertices;
+    std::vector<unsigned> indices;
+    makeSquare (-20.0f, -10.0f, 20.0f, vertices, indices);
+    OcclusionCuller culler (64, 32);
+    culler.beginFrame (projection);
+    culler.addOccluder (vertices, indices, 3, identity);
+    culler.rasterize ();
+    THEN ("Only the left half of the depth buffer holds the wall.") {
+      REQUIRE (culler.getStats ().occluders == 1);
+      REQUIRE (culler.getStats ().triangles == 2);
+      REQUIRE (culler.getDepth (5, 16) < 1.0f);
+      REQUIRE (culler.getDepth (31, 16) < 1.0f);
+      REQUIRE (culler.getDepth (32, 16) == 1.0f);
+      REQUIRE (culler.getTileDepth (0, 0) < 1.0f);
+      REQUIRE (culler.getTileDepth (7, 0) == 1.0f);
+    }
+    THEN ("A box behind the wall is hidden.") {
+      REQUIRE (culler.isOccluded (makeBox (Vector3 (-4.0f, 0.0f, -15.0f), 1.0f,
+                                           identity)));
+    }
+    THEN ("A box in front of the wall, or beside it, is not.") {
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (-4.0f, 0.0f, -6.0f),
+                                                 1.0f, identity)));
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (4.0f, 0.0f, -15.0f),
+                                                 1.0f, identity)));
+    }
+    THEN ("A box behind the wall that reaches past its edge is not.") {
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (-0.5f, 0.0f, -15.0f),
+                                                 1.0f, identity)));
+    }
+    THEN ("A box behind the wall that sticks out past its edge by less than a pixel is not.") {
+      // The wall's edge falls on x = 32 pixels, and the box's right side
+      //   within pixel 32, short of that pixel's center.
+      OcclusionCuller::Box box;
+      box.low = Vector3 (-1.0f, -0.5f, -15.01f);
+      box.high = Vector3 (0.2f, 0.5f, -14.99f);
+      box.world = &identity;
+      REQUIRE_FALSE (culler.isOccluded (box));
+      AND_THEN ("One that stops at the wall's edge is.") {
+        box.high.m_x = -0.1f;
+        REQUIRE (culler.isOccluded (box));
+      }
+    }
+    THEN ("A box around the camera, or partly off the screen, is not.") {
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (-1.0f, 0.0f, 0.0f),
+                                                 1.0f, identity)));
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (-30.0f, 0.0f, -15.0f),
+                                                 2.0f, identity)));
+    }
+    WHEN ("The wall is moved behind the boxes by its world matrix.") {
+      Matrix4 world (Vector4 (1.0f, 0.0f, 0.0f, 0.0f),
+                     Vector4 (0.0f, 1.0f, 0.0f, 0.0f),
+                     Vector4 (0.0f, 0.0f, 1.0f, 0.0f),
+                     Vector4 (0.0f, 0.0f, -20.0f, 1.0f));
+      culler.beginFrame (projection);
+      culler.addOccluder (vertices, indices, 3, world);
+      culler.rasterize ();
+      THEN ("The box it hid is seen again.") {
+        REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (-4.0f, 0.0f, -15.0f),
+                                                   1.0f, identity)));
+      }
+    }
+  }
+  GIVEN ("A wall crossing the near plane, seen at a slant.") {
+    Matrix4 viewProjection;
+    viewProjection.setToPerspectiveProjection (60.0, 1.0, 0.1, 100.0);
+    Matrix4 identity;
+    std::vector<float> vertices = { -1.0f, -5.0f, 5.0f,  -1.0f, -5.0f, -30.0f,
+                                    -1.0f, 5.0f, -30.0f,  -1.0f, 5.0f, 5.0f };
+    std::vector<unsigned> indices = { 0, 1, 2,  0, 2, 3 };
+    OcclusionCuller culler (64, 64);
+    culler.beginFrame (viewProjection);
+    culler.addOccluder (vertices, indices, 3, identity);
+    culler.rasterize ();
+    THEN ("It is clipped to what lies in front of the camera.") {
+      REQUIRE (culler.getStats ().triangles >= 2);
+      REQUIRE (culler.getDepth (1, 32) < culler.getDepth (30, 32));
+      REQUIRE (culler.getDepth (40, 32) == 1.0f);
+    }
+    THEN ("A box beyond it is hidden, and one on the near side is not.") {
+      REQUIRE (culler.isOccluded (makeBox (Vector3 (-2.5f, 0.0f, -8.0f), 0.5f,
+                                           identity)));
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (0.5f, 0.0f, -8.0f),
+                                                 0.5f, identity)));
+    }
+  }
+  GIVEN ("A frame with no occluders in it.") {
+    Matrix4 projection;
+    projection.setToPerspectiveProjection (60.0, 2.0, 0.1, 100.0);
+    Matrix4 identity;
+    OcclusionCuller culler (64, 32);
+    culler.beginFrame (projection);
+    culler.rasterize ();
+    THEN ("A box too small to cover any pixel center is still tested, and not hidden.") {
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (0.0f, 0.0f, -20.0f),
+                                                 0.001f, identity)));
+      REQUIRE_FALSE (culler.isOccluded (makeBox (Vector3 (3.0f, 2.0f, -20.0f),
+                                                 0.001f, identity)));
+    }
+  }
+  GIVEN ("Many occluders and boxes.") {
+    Matrix4 projection;
+    projection.setToPerspectiveProjection (70.0, 1.5, 0.1, 100.0);
+    Matrix4 identity;
+    OcclusionCuller serial (128, 64);
+    OcclusionCuller threaded (128, 64);
+    serial.beginFrame (projection);
+    threaded.beginFrame (projection);
+    for (int i = 0; i < 30; ++i) {
+      std::vector<float> vertices;
+      std::vector<unsigned> indices;
+      makeSquare (i % 6 * 3.0f - 8.0f, -8.0f - i / 6 * 2.0f, 1.0f + i % 4 * 0.4f,
+                  vertices, indices);
+      serial.addOccluder (vertices, indices, 3, identity);
+      threaded.addOccluder (vertices, indices, 3, identity);
+    }
+    std::vector<OcclusionCuller::Box> boxes;
+    for (int i = 0; i < 200; ++i)
+      boxes.push_back (makeBox (Vector3 (i % 20 * 1.0f - 10.0f,
+                                         i / 20 % 5 * 0.6f - 1.5f,
+                                         -7.0f - i / 20 * 1.5f), 0.3f, identity));
+    WHEN ("One rasterizes and tests on this thread, and the other on three.") {
+      JobSystem jobs (3);
+      std::vector<unsigned char> serialHidden, threadedHidden;
+      serial.rasterize ();
+      serial.testBoxes (boxes, serialHidden);
+      threaded.rasterize (&jobs);
+      threaded.testBoxes (boxes, threadedHidden, &jobs);
+      THEN ("They agree on every pixel and every box.") {
+        for (unsigned y = 0; y < serial.getHeight (); ++y)
+          for (unsigned x = 0; x < serial.getWidth (); ++x)
+            REQUIRE (serial.getDepth (x, y) == threaded.getDepth (x, y));
+        REQUIRE (serialHidden == threadedHidden);
+        REQUIRE (serial.getStats ().tested == boxes.size ());
+        REQUIRE (serial.getStats ().occluded == threaded.getStats ().occluded);
+        REQUIRE (serial.getStats ().occluded > 0);
+        REQUIRE (serial.getStats ().occluded < boxes.size ());
+      }
+    }
+  }
+}
+
+SCENARIO ("A Scene skips the Meshes hidden behind its occluders.", "[OcclusionCuller][A09]") {
+  GIVEN ("A Scene with a wall between the camera and most of its cubes.") {
+    SoftwareOpenGLContext* software = new SoftwareOpenGLContext (WIDTH, HEIGHT, 2);
+    RecordingOpenGLContext context (software);
+    context.enable (GL_DEPTH_TEST);
+    context.enable (GL_CULL_FACE);
+    ShaderProgram* phong = createShaderProgram (&context);
+    JobSystem jobs (3);
+
+    {
+      Scene scene (&context, phong);
+      scene.setDynamicBatchLimit (0);
+      Material* material = new Material ();
+      scene.addMaterial (material);
+      scene.addLightSource (new DirectionalLightSource (
+        Vector3 (0.9f), Vector3 (0.4f), Vector3 (-0.3f, -1.0f, -0.5f)));
+      Mesh* wall = createCube (&context, phong, material);
+      wall->scaleLocal (3.0f, 3.0f, 0.2f);
+      wall->setOccluder (true);
+      scene.add ("Wall", wall);
+      const unsigned HIDDEN_COUNT = 12;
+      for (unsigned i = 0; i < HIDDEN_COUNT; ++i) {
+        Mesh* cube = createCube (&context, phong, material);
+        cube->moveWorld (1.0f, Vector3 (i % 4 * 0.6f - 0.9f, i / 4 * 0.6f - 0.6f,
+                                        -2.0f - i % 3));
+        cube->scaleLocal (0.3f);
+        scene.add ("Hidden" + std::to_string (i), cube);
+      }
+      const unsigned SEEN_COUNT = 4;
+      for (unsigned i = 0; i < SEEN_COUNT; ++i) {
+        Mesh* cube = createCube (&context, phong, material);
+        cube->moveWorld (1.0f, Vector3 (i * 0.8f - 1.2f, 0.0f, 1.5f));
+        cube->scaleLocal (0.3f);
+        scene.add ("Seen" + std::to_string (i), cube);
+      }
+      Camera camera (Vector3 (0.0f, 0.0f, 6.0f), Vector3 (0.0f, 0.0f, 1.0f),
+                     0.1, 50.0, static_cast<double> (WIDTH) / HEIGHT, 40.0);
+
+      scene.draw (&camera);
+      context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      context.resetStatistics ();
+      scene.draw (&camera);
+      std::vector<std::uint32_t> direct = readPixels (*software, WIDTH, HEIGHT);
+      REQUIRE (context.getDrawCallCount () == 1 + HIDDEN_COUNT + SEEN_COUNT);
+
+      WHEN ("It culls occluded Meshes on worker threads.") {
+        scene.setOcclusionCulling (true, &jobs);
+        context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        context.resetStatistics ();
+        scene.draw (&camera);
+        THEN ("The cubes behind the wall are not drawn, and the frame is the same.") {
+          const OcclusionCuller::Stats& stats = scene.getOcclusionStats ();
+          REQUIRE (stats.occluders == 1);
+          REQUIRE (stats.tested == HIDDEN_COUNT + SEEN_COUNT);
+          REQUIRE (stats.occluded == HIDDEN_COUNT);
+          REQUIRE (context.getDrawCallCount () == 1 + SEEN_COUNT);
+          REQUIRE (readPixels (*software, WIDTH, HEIGHT) == direct);
+        }
+        AND_WHEN ("The wall moves aside.") {
+          scene.getMesh ("Wall")->moveWorld (5.0f, Vector3 (1.0f, 0.0f, 0.0f));
+          context.clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          context.resetStatistics ();
+          scene.draw (&camera);
+          THEN ("Every cube is drawn again.") {
+            REQUIRE (scene.getOcclusionStats ().occluded == 0);
+            REQUIRE (context.getDrawCallCount () == 1 + HIDDEN_COUNT + SEEN_COUNT);
+          }
+        }
+      }
+    }
+    delete phong;
+  }
+}
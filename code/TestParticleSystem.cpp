@@ -0,0 +1,103 @@
+/// \file TestParticleSystem.cpp
+/// \brief A collection of Catch2 unit tests for the ParticleSystem class and
+///   its kernels.
+/// \author Justin Stevens
+/// \version A09
+
+#include <random>
+#include <vector>
+
+#include "ParticleSystem.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("ParticleSystem bounces particles off the walls.", "[ParticleSystem][A09]") {
+  GIVEN ("Two particles heading out of a 2-wide box.") {
+    ParticleSystem particles;
+    particles.setBounds (-1.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f);
+    particles.add (Vector3 (0.5f, 0.0f, 0.0f), Vector3 (1.0f, 0.0f, 0.0f),
+                   0.25f);
+    particles.add (Vector3 (0.0f, 0.0f, 0.0f), Vector3 (0.0f, -1.0f, 2.0f),
+                   0.25f);
+    WHEN ("They move far enough to reach the walls.") {
+      particles.step (0.5f);
+      THEN ("They have moved and the components that reached turned around.") {
+        REQUIRE (particles.getPosition (0).m_x == Approx (1.0f));
+        REQUIRE (particles.getVelocity (0).m_x == Approx (-1.0f));
+        REQUIRE (particles.getVelocity (1).m_y == Approx (-1.0f));
+        REQUIRE (particles.getVelocity (1).m_z == Approx (-2.0f));
+      }
+    }
+  }
+  GIVEN ("Tens of thousands of random particles, not a multiple of 8.") {
+    const size_t COUNT = 40003;
+    ParticleSystem scalar;
+    ParticleSystem threaded;
+    std::mt19937 random (375);
+    std::uniform_real_distribution<float> place (-10.0f, 10.0f);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+      Vector3 position (place (random), place (random), place (random));
+      Vector3 velocity (place (random), place (random), place (random));
+      float radius = 0.1f + 0.05f * (i % 7);
+      scalar.add (position, velocity, radius);
+      threaded.add (position, velocity, radius);
+    }
+    scalar.setBounds (-8.0f, 8.0f, 8.0f, -8.0f, 8.0f, -8.0f);
+    threaded.setBounds (-8.0f, 8.0f, 8.0f, -8.0f, 8.0f, -8.0f);
+    WHEN ("The same steps are taken by the scalar kernel and by the default "
+          "kernel on several threads.") {
+      std::vector<float> x (COUNT), y (COUNT), z (COUNT);
+      std::vector<float> velocityX (COUNT), velocityY (COUNT),
+        velocityZ (COUNT), radius (COUNT);
+      for (size_t i = 0; i < COUNT; ++i)
+      {
+        Vector3 position = scalar.getPosition (i);
+        Vector3 velocity = scalar.getVelocity (i);
+        x[i] = position.m_x;
+        y[i] = position.m_y;
+        z[i] = position.m_z;
+        velocityX[i] = velocity.m_x;
+        velocityY[i] = velocity.m_y;
+        velocityZ[i] = velocity.m_z;
+        radius[i] = 0.1f + 0.05f * (i % 7);
+      }
+      ParticleSpan span { x.data (), y.data (), z.data (), velocityX.data (),
+                          velocityY.data (), velocityZ.data (), radius.data (),
+                          COUNT };
+      const float low[3] = { -8.0f, -8.0f, -8.0f };
+      const float high[3] = { 8.0f, 8.0f, 8.0f };
+      JobSystem jobs (3);
+      for (int step = 0; step < 100; ++step)
+      {
+        integrateParticlesScalar (span, 1.0f / 60.0f, low, high);
+        threaded.step (1.0f / 60.0f, &jobs);
+      }
+      THEN ("Every particle ends up exactly the same.") {
+        bool isSame = true;
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+          Vector3 position = threaded.getPosition (i);
+          Vector3 velocity = threaded.getVelocity (i);
+          isSame = isSame && position.m_x == x[i] && position.m_y == y[i]
+            && position.m_z == z[i] && velocity.m_x == velocityX[i]
+            && velocity.m_y == velocityY[i] && velocity.m_z == velocityZ[i];
+        }
+        REQUIRE (isSame);
+      }
+    }
+    WHEN ("Their world matrices are written out.") {
+      std::vector<float> matrices;
+      JobSystem jobs (2);
+      scalar.writeWorldMatrices (matrices, &jobs);
+      THEN ("Each scales by the radius and moves to the position.") {
+        REQUIRE (matrices.size () == 16 * COUNT);
+        REQUIRE (matrices[16 * 5 + 0] == Approx (0.1f + 0.05f * 5));
+        REQUIRE (matrices[16 * 5 + 12] == scalar.getPosition (5).m_x);
+        REQUIRE (matrices[16 * 5 + 14] == scalar.getPosition (5).m_z);
+        REQUIRE (matrices[16 * 5 + 15] == 1.0f);
+      }
+    }
+  }
+}
@@ -0,0 +1,245 @@
+/// \file TestPathTracer.cpp
+/// \brief A collection of Catch2 unit tests for the Bvh and PathTracer
+///   classes.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "Bvh.hpp"
+#include "Camera.hpp"
+#include "PathTracer.hpp"
+#include "SceneTestFixture.hpp"
+#include "SoftwareOpenGLContext.hpp"
+#include "Scenes/Scene.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+// Random triangles about a unit across, scattered through a box 10 across.
+static std::vector<Vector3>
+makeTriangles (std::mt19937& random, unsigned count)
+{
+  std::uniform_real_distribution<float> place (-5.0f, 5.0f);
+  std::uniform_real_distribution<float> offset (-0.6f, 0.6f);
+  std::vector<Vector3> vertices;
+  for (unsigned i = 0; i < count; ++i)
+  {
+    Vector3 center (place (random), place (random), place (random));
+    for (int corner = 0; corner < 3; ++corner)
+    {
+      vertices.push_back (center + Vector3 (offset (random), offset (random),
+                                            offset (random)));
+    }
+  }
+  return vertices;
+}
+
+// The closest hit of a ray, found by testing every triangle.
+static bool
+intersectAll (const std::vector<Vector3>& vertices, const Vector3& origin,
+              const Vector3& direction, float maxDistance,
+              bool isCullingBackFaces, BvhHit& hit)
+{
+  bool isHit = false;
+  for (unsigned i = 0; i < vertices.size () / 3; ++i)
+  {
+    Vector3 edge1 = vertices[3 * i + 1] - vertices[3 * i];
+    Vector3 edge2 = vertices[3 * i + 2] - vertices[3 * i];
+    Vector3 p = direction.cross (edge2);
+    float determinant = edge1.dot (p);
+    if (std::abs (determinant) < 1e-12f
+        || (isCullingBackFaces && determinant < 0.0f))
+      continue;
+    Vector3 s = origin - vertices[3 * i];
+    float u = s.dot (p) / determinant;
+    Vector3 q = s.cross (edge1);
+    float v = direction.dot (q) / determinant;
+    float distance = edge2.dot (q) / determinant;
+    if (u < 0.0f || v < 0.0f || u + v > 1.0f || distance <= 0.0f
+        || distance >= maxDistance)
+      continue;
+    hit = BvhHit { distance, i, u, v };
+    maxDistance = distance;
+    isHit = true;
+  }
+  return isHit;
+}
+
+SCENARIO ("A Bvh finds the same hits as testing every triangle.", "[Bvh][A09]") {
+  GIVEN ("A Bvh over a thousand random triangles, and rays through them.") {
+    std::mt19937 random (11);
+    std::vector<Vector3> vertices = makeTriangles (random, 1000);
+    Bvh bvh;
+    bvh.build (vertices);
+    std::uniform_real_distribution<float> place (-8.0f, 8.0f);
+    std::uniform_real_distribution<float> turn (-1.0f, 1.0f);
+    const unsigned RAY_COUNT = 400;
+    std::vector<Vector3> origins, directions;
+    for (unsigned i = 0; i < RAY_COUNT; ++i)
+    {
+      origins.push_back (Vector3 (place (random), place (random), 8.0f));
+      directions.push_back (Vector3 (turn (random), turn (random), -1.0f));
+    }
+    REQUIRE (bvh.getTriangleCount () == 1000);
+    REQUIRE (bvh.getNodeCount () > 1);
+
+    THEN ("Every ray hits the triangle, if any, that is closest.") {
+      unsigned hitCount = 0;
+      for (unsigned i = 0; i < RAY_COUNT; ++i)
+      {
+        BvhHit expected, actual;
+        bool isExpected = intersectAll (vertices, origins[i], directions[i],
+                                        100.0f, false, expected);
+        REQUIRE (bvh.intersect (origins[i], directions[i], 100.0f, actual)
+                 == isExpected);
+        REQUIRE (bvh.isOccluded (origins[i], directions[i], 100.0f)
+                 == isExpected);
+        if (isExpected)
+        {
+          ++hitCount;
+          REQUIRE (actual.triangle == expected.triangle);
+          REQUIRE (actual.distance == Approx (expected.distance));
+          REQUIRE (actual.u == Approx (expected.u).margin (1e-5));
+          REQUIRE (actual.v == Approx (expected.v).margin (1e-5));
+        }
+      }
+      // Enough rays hit and miss for the comparison to mean something.
+      REQUIRE (hitCount > RAY_COUNT / 10);
+      REQUIRE (hitCount < RAY_COUNT);
+    }
+    THEN ("Packets of rays hit what each ray does alone, with and without back faces.") {
+      for (bool isCulling : { false, true })
+      {
+        for (unsigned first = 0; first < RAY_COUNT; first += Bvh::PACKET_SIZE)
+        {
+          BvhHit hits[Bvh::PACKET_SIZE];
+          bool isHit[Bvh::PACKET_SIZE];
+          bvh.intersectPacket (&origins[first], &directions[first], 100.0f,
+                               hits, isHit, isCulling);
+          for (int r = 0; r < Bvh::PACKET_SIZE; ++r)
+          {
+            BvhHit expected;
+            REQUIRE (isHit[r] == intersectAll (vertices, origins[first + r],
+                                               directions[first + r], 100.0f,
+                                               isCulling, expected));
+            if (isHit[r])
+            {
+              REQUIRE (hits[r].triangle == expected.triangle);
+              REQUIRE (hits[r].distance == Approx (expected.distance));
+            }
+          }
+        }
+      }
+    }
+    THEN ("Nothing beyond the maximum distance is hit.") {
+      BvhHit hit;
+      for (unsigned i = 0; i < RAY_COUNT; ++i)
+        REQUIRE_FALSE (bvh.intersect (origins[i], directions[i], 0.5f, hit));
+    }
+  }
+  GIVEN ("An empty Bvh.") {
+    Bvh bvh;
+    THEN ("No ray hits it.") {
+      BvhHit hit;
+      REQUIRE_FALSE (bvh.intersect (Vector3 (0.0f), Vector3 (0.0f, 0.0f, -1.0f),
+                                    100.0f, hit));
+      REQUIRE_FALSE (bvh.isOccluded (Vector3 (0.0f),
+                                     Vector3 (0.0f, 0.0f, -1.0f), 100.0f));
+    }
+  }
+}
+
+SCENARIO ("A PathTracer renders a Scene the same on any number of threads.", "[PathTracer][A09]") {
+  GIVEN ("A lit cube on a floor.") {
+    SoftwareOpenGLContext context (8, 8, 1);
+    ShaderProgram* phong = createShaderProgram (&context);
+    {
+      Scene scene (&context, phong);
+      Material* material = new Material (Vector3 (0.1f), Vector3 (0.8f),
+                                         Vector3 (0.0f), Vector3 (0.0f), 1.0f);
+      scene.addMaterial (material);
+      scene.addLightSource (new DirectionalLightSource (
+        Vector3 (0.9f), Vector3 (0.4f), Vector3 (-0.3f, -1.0f, -0.5f)));
+      Mesh* floor = createCube (&context, phong, material);
+      floor->moveWorld (1.0f, Vector3 (0.0f, -1.0f, 0.0f));
+      floor->scaleLocal (6.0f, 0.2f, 6.0f);
+      scene.add ("Floor", floor);
+      Mesh* cube = createCube (&context, phong, material);
+      cube->yaw (30.0f);
+      scene.add ("Cube", cube);
+      Camera camera (Vector3 (1.0f, 2.0f, 5.0f), Vector3 (0.2f, 0.4f, 1.0f),
+                     0.1, 50.0, 1.5, 50.0);
+
+      const unsigned WIDTH = 24, HEIGHT = 16;
+      PathTracer serial (scene, 1);
+      serial.setSeed (375);
+      serial.render (&camera, WIDTH, HEIGHT, 4);
+      PathTracer threaded (scene, 4);
+      threaded.setSeed (375);
+      threaded.render (&camera, WIDTH, HEIGHT, 4);
+      THEN ("Every pixel is exactly the same.") {
+        REQUIRE (serial.getTriangleCount () == 24);
+        REQUIRE (serial.getSampleCount () == 4);
+        REQUIRE (threaded.getSampleCount () == 4);
+        bool isAllBlack = true;
+        for (unsigned y = 0; y < HEIGHT; ++y)
+        {
+          for (unsigned x = 0; x < WIDTH; ++x)
+          {
+            Vector3 expected = serial.getPixel (x, y);
+            Vector3 actual = threaded.getPixel (x, y);
+            REQUIRE (actual.m_x == expected.m_x);
+            REQUIRE (actual.m_y == expected.m_y);
+            REQUIRE (actual.m_z == expected.m_z);
+            isAllBlack = isAllBlack && expected.m_x == 0.0f;
+          }
+        }
+        REQUIRE_FALSE (isAllBlack);
+      }
+      WHEN ("A different seed is used.") {
+        threaded.setSeed (376);
+        threaded.render (&camera, WIDTH, HEIGHT, 4);
+        THEN ("Some pixel differs.") {
+          bool isDifferent = false;
+          for (unsigned y = 0; y < HEIGHT; ++y)
+            for (unsigned x = 0; x < WIDTH; ++x)
+              isDifferent = isDifferent
+                || !(threaded.getPixel (x, y) == serial.getPixel (x, y));
+          REQUIRE (isDifferent);
+        }
+      }
+      WHEN ("The floor's light is baked.") {
+        Lightmap lightmap = threaded.bakeLightmap ("Floor", 32, 32, 2);
+        THEN ("It has a texel for every place and a corner for every index.") {
+          REQUIRE (lightmap.width == 32);
+          REQUIRE (lightmap.height == 32);
+          REQUIRE (lightmap.texels.size () == 3 * 32 * 32);
+          REQUIRE (lightmap.uvs.size () == 2 * floor->getIndices ().size ());
+          float brightest = 0.0f;
+          for (float texel : lightmap.texels)
+          {
+            REQUIRE (std::isfinite (texel));
+            REQUIRE (texel >= 0.0f);
+            brightest = std::max (brightest, texel);
+          }
+          REQUIRE (brightest > 0.0f);
+          for (float uv : lightmap.uvs)
+          {
+            REQUIRE (uv >= 0.0f);
+            REQUIRE (uv <= 1.0f);
+          }
+        }
+        THEN ("Baking a Mesh the Scene does not have throws.") {
+          REQUIRE_THROWS_AS (threaded.bakeLightmap ("Ceiling", 8, 8, 1),
+                             std::invalid_argument);
+        }
+      }
+    }
+    delete phong;
+  }
+}
@@ -0,0 +1,134 @@
+/// \file TestPhongKernel.cpp
+/// \brief A collection of Catch2 unit tests for the Phong kernels.
+/// \author Justin Stevens
+/// \version A09
+
+#include <cmath>
+#include <random>
+
+#include "PhongKernel.hpp"
+#include "LightSource.hpp"
+#include "Vector3.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+// A material with a white specular reflection and the given power.
+static MaterialUniforms
+makeMaterial (float specularPower)
+{
+  MaterialUniforms material = {};
+  material.specularReflection[0] = 1.0f;
+  material.specularReflection[1] = 1.0f;
+  material.specularReflection[2] = 1.0f;
+  material.specularPower = specularPower;
+  return material;
+}
+
+// Fills every lane with random positions in a box around the origin, random
+//   unit normals and random diffuse reflections.
+static void
+randomizeFragments (std::mt19937& random, PhongFragments& fragments)
+{
+  std::uniform_real_distribution<float> coordinate (-5.0f, 5.0f);
+  std::uniform_real_distribution<float> reflection (0.0f, 1.0f);
+  for (int lane = 0; lane < PHONG_BATCH_SIZE; ++lane)
+  {
+    fragments.positionX[lane] = coordinate (random);
+    fragments.positionY[lane] = coordinate (random);
+    fragments.positionZ[lane] = coordinate (random);
+    Vector3 normal (coordinate (random), coordinate (random),
+                    coordinate (random) + 0.01f);
+    normal.normalize ();
+    fragments.normalX[lane] = normal.m_x;
+    fragments.normalY[lane] = normal.m_y;
+    fragments.normalZ[lane] = normal.m_z;
+    fragments.diffuseR[lane] = reflection (random);
+    fragments.diffuseG[lane] = reflection (random);
+    fragments.diffuseB[lane] = reflection (random);
+  }
+}
+
+SCENARIO ("The scalar Phong kernel matches the shader.", "[PhongKernel][A09]") {
+  GIVEN ("A directional light shining straight down onto upward fragments.") {
+    MaterialUniforms material = makeMaterial (16.0f);
+    LightUniforms light = {};
+    DirectionalLightSource (Vector3 (0.5f, 0.25f, 1.0f),
+                            Vector3 (0.2f, 0.2f, 0.2f),
+                            Vector3 (0.0f, -1.0f, 0.0f)).writeUniforms (light);
+    PhongFragments fragments = {};
+    for (int lane = 0; lane < PHONG_BATCH_SIZE; ++lane)
+    {
+      fragments.positionX[lane] = static_cast<float> (lane);
+      fragments.normalY[lane] = lane % 2 == 0 ? 1.0f : -1.0f;
+      fragments.diffuseR[lane] = 1.0f;
+      fragments.diffuseG[lane] = 1.0f;
+      fragments.diffuseB[lane] = 1.0f;
+    }
+    WHEN ("The eye is directly above the first fragment.") {
+      float eye[3] = { 0.0f, 10.0f, 0.0f };
+      PhongColors colors = {};
+      shadePhongScalar (material, eye, &light, 1, fragments, colors);
+      THEN ("It gets the full diffuse and specular light.") {
+        REQUIRE (colors.red[0] == Approx (0.7f));
+        REQUIRE (colors.green[0] == Approx (0.45f));
+        REQUIRE (colors.blue[0] == Approx (1.2f));
+      }
+      THEN ("Fragments facing away from the light get nothing.") {
+        for (int lane = 1; lane < PHONG_BATCH_SIZE; lane += 2)
+        {
+          REQUIRE (colors.red[lane] == 0.0f);
+          REQUIRE (colors.green[lane] == 0.0f);
+          REQUIRE (colors.blue[lane] == 0.0f);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("The AVX2 Phong kernel matches the scalar one.", "[PhongKernel][A09]") {
+  GIVEN ("Random fragments lit by one light of each type.") {
+    std::mt19937 random (375);
+    MaterialUniforms material = makeMaterial (32.0f);
+    LightUniforms lights[3] = {};
+    DirectionalLightSource (Vector3 (0.3f, 0.3f, 0.3f),
+                            Vector3 (0.5f, 0.5f, 0.5f),
+                            Vector3 (-1.0f, -2.0f, -0.5f))
+      .writeUniforms (lights[0]);
+    PointLightSource (Vector3 (0.8f, 0.4f, 0.2f), Vector3 (1.0f, 1.0f, 1.0f),
+                      Vector3 (1.0f, 3.0f, 2.0f), Vector3 (1.0f, 0.1f, 0.01f))
+      .writeUniforms (lights[1]);
+    SpotLightSource (Vector3 (0.2f, 0.9f, 0.4f), Vector3 (1.0f, 1.0f, 1.0f),
+                     Vector3 (0.0f, 6.0f, 0.0f), Vector3 (1.0f, 0.0f, 0.02f),
+                     Vector3 (0.0f, -1.0f, 0.0f), std::cos (0.6f), 4.0f)
+      .writeUniforms (lights[2]);
+    float eye[3] = { 2.0f, 4.0f, 12.0f };
+    WHEN ("Many batches are shaded by both kernels.") {
+      THEN ("They agree to within the accuracy of the AVX2 pow.") {
+        if (!hasAvx2PhongKernel ())
+        {
+          WARN ("This CPU has no AVX2, so only the scalar kernel is tested.");
+          return;
+        }
+        for (int batch = 0; batch < 1000; ++batch)
+        {
+          PhongFragments fragments;
+          randomizeFragments (random, fragments);
+          PhongColors expected = {};
+          PhongColors actual = {};
+          shadePhongScalar (material, eye, lights, 3, fragments, expected);
+          shadePhongAvx2 (material, eye, lights, 3, fragments, actual);
+          for (int lane = 0; lane < PHONG_BATCH_SIZE; ++lane)
+          {
+            REQUIRE (actual.red[lane]
+                     == Approx (expected.red[lane]).epsilon (1e-4).margin (1e-6));
+            REQUIRE (actual.green[lane]
+                     == Approx (expected.green[lane]).epsilon (1e-4).margin (1e-6));
+            REQUIRE (actual.blue[lane]
+                     == Approx (expected.blue[lane]).epsilon (1e-4).margin (1e-6));
+          }
+        }
+      }
+    }
+  }
+}
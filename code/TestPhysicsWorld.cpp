@@ -0,0 +1,113 @@
+/// \file TestPhysicsWorld.cpp
+/// \brief A collection of Catch2 unit tests for the PhysicsWorld class.
+/// \author Justin Stevens
+/// \version A09
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "PhysicsWorld.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("PhysicsWorld bounces bodies off each other.", "[PhysicsWorld][A09]") {
+  GIVEN ("Two equal spheres moving toward each other.") {
+    PhysicsWorld world;
+    unsigned left = world.addSphere (Vector3 (-1.05f, 0.0f, 0.0f),
+                                     Vector3 (1.0f, 0.0f, 0.0f), 1.0f);
+    unsigned right = world.addSphere (Vector3 (1.05f, 0.0f, 0.0f),
+                                      Vector3 (-2.0f, 0.0f, 0.0f), 1.0f);
+    WHEN ("They meet.") {
+      world.step (0.1f);
+      THEN ("They swap velocities and no longer overlap.") {
+        REQUIRE (world.getContacts ().size () == 1);
+        REQUIRE (world.getVelocity (left).m_x == Approx (-2.0f));
+        REQUIRE (world.getVelocity (right).m_x == Approx (1.0f));
+        float gap = world.getPosition (right).m_x - world.getPosition (left).m_x;
+        REQUIRE (gap == Approx (2.0f));
+      }
+    }
+  }
+  GIVEN ("A sphere falling onto a box that cannot be pushed.") {
+    PhysicsWorld world;
+    unsigned floor = world.addBox (Vector3 (0.0f, -1.0f, 0.0f),
+                                   Vector3 (0.0f, 0.0f, 0.0f),
+                                   Vector3 (5.0f, 1.0f, 5.0f));
+    world.setMass (floor, 0.0f);
+    unsigned ball = world.addSphere (Vector3 (0.0f, 0.45f, 0.0f),
+                                     Vector3 (0.0f, -1.0f, 0.0f), 0.5f);
+    WHEN ("It lands.") {
+      world.step (0.1f);
+      THEN ("It bounces up and the box stays put.") {
+        REQUIRE (world.getContacts ().size () == 1);
+        REQUIRE (world.getVelocity (ball).m_y == Approx (1.0f));
+        REQUIRE (world.getPosition (ball).m_y == Approx (0.5f));
+        REQUIRE (world.getPosition (floor).m_y == -1.0f);
+      }
+    }
+  }
+  GIVEN ("Hundreds of spheres and boxes in a closed room.") {
+    PhysicsWorld sweep;
+    PhysicsWorld grid;
+    grid.setBroadphase (PhysicsWorld::Broadphase::UNIFORM_GRID);
+    std::mt19937 random (375);
+    std::uniform_real_distribution<float> place (-9.0f, 9.0f);
+    std::uniform_real_distribution<float> speed (-5.0f, 5.0f);
+    std::uniform_real_distribution<float> size (0.1f, 0.6f);
+    std::vector<Vector3> positions;
+    std::vector<Vector3> halfSizes;
+    for (int body = 0; body < 400; ++body)
+    {
+      Vector3 position (place (random), place (random), place (random));
+      Vector3 velocity (speed (random), speed (random), speed (random));
+      float radius = size (random);
+      Vector3 halfSize (radius, radius, radius);
+      if (body % 4 == 0)
+      {
+        halfSize.set (radius, size (random), size (random));
+        sweep.addBox (position, velocity, halfSize);
+        grid.addBox (position, velocity, halfSize);
+      }
+      else
+      {
+        sweep.addSphere (position, velocity, radius);
+        grid.addSphere (position, velocity, radius);
+      }
+      positions.push_back (position);
+      halfSizes.push_back (halfSize);
+    }
+    sweep.setBounds (-10.0f, 10.0f, 10.0f, -10.0f, 10.0f, -10.0f);
+    grid.setBounds (-10.0f, 10.0f, 10.0f, -10.0f, 10.0f, -10.0f);
+    WHEN ("Both broadphases look for pairs before anything moves.") {
+      sweep.step (0.0f);
+      grid.step (0.0f);
+      std::vector<PhysicsWorld::Pair> expected;
+      for (unsigned a = 0; a < positions.size (); ++a)
+      {
+        for (unsigned b = a + 1; b < positions.size (); ++b)
+        {
+          Vector3 distance = positions[b] - positions[a];
+          Vector3 reach = halfSizes[a] + halfSizes[b];
+          if (std::abs (distance.m_x) <= reach.m_x
+              && std::abs (distance.m_y) <= reach.m_y
+              && std::abs (distance.m_z) <= reach.m_z)
+          {
+            expected.emplace_back (a, b);
+          }
+        }
+      }
+      std::vector<PhysicsWorld::Pair> sweepPairs = sweep.getCandidatePairs ();
+      std::vector<PhysicsWorld::Pair> gridPairs = grid.getCandidatePairs ();
+      std::sort (sweepPairs.begin (), sweepPairs.end ());
+      std::sort (gridPairs.begin (), gridPairs.end ());
+      THEN ("They find the pairs whose bounding boxes overlap.") {
+        REQUIRE_FALSE (expected.empty ());
+        REQUIRE (sweepPairs == expected);
+        REQUIRE (gridPairs == expected);
+      }
+    }
+  }
+}
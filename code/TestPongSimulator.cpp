@@ -0,0 +1,79 @@
+/// \file TestPongSimulator.cpp
+/// \brief A collection of Catch2 unit tests for the Pong AI's decisions and
+///   the PongSimulator class.
+/// \author Justin Stevens
+/// \version A09
+
+#include "Scenes/Pong/PongSimulator.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("The Pong AI chases the ball.", "[PongSimulator][A09]") {
+  GIVEN ("A 2D paddle in the middle of the right side.") {
+    THEN ("It follows the ball on its half and returns to the middle otherwise.") {
+      REQUIRE (trackBall2D (Vector3 (3.0f, 2.0f, 0.0f), 0.0f, 0.0f, 0.0f, 0.5f) == 1);
+      REQUIRE (trackBall2D (Vector3 (3.0f, -2.0f, 0.0f), 0.0f, 0.0f, 0.0f, 0.5f) == -1);
+      REQUIRE (trackBall2D (Vector3 (-3.0f, 2.0f, 0.0f), 0.0f, 0.0f, 0.0f, 0.5f) == 0);
+      REQUIRE (trackBall2D (Vector3 (-3.0f, 2.0f, 0.0f), 2.0f, 0.0f, 0.0f, 0.5f) == -1);
+    }
+  }
+  GIVEN ("A 3D paddle with a margin of 1 and a top speed of 20.") {
+    PongAiParameters ai { 1.0f, 20.0f };
+    THEN ("It slows down as it closes in and stops within the margin.") {
+      REQUIRE (trackBall3D (15.0f, 0.0f, ai) == Approx (20.0f));
+      REQUIRE (trackBall3D (-5.0f, 0.0f, ai) == Approx (-15.0f));
+      REQUIRE (trackBall3D (0.5f, 0.0f, ai) == 0.0f);
+    }
+  }
+}
+
+SCENARIO ("PongSimulator plays many games the same way on any number of threads.", "[PongSimulator][A09]") {
+  for (PongSimulator::Rules rules : { PongSimulator::Rules::PONG_2D,
+                                      PongSimulator::Rules::PONG_3D }) {
+    GIVEN ("Two simulators with the same seed and AIs slow enough to miss.") {
+      const size_t GAMES = 1000;
+      PongSimulator serial (rules, GAMES, 7);
+      PongSimulator threaded (rules, GAMES, 7);
+      PongAiParameters slow = PongSimulator::getDefaultAi (rules);
+      slow.speed *= 0.4f;
+      for (unsigned side = 0; side < 2; ++side) {
+        serial.setAi (side, slow);
+        threaded.setAi (side, slow);
+      }
+      JobSystem jobs (3);
+      WHEN ("One is stepped on this thread and the other across a JobSystem.") {
+        for (int step = 0; step < 60 * 60; ++step) {
+          serial.step (1.0f / 60.0f);
+          threaded.step (1.0f / 60.0f, &jobs);
+        }
+        THEN ("Points have been played, and every game has the same score.") {
+          PongSimulator::Totals totals = serial.getTotals ();
+          REQUIRE (totals.steps == 60 * 60);
+          REQUIRE (totals.points[0] + totals.points[1] > GAMES);
+          REQUIRE (totals.hits > 0);
+          for (size_t game = 0; game < GAMES; ++game) {
+            REQUIRE (serial.getScore (game, 0) == threaded.getScore (game, 0));
+            REQUIRE (serial.getScore (game, 1) == threaded.getScore (game, 1));
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO ("PongSimulator tells a better AI from a worse one.", "[PongSimulator][A09]") {
+  GIVEN ("3D games where side 1's paddle is much slower.") {
+    PongSimulator simulator (PongSimulator::Rules::PONG_3D, 200, 11);
+    simulator.setAi (1, PongAiParameters { DEFAULT_MARGIN_3D, 2.0f });
+    WHEN ("They are played for a while.") {
+      for (int step = 0; step < 60 * 60; ++step) {
+        simulator.step (1.0f / 60.0f);
+      }
+      THEN ("Side 0 wins most of the points.") {
+        PongSimulator::Totals totals = simulator.getTotals ();
+        REQUIRE (totals.points[0] > 2 * totals.points[1]);
+      }
+    }
+  }
+}
@@ -0,0 +1,129 @@
+/// \file TestQuaternion.cpp
+/// \brief A collection of Catch2 unit tests for the Quaternion and
+///   QuaternionTransform classes.
+/// \author Justin Stevens
+/// \version A09
+
+#include "Vector3.hpp"
+#include "Matrix3.hpp"
+#include "Quaternion.hpp"
+#include "QuaternionTransform.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+// Compares two matrices column by column with Approx.
+static void
+requireMatrixApprox (const Matrix3& actual, const Matrix3& expected)
+{
+  Vector3 columns[3][2] = {
+    { actual.getRight(), expected.getRight() },
+    { actual.getUp(), expected.getUp() },
+    { actual.getBack(), expected.getBack() }
+  };
+  for (auto& c : columns)
+  {
+    REQUIRE (c[0].m_x == Approx (c[1].m_x).margin (0.0001));
+    REQUIRE (c[0].m_y == Approx (c[1].m_y).margin (0.0001));
+    REQUIRE (c[0].m_z == Approx (c[1].m_z).margin (0.0001));
+  }
+}
+
+SCENARIO ("Quaternion rotations.", "[Quaternion][A09]") {
+  GIVEN ("Quaternions built from the cardinal axes.") {
+    Quaternion qx (30.0f, Vector3 (1.0f, 0.0f, 0.0f));
+    Quaternion qy (45.0f, Vector3 (0.0f, 2.0f, 0.0f));
+    Quaternion qz (-60.0f, Vector3 (0.0f, 0.0f, 1.0f));
+    THEN ("They have unit length.") {
+      REQUIRE (qx.length() == Approx (1.0f));
+      REQUIRE (qy.length() == Approx (1.0f));
+      REQUIRE (qz.length() == Approx (1.0f));
+    }
+    THEN ("They convert to the same matrices as Matrix3.") {
+      Matrix3 m;
+      m.setToRotationX (30.0f);
+      requireMatrixApprox (qx.toMatrix3(), m);
+      m.setToRotationY (45.0f);
+      requireMatrixApprox (qy.toMatrix3(), m);
+      m.setToRotationZ (-60.0f);
+      requireMatrixApprox (qz.toMatrix3(), m);
+    }
+    THEN ("Products compose in the same order as matrix products.") {
+      Matrix3 mx, my;
+      mx.setToRotationX (30.0f);
+      my.setToRotationY (45.0f);
+      requireMatrixApprox ((qx * qy).toMatrix3(), mx * my);
+    }
+    THEN ("Rotating a vector matches the matrix.") {
+      Vector3 v (1.0f, 2.0f, 3.0f);
+      Vector3 expected = (qx * qz).toMatrix3() * v;
+      Vector3 actual = (qx * qz).rotate (v);
+      REQUIRE (actual.m_x == Approx (expected.m_x));
+      REQUIRE (actual.m_y == Approx (expected.m_y));
+      REQUIRE (actual.m_z == Approx (expected.m_z));
+    }
+    THEN ("Converting to a matrix and back gives the same rotation.") {
+      Quaternion q = qx * qy * qz;
+      Quaternion back;
+      back.setFromMatrix (q.toMatrix3());
+      requireMatrixApprox (back.toMatrix3(), q.toMatrix3());
+    }
+  }
+}
+
+SCENARIO ("Quaternion interpolation.", "[Quaternion][A09]") {
+  GIVEN ("Two rotations about the Y axis.") {
+    Quaternion q1 (0.0f, Vector3 (0.0f, 1.0f, 0.0f));
+    Quaternion q2 (90.0f, Vector3 (0.0f, 1.0f, 0.0f));
+    WHEN ("I slerp halfway.") {
+      Quaternion q = slerp (q1, q2, 0.5f);
+      THEN ("The result is the 45 degree rotation.") {
+        Matrix3 m;
+        m.setToRotationY (45.0f);
+        requireMatrixApprox (q.toMatrix3(), m);
+      }
+    }
+    WHEN ("I slerp or nlerp to the end points.") {
+      THEN ("The results are the end points.") {
+        requireMatrixApprox (slerp (q1, q2, 0.0f).toMatrix3(), q1.toMatrix3());
+        requireMatrixApprox (slerp (q1, q2, 1.0f).toMatrix3(), q2.toMatrix3());
+        requireMatrixApprox (nlerp (q1, q2, 1.0f).toMatrix3(), q2.toMatrix3());
+      }
+    }
+  }
+}
+
+SCENARIO ("QuaternionTransform matches Transform.", "[QuaternionTransform][A09]") {
+  GIVEN ("A Transform and a QuaternionTransform.") {
+    Transform t;
+    QuaternionTransform q;
+    WHEN ("I apply the same moves, rotations, and scales to both.") {
+      t.moveBack (2.0f);
+      q.moveBack (2.0f);
+      t.yaw (30.0f);
+      q.yaw (30.0f);
+      t.pitch (-20.0f);
+      q.pitch (-20.0f);
+      t.scaleLocal (2.0f, 1.0f, 0.5f);
+      q.scaleLocal (2.0f, 1.0f, 0.5f);
+      t.moveRight (1.5f);
+      q.moveRight (1.5f);
+      t.rotateWorld (45.0f, Vector3 (0.0f, 0.0f, 1.0f));
+      q.rotateWorld (45.0f, Vector3 (0.0f, 0.0f, 1.0f));
+      THEN ("They represent the same transform.") {
+        Transform converted = q.toTransform();
+        requireMatrixApprox (converted.getOrientation(), t.getOrientation());
+        Vector3 p = q.getPosition();
+        REQUIRE (p.m_x == Approx (t.getPosition().m_x));
+        REQUIRE (p.m_y == Approx (t.getPosition().m_y));
+        REQUIRE (p.m_z == Approx (t.getPosition().m_z));
+      }
+      THEN ("Converting the Transform back recovers the scale.") {
+        QuaternionTransform fromT (t);
+        REQUIRE (fromT.getScale().m_x == Approx (2.0f));
+        REQUIRE (fromT.getScale().m_y == Approx (1.0f));
+        REQUIRE (fromT.getScale().m_z == Approx (0.5f));
+      }
+    }
+  }
+}
@@ -0,0 +1,98 @@
+/// \file TestSceneGraph.cpp
+/// \brief A collection of Catch2 unit tests for the SceneGraph class.
+/// \author Justin Stevens
+/// \version A09
+
+#include "SceneGraph.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+// A transform that only moves.
+static Transform
+translation (float x, float y, float z)
+{
+  Transform transform;
+  transform.setPosition (x, y, z);
+  return transform;
+}
+
+SCENARIO ("SceneGraph places children relative to their parents.", "[SceneGraph][A09]") {
+  GIVEN ("A paddle with a model attached, and a ball on its own.") {
+    SceneGraph graph;
+    unsigned paddle = graph.add (translation (0.0f, -10.0f, 18.0f));
+    unsigned model = graph.add (translation (0.0f, 1.0f, 0.0f), paddle);
+    unsigned ball = graph.add (translation (5.0f, 0.0f, 0.0f));
+    REQUIRE (graph.update () == 3);
+    THEN ("The model is where the paddle puts it.") {
+      REQUIRE (graph.getWorld (model).getPosition () == Vector3 (0.0f, -9.0f, 18.0f));
+      REQUIRE (graph.getParent (model) == paddle);
+      REQUIRE (graph.getParent (paddle) == SceneGraph::NO_PARENT);
+    }
+    WHEN ("The paddle turns and moves.") {
+      Transform moved = translation (2.0f, -10.0f, 18.0f);
+      moved.roll (90.0f);
+      graph.setLocal (paddle, moved);
+      size_t recomputed = graph.update ();
+      THEN ("Only the paddle and its model are recomputed, and the model turns with it.") {
+        REQUIRE (recomputed == 2);
+        Vector3 position = graph.getWorld (model).getPosition ();
+        REQUIRE (position.m_x == Approx (1.0f));
+        REQUIRE (position.m_y == Approx (-10.0f));
+        REQUIRE (graph.getWorld (ball).getPosition () == Vector3 (5.0f, 0.0f, 0.0f));
+      }
+    }
+    WHEN ("Nothing changes.") {
+      THEN ("Nothing is recomputed.") {
+        REQUIRE (graph.update () == 0);
+      }
+    }
+    WHEN ("The model is moved to the ball.") {
+      graph.setParent (model, ball);
+      graph.update ();
+      THEN ("It keeps its offset, now from the ball.") {
+        REQUIRE (graph.getWorld (model).getPosition () == Vector3 (5.0f, 1.0f, 0.0f));
+        REQUIRE (graph.getParent (model) == ball);
+      }
+    }
+    WHEN ("The model is removed and another node is added.") {
+      graph.remove (model);
+      unsigned shadow = graph.add (translation (0.0f, -1.0f, 0.0f), ball);
+      graph.update ();
+      THEN ("The new node reuses the id and the rest are unaffected.") {
+        REQUIRE (shadow == model);
+        REQUIRE (graph.getNodeCount () == 3);
+        REQUIRE (graph.getWorld (shadow).getPosition () == Vector3 (5.0f, -1.0f, 0.0f));
+        REQUIRE (graph.getWorld (paddle).getPosition () == Vector3 (0.0f, -10.0f, 18.0f));
+      }
+    }
+  }
+}
+
+SCENARIO ("SceneGraph propagates through deep hierarchies in any order they were built.", "[SceneGraph][A09]") {
+  GIVEN ("A chain of 100 nodes, each one unit above its parent.") {
+    SceneGraph graph;
+    std::vector<unsigned> chain { graph.add (Transform ()) };
+    for (int i = 1; i < 100; ++i) {
+      chain.push_back (graph.add (translation (0.0f, 1.0f, 0.0f), chain.back ()));
+    }
+    graph.update ();
+    WHEN ("The root is hung from a new node that was added last.") {
+      unsigned hook = graph.add (translation (0.0f, 0.0f, 7.0f));
+      graph.setParent (chain.front (), hook);
+      size_t recomputed = graph.update ();
+      THEN ("The whole chain follows.") {
+        REQUIRE (recomputed == 101);
+        REQUIRE (graph.getWorld (chain.back ()).getPosition () == Vector3 (0.0f, 99.0f, 7.0f));
+      }
+    }
+    WHEN ("A node in the middle moves.") {
+      graph.setLocal (chain[50], translation (1.0f, 1.0f, 0.0f));
+      THEN ("Only it and the nodes below it are recomputed.") {
+        REQUIRE (graph.update () == 50);
+        REQUIRE (graph.getWorld (chain[49]).getPosition () == Vector3 (0.0f, 49.0f, 0.0f));
+        REQUIRE (graph.getWorld (chain[99]).getPosition () == Vector3 (1.0f, 99.0f, 0.0f));
+      }
+    }
+  }
+}
@@ -0,0 +1,96 @@
+/// \file TestSweptCollision.cpp
+/// \brief A collection of Catch2 unit tests for the swept sphere tests.
+/// \author Justin Stevens
+/// \version A09
+
+#include <cmath>
+
+#include "SweptCollision.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("A swept sphere finds the first touch with a box.", "[SweptCollision][A09]") {
+  GIVEN ("A paddle 0.5 deep and a ball of radius 0.75 far in front of it.") {
+    Vector3 paddle (0.0f, 0.0f, 18.0f);
+    Vector3 halfSize (3.0f, 3.0f, 0.25f);
+    Vector3 start (1.0f, 1.0f, 0.0f);
+    SweepHit hit;
+    WHEN ("It moves so far in one step that it would end up past the paddle.") {
+      bool isHit = sweepSphereAabb (start, Vector3 (0.0f, 0.0f, 40.0f), 0.75f,
+                                    paddle, halfSize, hit);
+      THEN ("It touches the front face at the right time.") {
+        REQUIRE (isHit);
+        REQUIRE (hit.time == Approx ((18.0f - 0.25f - 0.75f) / 40.0f));
+        REQUIRE (hit.normal.m_z == Approx (-1.0f));
+      }
+    }
+    WHEN ("It passes beside the paddle, just clear of an edge.") {
+      bool isHit = sweepSphereAabb (Vector3 (3.8f, 0.0f, 0.0f),
+                                    Vector3 (0.0f, 0.0f, 40.0f), 0.75f,
+                                    paddle, halfSize, hit);
+      THEN ("It does not touch it.") {
+        REQUIRE_FALSE (isHit);
+      }
+    }
+    WHEN ("It grazes the paddle's edge.") {
+      bool isHit = sweepSphereAabb (Vector3 (3.5f, 0.0f, 0.0f),
+                                    Vector3 (0.0f, 0.0f, 40.0f), 0.75f,
+                                    paddle, halfSize, hit);
+      THEN ("It touches the rounded edge, with a slanted normal.") {
+        REQUIRE (isHit);
+        REQUIRE (hit.normal.m_x == Approx (2.0f / 3.0f));
+        REQUIRE (hit.normal.m_z == Approx (-std::sqrt (5.0f) / 3.0f));
+      }
+    }
+    WHEN ("It already overlaps the paddle.") {
+      Vector3 touching (0.0f, 0.0f, 17.5f);
+      bool isMovingIn = sweepSphereAabb (touching, Vector3 (0.0f, 0.0f, 1.0f),
+                                         0.75f, paddle, halfSize, hit);
+      bool isMovingOut = sweepSphereAabb (touching,
+                                          Vector3 (0.0f, 0.0f, -1.0f), 0.75f,
+                                          paddle, halfSize, hit);
+      THEN ("It touches at once if moving in, and is let go if moving out.") {
+        REQUIRE (isMovingIn);
+        REQUIRE (isMovingOut == false);
+      }
+    }
+  }
+}
+
+SCENARIO ("A swept sphere finds the first touch with a triangle.", "[SweptCollision][A09]") {
+  GIVEN ("A triangle in the z = 0 plane.") {
+    Vector3 a (-1.0f, -1.0f, 0.0f);
+    Vector3 b (1.0f, -1.0f, 0.0f);
+    Vector3 c (0.0f, 1.0f, 0.0f);
+    SweepHit hit;
+    WHEN ("A sphere falls onto its face from behind.") {
+      bool isHit = sweepSphereTriangle (Vector3 (0.0f, 0.0f, -5.0f),
+                                        Vector3 (0.0f, 0.0f, 10.0f), 0.5f,
+                                        a, b, c, hit);
+      THEN ("It touches the face with the normal facing it.") {
+        REQUIRE (isHit);
+        REQUIRE (hit.time == Approx (0.45f));
+        REQUIRE (hit.normal.m_z == Approx (-1.0f));
+      }
+    }
+    WHEN ("A sphere moves past a corner.") {
+      bool isHit = sweepSphereTriangle (Vector3 (0.0f, 1.3f, -5.0f),
+                                        Vector3 (0.0f, 0.0f, 10.0f), 0.5f,
+                                        a, b, c, hit);
+      THEN ("It touches the corner.") {
+        REQUIRE (isHit);
+        REQUIRE (hit.time == Approx ((5.0f - 0.4f) / 10.0f));
+        REQUIRE (hit.normal.m_y == Approx (0.6f));
+      }
+    }
+    WHEN ("A sphere moves parallel to it, out of reach.") {
+      bool isHit = sweepSphereTriangle (Vector3 (-5.0f, 0.0f, 0.6f),
+                                        Vector3 (10.0f, 0.0f, 0.0f), 0.5f,
+                                        a, b, c, hit);
+      THEN ("It does not touch it.") {
+        REQUIRE_FALSE (isHit);
+      }
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/// \file TestTripleBuffer.cpp
+/// \brief A collection of Catch2 unit tests for the TripleBuffer class.
+/// \author Justin Stevens
+/// \version A09
+
+#include <thread>
+#include <vector>
+
+#include "TripleBuffer.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+SCENARIO ("TripleBuffer hands the latest value to the reader.", "[TripleBuffer][A09]") {
+  GIVEN ("A TripleBuffer of ints starting at 0.") {
+    TripleBuffer<int> buffer (0);
+    THEN ("The reader sees the initial value before anything is published.") {
+      REQUIRE (buffer.getFront () == 0);
+    }
+    WHEN ("Several values are published before the reader looks.") {
+      for (int value = 1; value <= 3; ++value)
+      {
+        buffer.getBack () = value;
+        buffer.publish ();
+      }
+      THEN ("The reader sees only the last one, and keeps it until the next.") {
+        REQUIRE (buffer.getFront () == 3);
+        REQUIRE (buffer.getFront () == 3);
+        buffer.getBack () = 4;
+        buffer.publish ();
+        REQUIRE (buffer.getFront () == 4);
+      }
+    }
+  }
+  GIVEN ("A writer thread publishing whole frames as fast as it can.") {
+    const int FRAMES = 100000;
+    const size_t SIZE = 64;
+    TripleBuffer<std::vector<int>> buffer (std::vector<int> (SIZE, 0));
+    std::thread writer ([&buffer, FRAMES] () {
+      for (int frame = 1; frame <= FRAMES; ++frame)
+      {
+        std::vector<int>& back = buffer.getBack ();
+        for (int& value : back)
+          value = frame;
+        buffer.publish ();
+      }
+    });
+    WHEN ("The reader reads at the same time.") {
+      bool isTorn = false;
+      bool isBackwards = false;
+      int previous = 0;
+      while (previous < FRAMES)
+      {
+        const std::vector<int>& front = buffer.getFront ();
+        for (int value : front)
+          isTorn = isTorn || value != front[0];
+        isBackwards = isBackwards || front[0] < previous;
+        previous = front[0];
+      }
+      writer.join ();
+      THEN ("It never sees a half-written or older frame.") {
+        REQUIRE_FALSE (isTorn);
+        REQUIRE_FALSE (isBackwards);
+      }
+    }
+  }
+}
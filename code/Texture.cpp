@@ -3,6 +3,9 @@
 /// \author Aaron Katz & Justin Stevens
 /// \version A09
 
+#include <algorithm>
+#include <cmath>
+
 #include "Texture.hpp"
 
 
@@ -17,12 +20,30 @@ Texture::Texture(std::string filename)
 }
 
 void
-Texture::loadTextureID(GLuint &textureID)
+Texture::loadTextureID(OpenGLContext* context, GLuint &textureID)
+{
+  context->genTextures (1, &textureID);
+  context->bindTexture (GL_TEXTURE_2D, textureID);
+  context->texImage2D (GL_TEXTURE_2D, 0, GL_RGB, m_width, m_height, 0, GL_BGR, GL_UNSIGNED_BYTE, m_data);
+  context->generateMipmap (GL_TEXTURE_2D);
+}
+
+Vector3
+Texture::getColor (float u, float v) const
 {
-  glGenTextures (1, &textureID);
-  glBindTexture (GL_TEXTURE_2D, textureID);
-  glTexImage2D (GL_TEXTURE_2D, 0, GL_RGB, m_width, m_height, 0, GL_BGR, GL_UNSIGNED_BYTE, m_data);
-  glGenerateMipmap (GL_TEXTURE_2D);
+  if (m_width == 0 || m_height == 0)
+  {
+    return Vector3 (0.0f, 0.0f, 0.0f);
+  }
+  // FreeImage stores BGR rows from the bottom up, each padded to 4 bytes,
+  //   which is also how texImage2D reads them.
+  GLuint pitch = (3 * m_width + 3) / 4 * 4;
+  GLuint column = static_cast<GLuint> ((u - std::floor (u)) * m_width);
+  GLuint row = static_cast<GLuint> ((v - std::floor (v)) * m_height);
+  column = std::min (column, m_width - 1);
+  row = std::min (row, m_height - 1);
+  const BYTE* texel = m_data + row * pitch + 3 * column;
+  return Vector3 (texel[2], texel[1], texel[0]) / 255.0f;
 }
 
 Texture::~Texture()
@@ -10,6 +10,8 @@
 #include <FreeImagePlus.h>
 #include <string>
 
+#include "Vector3.hpp"
+
 class Texture
 {
 public:
@@ -17,7 +19,15 @@ public:
   Texture(std::string filename);
 
   void
-  loadTextureID(GLuint &textureID);
+  loadTextureID(OpenGLContext* context, GLuint &textureID);
+
+  /// \brief Reads the texel nearest to some texture coordinates on the CPU,
+  ///   wrapping the way GL_REPEAT does.
+  /// \param[in] u The horizontal texture coordinate.
+  /// \param[in] v The vertical texture coordinate.
+  /// \return The texel's red, green, and blue, from 0 to 1.
+  Vector3
+  getColor (float u, float v) const;
 
   ~Texture();
 
@@ -0,0 +1,53 @@
+/// \file TextureBuffer.cpp
+/// \brief Implementation of TextureBuffer class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include "TextureBuffer.hpp"
+
+TextureBuffer::TextureBuffer (OpenGLContext* context, GLenum internalFormat)
+  : m_context(context)
+{
+  m_context->genBuffers (1, &m_buffer);
+  setData (nullptr, 0);
+  m_context->genTextures (1, &m_texture);
+  m_context->bindTexture (GL_TEXTURE_BUFFER, m_texture);
+  m_context->texBuffer (GL_TEXTURE_BUFFER, internalFormat, m_buffer);
+  m_context->bindTexture (GL_TEXTURE_BUFFER, 0);
+}
+
+TextureBuffer::~TextureBuffer ()
+{
+  m_context->deleteTextures (1, &m_texture);
+  m_context->deleteBuffers (1, &m_buffer);
+}
+
+void
+TextureBuffer::setData (const void* data, GLsizeiptr size)
+{
+  // 16 bytes covers one texel of every format we use.
+  const GLsizeiptr MIN_SIZE = 16;
+  m_context->bindBuffer (GL_TEXTURE_BUFFER, m_buffer);
+  if (size < MIN_SIZE)
+  {
+    m_context->bufferData (GL_TEXTURE_BUFFER, MIN_SIZE, nullptr,
+                           GL_STREAM_DRAW);
+    if (size > 0)
+    {
+      m_context->bufferSubData (GL_TEXTURE_BUFFER, 0, size, data);
+    }
+  }
+  else
+  {
+    m_context->bufferData (GL_TEXTURE_BUFFER, size, data, GL_STREAM_DRAW);
+  }
+  m_context->bindBuffer (GL_TEXTURE_BUFFER, 0);
+}
+
+void
+TextureBuffer::bind (GLuint unit)
+{
+  m_context->activeTexture (GL_TEXTURE0 + unit);
+  m_context->bindTexture (GL_TEXTURE_BUFFER, m_texture);
+}
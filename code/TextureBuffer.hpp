@@ -0,0 +1,64 @@
+/// \file TextureBuffer.hpp
+/// \brief Declaration of TextureBuffer class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef TEXTURE_BUFFER_HPP
+#define TEXTURE_BUFFER_HPP
+
+#include "OpenGLContext.hpp"
+
+/// \brief A buffer object that shaders read as a samplerBuffer.
+/// Unlike a uniform block, a texture buffer can be far larger than the
+///   uniform size limit and its length can change from frame to frame, which
+///   makes it suitable for arrays whose size is only known at run time.
+class TextureBuffer
+{
+public:
+
+  /// \brief Constructs a new, empty texture buffer.
+  /// \param context A pointer to an object through which the buffer will make
+  ///   OpenGL calls.
+  /// \param[in] internalFormat How shaders interpret each texel, such as
+  ///   GL_RGBA32F or GL_R32UI.
+  /// \post A buffer object and a texture that reads from it have been
+  ///   created.
+  TextureBuffer (OpenGLContext* context, GLenum internalFormat);
+
+  /// \brief Destructs this buffer.
+  /// \post The buffer object and texture have been deleted.
+  ~TextureBuffer ();
+
+  /// \brief Copy constructor removed because you shouldn't be copying buffers.
+  TextureBuffer (const TextureBuffer&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   buffers.
+  TextureBuffer&
+  operator= (const TextureBuffer&) = delete;
+
+  /// \brief Replaces the buffer's contents, resizing it if needed.
+  /// \param[in] data The bytes to copy.
+  /// \param[in] size How many bytes to copy.  An empty buffer still gets one
+  ///   texel, since some drivers reject textures with no storage.
+  /// \post The buffer contains a copy of data.
+  void
+  setData (const void* data, GLsizeiptr size);
+
+  /// \brief Binds the texture to a texture unit.
+  /// \param[in] unit The index of the texture unit (0 for GL_TEXTURE0).
+  /// \post A samplerBuffer set to unit reads from this buffer.
+  void
+  bind (GLuint unit);
+
+private:
+  /// A pointer to the object through which this buffer makes OpenGL calls.
+  OpenGLContext* m_context;
+  /// The name of the buffer object.
+  GLuint m_buffer;
+  /// The name of the texture that reads from m_buffer.
+  GLuint m_texture;
+};
+
+#endif//TEXTURE_BUFFER_HPP
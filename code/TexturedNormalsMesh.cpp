@@ -7,14 +7,14 @@ TexturedNormalsMesh::TexturedNormalsMesh (OpenGLContext* context, ShaderProgram*
   : NormalsMesh(context, shaderProgram, material)
 {
   m_texture = texture;
-  m_texture->loadTextureID(m_tid);
+  m_texture->loadTextureID(m_context, m_tid);
 }
 
 TexturedNormalsMesh::TexturedNormalsMesh (OpenGLContext* context, ShaderProgram* shader, std::string filename, unsigned int meshNum, Material* material, Texture* texture, float detail)
   : NormalsMesh(context, shader, material)
 {
   m_texture = texture;
-  m_texture->loadTextureID(m_tid);
+  m_texture->loadTextureID(m_context, m_tid);
   Assimp::Importer importer;
   unsigned int flags =
     aiProcess_Triangulate              // convert all shapes to triangles
@@ -102,36 +102,30 @@ TexturedNormalsMesh::~TexturedNormalsMesh ()
 }
 
 void
-TexturedNormalsMesh::draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPosition)
+TexturedNormalsMesh::drawThrough (OpenGLContext* context)
 {
   // Iterate over each object in scene and draw it
   // The shader program is already enabled, but we do not want to
   //   make that assumption in general.
-  m_shaderProgram->enable ();
+  m_shaderProgram->enable (context);
 
-  m_shaderProgram->setUniformMatrix ("uWorld", m_world.getTransform());
-  m_shaderProgram->setUniformMatrix ("uView", viewMatrix.getTransform());
-  m_shaderProgram->setUniformMatrix ("uProjection", projectionMatrix);
-  
-  m_shaderProgram->setUniformVector ("uEyePosition", Vector3(0.0f, 0.0f, 0.0f));
-
-  m_material->setUniforms(m_shaderProgram);
-  m_shaderProgram->setUniformInt("uHasTexture", 1);
+  // The camera and lights are in the Scene's FrameBlock, so only the
+  //   object and material blocks are bound here.
+  bindUniformBlocks (context, true);
 
-  // Draw Texture
-  glActiveTexture (GL_TEXTURE0);
-  glBindTexture (GL_TEXTURE_2D, m_tid);
-  m_shaderProgram->setUniformInt("uDiffuseSampler", 0);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  // Draw Texture (uDiffuseSampler always reads unit 0)
+  context->activeTexture (GL_TEXTURE0);
+  context->bindTexture (GL_TEXTURE_2D, m_tid);
+  context->texParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  context->texParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 
   // Draw geometry
-  m_context->bindVertexArray (m_vao);
-  glDrawElements (GL_TRIANGLES, m_indices.size (), GL_UNSIGNED_INT,
+  context->bindVertexArray (m_vao);
+  context->drawElements (GL_TRIANGLES, m_indices.size (), m_indexType,
     reinterpret_cast<void*> (0));
-  m_context->bindVertexArray (0);
+  context->bindVertexArray (0);
 
-  m_shaderProgram->disable ();
+  m_shaderProgram->disable (context);
 }
 
 unsigned int
@@ -140,6 +134,18 @@ TexturedNormalsMesh::getFloatsPerVertex () const
   return 8;
 }
 
+VertexLayout
+TexturedNormalsMesh::getVertexLayout () const
+{
+  return VertexLayout { -1, 3, 6 };
+}
+
+const Texture*
+TexturedNormalsMesh::getTexture () const
+{
+  return m_texture;
+}
+
 void
 TexturedNormalsMesh::enableAttributes()
 {
@@ -161,4 +167,11 @@ TexturedNormalsMesh::enableAttributes()
   // Textures have 2 parts, each are floats, start at 6th position in array, stride is 8
   m_context->vertexAttribPointer (TEXTURE_ATTRIB_INDEX, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float),
           reinterpret_cast<void*> (6 * sizeof(float)));
-}
\ No newline at end of file
+}
+
+Mesh*
+TexturedNormalsMesh::createEmpty () const
+{
+  return new TexturedNormalsMesh(m_context, m_shaderProgram, m_material,
+                                 m_texture);
+}
@@ -49,13 +49,29 @@ public:
   ~TexturedNormalsMesh ();
 
   void
-  draw (const Transform& viewMatrix, const Matrix4& projectionMatrix, const Vector3& cameraPosition);
+  drawThrough (OpenGLContext* context);
 
   /// \brief Gets the number of floats used to represent each vertex.
   /// \return The number of floats used for each vertex.
   unsigned int
   getFloatsPerVertex () const;
 
+  /// \brief Gets which attributes each vertex has and where they are.
+  /// \return Positions, normals, and texture coordinates.
+  VertexLayout
+  getVertexLayout () const;
+
+  /// \brief Gets the texture the diffuse reflection is read from.
+  /// \return The texture.
+  const Texture*
+  getTexture () const;
+
+  /// \brief Constructs an empty Mesh of the same kind as this one, drawn with
+  ///   the same ShaderProgram, Material, and texture.
+  /// \return The new Mesh, which the caller owns.
+  Mesh*
+  createEmpty () const;
+
   /// \brief Enables VAO attributes.
   /// \pre This Mesh's VAO has been bound.
   /// \post Any attributes (positions, colors, normals, texture coordinates)
@@ -7,7 +7,9 @@
 #define TRANSFORM_HPP
 
 #include <iostream>
+#include <type_traits>
 
+#include "Aligned16.hpp"
 #include "Matrix3.hpp"
 #include "Matrix4.hpp"
 #include "Vector3.hpp"
@@ -308,4 +310,19 @@ operator<< (std::ostream& out, const Transform& t);
 bool
 operator== (const Transform& t1, const Transform& t2);
 
+// So that arrays of transforms can be snapshotted, written to disk, and
+//   uploaded with memcpy.
+static_assert (std::is_trivially_copyable<Transform>::value
+               && std::is_standard_layout<Transform>::value,
+               "Transform must be copyable as bytes");
+static_assert (sizeof (Transform) == sizeof (Matrix3) + sizeof (Vector3),
+               "Transform must hold nothing but its matrix and position");
+
+/// \brief A Transform on a 16-byte boundary.
+using AlignedTransform = Aligned16<Transform>;
+
+static_assert (sizeof (AlignedTransform) == 48
+               && std::is_trivially_copyable<AlignedTransform>::value,
+               "AlignedTransform must be Transform padded to 16 bytes");
+
 #endif//TRANSFORM_HPP
\ No newline at end of file
@@ -0,0 +1,88 @@
+/// \file TripleBuffer.hpp
+/// \brief Declaration and definition of TripleBuffer class template.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+
+/// \brief Hands values from one writer thread to one reader thread without
+///   locks or waiting.
+/// The writer fills its back slot and publishes it; the reader takes the most
+///   recently published slot as its front.  A third slot sits between them,
+///   holding the latest published value, so that neither thread ever has to
+///   wait for the other to finish with a slot: this is double buffering with
+///   the swap made lock-free.  Values the reader never got to are skipped.
+/// \tparam T The type of value, which is copied into all three slots once.
+template <typename T>
+class TripleBuffer
+{
+public:
+
+  /// \brief Constructs a TripleBuffer with every slot holding a value.
+  /// \param[in] initial The value the reader sees until the first publish.
+  explicit TripleBuffer (const T& initial)
+    : m_slots { initial, initial, initial },
+      m_back (0), m_middle (1), m_front (2)
+  {
+  }
+
+  /// \brief Copy constructor removed because the slots belong to threads.
+  TripleBuffer (const TripleBuffer&) = delete;
+
+  /// \brief Assignment operator removed because the slots belong to threads.
+  TripleBuffer&
+  operator= (const TripleBuffer&) = delete;
+
+  /// \brief Gets the slot the writer fills, which the reader cannot see.
+  /// Only the writer thread may call this.
+  /// \return The back slot, holding whatever was published two or more
+  ///   publishes ago.
+  T&
+  getBack ()
+  {
+    return m_slots[m_back];
+  }
+
+  /// \brief Makes the back slot the latest value and takes a new back slot.
+  /// Only the writer thread may call this.
+  /// \post Everything written to the old back slot is visible to the reader
+  ///   once it takes it.
+  void
+  publish ()
+  {
+    m_back = m_middle.exchange (m_back | FRESH, std::memory_order_acq_rel)
+      & ~FRESH;
+  }
+
+  /// \brief Gets the latest published value.
+  /// Only the reader thread may call this.
+  /// \return The front slot, which stays unchanged until the next call.
+  const T&
+  getFront ()
+  {
+    if (m_middle.load (std::memory_order_relaxed) & FRESH)
+    {
+      m_front = m_middle.exchange (m_front, std::memory_order_acq_rel)
+        & ~FRESH;
+    }
+    return m_slots[m_front];
+  }
+
+private:
+  /// Set in m_middle when its slot was published after the reader last took
+  ///   one.
+  static const unsigned FRESH = 4;
+
+  T m_slots[3];
+  /// The index of the writer's slot.
+  unsigned m_back;
+  /// The index of the slot between the threads, and FRESH.
+  std::atomic<unsigned> m_middle;
+  /// The index of the reader's slot.
+  unsigned m_front;
+};
+
+#endif//TRIPLE_BUFFER_HPP
@@ -0,0 +1,178 @@
+/// \file UniformBlocks.hpp
+/// \brief Declaration of the C++ mirrors of the shaders' uniform blocks.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef UNIFORM_BLOCKS_HPP
+#define UNIFORM_BLOCKS_HPP
+
+#include <cstddef>
+#include <cstring>
+
+#include "Vector3.hpp"
+#include "Matrix3.hpp"
+#include "Matrix4.hpp"
+
+// Each struct below is copied byte for byte into a uniform buffer, so its
+//   layout must match the std140 rules for the block of the same name in
+//   Shaders/PhongShader.vert and Shaders/PhongShader.frag:
+//   vec3s take 16 bytes unless a scalar follows them, mat3 columns are padded
+//   to vec4s, and struct and array elements start on 16-byte boundaries.
+
+/// \brief The binding points that the uniform blocks are attached to.
+/// These are assigned to every ShaderProgram once, after it is linked.
+enum UniformBlockBinding {
+  FRAME_BLOCK_BINDING = 0,
+  MATERIAL_BLOCK_BINDING = 1,
+  OBJECT_BLOCK_BINDING = 2
+};
+
+/// \brief The texture units that the clustered lighting buffers are bound
+///   to, after the diffuse texture's unit 0.
+/// These are assigned to the Phong ShaderProgram's samplers once, after it is
+///   linked.
+enum ClusterTextureUnit {
+  CLUSTER_LIGHTS_UNIT = 1,
+  CLUSTER_GRID_UNIT = 2,
+  CLUSTER_INDICES_UNIT = 3
+};
+
+/// \brief The texture units that the per-object buffers of an indirect
+///   ShaderProgram are bound to, after the clustered lighting buffers.
+/// These are assigned to the indirect programs' samplers once, after they
+///   are linked.
+enum IndirectTextureUnit {
+  INDIRECT_OBJECTS_UNIT = 4,
+  INDIRECT_MATERIALS_UNIT = 5
+};
+
+/// \brief The size of the directional light array in FrameUniforms (and the
+///   shaders).  Point and spot lights are culled into clusters instead, so
+///   there is no limit on them.
+const int MAX_LIGHTS = 8;
+
+/// \brief One element of the "uLights" array, and also one light in the
+///   "uClusterLights" texture buffer, where it is read as 5 RGBA32F texels.
+struct LightUniforms
+{
+  float diffuseIntensity[3];
+  /// 0 if directional, 1 if point, 2 if spot.
+  int type;
+  float specularIntensity[3];
+  float cutoffCosAngle;
+  float position[3];
+  float falloff;
+  float attenuationCoefficients[3];
+  float padding0;
+  float direction[3];
+  float padding1;
+};
+
+/// \brief The "FrameBlock" uniform block: everything shared by every object
+///   drawn in a frame.
+struct FrameUniforms
+{
+  float view[16];
+  float inverseView[16];
+  float projection[16];
+  float ambientIntensity[3];
+  int numLights;
+  int clusterCounts[3];
+  float clusterDepthScale;
+  float clusterDepthBias;
+  float padding[3];
+  LightUniforms lights[MAX_LIGHTS];
+};
+
+/// \brief The "MaterialBlock" uniform block.
+struct MaterialUniforms
+{
+  float ambientReflection[3];
+  float padding0;
+  float diffuseReflection[3];
+  float padding1;
+  float specularReflection[3];
+  float padding2;
+  float emissiveIntensity[3];
+  float specularPower;
+};
+
+/// \brief The "ObjectBlock" uniform block: everything specific to one Mesh.
+struct ObjectUniforms
+{
+  float world[16];
+  /// The inverse transpose of the world matrix's 3x3 part, as 3 padded
+  ///   columns.
+  float worldNormal[12];
+  int hasTexture;
+  float padding[3];
+};
+
+/// \brief One object in the "uObjects" texture buffer that shaders compiled
+///   with INDIRECT_DRAW read in place of the ObjectBlock, as 8 RGBA32F
+///   texels.  Each draw's aObjectIndex selects one; its Material is
+///   selected in turn from "uMaterials", which holds MaterialUniforms, 4
+///   texels each.
+struct IndirectObjectUniforms
+{
+  float world[16];
+  /// The inverse transpose of the world matrix's 3x3 part, as 3 padded
+  ///   columns.
+  float worldNormal[12];
+  /// A float, since everything in the buffer is read as one.
+  float materialIndex;
+  float padding[3];
+};
+
+static_assert (sizeof (LightUniforms) == 80, "LightUniforms must match std140");
+static_assert (sizeof (FrameUniforms) == 240 + MAX_LIGHTS * 80,
+               "FrameUniforms must match std140");
+static_assert (offsetof (FrameUniforms, clusterCounts) == 208,
+               "FrameUniforms::clusterCounts must match std140");
+static_assert (offsetof (FrameUniforms, lights) == 240,
+               "FrameUniforms::lights must match std140");
+static_assert (sizeof (MaterialUniforms) == 64,
+               "MaterialUniforms must match std140");
+static_assert (sizeof (ObjectUniforms) == 128,
+               "ObjectUniforms must match std140");
+static_assert (sizeof (IndirectObjectUniforms) == 128,
+               "IndirectObjectUniforms must be 8 texels");
+
+/// \brief Copies a vector into a std140 vec3.
+/// \param[out] out The 3 floats to write.
+/// \param[in] v The vector to copy.
+inline void
+copyToBlock (float out[3], const Vector3& v)
+{
+  out[0] = v.m_x;
+  out[1] = v.m_y;
+  out[2] = v.m_z;
+}
+
+/// \brief Copies a matrix into a std140 mat4.
+/// \param[out] out The 16 floats to write.
+/// \param[in] m The matrix to copy.
+inline void
+copyToBlock (float out[16], const Matrix4& m)
+{
+  std::memcpy (out, m.data (), 16 * sizeof (float));
+}
+
+/// \brief Copies a matrix into a std140 mat3, which pads each column to 4
+///   floats.
+/// \param[out] out The 12 floats to write.
+/// \param[in] m The matrix to copy.
+inline void
+copyToBlock (float out[12], const Matrix3& m)
+{
+  const float* data = m.data ();
+  for (int column = 0; column < 3; ++column)
+  {
+    out[column * 4 + 0] = data[column * 3 + 0];
+    out[column * 4 + 1] = data[column * 3 + 1];
+    out[column * 4 + 2] = data[column * 3 + 2];
+    out[column * 4 + 3] = 0.0f;
+  }
+}
+
+#endif//UNIFORM_BLOCKS_HPP
@@ -0,0 +1,48 @@
+/// \file UniformBuffer.cpp
+/// \brief Implementation of UniformBuffer class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#include "UniformBuffer.hpp"
+
+UniformBuffer::UniformBuffer (OpenGLContext* context, GLsizeiptr size)
+  : m_context(context)
+{
+  m_context->genBuffers (1, &m_buffer);
+  m_context->bindBuffer (GL_UNIFORM_BUFFER, m_buffer);
+  m_context->bufferData (GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  m_context->bindBuffer (GL_UNIFORM_BUFFER, 0);
+}
+
+UniformBuffer::~UniformBuffer ()
+{
+  m_context->deleteBuffers (1, &m_buffer);
+}
+
+void
+UniformBuffer::update (const void* data, GLsizeiptr size, GLintptr offset)
+{
+  update (m_context, data, size, offset);
+}
+
+void
+UniformBuffer::update (OpenGLContext* context, const void* data,
+                       GLsizeiptr size, GLintptr offset) const
+{
+  context->bindBuffer (GL_UNIFORM_BUFFER, m_buffer);
+  context->bufferSubData (GL_UNIFORM_BUFFER, offset, size, data);
+  context->bindBuffer (GL_UNIFORM_BUFFER, 0);
+}
+
+void
+UniformBuffer::bind (GLuint bindingPoint)
+{
+  bind (m_context, bindingPoint);
+}
+
+void
+UniformBuffer::bind (OpenGLContext* context, GLuint bindingPoint) const
+{
+  context->bindBufferBase (GL_UNIFORM_BUFFER, bindingPoint, m_buffer);
+}
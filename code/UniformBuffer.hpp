@@ -0,0 +1,78 @@
+/// \file UniformBuffer.hpp
+/// \brief Declaration of UniformBuffer class and any associated global
+///   functions.
+/// \author Justin Stevens
+/// \version A09
+
+#ifndef UNIFORM_BUFFER_HPP
+#define UNIFORM_BUFFER_HPP
+
+#include "OpenGLContext.hpp"
+
+/// \brief A buffer object that backs a uniform block.
+/// Uniform blocks let many uniforms be set with a single buffer update, and
+///   let every ShaderProgram that declares the block share the same values.
+class UniformBuffer
+{
+public:
+
+  /// \brief Constructs a new buffer with room for a block.
+  /// \param context A pointer to an object through which the buffer will make
+  ///   OpenGL calls.
+  /// \param[in] size The size of the block, in bytes.
+  /// \post A buffer of that size has been allocated, with undefined contents.
+  UniformBuffer (OpenGLContext* context, GLsizeiptr size);
+
+  /// \brief Destructs this buffer.
+  /// \post The buffer object has been deleted.
+  ~UniformBuffer ();
+
+  /// \brief Copy constructor removed because you shouldn't be copying buffers.
+  UniformBuffer (const UniformBuffer&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   buffers.
+  UniformBuffer&
+  operator= (const UniformBuffer&) = delete;
+
+  /// \brief Replaces part of the buffer's contents.
+  /// \param[in] data The bytes to copy.
+  /// \param[in] size How many bytes to copy.
+  /// \param[in] offset Where in the buffer to start writing.
+  /// \pre offset + size is no more than the size of the buffer.
+  /// \post Those bytes of the buffer contain a copy of data.
+  void
+  update (const void* data, GLsizeiptr size, GLintptr offset = 0);
+
+  /// \brief Replaces part of the buffer's contents through another context,
+  ///   such as a CommandList recording the calls to make later.
+  /// \param context The context to make the calls through.
+  /// \param[in] data The bytes to copy.
+  /// \param[in] size How many bytes to copy.
+  /// \param[in] offset Where in the buffer to start writing.
+  /// \pre offset + size is no more than the size of the buffer.
+  void
+  update (OpenGLContext* context, const void* data, GLsizeiptr size,
+          GLintptr offset = 0) const;
+
+  /// \brief Attaches this buffer to a uniform block binding point.
+  /// \param[in] bindingPoint The binding point to use.
+  /// \post Every block assigned to bindingPoint reads from this buffer.
+  void
+  bind (GLuint bindingPoint);
+
+  /// \brief Attaches this buffer to a uniform block binding point through
+  ///   another context, such as a CommandList.
+  /// \param context The context to make the call through.
+  /// \param[in] bindingPoint The binding point to use.
+  void
+  bind (OpenGLContext* context, GLuint bindingPoint) const;
+
+private:
+  /// A pointer to the object through which this buffer makes OpenGL calls.
+  OpenGLContext* m_context;
+  /// The name of the buffer object.
+  GLuint m_buffer;
+};
+
+#endif//UNIFORM_BUFFER_HPP
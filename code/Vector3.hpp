@@ -11,6 +11,9 @@
 #include <cmath>
 #include <iomanip>
 #include <glm/vec3.hpp> 
+#include <type_traits>
+
+#include "Aligned16.hpp"
 
 /// \brief A vector of 3 floating-point numbers.
 /// These should behave just like our normal mathematical understanding of
@@ -195,4 +198,17 @@ operator<< (std::ostream& out, const Vector3& v);
 bool
 operator== (const Vector3& v1, const Vector3& v2);
 
+static_assert (std::is_trivially_copyable<Vector3>::value
+               && std::is_standard_layout<Vector3>::value,
+               "Vector3 must be copyable as bytes");
+static_assert (sizeof (Vector3) == 3 * sizeof (float),
+               "Vector3 must hold nothing but its three coefficients");
+
+/// \brief A Vector3 on a 16-byte boundary.
+using AlignedVector3 = Aligned16<Vector3>;
+
+static_assert (sizeof (AlignedVector3) == 16
+               && std::is_trivially_copyable<AlignedVector3>::value,
+               "AlignedVector3 must be Vector3 padded to 16 bytes");
+
 #endif//VECTOR3_HPP
\ No newline at end of file
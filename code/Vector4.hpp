@@ -7,6 +7,9 @@
 #define VECTOR4_HPP
 
 #include <iostream>
+#include <type_traits>
+
+#include "Aligned16.hpp"
 
 /// \brief A vector with 4 float components (x, y, z, and w).
 class Vector4
@@ -185,4 +188,17 @@ operator<< (std::ostream& out, const Vector4& v);
 bool
 operator== (const Vector4& v1, const Vector4& v2);
 
+static_assert (std::is_trivially_copyable<Vector4>::value
+               && std::is_standard_layout<Vector4>::value,
+               "Vector4 must be copyable as bytes");
+static_assert (sizeof (Vector4) == 4 * sizeof (float),
+               "Vector4 must hold nothing but its four coefficients");
+
+/// \brief A Vector4 on a 16-byte boundary.
+using AlignedVector4 = Aligned16<Vector4>;
+
+static_assert (sizeof (AlignedVector4) == 16
+               && std::is_trivially_copyable<AlignedVector4>::value,
+               "AlignedVector4 must be Vector4 padded to 16 bytes");
+
 #endif//TRANSFORM_HPP
\ No newline at end of file